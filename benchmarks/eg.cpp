@@ -0,0 +1,115 @@
+/*
+    Envelope generator benchmark
+
+    Compares the per voice cost of the gig::EGADSR envelope generator being
+    advanced the conventional way, that is by calling processLin() /
+    processExp() for every single subfragment, against advancing it in
+    closed form with processSteps() for a whole audio fragment at once
+    (split only at envelope stage transitions). It also prints the max.
+    level difference between both methods.
+*/
+
+#include <math.h>
+#include <time.h>
+#include <stdio.h>
+
+#include "../src/engines/gig/EGADSR.h"
+
+#define SAMPLERATE      44100
+#define FRAGMENTSIZE    256
+#define VOICES          64
+#define FRAGMENTS       20000 // per run, that is about 2 minutes of audio
+
+using namespace LinuxSampler;
+
+static const int steps = FRAGMENTSIZE / CONFIG_DEFAULT_SUBFRAGMENT_SIZE; // EG steps per fragment
+
+static void trigger(gig::EGADSR& eg, int voice) {
+    eg.trigger(
+        0 /*PreAttack*/, 0.01f * (voice % 8) /*AttackTime*/, false /*HoldAttack*/,
+        0.5f + 0.1f * (voice % 5) /*Decay1Time*/, 2.0 /*Decay2Time*/,
+        voice % 2 /*InfiniteSustain*/, 500 /*SustainLevel*/,
+        0.3f /*ReleaseTime*/, 1.0f /*Volume*/,
+        SAMPLERATE / CONFIG_DEFAULT_SUBFRAGMENT_SIZE
+    );
+}
+
+static bool release(int fragment, int voice) {
+    return fragment == 3000 + voice * 20;
+}
+
+// advance EG by one step the conventional way
+static float step(gig::EGADSR& eg) {
+    float level;
+    switch (eg.getSegmentType()) {
+        case EG::segment_lin: level = eg.processLin(); break;
+        case EG::segment_exp: level = eg.processExp(); break;
+        case EG::segment_pow: level = eg.processPow(); break;
+        default:              level = eg.getLevel();
+    }
+    if (eg.active()) {
+        eg.increment(1);
+        if (!eg.toStageEndLeft()) eg.update(EG::event_stage_end, SAMPLERATE / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+    }
+    return level;
+}
+
+// advance EG by n steps in closed form, returns level after the last step
+static float block(gig::EGADSR& eg, int n) {
+    float level = eg.getLevel();
+    while (n > 0) {
+        if (!eg.active()) return eg.getLevel();
+        int k = eg.toStageEndLeft();
+        if (k > n) k = n;
+        level = eg.processSteps(k);
+        eg.increment(k);
+        if (!eg.toStageEndLeft()) eg.update(EG::event_stage_end, SAMPLERATE / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+        n -= k;
+    }
+    return level;
+}
+
+int main() {
+    static gig::EGADSR egStep[VOICES], egBlock[VOICES];
+    static float levelStep[VOICES], levelBlock[VOICES];
+
+    for (int v = 0; v < VOICES; v++) {
+        trigger(egStep[v], v);
+        trigger(egBlock[v], v);
+    }
+
+    // first run: verify both methods yield the same envelope levels
+    float maxDiff = 0.0f;
+    for (int f = 0; f < FRAGMENTS; f++) {
+        for (int v = 0; v < VOICES; v++) {
+            if (release(f, v)) {
+                egStep[v].update(EG::event_release, SAMPLERATE / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+                egBlock[v].update(EG::event_release, SAMPLERATE / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+            }
+            for (int i = 0; i < steps; i++) levelStep[v] = step(egStep[v]);
+            levelBlock[v] = block(egBlock[v], steps);
+            const float diff = fabs(levelStep[v] - levelBlock[v]);
+            if (diff > maxDiff) maxDiff = diff;
+        }
+    }
+    printf("Max. level difference: %g\n", maxDiff);
+
+    for (int method = 0; method < 2; method++) {
+        for (int v = 0; v < VOICES; v++) trigger(egStep[v], v);
+        float sum = 0.0f; // prevent the compiler from optimizing everything away
+        clock_t start_time = clock();
+        for (int f = 0; f < FRAGMENTS; f++) {
+            for (int v = 0; v < VOICES; v++) {
+                if (release(f, v)) egStep[v].update(EG::event_release, SAMPLERATE / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+                if (method == 0)
+                    for (int i = 0; i < steps; i++) sum += step(egStep[v]);
+                else
+                    sum += block(egStep[v], steps);
+            }
+        }
+        clock_t stop_time = clock();
+        float elapsed_time = (stop_time - start_time) / (double(CLOCKS_PER_SEC) / 1000.0);
+        printf("%s: %1.0f ms (%d voices, %d steps per fragment) [%g]\n",
+               (method == 0) ? "per step   " : "closed form", elapsed_time, VOICES, steps, sum);
+    }
+}
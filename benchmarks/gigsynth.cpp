@@ -64,6 +64,8 @@ int main() {
     pParam->fFinalVolumeDeltaLeft = 0;
     pParam->fFinalVolumeDeltaRight = 0;
     pParam->pSrc = pSampleInputBuf;
+    pParam->pRawLeft = NULL;
+    pParam->pRawRight = NULL;
 
     // define some loop points
     Loop* pLoop = new Loop;
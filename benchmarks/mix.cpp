@@ -0,0 +1,129 @@
+/*
+    Audio channel mixing benchmark
+
+    Compares routing the (stereo) signals of several sampler channels to
+    their dry destination and to their FX send destinations by calling
+    AudioChannel::MixTo() once for each destination, against mixing each
+    source channel to all its destinations in one pass with the multi
+    destination version of AudioChannel::MixTo(). A plain scalar loop per
+    destination is benchmarked as reference as well. It also prints the
+    max. difference between the results of the methods.
+*/
+
+#include <math.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/drivers/audio/AudioChannel.h"
+
+#define FRAGMENTSIZE    256
+#define SOURCES         32   // mono source channels (i.e. 16 stereo sampler channels)
+#define OUTPUTS         8    // output channels the sources are routed to (dry)
+#define SENDS           3    // FX sends of each source
+#define FX_INPUTS       6    // effect input channels the FX sends are routed to
+#define FRAGMENTS       20000 // per run, that is about 2 minutes of audio
+
+using namespace LinuxSampler;
+
+static AudioChannel* sources[SOURCES];
+static AudioChannel* destinations[OUTPUTS + FX_INPUTS];
+
+// the destinations of each source, index 0 is the dry destination
+static AudioChannel* routing[SOURCES][1 + SENDS];
+static float         levels[SOURCES][1 + SENDS];
+
+static void render() {
+    for (int s = 0; s < SOURCES; s++) {
+        float* buf = sources[s]->Buffer();
+        for (int i = 0; i < FRAGMENTSIZE; i++)
+            buf[i] = float(rand()) / float(RAND_MAX) * 2.0f - 1.0f;
+    }
+}
+
+static void clear() {
+    for (int d = 0; d < OUTPUTS + FX_INPUTS; d++)
+        destinations[d]->Clear();
+}
+
+static void mix(int method) {
+    for (int s = 0; s < SOURCES; s++) {
+        switch (method) {
+            case 0: // plain scalar loop per destination
+                for (int d = 0; d < 1 + SENDS; d++) {
+                    const float* src = sources[s]->ConstBuffer();
+                    float* dst = routing[s][d]->Buffer();
+                    const float level = levels[s][d];
+                    for (int i = 0; i < FRAGMENTSIZE; i++)
+                        dst[i] += src[i] * level;
+                }
+                break;
+            case 1: // MixTo() per destination
+                for (int d = 0; d < 1 + SENDS; d++)
+                    sources[s]->MixTo(routing[s][d], FRAGMENTSIZE, levels[s][d]);
+                break;
+            case 2: // all destinations in one pass
+                sources[s]->MixTo(routing[s], levels[s], 1 + SENDS, FRAGMENTSIZE);
+                break;
+        }
+    }
+}
+
+static const char* name(int method) {
+    switch (method) {
+        case 0:  return "scalar loop per destination";
+        case 1:  return "MixTo() per destination    ";
+        default: return "MixTo() all destinations   ";
+    }
+}
+
+int main() {
+    for (int s = 0; s < SOURCES; s++)
+        sources[s] = new AudioChannel(s, FRAGMENTSIZE);
+    for (int d = 0; d < OUTPUTS + FX_INPUTS; d++)
+        destinations[d] = new AudioChannel(d, FRAGMENTSIZE);
+    for (int s = 0; s < SOURCES; s++) {
+        routing[s][0] = destinations[s % OUTPUTS];
+        levels[s][0]  = 1.0f;
+        for (int f = 0; f < SENDS; f++) {
+            routing[s][1 + f] = destinations[OUTPUTS + (s + f) % FX_INPUTS];
+            levels[s][1 + f]  = 0.1f * (f + 1);
+        }
+    }
+
+    // first run: verify all methods yield the same result
+    static float result[3][OUTPUTS + FX_INPUTS][FRAGMENTSIZE];
+    for (int method = 0; method < 3; method++) {
+        srand(0);
+        render();
+        clear();
+        mix(method);
+        for (int d = 0; d < OUTPUTS + FX_INPUTS; d++)
+            for (int i = 0; i < FRAGMENTSIZE; i++)
+                result[method][d][i] = destinations[d]->ConstBuffer()[i];
+    }
+    float maxDiff = 0.0f;
+    for (int method = 1; method < 3; method++)
+        for (int d = 0; d < OUTPUTS + FX_INPUTS; d++)
+            for (int i = 0; i < FRAGMENTSIZE; i++) {
+                const float diff = fabs(result[method][d][i] - result[0][d][i]);
+                if (diff > maxDiff) maxDiff = diff;
+            }
+    printf("Max. difference: %g\n", maxDiff);
+
+    srand(0);
+    render();
+    for (int method = 0; method < 3; method++) {
+        float sum = 0.0f; // prevent the compiler from optimizing everything away
+        clock_t start_time = clock();
+        for (int f = 0; f < FRAGMENTS; f++) {
+            clear();
+            mix(method);
+            sum += destinations[f % (OUTPUTS + FX_INPUTS)]->ConstBuffer()[f % FRAGMENTSIZE];
+        }
+        clock_t stop_time = clock();
+        float elapsed_time = (stop_time - start_time) / (double(CLOCKS_PER_SEC) / 1000.0);
+        printf("%s: %1.0f ms (%d sources, %d destinations each) [%g]\n",
+               name(method), elapsed_time, SOURCES, 1 + SENDS, sum);
+    }
+}
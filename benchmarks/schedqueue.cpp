@@ -0,0 +1,117 @@
+/*
+    Scheduler queue benchmark
+
+    Compares the RTAVLTree against the RTTimingWheel as scheduler queue for
+    suspended instrument script events, i.e. for scripts calling wait() on
+    every note. A fixed amount of events is scheduled with random delays,
+    then for each audio fragment all events due in the fragment are popped
+    and scheduled again with a new random delay (like a script calling
+    wait() in a loop), so the queue stays at a steady amount of events. The
+    benchmark is run for several queue sizes. It also verifies that both
+    queues return the events in the same order.
+*/
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "../src/common/RTAVLTree.h"
+#include "../src/common/RTTimingWheel.h"
+
+#define FRAGMENTSIZE    256
+#define SAMPLERATE      44100
+#define MAX_DELAY       (2 * SAMPLERATE) // max. wait() time of the events
+#define FRAGMENTS       20000 // per run, that is about 2 minutes of audio
+
+typedef uint64_t sched_time_t;
+
+class Node : public RTAVLNode, public RTTimingWheelNode {
+public:
+    sched_time_t scheduleTime;
+
+    inline bool operator==(const Node& other) const {
+        return scheduleTime == other.scheduleTime;
+    }
+
+    inline bool operator<(const Node& other) const {
+        return scheduleTime < other.scheduleTime;
+    }
+};
+
+// pops the next event due before 'end' from the queue (NULL if none)
+static Node* popNext(RTAVLTree<Node>& queue, sched_time_t end) {
+    if (queue.isEmpty()) return NULL;
+    Node& node = queue.lowest();
+    if (node.scheduleTime >= end) return NULL;
+    queue.erase(node);
+    return &node;
+}
+
+static Node* popNext(RTTimingWheel<Node>& queue, sched_time_t end) {
+    return queue.popNext(end);
+}
+
+static int popped;
+
+/*
+ * Runs the scheduler simulation with all @a nodes on a new queue of type
+ * T_queue. If @a order is not NULL, the schedule times of all popped events
+ * are appended to it.
+ */
+template<class T_queue>
+static sched_time_t run(std::vector<Node>& nodes, int fragments, std::vector<sched_time_t>* order) {
+    T_queue queue;
+    srand(0);
+    popped = 0;
+    sched_time_t sum = 0; // prevent the compiler from optimizing everything away
+    sched_time_t now = 0;
+    for (int i = 0; i < nodes.size(); i++) {
+        nodes[i].scheduleTime = now + rand() % MAX_DELAY;
+        queue.insert(nodes[i]);
+    }
+    for (int f = 0; f < fragments; f++) {
+        const sched_time_t end = now + FRAGMENTSIZE;
+        while (Node* node = popNext(queue, end)) {
+            sum += node->scheduleTime;
+            popped++;
+            if (order) order->push_back(node->scheduleTime);
+            // resume the script, which calls wait() again
+            node->scheduleTime += 1 + rand() % MAX_DELAY;
+            queue.insert(*node);
+        }
+        now = end;
+    }
+    return sum;
+}
+
+int main() {
+    const int sizes[] = { 16, 256, 4096, 32768 };
+    for (int s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+        std::vector<Node> nodes(sizes[s]);
+
+        // first run: verify both queues return the events in the same order
+        std::vector<sched_time_t> orderTree, orderWheel;
+        run< RTAVLTree<Node> >(nodes, FRAGMENTS / 10, &orderTree);
+        run< RTTimingWheel<Node> >(nodes, FRAGMENTS / 10, &orderWheel);
+        if (orderTree != orderWheel) {
+            printf("ERROR: RTAVLTree and RTTimingWheel returned different order for %d events!\n", sizes[s]);
+            return -1;
+        }
+
+        clock_t start_time = clock();
+        sched_time_t sum = run< RTAVLTree<Node> >(nodes, FRAGMENTS, NULL);
+        clock_t stop_time = clock();
+        float elapsed_time = (stop_time - start_time) / (double(CLOCKS_PER_SEC) / 1000.0);
+        printf("RTAVLTree: %1.0f ms (%d events, %d resumed) [%llu]\n",
+               elapsed_time, sizes[s], popped, (unsigned long long) sum);
+
+        start_time = clock();
+        sum = run< RTTimingWheel<Node> >(nodes, FRAGMENTS, NULL);
+        stop_time = clock();
+        elapsed_time = (stop_time - start_time) / (double(CLOCKS_PER_SEC) / 1000.0);
+        printf("RTTimingWheel: %1.0f ms (%d events, %d resumed) [%llu]\n",
+               elapsed_time, sizes[s], popped, (unsigned long long) sum);
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+    Adaptive subfragment size benchmark
+
+    Benchmarks the control rate overhead of rendering a sustained,
+    unmodulated voice (i.e. a held note without LFOs) the way
+    AbstractVoice::Synthesize() does it: either with fixed subfragments of
+    CONFIG_DEFAULT_SUBFRAGMENT_SIZE sample points, recalculating all
+    synthesis parameters (volume, pan, filter coefficients) for each
+    subfragment, or adaptive, that is with one single control block for the
+    whole audio fragment, since none of the parameters changes. It uses
+    fake sample data and fake audio outputs, so we don't have to load a
+    .gig file or care about drivers.
+*/
+
+#include <math.h>
+#include <time.h>
+#include <stdio.h>
+#include <malloc.h>
+#include <string.h>
+
+#include <gig.h>
+
+#include "../src/engines/gig/SynthesisParam.h"
+#include "../src/engines/gig/Synthesizer.h"
+#include "../src/engines/gig/SmoothVolume.h"
+
+#define FRAGMENTSIZE    256
+#define SAMPLERATE      44100
+#define RUNS            100000
+
+using namespace LinuxSampler;
+using namespace LinuxSampler::gig;
+
+int16_t* pSampleInputBuf; // just a buffer with random data
+
+float* pOutputL;
+float* pOutputR;
+
+struct Voice {
+    SynthesisParam param;
+    SmoothVolume   VolumeSmoother;
+    SmoothVolume   PanLeftSmoother;
+    SmoothVolume   PanRightSmoother;
+    float          Level; // (flat) EG1 level
+};
+
+void printmode(int mode) {
+    printf("Synthesis Mode: %d ",mode);
+    printf("(%s,FILTER=%s,INTERPOLATE=%s)\n",
+           (SYNTHESIS_MODE_GET_CHANNELS(mode)) ? "STEREO" : "MONO",
+           (SYNTHESIS_MODE_GET_FILTER(mode)) ? "y" : "n",
+           (SYNTHESIS_MODE_GET_INTERPOLATE(mode)) ? "y" : "n"
+    );
+    fflush(stdout);
+}
+
+/// Renders one audio fragment with control blocks of @a BlockSize sample points.
+void render(Voice& voice, int mode, Loop* pLoop, uint BlockSize) {
+    SynthesisParam& p = voice.param;
+    p.dPos      = 0.0;
+    p.pOutLeft  = pOutputL;
+    p.pOutRight = pOutputR;
+    for (uint i = 0; i < FRAGMENTSIZE; ) {
+        const uint end = (i + BlockSize < FRAGMENTSIZE) ? i + BlockSize : FRAGMENTSIZE;
+        const uint n   = end - i;
+        // same calculations as done by AbstractVoice::Synthesize() for
+        // each subfragment
+        voice.PanLeftSmoother.update(0.7f);
+        voice.PanRightSmoother.update(0.7f);
+        const float fFinalVolume = voice.VolumeSmoother.render() * voice.Level;
+        if (SYNTHESIS_MODE_GET_FILTER(mode)) {
+            p.filterLeft.SetParameters(2000.0f, 0.5f, SAMPLERATE, n);
+            p.filterRight.SetParameters(2000.0f, 0.5f, SAMPLERATE, n);
+        }
+        p.uiToGo = n;
+        p.fFinalVolumeDeltaLeft  = (fFinalVolume * voice.PanLeftSmoother.render()  - p.fFinalVolumeLeft)  / n;
+        p.fFinalVolumeDeltaRight = (fFinalVolume * voice.PanRightSmoother.render() - p.fFinalVolumeRight) / n;
+        RunSynthesisFunction(mode, &p, pLoop);
+        i = end;
+    }
+}
+
+int main() {
+    pSampleInputBuf = new int16_t[FRAGMENTSIZE*4 + 100];
+    pOutputL = (float*) memalign(16,FRAGMENTSIZE*sizeof(float));
+    pOutputR = (float*) memalign(16,FRAGMENTSIZE*sizeof(float));
+
+    // prepare some input data for simulation
+    for (int i = 0; i < FRAGMENTSIZE*4; i++) {
+        pSampleInputBuf[i] = i;
+    }
+
+    Voice* pVoice = new Voice;
+    pVoice->param.filterLeft.SetType(Filter::vcf_type_2p_lowpass);
+    pVoice->param.filterRight.SetType(Filter::vcf_type_2p_lowpass);
+    pVoice->param.fFinalPitch = 1.5f;
+    pVoice->param.fFinalVolumeLeft = 0.0f;
+    pVoice->param.fFinalVolumeRight = 0.0f;
+    pVoice->param.pSrc = pSampleInputBuf;
+    pVoice->param.pRawLeft = NULL;
+    pVoice->param.pRawRight = NULL;
+    pVoice->VolumeSmoother.trigger(1.0f, float(SAMPLERATE) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+    pVoice->PanLeftSmoother.trigger(0.7f, float(SAMPLERATE) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+    pVoice->PanRightSmoother.trigger(0.7f, float(SAMPLERATE) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+    pVoice->Level = 0.8f;
+
+    Loop* pLoop = new Loop;
+    pLoop->uiStart = 4;
+    pLoop->uiEnd   = 20;
+    pLoop->uiSize  = 16;
+    pLoop->uiTotalCycles = 0; // infinity
+
+    // sustained voice: interpolation on, with and without filter, mono / stereo
+    const int modes[] = { 1, 3, 9, 11 };
+    for (int m = 0; m < 4; m++) {
+        const int mode = modes[m];
+        printf("Benchmarking ");
+        printmode(mode);
+        for (int adaptive = 0; adaptive < 2; adaptive++) {
+            const uint blockSize = (adaptive) ? FRAGMENTSIZE : CONFIG_DEFAULT_SUBFRAGMENT_SIZE;
+            pVoice->param.filterLeft.Reset();
+            pVoice->param.filterRight.Reset();
+
+            clock_t start_time = clock();
+            for (uint i = 0; i < RUNS; i++) {
+                memset(pOutputL,0,FRAGMENTSIZE*sizeof(float));
+                memset(pOutputR,0,FRAGMENTSIZE*sizeof(float));
+                render(*pVoice, mode, pLoop, blockSize);
+            }
+            clock_t stop_time = clock();
+            float elapsed_time = (stop_time - start_time) / (double(CLOCKS_PER_SEC) / 1000.0);
+            printf("\t%s (%d sample points per block): %1.0f ms\n",
+                   (adaptive) ? "adaptive" : "fixed   ", blockSize, elapsed_time);
+        }
+    }
+}
@@ -2,7 +2,10 @@
     Triangle wave generator benchmark
 
     This is a benchmark for comparison between a integer math, table lookup
-    and numeric sine wave harmonics solution.
+    and numeric sine wave harmonics solution. Unless SILENT is set, the
+    integer math and numeric harmonics solutions are also benchmarked when
+    rendered by the LFO bank (many voices at once), in that case
+    LFOBank.cpp has to be linked as well (see 'make triang').
 
     Copyright (C) 2005 Christian Schoenebeck <cuse@users.sf.net>
 */
@@ -14,6 +17,9 @@
 #include "../src/engines/common/LFOTriangleIntMath.h"
 #include "../src/engines/common/LFOTriangleIntAbsMath.h"
 #include "../src/engines/common/LFOTriangleDiHarmonic.h"
+#if ! SILENT
+# include "../src/engines/common/LFOBank.h"
+#endif
 
 // whether we should not show any messages on the console
 #ifndef SILENT
@@ -47,6 +53,16 @@
 # define MAX			1.0f
 #endif
 
+// amount of voices (LFOs) rendered together by the LFO bank
+#ifndef BANK_VOICES
+# define BANK_VOICES		256
+#endif
+
+// amount of LFO steps (subfragments) per audio fragment for the LFO bank
+#ifndef BANK_STEPS
+# define BANK_STEPS		8
+#endif
+
 // pro forma
 #ifndef SAMPLING_RATE
 # define SAMPLING_RATE		44100.0f
@@ -217,6 +233,56 @@ float numeric_di_harmonic_solution(sample_t* pDestinationBuffer, float* pAmp, co
     return elapsed_time;
 }
 
+#if ! SILENT
+// LFO bank, rendering BANK_VOICES LFOs at once, the same amount of LFO steps
+// in total as the other solutions
+float lfo_bank(sample_t* pDestinationBuffer, float* pAmp, const int steps, const float frequency, int algorithm) {
+    const range_type_t range = (SIGNED) ? range_signed : range_unsigned;
+    LFOBank::SetTriangleAlgorithm(range, algorithm);
+    LFOBank bank(BANK_VOICES, 1, BANK_STEPS);
+    LFOBank::LFO** pLFOs = new LFOBank::LFO*[BANK_VOICES];
+    for (int v = 0; v < BANK_VOICES; ++v) {
+        pLFOs[v] = new LFOBank::LFO(range, MAX);
+        pLFOs[v]->Bind(&bank, bank.Lane(v, 0));
+        // pro forma
+        pLFOs[v]->trigger(frequency, start_level_max, 1200 /* max. internal depth */, 0, false, (unsigned int) SAMPLING_RATE);
+        pLFOs[v]->update(127);
+    }
+    const int fragments = steps / BANK_STEPS;
+    const int runs = RUNS / BANK_VOICES + 1;
+
+    clock_t stop_time;
+    clock_t start_time = clock();
+
+    for (int run = 0; run < runs; run++) {
+        for (int f = 0; f < fragments; ++f) {
+            bank.Render(BANK_STEPS);
+            for (int v = 0; v < BANK_VOICES; ++v) {
+                sample_t* pOut = &pDestinationBuffer[f * BANK_STEPS];
+                float* pA = &pAmp[f * BANK_STEPS];
+                LFOBank::LFO* pLFO = pLFOs[v];
+                for (int i = 0; i < BANK_STEPS; ++i)
+                    pOut[i] = pLFO->render() * pA[i]; // * pAmp[i] just to simulate some memory load
+                pLFO->enlist();
+            }
+        }
+    }
+
+    stop_time = clock();
+    // normalize to the amount of LFO steps of the other solutions
+    float elapsed_time = (stop_time - start_time) / (double(CLOCKS_PER_SEC) / 1000.0) *
+                         double(RUNS) / double(runs * BANK_VOICES);
+    printf("LFO bank (%s, %d voices) elapsed time: %1.0f ms\n",
+           (algorithm == DI_HARMONIC_SOLUTION) ? "numeric harmonics" : "int math",
+           BANK_VOICES, elapsed_time);
+
+    for (int v = 0; v < BANK_VOICES; ++v) delete pLFOs[v];
+    delete[] pLFOs;
+
+    return elapsed_time;
+}
+#endif
+
 // output calculated values as RAW audio format (32 bit floating point, mono) file
 void output_as_raw_file(const char* filename, sample_t* pOutputBuffer, int steps) {
     FILE* file = fopen(filename, "w");
@@ -291,6 +357,12 @@ int main() {
     //table_lookup_result        += table_lookup(pOutputBuffer, pAmplitude, steps, sinusoidFrequency);
     numeric_di_harmonic_result += numeric_di_harmonic_solution(pOutputBuffer, pAmplitude, steps, sinusoidFrequency);
 
+    #if ! SILENT
+    printf("\n");
+    lfo_bank(pOutputBuffer, pAmplitude, steps, sinusoidFrequency, INT_MATH_SOLUTION);
+    lfo_bank(pOutputBuffer, pAmplitude, steps, sinusoidFrequency, DI_HARMONIC_SOLUTION);
+    #endif
+
     if (pAmplitude)    delete[] pAmplitude;
     if (pOutputBuffer) delete[] pOutputBuffer;
 
@@ -360,6 +360,17 @@ void Condition::Set(bool bCondition) {
     dmsg(7,("Condition::Set() -> LOCK()\n"));
     LockGuard lock(*this);
     dmsg(7,("Condition::Set() -> LOCK() passed\n"));
+    Broadcast(bCondition);
+}
+
+bool Condition::TrySet(bool bCondition) {
+    if (!Trylock()) return false;
+    Broadcast(bCondition);
+    Unlock();
+    return true;
+}
+
+void Condition::Broadcast(bool bCondition) {
     if (this->bCondition != bCondition) {
         this->bCondition = bCondition;
         if (bCondition) {
@@ -106,6 +106,16 @@ class Condition : public Mutex {
          */
         void Set(bool bCondition);
 
+        /**
+         * Same as Set(), except that this method never blocks the calling
+         * thread. If the Condition object is currently locked by another
+         * thread, the condition is left unchanged and @c false is returned.
+         *
+         * @param bCondition - new condition
+         * @returns @c true if the condition was set, @c false otherwise
+         */
+        bool TrySet(bool bCondition);
+
         /**
          * Returns the current boolean state of this condition object. This
          * method never blocks, it returns immediately and doesn't use any
@@ -127,6 +137,8 @@ class Condition : public Mutex {
 #endif
 
     protected:
+        void Broadcast(bool bCondition); ///< Must only be called while this object is locked.
+
     #if defined(WIN32)
         friend class ConditionInternal;
         struct win32thread_cond_t {
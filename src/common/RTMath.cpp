@@ -27,6 +27,12 @@ static float CentsToFreqTable[CONFIG_MAX_PITCH * 1200 * 2 + 1]; // +-1200 cents
 
 float* RTMathBase::pCentsToFreqTable(InitCentsToFreqTable());
 
+#if defined(WIN32)
+#include <windows.h>
+#elif !defined(__APPLE__)
+#include <time.h>
+#endif
+
 #if defined(__APPLE__)
 #include <mach/mach_time.h>
 typedef uint64_t time_stamp_t;
@@ -77,6 +83,24 @@ RTMathBase::time_stamp_t RTMathBase::CreateTimeStamp() {
     #endif
 }
 
+uint64_t RTMathBase::MicroSecondsNow() {
+    #if defined(WIN32)
+    static LARGE_INTEGER freq = { 0 };
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return uint64_t(t.QuadPart) * 1000000 / uint64_t(freq.QuadPart);
+    #elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase = { 0, 0 };
+    if (!timebase.denom) mach_timebase_info(&timebase);
+    return mach_absolute_time() * timebase.numer / timebase.denom / 1000;
+    #else
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return uint64_t(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+    #endif
+}
+
 /**
  * Will automatically be called once to initialize the 'Cents to frequency
  * ratio' table.
@@ -56,6 +56,14 @@ class RTMathBase {
          */
         static time_stamp_t CreateTimeStamp();
 
+        /**
+         * Returns the current time of a monotonic clock in microseconds,
+         * with an arbitrary origin. So unlike CreateTimeStamp() the result
+         * has a fixed time entity, but again it only makes sense to
+         * calculate with differences of these values. Real-time safe.
+         */
+        static uint64_t MicroSecondsNow();
+
         /**
          * Calculates the frequency ratio for a pitch value given in cents
          * (assuming equal tempered scale of course, divided into 12
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2026 agent
+ *
+ * http://www.linuxsampler.org
+ *
+ * This file is part of LinuxSampler and released under the same terms.
+ * See README file for details.
+ */
+
+#ifndef RTTIMINGWHEEL_H
+#define RTTIMINGWHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Base class of RTTimingWheel elements.
+ *
+ * For being able to manage elements with an RTTimingWheel, this class must be
+ * derived. The deriving node class must provide a public member variable
+ * @c scheduleTime of type @c uint64_t, which is the time (i.e. in sample
+ * points) the element is due and which must not be changed while the element
+ * is a member of a timing wheel.
+ */
+class RTTimingWheelNode {
+protected:
+    RTTimingWheelNode* prev;
+    RTTimingWheelNode* next;
+    uint8_t level; ///< Wheel level the element is currently stored on.
+    uint8_t slot;  ///< Slot on that level the element is currently stored in.
+    template<class T_node> friend class RTTimingWheel;
+};
+
+/**
+ * @brief Real-time safe hierarchical timing wheel.
+ *
+ * Sorted container for elements which are due at a certain time, intended as
+ * scheduler queue. In contrast to a sorted tree like RTAVLTree, inserting
+ * and removing elements takes constant time, regardless of the amount of
+ * elements being scheduled. Elements are always returned in exact order of
+ * their @c scheduleTime though, elements with equal time in the order they
+ * were inserted.
+ *
+ * The wheel consists of 4 levels with 256 slots each. Level 0 has the
+ * resolution of one time unit (i.e. one sample point) and covers the next
+ * 256 time units, each higher level has a 256 times coarser resolution and
+ * covers a 256 times longer time span. Elements stored on a higher level are
+ * moved down ("cascaded") to the lower levels as time advances. Elements due
+ * more than 2^32 time units in future are kept on an unsorted overflow list.
+ * Occupied slots are tracked by bitmaps, so empty time spans are skipped
+ * without iterating over them.
+ *
+ * The wheel's current time only advances by calling popNext(). Elements
+ * inserted with a time earlier than the wheel's current time are due
+ * immediately.
+ *
+ * This implementation does not allocate or deallocate any memory.
+ */
+template<class T_node>
+class RTTimingWheel {
+public:
+    enum {
+        LEVELS = 4,
+        SLOT_BITS = 8,
+        SLOTS = 1 << SLOT_BITS,
+        OVERFLOW_LEVEL = LEVELS
+    };
+
+    /**
+     * Constructs an empty RTTimingWheel object with current time @c 0.
+     */
+    RTTimingWheel() : now(0), nodesCount(0), overflow(NULL) {
+        memset(slots, 0, sizeof(slots));
+        memset(occupied, 0, sizeof(occupied));
+    }
+
+    /**
+     * Returns true if there are no elements in this wheel.
+     *
+     * Complexity: Theta(1).
+     */
+    inline bool isEmpty() const {
+        return !nodesCount;
+    }
+
+    /**
+     * Returns the amount of elements in this wheel.
+     *
+     * Complexity: Theta(1).
+     */
+    inline int size() const {
+        return nodesCount;
+    }
+
+    /**
+     * Inserts the new element @a item, which must not be a member of this or
+     * another wheel already. Elements with equal time are returned in the
+     * order they were inserted.
+     *
+     * Complexity: Theta(1).
+     */
+    void insert(T_node& item) {
+        link(item);
+        ++nodesCount;
+    }
+
+    /**
+     * Removes the element @a item, which must be a member of this wheel.
+     *
+     * Complexity: Theta(1).
+     */
+    void erase(T_node& item) {
+        unlink(item);
+        --nodesCount;
+    }
+
+    /**
+     * Removes the element with the lowest time from this wheel and returns
+     * it, if its time is lower than @a end. Otherwise NULL is returned and
+     * the wheel is left unchanged. The wheel's current time is advanced up
+     * to the time of the returned element.
+     *
+     * Complexity: amortized Theta(1) for each returned element, plus at most
+     * a few bitmap scans per call.
+     */
+    T_node* popNext(uint64_t end) {
+        while (nodesCount) {
+            int i = findSlot(0, digit(now, 0));
+            if (i >= 0) {
+                const uint64_t t = (now & ~uint64_t(SLOTS - 1)) | uint64_t(i);
+                if (t >= end) return NULL;
+                now = t;
+                RTTimingWheelNode* node = slots[0][i];
+                unlink(*node);
+                --nodesCount;
+                return static_cast<T_node*>(node);
+            }
+            // nothing left in the current time span of level 0, so skip
+            // to the next occupied slot of a higher level
+            if (!advance(end)) return NULL;
+        }
+        if (end > now) now = end - 1; // no need to cascade an empty wheel later
+        return NULL;
+    }
+
+    /**
+     * Removes all elements from this wheel and sets the wheel's current time
+     * back to @c 0, like it was after construction. So the wheel may be used
+     * with another time source afterwards, i.e. one that started counting
+     * from the beginning again. The elements themselves are not modified,
+     * so they may be inserted to this or another wheel again afterwards.
+     *
+     * Complexity: O(occupied slots).
+     */
+    void clear() {
+        for (int l = 0; l < LEVELS; ++l)
+            for (int w = 0; w < SLOTS / 64; ++w)
+                for (uint64_t bits = occupied[l][w]; bits; bits &= bits - 1)
+                    slots[l][w * 64 + lowestBit(bits)] = NULL;
+        memset(occupied, 0, sizeof(occupied));
+        overflow = NULL;
+        nodesCount = 0;
+        now = 0;
+    }
+
+protected:
+    static inline int digit(uint64_t t, int level) {
+        return int(t >> (level * SLOT_BITS)) & (SLOTS - 1);
+    }
+
+    static inline int lowestBit(uint64_t bits) {
+        #if defined(__GNUC__)
+        return __builtin_ctzll(bits);
+        #else
+        int i = 0;
+        for (; !(bits & 1); bits >>= 1) ++i;
+        return i;
+        #endif
+    }
+
+    /// Returns the first occupied slot >= @a from on @a level, -1 if none.
+    inline int findSlot(int level, int from) const {
+        int w = from >> 6;
+        uint64_t bits = occupied[level][w] & (~uint64_t(0) << (from & 63));
+        while (true) {
+            if (bits) return w * 64 + lowestBit(bits);
+            if (++w >= SLOTS / 64) return -1;
+            bits = occupied[level][w];
+        }
+    }
+
+    /// Appends @a node to the (circular) list starting with @a head.
+    static inline void pushBack(RTTimingWheelNode*& head, RTTimingWheelNode* node) {
+        if (head) {
+            node->prev = head->prev;
+            node->next = head;
+            head->prev->next = node;
+            head->prev = node;
+        } else {
+            node->prev = node->next = node;
+            head = node;
+        }
+    }
+
+    /// Removes @a node from the (circular) list starting with @a head.
+    static inline void remove(RTTimingWheelNode*& head, RTTimingWheelNode* node) {
+        if (node->next == node) {
+            head = NULL;
+        } else {
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            if (head == node) head = node->next;
+        }
+    }
+
+    void link(RTTimingWheelNode& node) {
+        uint64_t t = static_cast<T_node&>(node).scheduleTime;
+        if (t < now) t = now; // already due
+        // the level is the most significant digit t differs from now
+        const uint64_t diff = t ^ now;
+        int level = 0;
+        while (level < LEVELS && (diff >> ((level + 1) * SLOT_BITS)))
+            ++level;
+        if (level >= LEVELS) {
+            node.level = OVERFLOW_LEVEL;
+            pushBack(overflow, &node);
+            return;
+        }
+        const int i = digit(t, level);
+        node.level = level;
+        node.slot = i;
+        pushBack(slots[level][i], &node);
+        occupied[level][i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    void unlink(RTTimingWheelNode& node) {
+        if (node.level == OVERFLOW_LEVEL) {
+            remove(overflow, &node);
+            return;
+        }
+        RTTimingWheelNode*& head = slots[node.level][node.slot];
+        remove(head, &node);
+        if (!head)
+            occupied[node.level][node.slot >> 6] &= ~(uint64_t(1) << (node.slot & 63));
+    }
+
+    /**
+     * Advances the current time to the start of the next occupied slot of
+     * the lowest level above 0 and moves the elements of that slot down to
+     * the lower levels. Returns false if that time is not lower than @a end,
+     * in which case nothing is changed.
+     */
+    bool advance(uint64_t end) {
+        for (int l = 1; l < LEVELS; ++l) {
+            // slot digit(now, l) is always empty on levels above 0
+            const int from = digit(now, l) + 1;
+            const int i = (from < SLOTS) ? findSlot(l, from) : -1;
+            if (i < 0) continue;
+            const int shift = l * SLOT_BITS;
+            const uint64_t t =
+                (now & ~((uint64_t(1) << (shift + SLOT_BITS)) - 1)) |
+                (uint64_t(i) << shift);
+            if (t >= end) return false;
+            now = t;
+            cascade(slots[l][i]);
+            occupied[l][i >> 6] &= ~(uint64_t(1) << (i & 63));
+            return true;
+        }
+        if (!overflow) return false;
+        // rare: the next element is more than 2^32 time units ahead
+        uint64_t t = static_cast<T_node*>(overflow)->scheduleTime;
+        for (RTTimingWheelNode* node = overflow->next; node != overflow; node = node->next)
+            if (static_cast<T_node*>(node)->scheduleTime < t)
+                t = static_cast<T_node*>(node)->scheduleTime;
+        t &= ~((uint64_t(1) << (LEVELS * SLOT_BITS)) - 1);
+        if (t >= end) return false;
+        now = t;
+        cascade(overflow);
+        return true;
+    }
+
+    /// Re-inserts all elements of the ring @a head relative to the current time.
+    void cascade(RTTimingWheelNode*& head) {
+        RTTimingWheelNode* node = head;
+        head = NULL;
+        if (!node) return;
+        node->prev->next = NULL; // break the ring
+        while (node) {
+            RTTimingWheelNode* next = node->next;
+            link(*node);
+            node = next;
+        }
+    }
+
+private:
+    uint64_t now; ///< Current time of the wheel, no element is due earlier.
+    int nodesCount;
+    RTTimingWheelNode* slots[LEVELS][SLOTS]; ///< First element of each slot's (circular) list.
+    uint64_t occupied[LEVELS][SLOTS / 64]; ///< Bitmap of non-empty slots for each level.
+    RTTimingWheelNode* overflow; ///< Elements due too far ahead for the wheel.
+};
+
+#endif // RTTIMINGWHEEL_H
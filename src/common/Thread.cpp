@@ -186,7 +186,7 @@ int Thread::SignalStartThread() {
  */
 int Thread::StopThread() {
 #if defined(WIN32_SIGNALSTARTTHREAD_WORKAROUND)
-    SignalStopThread();
+    if (win32isRunning) SignalStopThread();
     win32isRunning = false;
     return 0;
 #endif
@@ -229,6 +229,29 @@ int Thread::SignalStopThread() {
     return 0;
 }
 
+/**
+ *  Waits until the thread finished its execution by returning from Main()
+ *  by itself. Unlike StopThread() this method does not cancel the thread,
+ *  so the caller has to make sure that Main() is going to return. Must be
+ *  called at most once for each StartThread() call.
+ */
+int Thread::JoinThread() {
+#if defined(WIN32)
+    WaitForSingleObject(hThread, INFINITE);
+    CloseHandle(hThread);
+    #if defined(WIN32_SIGNALSTARTTHREAD_WORKAROUND)
+    win32isRunning = false;
+    #else
+    RunningCondition.Set(false);
+    #endif
+    return 0;
+#else
+    // the thread destructor callback already reset the 'Running' flag
+    // when pthread_join() returns, so StopThread() won't cancel it later
+    return pthread_join(__thread_id, NULL);
+#endif
+}
+
 /**
  * Returns @c true in case the thread is currently running.
  */
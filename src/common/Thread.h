@@ -56,6 +56,7 @@ class Thread {
         virtual int  StopThread();
         virtual int  SignalStartThread();
         virtual int  SignalStopThread();
+        virtual int  JoinThread();
 
         void TestCancel();
 
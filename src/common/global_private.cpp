@@ -57,6 +57,9 @@
 #ifndef CONFIG_STREAM_BUFFER_SIZE
 # error "Configuration macro CONFIG_STREAM_BUFFER_SIZE not defined!"
 #endif // CONFIG_STREAM_BUFFER_SIZE
+#ifndef CONFIG_MAX_PRELAUNCH_STREAMS
+# error "Configuration macro CONFIG_MAX_PRELAUNCH_STREAMS not defined!"
+#endif // CONFIG_MAX_PRELAUNCH_STREAMS
 #ifndef CONFIG_DEFAULT_MAX_STREAMS
 # error "Configuration macro CONFIG_DEFAULT_MAX_STREAMS not defined!"
 #endif // CONFIG_DEFAULT_MAX_STREAMS
@@ -57,6 +57,8 @@ typedef int16_t sample_t;
 #if HAVE_GCC_VECTOR_EXTENSIONS
 // v4sf is used by some routines that make use of GCC vector extensions (ie AudioChannel.cpp)
 typedef float v4sf __attribute__ ((vector_size(16)));
+// v8sf is mapped to AVX registers if available, to two SSE registers otherwise
+typedef float v8sf __attribute__ ((vector_size(32)));
 #endif
 
 // circumvents a bug in GCC 4.x which causes a sizeof() expression applied
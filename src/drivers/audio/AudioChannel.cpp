@@ -23,6 +23,8 @@
 
 #include "AudioChannel.h"
 
+#include <algorithm>
+
 #include "../../common/global_private.h"
 #include "../../common/Thread.h" // needed for allocAlignedMem() and freeAlignedMem()
 
@@ -32,9 +34,100 @@
 # include <malloc.h>
 #endif
 
+/// Alignment (in bytes) of the buffers allocated by AudioChannel (suitable for AVX).
+#define AUDIO_CHANNEL_BUFFER_ALIGNMENT 32
+
 
 namespace LinuxSampler {
 
+    #if HAVE_GCC_VECTOR_EXTENSIONS
+    template<typename T_vec>
+    static inline bool _isAligned(const float* p) {
+        return (size_t)p % sizeof(T_vec) == 0;
+    }
+
+    template<typename T_vec>
+    static inline void _splat(T_vec& v, const float f) {
+        union { T_vec v; float a[sizeof(T_vec) / sizeof(float)]; } u;
+        for (uint i = 0; i < sizeof(T_vec) / sizeof(float); ++i) u.a[i] = f;
+        v = u.v;
+    }
+
+    /**
+     * Vector part of CopyTo(): dst = src * level. Returns the amount of
+     * sample points processed, the remaining ones (less than one vector)
+     * have to be processed by the caller.
+     */
+    template<typename T_vec>
+    static uint _copyScaled(const float* __restrict pSrc, float* __restrict pDst, const float fLevel, const uint Samples) {
+        const uint lanes = sizeof(T_vec) / sizeof(float);
+        T_vec vlevel;
+        _splat(vlevel, fLevel);
+        const T_vec* __restrict src = (const T_vec* __restrict) pSrc;
+        T_vec* __restrict dst = (T_vec* __restrict) pDst;
+        const uint cells = Samples / lanes;
+        for (uint i = 0; i < cells; ++i)
+            dst[i] = src[i] * vlevel;
+        return cells * lanes;
+    }
+
+    /**
+     * Vector part of _mixToMany() for exactly @a N destinations. The
+     * destinations may alias each other, thus no __restrict here.
+     */
+    template<typename T_vec, int N>
+    static uint _mixToManyFixed(const float* pSrc, float* const* ppDst, const float* pLevels, const uint Samples) {
+        const uint lanes = sizeof(T_vec) / sizeof(float);
+        const T_vec* src = (const T_vec*) pSrc;
+        T_vec* dst[N];
+        T_vec vlevel[N];
+        for (int d = 0; d < N; ++d) {
+            dst[d]    = (T_vec*) ppDst[d];
+            _splat(vlevel[d], pLevels[d]);
+        }
+        const uint cells = Samples / lanes;
+        for (uint i = 0; i < cells; ++i) {
+            const T_vec s = src[i];
+            for (int d = 0; d < N; ++d)
+                dst[d][i] += s * vlevel[d];
+        }
+        return cells * lanes;
+    }
+
+    template<typename T_vec>
+    static uint _mixToManyVec(const float* pSrc, float* const* ppDst, const float* pLevels, const uint Destinations, const uint Samples) {
+        switch (Destinations) {
+            case 1: return _mixToManyFixed<T_vec,1>(pSrc, ppDst, pLevels, Samples);
+            case 2: return _mixToManyFixed<T_vec,2>(pSrc, ppDst, pLevels, Samples);
+            case 3: return _mixToManyFixed<T_vec,3>(pSrc, ppDst, pLevels, Samples);
+            default: return _mixToManyFixed<T_vec,4>(pSrc, ppDst, pLevels, Samples);
+        }
+    }
+    #endif // HAVE_GCC_VECTOR_EXTENSIONS
+
+    /**
+     * Mixes the given source buffer to (up to 4) destination buffers with
+     * their individual volume coefficients in one pass.
+     */
+    static void _mixToMany(const float* pSrc, float* const* ppDst, const float* pLevels, const uint Destinations, const uint Samples) {
+        uint i = 0;
+        #if HAVE_GCC_VECTOR_EXTENSIONS
+        bool bAligned8 = _isAligned<v8sf>(pSrc);
+        bool bAligned4 = _isAligned<v4sf>(pSrc);
+        for (uint d = 0; d < Destinations; ++d) {
+            bAligned8 = bAligned8 && _isAligned<v8sf>(ppDst[d]);
+            bAligned4 = bAligned4 && _isAligned<v4sf>(ppDst[d]);
+        }
+        if (bAligned8)
+            i = _mixToManyVec<v8sf>(pSrc, ppDst, pLevels, Destinations, Samples);
+        else if (bAligned4)
+            i = _mixToManyVec<v4sf>(pSrc, ppDst, pLevels, Destinations, Samples);
+        #endif
+        for (; i < Samples; ++i)
+            for (uint d = 0; d < Destinations; ++d)
+                ppDst[d][i] += pSrc[i] * pLevels[d];
+    }
+
     /**
      * Create real channel.
      *
@@ -43,10 +136,12 @@ namespace LinuxSampler {
      */
     AudioChannel::AudioChannel(uint ChannelNr, uint BufferSize) {
         this->ChannelNr          = ChannelNr;
-        this->pBuffer            = (float *) Thread::allocAlignedMem(16,BufferSize*sizeof(float));
+        this->pBuffer            = (float *) Thread::allocAlignedMem(AUDIO_CHANNEL_BUFFER_ALIGNMENT, BufferSize*sizeof(float));
         this->uiBufferSize       = BufferSize;
         this->pMixChannel        = NULL;
         this->UsesExternalBuffer = false;
+        this->uiSilentFrom       = BufferSize;
+        this->pSilentFrom        = &uiSilentFrom;
 
         Parameters["NAME"]           = new ParameterName("Channel " + ToString(ChannelNr));
         Parameters["IS_MIX_CHANNEL"] = new ParameterIsMixChannel(false);
@@ -67,6 +162,8 @@ namespace LinuxSampler {
         this->uiBufferSize       = BufferSize;
         this->pMixChannel        = NULL;
         this->UsesExternalBuffer = true;
+        this->uiSilentFrom       = BufferSize;
+        this->pSilentFrom        = &uiSilentFrom;
 
         Parameters["NAME"]           = new ParameterName("Channel " + ToString(ChannelNr));
         Parameters["IS_MIX_CHANNEL"] = new ParameterIsMixChannel(false);
@@ -83,10 +180,12 @@ namespace LinuxSampler {
      */
     AudioChannel::AudioChannel(uint ChannelNr, AudioChannel* pMixChannelDestination) {
         this->ChannelNr          = ChannelNr;
-        this->pBuffer            = pMixChannelDestination->Buffer();
+        this->pBuffer            = pMixChannelDestination->pBuffer;
         this->uiBufferSize       = pMixChannelDestination->uiBufferSize;
         this->pMixChannel        = pMixChannelDestination;
         this->UsesExternalBuffer = true;
+        this->uiSilentFrom       = 0; // unused
+        this->pSilentFrom        = pMixChannelDestination->pSilentFrom;
 
         Parameters["NAME"]           = new ParameterName("Channel " + ToString(ChannelNr));
         Parameters["IS_MIX_CHANNEL"] = new ParameterIsMixChannel(true);
@@ -115,7 +214,10 @@ namespace LinuxSampler {
      * @param Samples - amount of sample points to be copied
      */
     void AudioChannel::CopyTo(AudioChannel* pDst, const uint Samples) {
-        memcpy((float* __restrict)pDst->Buffer(), (const float* __restrict)Buffer(), Samples * sizeof(float));
+        const uint uiAudible = std::min(Samples, SilentFrom());
+        if (uiAudible)
+            memcpy((float* __restrict)pDst->pBuffer, (const float* __restrict)pBuffer, uiAudible * sizeof(float));
+        pDst->Overwritten(uiAudible, Samples);
     }
 
     /**
@@ -133,29 +235,19 @@ namespace LinuxSampler {
     void AudioChannel::CopyTo(AudioChannel* pDst, const uint Samples, const float fLevel) {
         if (fLevel == 1.0f) CopyTo(pDst, Samples);
         else {
-            const float* __restrict pSrcBuf = Buffer();
-            float* __restrict pDstBuf = pDst->Buffer();
+            const uint uiAudible = (fLevel == 0.0f) ? 0 : std::min(Samples, SilentFrom());
+            const float* __restrict pSrcBuf = pBuffer;
+            float* __restrict pDstBuf = pDst->pBuffer;
+            uint i = 0;
             #if HAVE_GCC_VECTOR_EXTENSIONS
-            if ((size_t)pSrcBuf % 16 == 0 && (size_t)pDstBuf % 16 == 0) {
-                const v4sf vcoeff = { fLevel, fLevel, fLevel, fLevel };
-                const v4sf* __restrict src =
-                    static_cast<const v4sf* __restrict>(
-                        (const void* __restrict)pSrcBuf
-                    );
-                v4sf* __restrict dst =
-                     static_cast<v4sf* __restrict>(
-                         (void* __restrict)pDstBuf
-                     );
-                const int cells = Samples / 4;
-                for (int i = 0; i < cells; ++i)
-                    dst[i] = src[i] * vcoeff;
-            } else {
-            #endif
-                for (int i = 0; i < Samples; i++)
-                    pDstBuf[i] = pSrcBuf[i] * fLevel;
-            #if HAVE_GCC_VECTOR_EXTENSIONS
-            }
+            if (_isAligned<v8sf>(pSrcBuf) && _isAligned<v8sf>(pDstBuf))
+                i = _copyScaled<v8sf>(pSrcBuf, pDstBuf, fLevel, uiAudible);
+            else if (_isAligned<v4sf>(pSrcBuf) && _isAligned<v4sf>(pDstBuf))
+                i = _copyScaled<v4sf>(pSrcBuf, pDstBuf, fLevel, uiAudible);
             #endif
+            for (; i < uiAudible; i++)
+                pDstBuf[i] = pSrcBuf[i] * fLevel;
+            pDst->Overwritten(uiAudible, Samples);
         }
     }
 
@@ -167,28 +259,7 @@ namespace LinuxSampler {
      * @param Samples - amount of sample points to be mixed over
      */
     void AudioChannel::MixTo(AudioChannel* pDst, const uint Samples) {
-        const float* __restrict pSrcBuf = Buffer();
-        float* __restrict pDstBuf = pDst->Buffer();
-        #if HAVE_GCC_VECTOR_EXTENSIONS
-        if ((size_t)pSrcBuf % 16 == 0 && (size_t)pDstBuf % 16 == 0) {
-            const v4sf* __restrict src =
-                static_cast<const v4sf* __restrict>(
-                    (const void* __restrict)pSrcBuf
-                );
-            v4sf* __restrict dst =
-                static_cast<v4sf* __restrict>(
-                    (void* __restrict)pDstBuf
-                );
-            const int cells = Samples / 4;
-            for (int i = 0; i < cells; ++i)
-                dst[i] += src[i];
-        } else {
-        #endif
-            for (int i = 0; i < Samples; i++)
-                pDstBuf[i] += pSrcBuf[i];
-        #if HAVE_GCC_VECTOR_EXTENSIONS
-        }
-        #endif
+        MixTo(pDst, Samples, 1.0f);
     }
 
     /**
@@ -201,32 +272,60 @@ namespace LinuxSampler {
      * @param fLevel  - volume coefficient to be applied
      */
     void AudioChannel::MixTo(AudioChannel* pDst, const uint Samples, const float fLevel) {
-        if (fLevel == 1.0f) MixTo(pDst, Samples);
-        else {
-            const float* __restrict pSrcBuf = Buffer();
-            float* __restrict pDstBuf = pDst->Buffer();
-            #if HAVE_GCC_VECTOR_EXTENSIONS
-            if ((size_t)pSrcBuf % 16 == 0 && (size_t)pDstBuf % 16 == 0) {
-                const v4sf vcoeff = { fLevel, fLevel, fLevel, fLevel };
-                const v4sf* __restrict src =
-                    static_cast<const v4sf* __restrict>(
-                        (const void* __restrict)pSrcBuf
-                    );
-                v4sf* __restrict dst =
-                    static_cast<v4sf* __restrict>(
-                        (void* __restrict)pDstBuf
-                    );
-                const int cells = Samples / 4;
-                for (int i = 0; i < cells; ++i)
-                    dst[i] += src[i] * vcoeff;
-            } else {
-            #endif
-                for (int i = 0; i < Samples; i++)
-                    pDstBuf[i] += pSrcBuf[i] * fLevel;
-            #if HAVE_GCC_VECTOR_EXTENSIONS
+        MixTo(&pDst, &fLevel, 1, Samples);
+    }
+
+    /**
+     * Mixes the audio data of this AudioChannel to several destination
+     * channels at once, each one with its own volume coefficient. The
+     * source signal is only read once for (up to) 4 destinations, so this
+     * is cheaper than calling MixTo() for each destination, i.e. when
+     * routing a signal to its dry destination and to its FX sends.
+     *
+     * The same destination channel may be given several times.
+     *
+     * @param ppDst        - destination channels
+     * @param pLevels      - volume coefficient to be applied for each
+     *                       destination channel
+     * @param Destinations - amount of destination channels
+     * @param Samples      - amount of sample points to be mixed over
+     */
+    void AudioChannel::MixTo(AudioChannel* const* ppDst, const float* pLevels, const uint Destinations, const uint Samples) {
+        const uint uiAudible = std::min(Samples, SilentFrom());
+        if (!uiAudible) return; // nothing to mix
+
+        float* ppDstBuf[4];
+        float  pDstLevels[4];
+        uint   n = 0;
+        for (uint d = 0; d < Destinations; ++d) {
+            AudioChannel* pDst = ppDst[d];
+            if (pLevels[d] == 0.0f) continue;
+            if (pDst->IsSilent()) { // nothing to mix with
+                CopyTo(pDst, Samples, pLevels[d]);
+                continue;
+            }
+            if (*pDst->pSilentFrom < uiAudible) *pDst->pSilentFrom = uiAudible;
+            ppDstBuf[n]   = pDst->pBuffer;
+            pDstLevels[n] = pLevels[d];
+            if (++n == 4) {
+                _mixToMany(pBuffer, ppDstBuf, pDstLevels, n, uiAudible);
+                n = 0;
             }
-            #endif
         }
+        if (n) _mixToMany(pBuffer, ppDstBuf, pDstLevels, n, uiAudible);
+    }
+
+    /**
+     * Called on the destination channel after the first @a Audible sample
+     * points of its buffer were overwritten. Zeroes the following sample
+     * points up to @a Samples (as far as they are not silent already) and
+     * updates the silence position accordingly.
+     */
+    void AudioChannel::Overwritten(uint Audible, uint Samples) {
+        uint& uiSilent = *pSilentFrom;
+        if (Audible < Samples && Audible < uiSilent)
+            memset(pBuffer + Audible, 0, (std::min(Samples, uiSilent) - Audible) * sizeof(float));
+        if (Samples >= uiSilent) uiSilent = Audible;
     }
 
     std::map<String,DeviceRuntimeParameter*> AudioChannel::ChannelParameters() {
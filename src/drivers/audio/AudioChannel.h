@@ -52,6 +52,18 @@ namespace LinuxSampler {
      * actually be mixed to the 'mono_chan' channel, so this is an easy way
      * to downmix a signal source which has more audio channels than the
      * signal destination can offer.
+     *
+     * Each channel keeps track of the position from which on its buffer is
+     * known to contain silence only (see SilentFrom()), so clearing, copying
+     * and mixing a channel nothing was written to costs next to nothing.
+     * Therefore code which writes to the buffer directly has to retrieve it
+     * with Buffer(), which regards the whole buffer as non silent until the
+     * next Clear() call, whereas code which only reads the buffer should use
+     * ConstBuffer() instead. A mix channel shares this state with the real
+     * channel it refers to.
+     *
+     * Buffers allocated by the channel itself are aligned to 32 bytes, so
+     * the copy and mix routines can use SSE / AVX instructions on them.
      */
     class AudioChannel {
         public:
@@ -87,15 +99,19 @@ namespace LinuxSampler {
             //String Name;  ///< Arbitrary name of this audio channel
 
             // methods
-            inline float*        Buffer()     { return pBuffer;      } ///< Audio signal buffer
-            void SetBuffer(float* pBuffer)    { this->pBuffer = pBuffer; }
+            inline float*        Buffer()     { *pSilentFrom = uiBufferSize; return pBuffer; } ///< Audio signal buffer for writing (regards the whole buffer as non silent).
+            inline const float*  ConstBuffer() const { return pBuffer; } ///< Audio signal buffer for reading only.
+            void SetBuffer(float* pBuffer)    { this->pBuffer = pBuffer; *pSilentFrom = uiBufferSize; }
             inline AudioChannel* MixChannel() { return pMixChannel;  } ///< In case this channel is a mix channel, then it will return a pointer to the real channel this channel refers to, NULL otherwise.
-            inline void          Clear()      { memset(pBuffer, 0, uiBufferSize * sizeof(float)); } ///< Reset audio buffer with silence
-            inline void          Clear(uint Samples) { memset(pBuffer, 0, Samples * sizeof(float)); } ///< Reset audio buffer with silence
+            inline uint          SilentFrom() const { return *pSilentFrom; } ///< All sample points from this position on are known to be zero.
+            inline bool          IsSilent() const { return !*pSilentFrom; } ///< Whether the whole buffer is known to be zero.
+            inline void          Clear()      { if (*pSilentFrom) { memset(pBuffer, 0, *pSilentFrom * sizeof(float)); *pSilentFrom = 0; } } ///< Reset audio buffer with silence
+            inline void          Clear(uint Samples) { if (Samples >= *pSilentFrom) Clear(); else memset(pBuffer, 0, Samples * sizeof(float)); } ///< Reset audio buffer with silence
             void CopyTo(AudioChannel* pDst, const uint Samples);
             void CopyTo(AudioChannel* pDst, const uint Samples, const float fLevel);
             void MixTo(AudioChannel* pDst, const uint Samples);
             void MixTo(AudioChannel* pDst, const uint Samples, const float fLevel);
+            void MixTo(AudioChannel* const* ppDst, const float* pLevels, const uint Destinations, const uint Samples);
             std::map<String,DeviceRuntimeParameter*> ChannelParameters();
 
             // constructors / destructor
@@ -111,6 +127,10 @@ namespace LinuxSampler {
             uint          uiBufferSize;
             AudioChannel* pMixChannel;
             bool          UsesExternalBuffer;
+            uint          uiSilentFrom;
+            uint*         pSilentFrom; ///< Either points to uiSilentFrom or to the one of the real channel in case of a mix channel.
+
+            void Overwritten(uint Audible, uint Samples);
     };
 }
 
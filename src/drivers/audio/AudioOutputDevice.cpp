@@ -182,12 +182,22 @@ namespace LinuxSampler {
 // *
 
     AudioOutputDevice::AudioOutputDevice(std::map<String,DeviceCreationParameter*> DriverParameters)
-        : EnginesReader(Engines) {
+        : EnginesReader(Engines), RenderCycleListenersReader(RenderCycleListeners) {
+        uiFrameTime = 0;
+        frameTimeSequence.store(0, memory_order_relaxed);
         this->Parameters = DriverParameters;
         EffectChainIDs = new IDGenerator();
     }
 
     AudioOutputDevice::~AudioOutputDevice() {
+        // let objects still driven by our sample clock know that it is gone
+        {
+            const std::set<RenderCycleListener*> listeners = RenderCycleListeners.GetConfigForUpdate();
+            std::set<RenderCycleListener*>::const_iterator iter = listeners.begin();
+            for (; iter != listeners.end(); ++iter)
+                (*iter)->OnAudioDeviceDestroyed(this);
+        }
+
         // delete all audio channels
         {
             std::vector<AudioChannel*>::iterator iter = Channels.begin();
@@ -241,6 +251,35 @@ namespace LinuxSampler {
         }
     }
     
+    void AudioOutputDevice::AddRenderCycleListener(RenderCycleListener* l) {
+        std::set<RenderCycleListener*>& listeners = RenderCycleListeners.GetConfigForUpdate();
+        if (listeners.find(l) == listeners.end()) {
+            listeners.insert(l);
+            RenderCycleListeners.SwitchConfig().insert(l);
+        }
+    }
+
+    void AudioOutputDevice::RemoveRenderCycleListener(RenderCycleListener* l) {
+        std::set<RenderCycleListener*>& listeners = RenderCycleListeners.GetConfigForUpdate();
+        if (listeners.find(l) != listeners.end()) {
+            listeners.erase(l);
+            RenderCycleListeners.SwitchConfig().erase(l);
+        }
+    }
+
+    uint64_t AudioOutputDevice::FrameTime() const {
+        // the audio thread does not lock, so retry until we read a value
+        // which was not modified by the audio thread while reading it
+        while (true) {
+            const int seq = frameTimeSequence.load(memory_order_acquire);
+            if (seq & 1) continue;
+            const uint64_t frameTime = uiFrameTime;
+            atomic_thread_fence(memory_order_acquire);
+            if (frameTimeSequence.load(memory_order_relaxed) == seq)
+                return frameTime;
+        }
+    }
+
     void AudioOutputDevice::ReconnectAll() {
         // copy by value, not by reference here !
         std::set<Engine*> engines = Engines.GetConfigForUpdate();
@@ -358,6 +397,17 @@ namespace LinuxSampler {
                 (*iterChains)->ClearAllChannels(); // zero out audio buffers
         }
 
+        // let objects synchronized to our sample clock (i.e. MIDI drivers)
+        // dispatch their events for the current audio fragment cycle
+        {
+            const std::set<RenderCycleListener*>& listeners = RenderCycleListenersReader.Lock();
+            std::set<RenderCycleListener*>::const_iterator iter = listeners.begin();
+            std::set<RenderCycleListener*>::const_iterator end  = listeners.end();
+            for (; iter != end; ++iter)
+                (*iter)->OnRenderCycle(Samples, uiFrameTime);
+            RenderCycleListenersReader.Unlock();
+        }
+
         int result = 0;
 
         // let all connected engines render audio for the current audio fragment cycle
@@ -389,15 +439,28 @@ namespace LinuxSampler {
             for (; iterChains != end; ++iterChains) {
                 if (!(*iterChains)->EffectCount()) continue;
                 (*iterChains)->RenderAudio(Samples);
-                // mix the result of the last effect in the chain to the audio
-                // output device channel(s)
-                Effect* pLastEffect =
-                    (*iterChains)->GetEffect((*iterChains)->EffectCount() - 1);
-                for (int iChan = 0; iChan < pLastEffect->OutputChannelCount() && iChan < ChannelCount(); ++iChan)
-                    pLastEffect->OutputChannel(iChan)->MixTo(Channel(iChan), Samples);
+                // mix the result of the chain to the audio output device
+                // channel(s) (if the result is not silent)
+                EffectChain* pChain = *iterChains;
+                for (int iChan = 0; iChan < pChain->OutputChannelCount() && iChan < ChannelCount(); ++iChan)
+                    pChain->OutputChannel(iChan)->MixTo(Channel(iChan), Samples);
             }
         }
 
+        // a 64 bit value is not written atomically on all architectures, so
+        // let other threads detect a torn read (odd sequence number while
+        // updating, see FrameTime())
+        frameTimeSequence.store(
+            frameTimeSequence.load(memory_order_relaxed) + 1,
+            memory_order_relaxed
+        );
+        atomic_thread_fence(memory_order_release);
+        uiFrameTime += Samples;
+        frameTimeSequence.store(
+            frameTimeSequence.load(memory_order_relaxed) + 1,
+            memory_order_release
+        );
+
         return result;
     }
 
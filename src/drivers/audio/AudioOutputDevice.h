@@ -36,6 +36,7 @@
 #include "../../engines/Engine.h"
 #include "AudioChannel.h"
 #include "../../common/SynchronizedConfig.h"
+#include "../../common/lsatomic.h"
 #include "../../effects/EffectChain.h"
 
 namespace LinuxSampler {
@@ -118,6 +119,46 @@ namespace LinuxSampler {
 
 
 
+            /** Render cycle listener
+             *
+             * Interface for objects which have to be driven by the sample
+             * clock of an audio output device, for example MIDI input
+             * drivers which dispatch their events sample accurately. A
+             * registered listener is called by the audio thread at the
+             * beginning of each audio fragment cycle, right before the
+             * connected engines render the fragment. So implementations
+             * must be real-time safe!
+             */
+            class RenderCycleListener {
+                public:
+                    /**
+                     * Called by the audio thread at the beginning of each
+                     * RenderAudio() cycle.
+                     *
+                     * @param Samples   - amount of sample points going to be
+                     *                    rendered in this cycle
+                     * @param FrameTime - total amount of sample points
+                     *                    rendered by the audio device before
+                     *                    this cycle
+                     */
+                    virtual void OnRenderCycle(uint Samples, uint64_t FrameTime) = 0;
+
+                    /**
+                     * Called by the destructor of an audio output device
+                     * this listener is still registered with. The audio
+                     * thread is already stopped at this point and the
+                     * listener must not access @a pDevice anymore after
+                     * returning.
+                     *
+                     * @param pDevice - audio device being destroyed
+                     */
+                    virtual void OnAudioDeviceDestroyed(AudioOutputDevice* pDevice) {}
+
+                    virtual ~RenderCycleListener() {}
+            };
+
+
+
             /////////////////////////////////////////////////////////////////
             // abstract methods
             //     (these have to be implemented by the descendant)
@@ -238,6 +279,30 @@ namespace LinuxSampler {
              */
             void ReconnectAll();
 
+            /**
+             * Registers the given listener to be called by the audio thread
+             * at the beginning of each audio fragment cycle.
+             *
+             * @param l - listener to be added
+             * @see RenderCycleListener
+             */
+            void AddRenderCycleListener(RenderCycleListener* l);
+
+            /**
+             * Removes the given listener. When this method returns, the
+             * audio thread is guaranteed to not call the listener anymore.
+             *
+             * @param l - listener to be removed
+             */
+            void RemoveRenderCycleListener(RenderCycleListener* l);
+
+            /**
+             * Returns the total amount of sample points rendered by this
+             * audio device since it was created (that is the device's
+             * sample clock). This method may be called by any thread.
+             */
+            uint64_t FrameTime() const;
+
             /**
              * Returns audio channel with index \a ChannelIndex or NULL if
              * index out of bounds.
@@ -333,6 +398,10 @@ namespace LinuxSampler {
             std::map<String,DeviceCreationParameter*> Parameters;  ///< All device parameters.
             std::vector<EffectChain*>                 vEffectChains;
             IDGenerator*                              EffectChainIDs;
+            SynchronizedConfig<std::set<RenderCycleListener*> > RenderCycleListeners; ///< All objects driven by this audio device's sample clock.
+            SynchronizedConfig<std::set<RenderCycleListener*> >::Reader RenderCycleListenersReader; ///< Audio thread access to RenderCycleListeners.
+            uint64_t                                  uiFrameTime; ///< Total amount of sample points rendered so far.
+            atomic<int>                               frameTimeSequence; ///< Odd while the audio thread is updating @c uiFrameTime, so FrameTime() can detect (and retry) a torn read by another thread.
 
             AudioOutputDevice(std::map<String,DeviceCreationParameter*> DriverParameters);
 
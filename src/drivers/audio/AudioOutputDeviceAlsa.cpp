@@ -24,6 +24,8 @@
 #include "AudioOutputDeviceAlsa.h"
 #include "AudioOutputDeviceFactory.h"
 
+#include <algorithm>
+
 namespace LinuxSampler {
 
 // *************** ParameterCard ***************
@@ -753,13 +755,18 @@ namespace LinuxSampler {
             // range (-32768..+32767), check clipping  and copy to Alsa output buffer
             // (note: we use interleaved output method to Alsa)
             for (int c = 0; c < uiAlsaChannels; c++) {
-                float* in  = Channels[c]->Buffer();
-                for (int i = 0, o = c; i < FragmentSize; i++ , o += uiAlsaChannels) {
+                const float* in = Channels[c]->ConstBuffer();
+                // sample points from this position on are silent anyway
+                const int audible = std::min(FragmentSize, Channels[c]->SilentFrom());
+                int i = 0, o = c;
+                for (; i < audible; i++ , o += uiAlsaChannels) {
                     float sample_point = in[i] * 32768.0f;
                     if (sample_point < -32768.0) sample_point = -32768.0;
                     if (sample_point >  32767.0) sample_point =  32767.0;
                     pAlsaOutputBuffer[o] = (int16_t) sample_point;
                 }
+                for (; i < FragmentSize; i++ , o += uiAlsaChannels)
+                    pAlsaOutputBuffer[o] = 0;
             }
 
             // output sound
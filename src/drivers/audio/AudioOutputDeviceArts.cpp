@@ -21,6 +21,8 @@
 #include "AudioOutputDeviceArts.h"
 #include "AudioOutputDeviceFactory.h"
 
+#include <algorithm>
+
 //TODO: this driver currently allows and expects only a bit depth of 16 !
 #define LS_ARTS_BITDEPTH	16
 
@@ -177,13 +179,18 @@ namespace LinuxSampler {
             // convert from DSP value range (-1.0..+1.0) to 16 bit integer value
             // range (-32768..+32767), check clipping and copy to aRts output buffer
             for (int c = 0; c < uiArtsChannels; c++) {
-                float* in  = Channels[c]->Buffer();
-                for (int i = 0, o = c; i < FragmentSize; i++ , o += uiArtsChannels) {
+                const float* in = Channels[c]->ConstBuffer();
+                // sample points from this position on are silent anyway
+                const int audible = std::min(FragmentSize, Channels[c]->SilentFrom());
+                int i = 0, o = c;
+                for (; i < audible; i++ , o += uiArtsChannels) {
                     float sample_point = in[i] * 32768.0f;
                     if (sample_point < -32768.0) sample_point = -32768.0;
                     if (sample_point >  32767.0) sample_point =  32767.0;
                     pArtsOutputBuffer[o] = (int16_t) sample_point;
                 }
+                for (; i < FragmentSize; i++ , o += uiArtsChannels)
+                    pArtsOutputBuffer[o] = 0;
             }
 
             // output sound
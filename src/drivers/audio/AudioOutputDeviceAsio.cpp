@@ -24,6 +24,8 @@
 #include "AudioOutputDeviceAsio.h"
 #include "AudioOutputDeviceFactory.h"
 
+#include <algorithm>
+
 #define kMaxInputChannels 32
 #define kMaxOutputChannels 32
 #define ASIO_MAX_DEVICE_INFO 32
@@ -100,37 +102,43 @@ namespace LinuxSampler {
 ASIOCallbacks asioCallbacks;
 AudioOutputDeviceAsio* GlobalAudioOutputDeviceAsioThisPtr;
 
+// float to ASIO sample format converters (the sample points from position
+// numAudible on are known to be silent and are just zeroed)
+
 template<int bitres>
-static void floatToASIOSTInt32LSBXX(float* in, void* dest, int numSamples) {
+static void floatToASIOSTInt32LSBXX(const float* in, void* dest, int numSamples, int numAudible) {
     double pos_max_value = (1 << bitres) -1.0;
     double neg_max_value = -pos_max_value;
     int32_t* out = (int32_t*)dest;
-    for (int i = 0; i < numSamples ; i++) {
+    for (int i = 0; i < numAudible ; i++) {
         double sample_point = in[i] * pos_max_value;
         if (sample_point < neg_max_value) sample_point = neg_max_value;
         if (sample_point >  pos_max_value) sample_point =  pos_max_value;
         out[i] = (int16_t)sample_point;
     }
+    memset(out + numAudible, 0, (numSamples - numAudible) * sizeof(int32_t));
 }
 
-static void floatToASIOSTInt16LSB(float* in, void* dest, int numSamples) {
+static void floatToASIOSTInt16LSB(const float* in, void* dest, int numSamples, int numAudible) {
     int16_t* out = (int16_t*)dest;
-    for (int i = 0; i < numSamples ; i++) {
+    for (int i = 0; i < numAudible ; i++) {
         float sample_point = in[i] * 32768.0f;
         if (sample_point < -32768.0) sample_point = -32768.0;
         if (sample_point >  32767.0) sample_point =  32767.0;
         out[i] = (int16_t)sample_point;
     }
+    memset(out + numAudible, 0, (numSamples - numAudible) * sizeof(int16_t));
 }
 
-static void floatToASIOSTInt32LSB(float* in, void* dest, int numSamples) {
+static void floatToASIOSTInt32LSB(const float* in, void* dest, int numSamples, int numAudible) {
     int32_t* out = (int32_t*)dest;
-    for (int i = 0; i < numSamples ; i++) {
+    for (int i = 0; i < numAudible ; i++) {
         double sample_point = in[i] * 2147483648.0;
         if (sample_point < - 2147483648.0) sample_point = -2147483648.0;
         if (sample_point >  2147483647.0) sample_point =  2147483647.0;
         out[i] = (int32_t)(sample_point);
     }
+    memset(out + numAudible, 0, (numSamples - numAudible) * sizeof(int32_t));
 }
 
 std::vector<String> getAsioDriverNames();
@@ -381,19 +389,23 @@ ASIOTime* AudioOutputDeviceAsio::bufferSwitchTimeInfo(ASIOTime *timeInfo, long i
     // now write and convert the samples to the ASIO buffer
     for (int i = 0; i < asioDriverInfo.numOutputBuffers; i++)
     {
+        AudioChannel* pChannel = GlobalAudioOutputDeviceAsioThisPtr->Channels[i];
+        const float* in = pChannel->ConstBuffer();
+        const int audible = std::min(buffSize, (long) pChannel->SilentFrom());
+
         // do processing for the outputs only
         switch (asioDriverInfo.channelInfos[i].type)
         {
         case ASIOSTInt16LSB:
-            floatToASIOSTInt16LSB(GlobalAudioOutputDeviceAsioThisPtr->Channels[i]->Buffer(),
-                                  (int16_t*)asioDriverInfo.bufferInfos[i].buffers[index], buffSize);
+            floatToASIOSTInt16LSB(in,
+                                  (int16_t*)asioDriverInfo.bufferInfos[i].buffers[index], buffSize, audible);
             break;
         case ASIOSTInt24LSB:   // used for 20 bits as well
             memset (asioDriverInfo.bufferInfos[i].buffers[index], 0, buffSize * 3);
             break;
         case ASIOSTInt32LSB:
-            floatToASIOSTInt32LSB(GlobalAudioOutputDeviceAsioThisPtr->Channels[i]->Buffer(),
-                                  (int32_t*)asioDriverInfo.bufferInfos[i].buffers[index], buffSize);
+            floatToASIOSTInt32LSB(in,
+                                  (int32_t*)asioDriverInfo.bufferInfos[i].buffers[index], buffSize, audible);
             break;
         case ASIOSTFloat32LSB: // IEEE 754 32 bit float, as found on Intel x86 architecture
             throw AudioOutputException("ASIO Error: ASIOSTFloat32LSB not yet supported! report to LinuxSampler developers.");
@@ -407,24 +419,24 @@ ASIOTime* AudioOutputDeviceAsio::bufferSwitchTimeInfo(ASIOTime *timeInfo, long i
             // can more easily used with these.
 
         case ASIOSTInt32LSB16: // 32 bit data with 16 bit alignment
-            floatToASIOSTInt32LSBXX<16>(GlobalAudioOutputDeviceAsioThisPtr->Channels[i]->Buffer(),
+            floatToASIOSTInt32LSBXX<16>(in,
                                         (int32_t*)asioDriverInfo.bufferInfos[i].buffers[index],
-                                        buffSize);
+                                        buffSize, audible);
             break;
         case ASIOSTInt32LSB18: // 32 bit data with 18 bit alignment
-            floatToASIOSTInt32LSBXX<18>(GlobalAudioOutputDeviceAsioThisPtr->Channels[i]->Buffer(),
+            floatToASIOSTInt32LSBXX<18>(in,
                                         (int32_t*)asioDriverInfo.bufferInfos[i].buffers[index],
-                                        buffSize);
+                                        buffSize, audible);
             break;
         case ASIOSTInt32LSB20: // 32 bit data with 20 bit alignment
-            floatToASIOSTInt32LSBXX<20>(GlobalAudioOutputDeviceAsioThisPtr->Channels[i]->Buffer(),
+            floatToASIOSTInt32LSBXX<20>(in,
                                         (int32_t*)asioDriverInfo.bufferInfos[i].buffers[index],
-                                        buffSize);
+                                        buffSize, audible);
             break;
         case ASIOSTInt32LSB24: // 32 bit data with 24 bit alignment
-            floatToASIOSTInt32LSBXX<24>(GlobalAudioOutputDeviceAsioThisPtr->Channels[i]->Buffer(),
+            floatToASIOSTInt32LSBXX<24>(in,
                                         (int32_t*)asioDriverInfo.bufferInfos[i].buffers[index],
-                                        buffSize);
+                                        buffSize, audible);
             break;
         case ASIOSTInt16MSB:
             throw AudioOutputException("ASIO Error: ASIOSTInt16MSB not yet supported! report to LinuxSampler developers.");
@@ -24,6 +24,8 @@
 
 #include "../../common/global_private.h"
 
+#include <algorithm>
+
 namespace LinuxSampler {
 
     void AudioOutputDeviceCoreAudio::AudioQueueListener (
@@ -62,10 +64,16 @@ namespace LinuxSampler {
 
         uint uiCoreAudioChannels = pAqData->pDevice->uiCoreAudioChannels;
         for (int c = 0; c < uiCoreAudioChannels; c++) {
-            float* in  = pAqData->pDevice->Channels[c]->Buffer();
-            for (int i = 0, o = c; i < bufferSize; i++ , o += uiCoreAudioChannels) {
+            AudioChannel* pChannel = pAqData->pDevice->Channels[c];
+            const float* in = pChannel->ConstBuffer();
+            const uint audible = std::min(bufferSize, pChannel->SilentFrom());
+            uint i = 0, o = c;
+            for (; i < audible; i++ , o += uiCoreAudioChannels) {
                 pDataBuf[o] = in[i];
             }
+            for (; i < bufferSize; i++ , o += uiCoreAudioChannels) {
+                pDataBuf[o] = 0.0f;
+            }
         }
 
         inBuffer->mAudioDataByteSize = (uiCoreAudioChannels * 4) * bufferSize;
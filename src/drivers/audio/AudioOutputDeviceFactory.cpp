@@ -45,6 +45,8 @@
 # include "AudioOutputDeviceCoreAudio.h"
 #endif // HAVE_COREAUDIO
 
+#include "AudioOutputDeviceFile.h"
+
 namespace LinuxSampler {
 
     std::map<String, AudioOutputDeviceFactory::InnerFactory*> AudioOutputDeviceFactory::InnerFactories;
@@ -104,6 +106,17 @@ namespace LinuxSampler {
     REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceCoreAudio, ParameterBufferSize);
 #endif // HAVE_COREAUDIO
 
+    REGISTER_AUDIO_OUTPUT_DRIVER(AudioOutputDeviceFile);
+    /* Common parameters for now they'll have to be registered here. */
+    REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceFile, ParameterActive);
+    REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceFile, ParameterSampleRate);
+    REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceFile, ParameterChannels);
+    /* Driver specific parameters */
+    REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceFile, ParameterFragmentSize);
+    REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceFile, ParameterFormat);
+    REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceFile, ParameterFileName);
+    REGISTER_AUDIO_OUTPUT_DRIVER_PARAMETER(AudioOutputDeviceFile, ParameterFrames);
+
     AudioOutputDeviceFactory::AudioOutputDeviceMap AudioOutputDeviceFactory::mAudioOutputDevices;
 
     /**
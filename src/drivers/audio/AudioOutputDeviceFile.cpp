@@ -0,0 +1,384 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#include "AudioOutputDeviceFile.h"
+#include "AudioOutputDeviceFactory.h"
+
+#include <algorithm>
+
+namespace LinuxSampler {
+
+// *************** ParameterFragmentSize ***************
+// *
+
+    AudioOutputDeviceFile::ParameterFragmentSize::ParameterFragmentSize() : DeviceCreationParameterInt() {
+        InitWithDefault();
+    }
+
+    AudioOutputDeviceFile::ParameterFragmentSize::ParameterFragmentSize(String s) throw (Exception) : DeviceCreationParameterInt(s) {
+    }
+
+    String AudioOutputDeviceFile::ParameterFragmentSize::Description() {
+        return "Size of each buffer fragment";
+    }
+
+    bool AudioOutputDeviceFile::ParameterFragmentSize::Fix() {
+        return true;
+    }
+
+    bool AudioOutputDeviceFile::ParameterFragmentSize::Mandatory() {
+        return false;
+    }
+
+    std::map<String,DeviceCreationParameter*> AudioOutputDeviceFile::ParameterFragmentSize::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<int> AudioOutputDeviceFile::ParameterFragmentSize::DefaultAsInt(std::map<String,String> Parameters) {
+        return 128;
+    }
+
+    optional<int> AudioOutputDeviceFile::ParameterFragmentSize::RangeMinAsInt(std::map<String,String> Parameters) {
+        return 1;
+    }
+
+    optional<int> AudioOutputDeviceFile::ParameterFragmentSize::RangeMaxAsInt(std::map<String,String> Parameters) {
+        return 65536;
+    }
+
+    std::vector<int> AudioOutputDeviceFile::ParameterFragmentSize::PossibilitiesAsInt(std::map<String,String> Parameters) {
+        return std::vector<int>();
+    }
+
+    void AudioOutputDeviceFile::ParameterFragmentSize::OnSetValue(int i) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String AudioOutputDeviceFile::ParameterFragmentSize::Name() {
+        return "FRAGMENTSIZE";
+    }
+
+
+
+// *************** ParameterFormat ***************
+// *
+
+    AudioOutputDeviceFile::ParameterFormat::ParameterFormat() : DeviceCreationParameterString() {
+        InitWithDefault();
+    }
+
+    AudioOutputDeviceFile::ParameterFormat::ParameterFormat(String s) throw (Exception) : DeviceCreationParameterString(s) {
+        if (SndFileFormat(ValueAsString()) < 0)
+            throw Exception("Unknown audio file format '" + ValueAsString() + "'");
+    }
+
+    String AudioOutputDeviceFile::ParameterFormat::Description() {
+        return "Audio file format to be written";
+    }
+
+    bool AudioOutputDeviceFile::ParameterFormat::Fix() {
+        return true;
+    }
+
+    bool AudioOutputDeviceFile::ParameterFormat::Mandatory() {
+        return false;
+    }
+
+    std::map<String,DeviceCreationParameter*> AudioOutputDeviceFile::ParameterFormat::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<String> AudioOutputDeviceFile::ParameterFormat::DefaultAsString(std::map<String,String> Parameters) {
+        return String("WAV");
+    }
+
+    std::vector<String> AudioOutputDeviceFile::ParameterFormat::PossibilitiesAsString(std::map<String,String> Parameters) {
+        std::vector<String> formats;
+        formats.push_back("WAV");
+        #if HAVE_DECL_SF_FORMAT_FLAC
+        formats.push_back("FLAC");
+        #endif
+        formats.push_back("RAW");
+        formats.push_back("NONE");
+        return formats;
+    }
+
+    void AudioOutputDeviceFile::ParameterFormat::OnSetValue(String s) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String AudioOutputDeviceFile::ParameterFormat::Name() {
+        return "FORMAT";
+    }
+
+
+
+// *************** ParameterFileName ***************
+// *
+
+    AudioOutputDeviceFile::ParameterFileName::ParameterFileName() : DeviceCreationParameterString() {
+        InitWithDefault();
+    }
+
+    AudioOutputDeviceFile::ParameterFileName::ParameterFileName(String s) throw (Exception) : DeviceCreationParameterString(s) {
+    }
+
+    String AudioOutputDeviceFile::ParameterFileName::Description() {
+        return "Path of the audio file to be written";
+    }
+
+    bool AudioOutputDeviceFile::ParameterFileName::Fix() {
+        return true;
+    }
+
+    bool AudioOutputDeviceFile::ParameterFileName::Mandatory() {
+        return false;
+    }
+
+    std::map<String,DeviceCreationParameter*> AudioOutputDeviceFile::ParameterFileName::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<String> AudioOutputDeviceFile::ParameterFileName::DefaultAsString(std::map<String,String> Parameters) {
+        return optional<String>::nothing;
+    }
+
+    std::vector<String> AudioOutputDeviceFile::ParameterFileName::PossibilitiesAsString(std::map<String,String> Parameters) {
+        return std::vector<String>();
+    }
+
+    void AudioOutputDeviceFile::ParameterFileName::OnSetValue(String s) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String AudioOutputDeviceFile::ParameterFileName::Name() {
+        return "FILENAME";
+    }
+
+
+
+// *************** ParameterFrames ***************
+// *
+
+    AudioOutputDeviceFile::ParameterFrames::ParameterFrames() : DeviceCreationParameterInt() {
+        InitWithDefault();
+    }
+
+    AudioOutputDeviceFile::ParameterFrames::ParameterFrames(String s) throw (Exception) : DeviceCreationParameterInt(s) {
+    }
+
+    String AudioOutputDeviceFile::ParameterFrames::Description() {
+        return "Amount of sample frames to render (0 = unlimited)";
+    }
+
+    bool AudioOutputDeviceFile::ParameterFrames::Fix() {
+        return true;
+    }
+
+    bool AudioOutputDeviceFile::ParameterFrames::Mandatory() {
+        return false;
+    }
+
+    std::map<String,DeviceCreationParameter*> AudioOutputDeviceFile::ParameterFrames::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<int> AudioOutputDeviceFile::ParameterFrames::DefaultAsInt(std::map<String,String> Parameters) {
+        return 0;
+    }
+
+    optional<int> AudioOutputDeviceFile::ParameterFrames::RangeMinAsInt(std::map<String,String> Parameters) {
+        return 0;
+    }
+
+    optional<int> AudioOutputDeviceFile::ParameterFrames::RangeMaxAsInt(std::map<String,String> Parameters) {
+        return optional<int>::nothing;
+    }
+
+    std::vector<int> AudioOutputDeviceFile::ParameterFrames::PossibilitiesAsInt(std::map<String,String> Parameters) {
+        return std::vector<int>();
+    }
+
+    void AudioOutputDeviceFile::ParameterFrames::OnSetValue(int i) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String AudioOutputDeviceFile::ParameterFrames::Name() {
+        return "FRAMES";
+    }
+
+
+
+// *************** AudioOutputDeviceFile ***************
+// *
+
+    /**
+     * Create offline audio output device with given parameters.
+     *
+     * @param Parameters - optional parameters
+     * @throws AudioOutputException  if output file cannot be opened
+     */
+    AudioOutputDeviceFile::AudioOutputDeviceFile(std::map<String,DeviceCreationParameter*> Parameters) : AudioOutputDevice(Parameters), Thread(false, false, 0, 0) {
+        pSndFile         = NULL;
+        pOutputBuffer    = NULL;
+        uiFramesRendered = 0;
+        uiChannels       = ((DeviceCreationParameterInt*)Parameters["CHANNELS"])->ValueAsInt();
+        uiSamplerate     = ((DeviceCreationParameterInt*)Parameters["SAMPLERATE"])->ValueAsInt();
+        FragmentSize     = ((DeviceCreationParameterInt*)Parameters["FRAGMENTSIZE"])->ValueAsInt();
+        uiFramesToRender = ((DeviceCreationParameterInt*)Parameters["FRAMES"])->ValueAsInt();
+        String Format    = ((DeviceCreationParameterString*)Parameters["FORMAT"])->ValueAsString();
+        String FileName  = ((DeviceCreationParameterString*)Parameters["FILENAME"])->ValueAsString();
+
+        const int sfFormat = SndFileFormat(Format);
+        if (sfFormat < 0)
+            throw AudioOutputException("Unknown audio file format '" + Format + "'");
+
+        if (sfFormat) {
+            if (FileName.empty())
+                throw AudioOutputException("No output file name given");
+
+            SF_INFO sfInfo;
+            memset(&sfInfo, 0, sizeof(sfInfo));
+            sfInfo.samplerate = uiSamplerate;
+            sfInfo.channels   = uiChannels;
+            sfInfo.format     = sfFormat;
+            pSndFile = sf_open(FileName.c_str(), SFM_WRITE, &sfInfo);
+            if (!pSndFile)
+                throw AudioOutputException("Could not open output file '" + FileName + "': " + sf_strerror(NULL));
+            // formats with integer samples (i.e. FLAC) need clipping
+            sf_command(pSndFile, SFC_SET_CLIPPING, NULL, SF_TRUE);
+
+            pOutputBuffer = new float[uiChannels * FragmentSize];
+        }
+
+        // create audio channels for this audio device to which the sampler engines can write to
+        for (int i = 0; i < uiChannels; i++) this->Channels.push_back(new AudioChannel(i, FragmentSize));
+
+        if (((DeviceCreationParameterBool*)Parameters["ACTIVE"])->ValueAsBool()) {
+            Play();
+        }
+    }
+
+    AudioOutputDeviceFile::~AudioOutputDeviceFile() {
+        StopThread();
+        if (pSndFile) sf_close(pSndFile); // also finalizes the file header
+        if (pOutputBuffer) delete[] pOutputBuffer;
+    }
+
+    /**
+     * Returns the libsndfile format flags for the given value of parameter
+     * 'FORMAT', 0 if output shall be discarded or -1 if the format is
+     * unknown.
+     */
+    int AudioOutputDeviceFile::SndFileFormat(String format) {
+        if (format == "WAV")  return SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        #if HAVE_DECL_SF_FORMAT_FLAC
+        if (format == "FLAC") return SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+        #endif
+        if (format == "RAW")  return SF_FORMAT_RAW | SF_FORMAT_FLOAT;
+        if (format == "NONE") return 0;
+        return -1;
+    }
+
+    void AudioOutputDeviceFile::Play() {
+        StartThread();
+    }
+
+    bool AudioOutputDeviceFile::IsPlaying() {
+        return IsRunning(); // if Thread is running
+    }
+
+    void AudioOutputDeviceFile::Stop() {
+        StopThread();
+    }
+
+    AudioChannel* AudioOutputDeviceFile::CreateChannel(uint ChannelNr) {
+        // just create a mix channel
+        return new AudioChannel(ChannelNr, Channel(ChannelNr % uiChannels));
+    }
+
+    uint AudioOutputDeviceFile::MaxSamplesPerCycle() {
+        return FragmentSize;
+    }
+
+    uint AudioOutputDeviceFile::SampleRate() {
+        return uiSamplerate;
+    }
+
+    String AudioOutputDeviceFile::Name() {
+        return "FILE";
+    }
+
+    String AudioOutputDeviceFile::Driver() {
+        return Name();
+    }
+
+    String AudioOutputDeviceFile::Description() {
+        return "Offline rendering (faster than real-time) to audio file";
+    }
+
+    String AudioOutputDeviceFile::Version() {
+       String s = "$Revision$";
+       return s.substr(11, s.size() - 13); // cut dollar signs, spaces and CVS macro keyword
+    }
+
+    /**
+     * Entry point for the thread. Other than the drivers for real sound
+     * cards, this thread is not clocked by any device; it just renders one
+     * fragment after the other as fast as possible.
+     */
+    int AudioOutputDeviceFile::Main() {
+        while (!uiFramesToRender || uiFramesRendered < uiFramesToRender) {
+            TestCancel();
+
+            uint frames = FragmentSize;
+            if (uiFramesToRender && uiFramesToRender - uiFramesRendered < frames)
+                frames = uiFramesToRender - uiFramesRendered;
+
+            // let all connected engines render 'frames' sample points
+            RenderAudio(frames);
+
+            if (pSndFile) {
+                // interleave channels for libsndfile
+                for (int c = 0; c < uiChannels; c++) {
+                    const float* in = Channels[c]->ConstBuffer();
+                    const uint audible = std::min(frames, Channels[c]->SilentFrom());
+                    uint i = 0, o = c;
+                    for (; i < audible; i++ , o += uiChannels)
+                        pOutputBuffer[o] = in[i];
+                    for (; i < frames; i++ , o += uiChannels)
+                        pOutputBuffer[o] = 0.0f;
+                }
+                if (sf_writef_float(pSndFile, pOutputBuffer, frames) != frames) {
+                    std::cerr << "AudioOutputDeviceFile: Could not write output file: "
+                              << sf_strerror(pSndFile) << std::endl << std::flush;
+                    return -1;
+                }
+            }
+
+            uiFramesRendered += frames;
+        }
+        dmsg(1,("AudioOutputDeviceFile: rendered %lld frames.\n", (long long) uiFramesRendered));
+        return 0;
+    }
+
+} // namespace LinuxSampler
@@ -0,0 +1,169 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#ifndef __LS_AUDIOOUTPUTDEVICEFILE_H__
+#define __LS_AUDIOOUTPUTDEVICEFILE_H__
+
+#include <string.h>
+#include <sndfile.h>
+
+#include "../../common/global_private.h"
+#include "../../common/Thread.h"
+#include "AudioOutputDevice.h"
+#include "AudioChannel.h"
+#include "../DeviceParameter.h"
+
+namespace LinuxSampler {
+
+    /** Offline audio output driver
+     *
+     * Renders audio as fast as the CPU allows, that is without being clocked
+     * by any sound card or host application. The rendered audio is either
+     * written to an audio file (WAV, FLAC or raw 32 bit float) or simply
+     * discarded.
+     *
+     * This driver does not require any sound hardware at all and is thus
+     * useful for bouncing instrument performances to disk, for regression
+     * tests and as a base for throughput benchmarks.
+     */
+    class AudioOutputDeviceFile : public AudioOutputDevice, protected Thread {
+        public:
+            AudioOutputDeviceFile(std::map<String,DeviceCreationParameter*> Parameters);
+            virtual ~AudioOutputDeviceFile();
+
+            // derived abstract methods from class 'AudioOutputDevice'
+            virtual void Play() OVERRIDE;
+            virtual bool IsPlaying() OVERRIDE;
+            virtual void Stop() OVERRIDE;
+            virtual uint MaxSamplesPerCycle() OVERRIDE;
+            virtual uint SampleRate() OVERRIDE;
+            virtual AudioChannel* CreateChannel(uint ChannelNr) OVERRIDE;
+            virtual String Driver() OVERRIDE;
+
+            static String Name();
+            static String Description();
+            static String Version();
+
+            /**
+             * Returns the total amount of sample frames rendered by this
+             * device since it was created.
+             */
+            uint64_t FramesRendered() const { return uiFramesRendered; }
+
+            /** Device Parameter 'FRAGMENTSIZE'
+             *
+             * Used to set the audio fragment size / period size, that is the
+             * amount of sample points rendered in one RenderAudio() cycle.
+             */
+            class ParameterFragmentSize : public DeviceCreationParameterInt {
+                public:
+                    ParameterFragmentSize();
+                    ParameterFragmentSize(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<int>    DefaultAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<int>    RangeMinAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<int>    RangeMaxAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual std::vector<int> PossibilitiesAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void             OnSetValue(int i) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+            /** Device Parameter 'FORMAT'
+             *
+             * Used to select the output file format. Format "NONE" renders
+             * the audio as usual, but discards the result.
+             */
+            class ParameterFormat : public DeviceCreationParameterString {
+                public:
+                    ParameterFormat();
+                    ParameterFormat(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<String>    DefaultAsString(std::map<String,String> Parameters) OVERRIDE;
+                    virtual std::vector<String> PossibilitiesAsString(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void                OnSetValue(String s) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+            /** Device Parameter 'FILENAME'
+             *
+             * Path of the audio file to be written. Mandatory unless format
+             * "NONE" was selected.
+             */
+            class ParameterFileName : public DeviceCreationParameterString {
+                public:
+                    ParameterFileName();
+                    ParameterFileName(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<String>    DefaultAsString(std::map<String,String> Parameters) OVERRIDE;
+                    virtual std::vector<String> PossibilitiesAsString(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void                OnSetValue(String s) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+            /** Device Parameter 'FRAMES'
+             *
+             * Total amount of sample frames to be rendered before the device
+             * stops playback by itself. 0 means rendering until Stop() is
+             * called explicitly.
+             */
+            class ParameterFrames : public DeviceCreationParameterInt {
+                public:
+                    ParameterFrames();
+                    ParameterFrames(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<int>    DefaultAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<int>    RangeMinAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<int>    RangeMaxAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual std::vector<int> PossibilitiesAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void             OnSetValue(int i) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+        protected:
+            int Main();  ///< Implementation of virtual method from class Thread
+
+        private:
+            uint     uiChannels;
+            uint     uiSamplerate;
+            uint     FragmentSize;
+            uint64_t uiFramesToRender;  ///< Total amount of frames to be rendered (0: unlimited).
+            uint64_t uiFramesRendered;  ///< Total amount of frames rendered so far.
+            SNDFILE* pSndFile;          ///< Output file handle (NULL if output is discarded).
+            float*   pOutputBuffer;     ///< Interleaved output buffer passed to libsndfile.
+
+            static int SndFileFormat(String format);
+    };
+}
+
+#endif // __LS_AUDIOOUTPUTDEVICEFILE_H__
@@ -0,0 +1,236 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#include "MidiEventRecorder.h"
+#include "../../common/global_private.h"
+
+#include <algorithm>
+
+/// Size of the ring buffer between each recording thread and the writer thread (in bytes).
+#define MIDI_CAPTURE_BUFFER_SIZE    65536
+/// Size of one event record without the MIDI event bytes.
+#define MIDI_CAPTURE_RECORD_HEADER  18
+/// Max. time the writer thread sleeps before flushing the ring buffer (in ns).
+#define MIDI_CAPTURE_FLUSH_INTERVAL 20000000L
+
+static const char* captureMagic   = "LSMC";
+static const uint  captureVersion = 1;
+
+namespace LinuxSampler {
+
+    static void putLE(uint8_t* p, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i, value >>= 8) p[i] = value & 0xff;
+    }
+
+    static uint64_t getLE(const uint8_t* p, int bytes) {
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; --i) value = (value << 8) | p[i];
+        return value;
+    }
+
+    MidiEventRecorder::MidiEventRecorder(String FileName, AudioOutputDevice* pClock) throw (MidiInputException)
+        : Thread(false, false, 0, 0)
+    {
+        this->sFileName = FileName;
+        this->pClock    = pClock;
+        uiClockFrameTime = (pClock) ? pClock->FrameTime() : 0;
+        clockSequence.store(0, memory_order_relaxed);
+        atomic_set(&sequence, 0);
+        atomic_set(&droppedEvents, 0);
+        bStop = false;
+
+        hFile = fopen(FileName.c_str(), "wb");
+        if (!hFile) throw MidiInputException("Could not open MIDI capture file '" + FileName + "'");
+
+        for (int i = 0; i < MAX_PRODUCERS; ++i) {
+            producers[i].buffer = new RingBuffer<uint8_t,false>(MIDI_CAPTURE_BUFFER_SIZE);
+            atomic_set(&producers[i].unused, 1);
+        }
+
+        uint8_t header[12];
+        memcpy(header, captureMagic, 4);
+        putLE(&header[4], captureVersion, 4);
+        putLE(&header[8], (pClock) ? pClock->SampleRate() : 0, 4);
+        fwrite(header, 1, sizeof(header), hFile);
+
+        StartThread();
+
+        if (pClock) pClock->AddRenderCycleListener(this);
+    }
+
+    MidiEventRecorder::~MidiEventRecorder() {
+        {
+            LockGuard lock(clockMutex);
+            if (pClock) pClock->RemoveRenderCycleListener(this);
+            pClock = NULL;
+        }
+        // let the writer thread do its final flush and return
+        bStop = true;
+        wakeup.Set(true);
+        JoinThread();
+        fclose(hFile);
+        for (int i = 0; i < MAX_PRODUCERS; ++i)
+            delete producers[i].buffer;
+        if (DroppedEvents())
+            dmsg(1,("MidiEventRecorder: %u MIDI events could not be captured to '%s'.\n",
+                    DroppedEvents(), sFileName.c_str()));
+    }
+
+    void MidiEventRecorder::OnRenderCycle(uint Samples, uint64_t FrameTime) {
+        // mark the frame time as being updated (odd sequence number), see
+        // ClockFrameTime() for the reading side
+        clockSequence.store(
+            clockSequence.load(memory_order_relaxed) + 1,
+            memory_order_relaxed
+        );
+        atomic_thread_fence(memory_order_release);
+        uiClockFrameTime = FrameTime;
+        clockSequence.store(
+            clockSequence.load(memory_order_relaxed) + 1,
+            memory_order_release
+        );
+    }
+
+    void MidiEventRecorder::OnAudioDeviceDestroyed(AudioOutputDevice* pDevice) {
+        LockGuard lock(clockMutex);
+        if (pDevice == pClock) pClock = NULL;
+    }
+
+    /**
+     * Returns the frame time of the current audio fragment cycle of the
+     * clocking audio device. This method is real-time safe.
+     */
+    uint64_t MidiEventRecorder::ClockFrameTime() const {
+        // the audio thread does not lock, so retry until we read a value
+        // which was not modified by the audio thread while reading it
+        while (true) {
+            const int seq = clockSequence.load(memory_order_acquire);
+            if (seq & 1) continue;
+            const uint64_t frameTime = uiClockFrameTime;
+            atomic_thread_fence(memory_order_acquire);
+            if (clockSequence.load(memory_order_relaxed) == seq)
+                return frameTime;
+        }
+    }
+
+    void MidiEventRecorder::Record(const uint8_t* pData, uint Size, int32_t FragmentPos) {
+        if (!Size || Size > 0xffff) return;
+        // pick a ring buffer which is not in use by another thread right now
+        // and which still has enough space left; only the thread which
+        // decrements a buffer's counter to zero may write to it
+        for (int i = 0; i < MAX_PRODUCERS; ++i) {
+            Producer& producer = producers[i];
+            if (!atomic_dec_and_test(&producer.unused)) {
+                atomic_inc(&producer.unused);
+                continue;
+            }
+            RingBuffer<uint8_t,false>* pBuffer = producer.buffer;
+            if (pBuffer->write_space() < MIDI_CAPTURE_RECORD_HEADER + int(Size)) {
+                atomic_inc(&producer.unused);
+                continue;
+            }
+            uint8_t header[MIDI_CAPTURE_RECORD_HEADER];
+            putLE(&header[0], ClockFrameTime(), 8);
+            putLE(&header[8], uint32_t(FragmentPos), 4);
+            // events recorded by different threads at the same time might
+            // get the same number, but the numbers of each thread's events
+            // are strictly increasing
+            putLE(&header[12], uint32_t(atomic_read(&sequence)), 4);
+            atomic_inc(&sequence);
+            putLE(&header[16], Size, 2);
+            pBuffer->write(header, MIDI_CAPTURE_RECORD_HEADER);
+            pBuffer->write(const_cast<uint8_t*>(pData), Size);
+            atomic_inc(&producer.unused);
+            return;
+        }
+        atomic_inc(&droppedEvents);
+    }
+
+    void MidiEventRecorder::Flush() {
+        uint8_t chunk[4096];
+        for (int i = 0; i < MAX_PRODUCERS; ++i) {
+            RingBuffer<uint8_t,false>* pBuffer = producers[i].buffer;
+            // only read complete records, a producer might be writing one
+            // right now
+            while (true) {
+                const int space = pBuffer->read_space();
+                if (space < MIDI_CAPTURE_RECORD_HEADER) break;
+                uint8_t header[MIDI_CAPTURE_RECORD_HEADER];
+                pBuffer->get_non_volatile_reader().read(header, MIDI_CAPTURE_RECORD_HEADER);
+                const int size = MIDI_CAPTURE_RECORD_HEADER + int(getLE(&header[16], 2));
+                if (space < size) break;
+                for (int left = size; left > 0; ) {
+                    const int n = pBuffer->read(chunk, (left < int(sizeof(chunk))) ? left : int(sizeof(chunk)));
+                    fwrite(chunk, 1, n, hFile);
+                    left -= n;
+                }
+            }
+        }
+        fflush(hFile);
+    }
+
+    int MidiEventRecorder::Main() {
+        while (!bStop) {
+            wakeup.WaitAndUnlockIf(false, 0L, MIDI_CAPTURE_FLUSH_INTERVAL);
+            Flush();
+        }
+        // all Record() calls are done when the destructor stops us
+        Flush();
+        return 0;
+    }
+
+    /// Used for restoring the recording order of the events of a capture file.
+    static bool compareSequence(const MidiEventRecorder::CapturedEvent& a, const MidiEventRecorder::CapturedEvent& b) {
+        return a.sequence < b.sequence;
+    }
+
+    bool MidiEventRecorder::IsCaptureFile(const std::vector<uint8_t>& data) {
+        return data.size() >= 12 && memcmp(&data[0], captureMagic, 4) == 0;
+    }
+
+    void MidiEventRecorder::Parse(const std::vector<uint8_t>& data, std::vector<CapturedEvent>& records, uint& sampleRate) throw (MidiInputException) {
+        if (!IsCaptureFile(data))
+            throw MidiInputException("Not a MIDI capture file");
+        if (getLE(&data[4], 4) != captureVersion)
+            throw MidiInputException("Unsupported MIDI capture file version");
+        sampleRate = getLE(&data[8], 4);
+        records.clear();
+        for (size_t pos = 12; pos < data.size(); ) {
+            if (data.size() - pos < MIDI_CAPTURE_RECORD_HEADER)
+                throw MidiInputException("Truncated MIDI capture file");
+            CapturedEvent record;
+            record.frame       = getLE(&data[pos], 8);
+            record.fragmentPos = int32_t(getLE(&data[pos + 8], 4));
+            record.sequence    = uint32_t(getLE(&data[pos + 12], 4));
+            const uint size    = getLE(&data[pos + 16], 2);
+            pos += MIDI_CAPTURE_RECORD_HEADER;
+            if (data.size() - pos < size)
+                throw MidiInputException("Truncated MIDI capture file");
+            record.data.assign(data.begin() + pos, data.begin() + pos + size);
+            pos += size;
+            records.push_back(record);
+        }
+        // events of different ring buffers are interleaved in the file
+        std::stable_sort(records.begin(), records.end(), compareSequence);
+    }
+
+} // namespace LinuxSampler
@@ -0,0 +1,173 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#ifndef __LS_MIDIEVENTRECORDER_H__
+#define __LS_MIDIEVENTRECORDER_H__
+
+#include <stdio.h>
+#include <vector>
+
+#include "../../common/global.h"
+#include "../../common/atomic.h"
+#include "../../common/lsatomic.h"
+#include "../../common/Thread.h"
+#include "../../common/Condition.h"
+#include "../../common/Mutex.h"
+#include "../../common/RingBuffer.h"
+#include "../audio/AudioOutputDevice.h"
+#include "MidiInputDevice.h"
+
+namespace LinuxSampler {
+
+    /** @brief Captures MIDI events to a binary file.
+     *
+     * Logs every MIDI event dispatched by a MidiInputPort together with the
+     * sample clock of an audio output device (see
+     * AudioOutputDevice::FrameTime()) and the event's fragment position, so
+     * that a performance can be replayed later on (i.e. with the "SMF" MIDI
+     * input driver, which accepts capture files as well). The recorder
+     * follows the sample clock as AudioOutputDevice::RenderCycleListener,
+     * so events are timestamped with the beginning of the audio fragment
+     * cycle they arrived in. Only events which were dispatched with a
+     * fragment position are captured sample accurately. If the clocking
+     * audio device is destroyed while capturing, the time stamps stay at
+     * its last frame time.
+     *
+     * Record() is real-time safe: events are just pushed into a lock-free
+     * ring buffer, which is written to disk by a separate, non real-time
+     * writer thread. Record() may be called by several threads (i.e. the
+     * audio thread, MIDI input threads and control threads) concurrently:
+     * each call picks one of MAX_PRODUCERS ring buffers which is not used
+     * by another thread at that moment. Every event is numbered, so the
+     * order of the events can be restored when reading the file (see
+     * Parse()), at least for the events of each thread.
+     *
+     * File format (all values little endian): a header consisting of the
+     * magic "LSMC", the format version (uint32) and the sample rate of the
+     * clocking audio device (uint32), followed by one record per event:
+     * frame time (uint64), fragment position (int32, -1 if the event was not
+     * dispatched with a fragment position), sequence number (uint32), event
+     * size (uint16) and the raw MIDI event bytes.
+     */
+    class MidiEventRecorder : protected Thread, protected AudioOutputDevice::RenderCycleListener {
+        public:
+            /// One event read from a capture file.
+            struct CapturedEvent {
+                uint64_t frame;         ///< Sample clock of the audio device when the event was dispatched.
+                int32_t  fragmentPos;   ///< Fragment position of the event or -1 if none was given.
+                uint32_t sequence;      ///< Number of the event in the order it was recorded.
+                std::vector<uint8_t> data; ///< Raw MIDI event bytes.
+            };
+
+            /**
+             * Opens the given file for writing and starts the writer thread.
+             *
+             * @param FileName - path of the capture file to be written
+             * @param pClock   - audio device whose sample clock shall be used
+             *                   for timestamping the events (may be NULL)
+             * @throws MidiInputException - if file cannot be opened
+             */
+            MidiEventRecorder(String FileName, AudioOutputDevice* pClock) throw (MidiInputException);
+
+            /**
+             * Stops the writer thread, writes all pending events to disk and
+             * closes the file.
+             */
+            virtual ~MidiEventRecorder();
+
+            /**
+             * Logs the given raw MIDI event. This method is real-time safe.
+             *
+             * @param pData       - raw MIDI event bytes
+             * @param Size        - amount of bytes of the event
+             * @param FragmentPos - event's sample point position in the
+             *                      current audio fragment or -1
+             */
+            void Record(const uint8_t* pData, uint Size, int32_t FragmentPos);
+
+            /**
+             * Returns the amount of events which could not be logged,
+             * because the writer thread could not keep up (or because more
+             * than MAX_PRODUCERS threads were recording events at the same
+             * time).
+             */
+            uint DroppedEvents() const { return atomic_read(&droppedEvents); }
+
+            /**
+             * Returns the path of the capture file.
+             */
+            String FileName() const { return sFileName; }
+
+            /**
+             * Returns @c true if the given file starts with the magic of a
+             * MIDI capture file.
+             */
+            static bool IsCaptureFile(const std::vector<uint8_t>& data);
+
+            /**
+             * Parses the given content of a MIDI capture file.
+             *
+             * @param data       - content of the capture file
+             * @param records    - output: all events of the file, in the
+             *                     order they were recorded
+             * @param sampleRate - output: sample rate of the capture
+             * @throws MidiInputException - if file is invalid
+             */
+            static void Parse(const std::vector<uint8_t>& data, std::vector<CapturedEvent>& records, uint& sampleRate) throw (MidiInputException);
+
+        protected:
+            int Main(); ///< Implementation of virtual method from class Thread
+
+            // implementation of interface AudioOutputDevice::RenderCycleListener
+            virtual void OnRenderCycle(uint Samples, uint64_t FrameTime) OVERRIDE;
+            virtual void OnAudioDeviceDestroyed(AudioOutputDevice* pDevice) OVERRIDE;
+
+        private:
+            enum {
+                MAX_PRODUCERS = 8 ///< Max. amount of threads which may record events at the same time.
+            };
+
+            /// Ring buffer between Record() and the writer thread.
+            struct Producer {
+                RingBuffer<uint8_t,false>* buffer;
+                atomic_t unused; ///< 1 as long as no Record() call is writing to @c buffer.
+            };
+
+            FILE*               hFile;
+            String              sFileName;
+            AudioOutputDevice*  pClock; ///< Audio device providing the sample clock (NULL if none or if it was destroyed).
+            Mutex               clockMutex; ///< Protects @c pClock against concurrent destruction of the audio device. Not used by Record().
+            uint64_t            uiClockFrameTime; ///< Frame time of the current audio fragment cycle of @c pClock.
+            atomic<int>         clockSequence; ///< Odd while the audio thread is updating @c uiClockFrameTime, so Record() can detect (and retry) a torn read.
+            Producer            producers[MAX_PRODUCERS];
+            atomic_t            sequence; ///< Number of the next recorded event.
+            atomic_t            droppedEvents;
+            volatile bool       bStop;
+            Condition           wakeup;
+
+            uint64_t ClockFrameTime() const;
+            void Flush();
+    };
+
+} // namespace LinuxSampler
+
+#endif // __LS_MIDIEVENTRECORDER_H__
@@ -45,6 +45,8 @@
 # include "MidiInputDeviceJack.h"
 #endif // HAVE_JACK_MIDI
 
+#include "MidiInputDeviceSmf.h"
+
 namespace LinuxSampler {
 
     std::map<String, MidiInputDeviceFactory::InnerFactory*> MidiInputDeviceFactory::InnerFactories;
@@ -89,6 +91,16 @@ namespace LinuxSampler {
     REGISTER_MIDI_INPUT_DRIVER_PARAMETER(MidiInputDeviceJack, ParameterName);
 #endif // HAVE_JACK_MIDI
 
+    REGISTER_MIDI_INPUT_DRIVER(MidiInputDeviceSmf);
+    /* Common parameters */
+    REGISTER_MIDI_INPUT_DRIVER_PARAMETER(MidiInputDeviceSmf, ParameterActive);
+    REGISTER_MIDI_INPUT_DRIVER_PARAMETER(MidiInputDeviceSmf, ParameterPorts);
+    /* Driver specific parameters */
+    REGISTER_MIDI_INPUT_DRIVER_PARAMETER(MidiInputDeviceSmf, ParameterFileName);
+    REGISTER_MIDI_INPUT_DRIVER_PARAMETER(MidiInputDeviceSmf, ParameterAudioDevice);
+    REGISTER_MIDI_INPUT_DRIVER_PARAMETER(MidiInputDeviceSmf, ParameterLoop);
+    REGISTER_MIDI_INPUT_DRIVER_PARAMETER(MidiInputDeviceSmf, ParameterTempoScale);
+
     MidiInputDeviceFactory::MidiInputDeviceMap MidiInputDeviceFactory::mMidiInputDevices;
 
     /**
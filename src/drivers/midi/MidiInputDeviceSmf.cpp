@@ -0,0 +1,661 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#include "MidiInputDeviceSmf.h"
+#include "MidiInputDeviceFactory.h"
+#include "MidiEventRecorder.h"
+#include "../audio/AudioOutputDeviceFactory.h"
+
+#include <string.h>
+
+namespace LinuxSampler {
+
+// *************** MidiInputPortSmf ***************
+// *
+
+    MidiInputDeviceSmf::MidiInputPortSmf::MidiInputPortSmf(MidiInputDeviceSmf* pDevice, int portNumber)
+        : MidiInputPort(pDevice, portNumber) {
+    }
+
+
+
+// *************** ParameterFileName ***************
+// *
+
+    MidiInputDeviceSmf::ParameterFileName::ParameterFileName() : DeviceCreationParameterString() {
+        InitWithDefault();
+    }
+
+    MidiInputDeviceSmf::ParameterFileName::ParameterFileName(String s) throw (Exception) : DeviceCreationParameterString(s) {
+    }
+
+    String MidiInputDeviceSmf::ParameterFileName::Description() {
+        return "Path of the Standard MIDI File or MIDI capture file to be played";
+    }
+
+    bool MidiInputDeviceSmf::ParameterFileName::Fix() {
+        return true;
+    }
+
+    bool MidiInputDeviceSmf::ParameterFileName::Mandatory() {
+        return true;
+    }
+
+    std::map<String,DeviceCreationParameter*> MidiInputDeviceSmf::ParameterFileName::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<String> MidiInputDeviceSmf::ParameterFileName::DefaultAsString(std::map<String,String> Parameters) {
+        return optional<String>::nothing;
+    }
+
+    std::vector<String> MidiInputDeviceSmf::ParameterFileName::PossibilitiesAsString(std::map<String,String> Parameters) {
+        return std::vector<String>();
+    }
+
+    void MidiInputDeviceSmf::ParameterFileName::OnSetValue(String s) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String MidiInputDeviceSmf::ParameterFileName::Name() {
+        return "FILENAME";
+    }
+
+
+
+// *************** ParameterAudioDevice ***************
+// *
+
+    MidiInputDeviceSmf::ParameterAudioDevice::ParameterAudioDevice() : DeviceCreationParameterInt() {
+        InitWithDefault();
+    }
+
+    MidiInputDeviceSmf::ParameterAudioDevice::ParameterAudioDevice(String s) throw (Exception) : DeviceCreationParameterInt(s) {
+    }
+
+    String MidiInputDeviceSmf::ParameterAudioDevice::Description() {
+        return "ID of the audio output device clocking the playback";
+    }
+
+    bool MidiInputDeviceSmf::ParameterAudioDevice::Fix() {
+        return true;
+    }
+
+    bool MidiInputDeviceSmf::ParameterAudioDevice::Mandatory() {
+        return true;
+    }
+
+    std::map<String,DeviceCreationParameter*> MidiInputDeviceSmf::ParameterAudioDevice::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<int> MidiInputDeviceSmf::ParameterAudioDevice::DefaultAsInt(std::map<String,String> Parameters) {
+        return optional<int>::nothing;
+    }
+
+    optional<int> MidiInputDeviceSmf::ParameterAudioDevice::RangeMinAsInt(std::map<String,String> Parameters) {
+        return 0;
+    }
+
+    optional<int> MidiInputDeviceSmf::ParameterAudioDevice::RangeMaxAsInt(std::map<String,String> Parameters) {
+        return optional<int>::nothing;
+    }
+
+    std::vector<int> MidiInputDeviceSmf::ParameterAudioDevice::PossibilitiesAsInt(std::map<String,String> Parameters) {
+        std::vector<int> ids;
+        std::map<uint, AudioOutputDevice*> devices = AudioOutputDeviceFactory::Devices();
+        for (std::map<uint, AudioOutputDevice*>::iterator iter = devices.begin(); iter != devices.end(); ++iter)
+            if (iter->second) ids.push_back(iter->first);
+        return ids;
+    }
+
+    void MidiInputDeviceSmf::ParameterAudioDevice::OnSetValue(int i) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String MidiInputDeviceSmf::ParameterAudioDevice::Name() {
+        return "AUDIO_DEVICE";
+    }
+
+
+
+// *************** ParameterLoop ***************
+// *
+
+    MidiInputDeviceSmf::ParameterLoop::ParameterLoop() : DeviceCreationParameterBool() {
+        InitWithDefault();
+    }
+
+    MidiInputDeviceSmf::ParameterLoop::ParameterLoop(String s) throw (Exception) : DeviceCreationParameterBool(s) {
+    }
+
+    String MidiInputDeviceSmf::ParameterLoop::Description() {
+        return "Restart playback when end of file is reached";
+    }
+
+    bool MidiInputDeviceSmf::ParameterLoop::Fix() {
+        return true;
+    }
+
+    bool MidiInputDeviceSmf::ParameterLoop::Mandatory() {
+        return false;
+    }
+
+    std::map<String,DeviceCreationParameter*> MidiInputDeviceSmf::ParameterLoop::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<bool> MidiInputDeviceSmf::ParameterLoop::DefaultAsBool(std::map<String,String> Parameters) {
+        return false;
+    }
+
+    void MidiInputDeviceSmf::ParameterLoop::OnSetValue(bool b) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String MidiInputDeviceSmf::ParameterLoop::Name() {
+        return "LOOP";
+    }
+
+
+
+// *************** ParameterTempoScale ***************
+// *
+
+    MidiInputDeviceSmf::ParameterTempoScale::ParameterTempoScale() : DeviceCreationParameterFloat() {
+        InitWithDefault();
+    }
+
+    MidiInputDeviceSmf::ParameterTempoScale::ParameterTempoScale(String s) throw (Exception) : DeviceCreationParameterFloat(s) {
+    }
+
+    String MidiInputDeviceSmf::ParameterTempoScale::Description() {
+        return "Playback tempo factor (1.0 = original tempo)";
+    }
+
+    bool MidiInputDeviceSmf::ParameterTempoScale::Fix() {
+        return true;
+    }
+
+    bool MidiInputDeviceSmf::ParameterTempoScale::Mandatory() {
+        return false;
+    }
+
+    std::map<String,DeviceCreationParameter*> MidiInputDeviceSmf::ParameterTempoScale::DependsAsParameters() {
+        return std::map<String,DeviceCreationParameter*>(); // no dependencies
+    }
+
+    optional<float> MidiInputDeviceSmf::ParameterTempoScale::DefaultAsFloat(std::map<String,String> Parameters) {
+        return 1.0f;
+    }
+
+    optional<float> MidiInputDeviceSmf::ParameterTempoScale::RangeMinAsFloat(std::map<String,String> Parameters) {
+        return 0.01f;
+    }
+
+    optional<float> MidiInputDeviceSmf::ParameterTempoScale::RangeMaxAsFloat(std::map<String,String> Parameters) {
+        return 100.0f;
+    }
+
+    std::vector<float> MidiInputDeviceSmf::ParameterTempoScale::PossibilitiesAsFloat(std::map<String,String> Parameters) {
+        return std::vector<float>();
+    }
+
+    void MidiInputDeviceSmf::ParameterTempoScale::OnSetValue(float f) throw (Exception) {
+        // not posssible, as parameter is fix
+    }
+
+    String MidiInputDeviceSmf::ParameterTempoScale::Name() {
+        return "TEMPO_SCALE";
+    }
+
+
+
+// *************** Standard MIDI File parser ***************
+// *
+
+    namespace {
+
+        /// Event as read from one track, before all tracks are merged.
+        struct SmfTrackEvent {
+            uint64_t tick;
+            uint     track;
+            uint     seq;     ///< Position within the file (for stable ordering).
+            uint8_t  status;  ///< Channel voice status byte, 0xF0 for SysEx, 0xFF for tempo change.
+            uint8_t  data[2];
+            uint     tempo;   ///< Microseconds per quarter note (only for tempo changes).
+            uint     sysexOffset;
+            uint     sysexSize;
+        };
+
+        inline bool operator<(const SmfTrackEvent& a, const SmfTrackEvent& b) {
+            if (a.tick != b.tick) return a.tick < b.tick;
+            return a.seq < b.seq;
+        }
+
+        class SmfReader {
+        public:
+            SmfReader(const std::vector<uint8_t>& data, uint pos, uint end) : data(data), pos(pos), end(end) {}
+
+            bool eof() const { return pos >= end; }
+
+            uint8_t byte() throw (MidiInputException) {
+                if (pos >= end) throw MidiInputException("Unexpected end of MIDI track");
+                return data[pos++];
+            }
+
+            uint varLen() throw (MidiInputException) {
+                uint value = 0;
+                for (int i = 0; i < 4; ++i) {
+                    uint8_t b = byte();
+                    value = (value << 7) | (b & 0x7f);
+                    if (!(b & 0x80)) return value;
+                }
+                throw MidiInputException("Invalid variable length quantity in MIDI track");
+            }
+
+            void skip(uint n) throw (MidiInputException) {
+                if (end - pos < n) throw MidiInputException("Unexpected end of MIDI track");
+                pos += n;
+            }
+
+            uint position() const { return pos; }
+
+        private:
+            const std::vector<uint8_t>& data;
+            uint pos;
+            uint end;
+        };
+
+        inline uint readBE(const std::vector<uint8_t>& data, uint pos, int bytes) {
+            uint value = 0;
+            for (int i = 0; i < bytes; ++i) value = (value << 8) | data[pos + i];
+            return value;
+        }
+
+    } // anonymous namespace
+
+    /**
+     * Loads the given Standard MIDI File, merges all its tracks and converts
+     * all event positions from ticks to seconds.
+     *
+     * @throws MidiInputException - if file cannot be read or is invalid
+     */
+    void MidiInputDeviceSmf::LoadFile(String FileName) throw (MidiInputException) {
+        std::vector<uint8_t> data;
+        {
+            FILE* hFile = fopen(FileName.c_str(), "rb");
+            if (!hFile) throw MidiInputException("Could not open MIDI file '" + FileName + "'");
+            uint8_t buf[4096];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof(buf), hFile)) > 0)
+                data.insert(data.end(), buf, buf + n);
+            fclose(hFile);
+        }
+
+        if (MidiEventRecorder::IsCaptureFile(data)) {
+            LoadCaptureFile(data);
+            dmsg(2,("MidiInputDeviceSmf: loaded capture '%s' (%d events, %.1f s).\n",
+                    FileName.c_str(), int(vEvents.size()), fileLength));
+            return;
+        }
+
+        if (data.size() < 14 || memcmp(&data[0], "MThd", 4) != 0)
+            throw MidiInputException("'" + FileName + "' is not a Standard MIDI File");
+        const uint headerSize = readBE(data, 4, 4);
+        const uint format     = readBE(data, 8, 2);
+        const uint tracks     = readBE(data, 10, 2);
+        const uint division   = readBE(data, 12, 2);
+        if (format > 1)
+            throw MidiInputException("MIDI file format " + ToString(format) + " is not supported");
+        if (!division)
+            throw MidiInputException("Invalid time division in MIDI file");
+
+        // parse all tracks
+        std::vector<SmfTrackEvent> events;
+        uint64_t lastTick = 0;
+        uint pos = 8 + headerSize;
+        for (uint track = 0; track < tracks && pos + 8 <= data.size(); ++track) {
+            const uint chunkSize = readBE(data, pos + 4, 4);
+            const bool isTrack   = memcmp(&data[pos], "MTrk", 4) == 0;
+            pos += 8;
+            if (chunkSize > data.size() - pos)
+                throw MidiInputException("Truncated MIDI track");
+            if (!isTrack) { // skip unknown chunks
+                pos += chunkSize;
+                --track;
+                continue;
+            }
+            SmfReader reader(data, pos, pos + chunkSize);
+            pos += chunkSize;
+
+            uint64_t tick = 0;
+            uint8_t runningStatus = 0;
+            while (!reader.eof()) {
+                tick += reader.varLen();
+                uint8_t status = reader.byte();
+                SmfTrackEvent ev;
+                ev.tick  = tick;
+                ev.track = track;
+                ev.seq   = events.size();
+                ev.sysexOffset = ev.sysexSize = 0;
+                if (status == 0xff) { // meta event
+                    const uint8_t type = reader.byte();
+                    const uint len = reader.varLen();
+                    if (type == 0x51 && len == 3) { // tempo change
+                        ev.status = 0xff;
+                        ev.tempo  = reader.byte() << 16;
+                        ev.tempo |= reader.byte() << 8;
+                        ev.tempo |= reader.byte();
+                        events.push_back(ev);
+                    } else {
+                        reader.skip(len);
+                    }
+                    if (type == 0x2f) break; // end of track
+                } else if (status == 0xf0 || status == 0xf7) { // SysEx
+                    const uint len = reader.varLen();
+                    const uint start = reader.position();
+                    reader.skip(len);
+                    if (status == 0xf0) {
+                        ev.status      = 0xf0;
+                        ev.sysexOffset = vSysexData.size();
+                        ev.sysexSize   = len + 1;
+                        vSysexData.push_back(0xf0);
+                        vSysexData.insert(vSysexData.end(), data.begin() + start, data.begin() + start + len);
+                        events.push_back(ev);
+                    } // else: SysEx continuation / escape packet, ignored
+                } else { // channel voice message
+                    if (status & 0x80) {
+                        runningStatus = status;
+                        ev.data[0] = reader.byte();
+                    } else if (runningStatus) {
+                        ev.data[0] = status;
+                        status = runningStatus;
+                    } else {
+                        throw MidiInputException("Invalid running status in MIDI track");
+                    }
+                    ev.status = status;
+                    const uint8_t type = status & 0xf0;
+                    ev.data[1] = (type == 0xc0 || type == 0xd0) ? 0 : reader.byte();
+                    events.push_back(ev);
+                }
+            }
+            if (tick > lastTick) lastTick = tick;
+        }
+
+        std::stable_sort(events.begin(), events.end());
+
+        // convert ticks to seconds, applying the file's tempo map
+        double secondsPerTick;
+        const bool smpte = division & 0x8000;
+        if (smpte) {
+            const int fps = -(int8_t)(division >> 8);
+            secondsPerTick = 1.0 / double(fps * (division & 0xff));
+        } else {
+            secondsPerTick = 0.5 / double(division); // default tempo: 120 bpm
+        }
+        double time = 0.0;
+        uint64_t tick = 0;
+        vEvents.clear();
+        vEvents.reserve(events.size());
+        for (uint i = 0; i < events.size(); ++i) {
+            const SmfTrackEvent& ev = events[i];
+            time += double(ev.tick - tick) * secondsPerTick;
+            tick = ev.tick;
+            if (ev.status == 0xff) {
+                if (!smpte) secondsPerTick = double(ev.tempo) / (1000000.0 * double(division));
+                continue;
+            }
+            SmfEvent event;
+            event.time        = time;
+            event.frame       = 0;
+            event.data[0]     = ev.status;
+            event.data[1]     = ev.data[0];
+            event.data[2]     = ev.data[1];
+            event.sysexOffset = ev.sysexOffset;
+            event.sysexSize   = ev.sysexSize;
+            vEvents.push_back(event);
+        }
+        fileLength = time + double(lastTick - tick) * secondsPerTick;
+
+        dmsg(2,("MidiInputDeviceSmf: loaded '%s' (%d events, %.1f s).\n",
+                FileName.c_str(), int(vEvents.size()), fileLength));
+    }
+
+    /**
+     * Loads a MIDI capture file written by MidiEventRecorder. The captured
+     * sample clock is converted to seconds, so replay on an audio device
+     * with the same sample rate and fragment size dispatches every event in
+     * the same audio fragment it originally arrived in. Only events which
+     * were captured with a fragment position are replayed sample
+     * accurately, all others are dispatched at the beginning of their
+     * fragment.
+     *
+     * @throws MidiInputException - if file is invalid
+     */
+    void MidiInputDeviceSmf::LoadCaptureFile(const std::vector<uint8_t>& data) throw (MidiInputException) {
+        std::vector<MidiEventRecorder::CapturedEvent> records;
+        uint sampleRate;
+        MidiEventRecorder::Parse(data, records, sampleRate);
+        if (!sampleRate)
+            throw MidiInputException("Invalid sample rate in MIDI capture file");
+
+        vEvents.clear();
+        vEvents.reserve(records.size());
+        fileLength = 0.0;
+        // events of different threads are not recorded in chronological order
+        uint64_t firstFrame = (records.empty()) ? 0 : records[0].frame;
+        for (uint i = 1; i < records.size(); ++i)
+            if (records[i].frame < firstFrame) firstFrame = records[i].frame;
+        for (uint i = 0; i < records.size(); ++i) {
+            const MidiEventRecorder::CapturedEvent& record = records[i];
+            if (record.data.empty()) continue;
+            const int64_t frame = int64_t(record.frame - firstFrame) + ((record.fragmentPos > 0) ? record.fragmentPos : 0);
+            SmfEvent event;
+            event.time        = double(frame) / double(sampleRate);
+            event.frame       = 0;
+            event.data[0]     = record.data[0];
+            event.data[1]     = (record.data.size() > 1) ? record.data[1] : 0;
+            event.data[2]     = (record.data.size() > 2) ? record.data[2] : 0;
+            event.sysexOffset = event.sysexSize = 0;
+            if (record.data[0] == 0xf0) {
+                event.sysexOffset = vSysexData.size();
+                event.sysexSize   = record.data.size();
+                vSysexData.insert(vSysexData.end(), record.data.begin(), record.data.end());
+            } else if (record.data[0] < 0x80 || record.data[0] >= 0xf0) {
+                continue; // not a channel voice message
+            }
+            vEvents.push_back(event);
+            if (event.time > fileLength) fileLength = event.time;
+        }
+        // events dispatched without fragment position might be out of order,
+        // events with the same time stay in the order they were recorded
+        std::stable_sort(vEvents.begin(), vEvents.end());
+    }
+
+
+
+// *************** MidiInputDeviceSmf ***************
+// *
+
+    MidiInputDeviceSmf::MidiInputDeviceSmf(std::map<String,DeviceCreationParameter*> Parameters, void* pSampler) : MidiInputDevice(Parameters, pSampler) {
+        pAudioDevice   = NULL;
+        fileLength     = 0.0;
+        uiLengthFrames = 0;
+        uiNextEvent    = 0;
+        uiStartFrame   = 0;
+        bRestart       = true;
+        bFinished      = false;
+        memset(activeNotes, 0, sizeof(activeNotes));
+
+        iAudioDeviceID = ((DeviceCreationParameterInt*)Parameters["AUDIO_DEVICE"])->ValueAsInt();
+        bLoop          = ((DeviceCreationParameterBool*)Parameters["LOOP"])->ValueAsBool();
+        fTempoScale    = ((DeviceCreationParameterFloat*)Parameters["TEMPO_SCALE"])->ValueAsFloat();
+        LoadFile(((DeviceCreationParameterString*)Parameters["FILENAME"])->ValueAsString());
+
+        AcquirePorts(((DeviceCreationParameterInt*)Parameters["PORTS"])->ValueAsInt());
+        if (((DeviceCreationParameterBool*)Parameters["ACTIVE"])->ValueAsBool()) {
+            Listen();
+        }
+    }
+
+    MidiInputDeviceSmf::~MidiInputDeviceSmf() {
+        StopListen();
+        for (std::map<int,MidiInputPort*>::iterator iter = Ports.begin(); iter != Ports.end() ; iter++) {
+            delete static_cast<MidiInputPortSmf*>(iter->second);
+        }
+        Ports.clear();
+    }
+
+    /**
+     * Returns the audio device with the ID given by parameter 'AUDIO_DEVICE'
+     * or @c NULL if there is no such device (anymore).
+     */
+    AudioOutputDevice* MidiInputDeviceSmf::LookupAudioDevice() {
+        std::map<uint, AudioOutputDevice*> devices = AudioOutputDeviceFactory::Devices();
+        return (devices.count(iAudioDeviceID)) ? devices[iAudioDeviceID] : NULL;
+    }
+
+    void MidiInputDeviceSmf::Listen() {
+        if (pAudioDevice) return; // already listening
+        AudioOutputDevice* pDevice = LookupAudioDevice();
+        if (!pDevice)
+            throw MidiInputException("There is no audio output device with ID " + ToString(iAudioDeviceID));
+
+        // convert event positions to the audio device's sample clock
+        const double framesPerSecond = double(pDevice->SampleRate()) / double(fTempoScale);
+        for (uint i = 0; i < vEvents.size(); ++i)
+            vEvents[i].frame = uint64_t(vEvents[i].time * framesPerSecond + 0.5);
+        uiLengthFrames = uint64_t(fileLength * framesPerSecond + 0.5);
+
+        uiNextEvent = 0;
+        bRestart    = true;
+        bFinished   = false;
+        pAudioDevice = pDevice;
+        pAudioDevice->AddRenderCycleListener(this);
+    }
+
+    void MidiInputDeviceSmf::StopListen() {
+        if (!pAudioDevice) return;
+        // the audio device might have been destroyed in the meantime
+        if (LookupAudioDevice() == pAudioDevice)
+            pAudioDevice->RemoveRenderCycleListener(this);
+        pAudioDevice = NULL;
+        // audio thread doesn't touch us anymore, so release hanging notes
+        // directly from this thread
+        for (uint c = 0; c < 16; ++c) {
+            for (uint k = 0; k < 128; ++k) {
+                for (; activeNotes[c][k]; --activeNotes[c][k])
+                    for (std::map<int,MidiInputPort*>::iterator iter = Ports.begin(); iter != Ports.end(); ++iter)
+                        iter->second->DispatchNoteOff(k, 0, c);
+            }
+        }
+    }
+
+    /**
+     * Called by the audio thread at the beginning of each audio fragment
+     * cycle. Dispatches all events of the MIDI file which fall into the
+     * upcoming audio fragment, with sample accurate fragment positions.
+     */
+    void MidiInputDeviceSmf::OnRenderCycle(uint Samples, uint64_t FrameTime) {
+        if (bRestart) {
+            uiStartFrame = FrameTime;
+            uiNextEvent  = 0;
+            bRestart     = false;
+        }
+        const uint64_t fragmentEnd = FrameTime + Samples;
+        while (true) {
+            if (uiNextEvent >= vEvents.size()) {
+                if (!bLoop || !uiLengthFrames) {
+                    bFinished = true;
+                    return;
+                }
+                if (uiStartFrame + uiLengthFrames >= fragmentEnd) return;
+                // restart from the beginning of the file
+                uiStartFrame += uiLengthFrames;
+                uiNextEvent = 0;
+                ReleaseActiveNotes((uiStartFrame > FrameTime) ? uiStartFrame - FrameTime : 0);
+                continue;
+            }
+            const SmfEvent& event = vEvents[uiNextEvent];
+            const uint64_t frame = uiStartFrame + event.frame;
+            if (frame >= fragmentEnd) return;
+            Dispatch(event, (frame > FrameTime) ? frame - FrameTime : 0);
+            ++uiNextEvent;
+        }
+    }
+
+    void MidiInputDeviceSmf::Dispatch(const SmfEvent& event, int32_t FragmentPos) {
+        if (event.sysexSize) {
+            for (std::map<int,MidiInputPort*>::iterator iter = Ports.begin(); iter != Ports.end(); ++iter)
+                iter->second->DispatchSysex((void*) &vSysexData[event.sysexOffset], event.sysexSize);
+            return;
+        }
+        const uint8_t channel = event.data[0] & 0x0f;
+        const uint8_t key     = event.data[1] & 0x7f;
+        switch (event.data[0] & 0xf0) {
+            case 0x90:
+                if (event.data[2]) {
+                    if (activeNotes[channel][key] < 255) ++activeNotes[channel][key];
+                    break;
+                } // note-on with velocity zero is note-off, so fall through
+            case 0x80:
+                if (activeNotes[channel][key]) --activeNotes[channel][key];
+                break;
+        }
+        uint8_t data[3] = { event.data[0], event.data[1], event.data[2] };
+        for (std::map<int,MidiInputPort*>::iterator iter = Ports.begin(); iter != Ports.end(); ++iter)
+            iter->second->DispatchRaw(data, FragmentPos);
+    }
+
+    void MidiInputDeviceSmf::ReleaseActiveNotes(int32_t FragmentPos) {
+        for (uint c = 0; c < 16; ++c) {
+            for (uint k = 0; k < 128; ++k) {
+                for (; activeNotes[c][k]; --activeNotes[c][k])
+                    for (std::map<int,MidiInputPort*>::iterator iter = Ports.begin(); iter != Ports.end(); ++iter)
+                        iter->second->DispatchNoteOff(k, 0, c, FragmentPos);
+            }
+        }
+    }
+
+    String MidiInputDeviceSmf::Name() {
+        return "SMF";
+    }
+
+    String MidiInputDeviceSmf::Driver() {
+        return Name();
+    }
+
+    String MidiInputDeviceSmf::Description() {
+        return "Standard MIDI File player";
+    }
+
+    String MidiInputDeviceSmf::Version() {
+        String s = "$Revision$";
+        return s.substr(11, s.size() - 13); // cut dollar signs, spaces and CVS macro keyword
+    }
+
+    MidiInputPort* MidiInputDeviceSmf::CreateMidiPort() {
+        return new MidiInputPortSmf(this, Ports.size());
+    }
+
+} // namespace LinuxSampler
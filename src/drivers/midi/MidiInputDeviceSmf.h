@@ -0,0 +1,197 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#ifndef __LS_MIDIINPUTDEVICESMF_H__
+#define __LS_MIDIINPUTDEVICESMF_H__
+
+#include <vector>
+
+#include "../../common/global_private.h"
+#include "MidiInputDevice.h"
+#include "../audio/AudioOutputDevice.h"
+
+namespace LinuxSampler {
+
+    /** Standard MIDI File input driver
+     *
+     * Plays back a Standard MIDI File (format 0 or 1) as MIDI input. The
+     * driver has no clock on its own: it is driven by the sample clock of an
+     * audio output device, and all MIDI events are dispatched with sample
+     * accurate fragment positions right before the respective audio
+     * fragment is rendered. So the same file played on the same instruments
+     * always leads to exactly the same event stream, which makes this driver
+     * suitable (especially together with the offline "FILE" audio driver)
+     * for reproducible load tests and regression tests.
+     *
+     * Instead of a Standard MIDI File, a MIDI capture file written by
+     * MidiEventRecorder (see MIDI port parameter "CAPTURE_FILE") can be
+     * played as well, to replay a live performance with audio fragment
+     * accuracy.
+     */
+    class MidiInputDeviceSmf : public MidiInputDevice, protected AudioOutputDevice::RenderCycleListener {
+        public:
+            /**
+             * MIDI Port implementation for the Standard MIDI File driver.
+             */
+            class MidiInputPortSmf : public MidiInputPort {
+                protected:
+                    MidiInputPortSmf(MidiInputDeviceSmf* pDevice, int portNumber);
+                    friend class MidiInputDeviceSmf;
+            };
+
+            /** MIDI Device Parameter 'FILENAME'
+             *
+             * Path of the Standard MIDI File to be played.
+             */
+            class ParameterFileName : public DeviceCreationParameterString {
+                public:
+                    ParameterFileName();
+                    ParameterFileName(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<String>    DefaultAsString(std::map<String,String> Parameters) OVERRIDE;
+                    virtual std::vector<String> PossibilitiesAsString(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void                OnSetValue(String s) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+            /** MIDI Device Parameter 'AUDIO_DEVICE'
+             *
+             * Numerical ID of the audio output device whose sample clock
+             * shall drive the playback of the MIDI file.
+             */
+            class ParameterAudioDevice : public DeviceCreationParameterInt {
+                public:
+                    ParameterAudioDevice();
+                    ParameterAudioDevice(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<int>    DefaultAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<int>    RangeMinAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<int>    RangeMaxAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual std::vector<int> PossibilitiesAsInt(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void             OnSetValue(int i) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+            /** MIDI Device Parameter 'LOOP'
+             *
+             * Whether playback shall restart from the beginning once the end
+             * of the MIDI file was reached.
+             */
+            class ParameterLoop : public DeviceCreationParameterBool {
+                public:
+                    ParameterLoop();
+                    ParameterLoop(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<bool> DefaultAsBool(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void OnSetValue(bool b) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+            /** MIDI Device Parameter 'TEMPO_SCALE'
+             *
+             * Factor applied to the tempo of the MIDI file, i.e. 2.0 plays
+             * the file twice as fast as notated.
+             */
+            class ParameterTempoScale : public DeviceCreationParameterFloat {
+                public:
+                    ParameterTempoScale();
+                    ParameterTempoScale(String s) throw (Exception);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual bool   Mandatory() OVERRIDE;
+                    virtual std::map<String,DeviceCreationParameter*> DependsAsParameters() OVERRIDE;
+                    virtual optional<float>    DefaultAsFloat(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<float>    RangeMinAsFloat(std::map<String,String> Parameters) OVERRIDE;
+                    virtual optional<float>    RangeMaxAsFloat(std::map<String,String> Parameters) OVERRIDE;
+                    virtual std::vector<float> PossibilitiesAsFloat(std::map<String,String> Parameters) OVERRIDE;
+                    virtual void OnSetValue(float f) throw (Exception) OVERRIDE;
+                    static String Name();
+            };
+
+            MidiInputDeviceSmf(std::map<String,DeviceCreationParameter*> Parameters, void* pSampler);
+            virtual ~MidiInputDeviceSmf();
+
+            // derived abstract methods from class 'MidiInputDevice'
+            void Listen() OVERRIDE;
+            void StopListen() OVERRIDE;
+            String Driver() OVERRIDE;
+            static String Name();
+            static String Description();
+            static String Version();
+            MidiInputPort* CreateMidiPort() OVERRIDE;
+
+            /**
+             * Returns @c true if the end of the MIDI file was reached (never
+             * the case if looping is enabled).
+             */
+            bool IsFinished() const { return bFinished; }
+
+        protected:
+            // implementation of interface AudioOutputDevice::RenderCycleListener
+            virtual void OnRenderCycle(uint Samples, uint64_t FrameTime) OVERRIDE;
+
+        private:
+            /// One MIDI event of the loaded file.
+            struct SmfEvent {
+                double   time;        ///< Position in seconds from the beginning of the file (at original tempo).
+                uint64_t frame;       ///< Position in sample points from the beginning of the file (computed on Listen()).
+                uint8_t  data[3];     ///< Channel voice message (unused for SysEx).
+                uint     sysexOffset; ///< Start of SysEx message in vSysexData.
+                uint     sysexSize;   ///< Length of SysEx message (0 for channel voice messages).
+
+                bool operator<(const SmfEvent& other) const { return time < other.time; }
+            };
+
+            std::vector<SmfEvent> vEvents;    ///< All events of all tracks, merged and sorted by time.
+            std::vector<uint8_t>  vSysexData; ///< SysEx message payloads (including leading 0xF0).
+            double   fileLength;              ///< Duration of the MIDI file in seconds (at original tempo).
+            uint64_t uiLengthFrames;          ///< Duration of the MIDI file in sample points (computed on Listen()).
+            int      iAudioDeviceID;
+            AudioOutputDevice* pAudioDevice;  ///< Audio device currently driving the playback (NULL if not listening).
+            bool     bLoop;
+            float    fTempoScale;
+
+            // playback state (only accessed by audio thread while listening)
+            uint     uiNextEvent;
+            uint64_t uiStartFrame;            ///< Audio device frame time of the current playback cycle's start.
+            bool     bRestart;
+            volatile bool bFinished;
+            uint8_t  activeNotes[16][128];    ///< For releasing notes still hanging on loop and stop.
+
+            void LoadFile(String FileName) throw (MidiInputException);
+            void LoadCaptureFile(const std::vector<uint8_t>& data) throw (MidiInputException);
+            void Dispatch(const SmfEvent& event, int32_t FragmentPos);
+            void ReleaseActiveNotes(int32_t FragmentPos);
+            AudioOutputDevice* LookupAudioDevice();
+    };
+}
+
+#endif // __LS_MIDIINPUTDEVICESMF_H__
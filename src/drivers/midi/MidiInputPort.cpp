@@ -28,6 +28,7 @@
 #include "../../Sampler.h"
 #include "../../engines/EngineFactory.h"
 #include "VirtualMidiDevice.h"
+#include "MidiEventRecorder.h"
 
 #include <algorithm>
 
@@ -62,10 +63,36 @@ namespace LinuxSampler {
 
 
 
+// *************** ParameterCaptureFile ***************
+// *
+
+    MidiInputPort::ParameterCaptureFile::ParameterCaptureFile(MidiInputPort* pPort) : DeviceRuntimeParameterString("") {
+        this->pPort = pPort;
+    }
+
+    String MidiInputPort::ParameterCaptureFile::Description() {
+        return "File all MIDI events of this port are captured to (empty: capturing disabled)";
+    }
+
+    bool MidiInputPort::ParameterCaptureFile::Fix() {
+        return false;
+    }
+
+    std::vector<String> MidiInputPort::ParameterCaptureFile::PossibilitiesAsString() {
+        return std::vector<String>();
+    }
+
+    void MidiInputPort::ParameterCaptureFile::OnSetValue(String s) throw (Exception) {
+        pPort->SetCaptureFile(s);
+    }
+
+
+
 // *************** MidiInputPort ***************
 // *
 
     MidiInputPort::~MidiInputPort() {
+        SetCaptureFile("");
         std::map<String,DeviceRuntimeParameter*>::iterator iter = Parameters.begin();
         while (iter != Parameters.end()) {
             delete iter->second;
@@ -78,12 +105,16 @@ namespace LinuxSampler {
         : MidiChannelMapReader(MidiChannelMap),
           SysexListenersReader(SysexListeners),
           virtualMidiDevicesReader(virtualMidiDevices),
-          noteOnVelocityFilterReader(noteOnVelocityFilter)
+          noteOnVelocityFilterReader(noteOnVelocityFilter),
+          captureRecorderReader(captureRecorder)
     {
         this->pDevice = pDevice;
         this->portNumber = portNumber;
         runningStatusBuf[0] = 0;
+        captureRecorder.GetConfigForUpdate() = NULL;
+        captureRecorder.SwitchConfig() = NULL;
         Parameters["NAME"] = new ParameterName(this);
+        Parameters["CAPTURE_FILE"] = new ParameterCaptureFile(this);
     }
 
     MidiInputDevice* MidiInputPort::GetDevice() {
@@ -100,6 +131,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchNoteOn(uint8_t Key, uint8_t Velocity, uint MidiChannel) {
         if (Key > 127 || Velocity > 127 || MidiChannel > 16) return;
+        CaptureEvent(0x90, Key, Velocity, MidiChannel, -1);
         
         // apply velocity filter (if any)
         const std::vector<uint8_t>& velocityFilter = noteOnVelocityFilterReader.Lock();
@@ -131,6 +163,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchNoteOn(uint8_t Key, uint8_t Velocity, uint MidiChannel, int32_t FragmentPos) {
         if (Key > 127 || Velocity > 127 || MidiChannel > 16) return;
+        CaptureEvent(0x90, Key, Velocity, MidiChannel, FragmentPos);
         
         // apply velocity filter (if any)
         const std::vector<uint8_t>& velocityFilter = noteOnVelocityFilterReader.Lock();
@@ -162,6 +195,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchNoteOff(uint8_t Key, uint8_t Velocity, uint MidiChannel) {
         if (Key > 127 || Velocity > 127 || MidiChannel > 16) return;
+        CaptureEvent(0x80, Key, Velocity, MidiChannel, -1);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -187,6 +221,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchNoteOff(uint8_t Key, uint8_t Velocity, uint MidiChannel, int32_t FragmentPos) {
         if (Key > 127 || Velocity > 127 || MidiChannel > 16) return;
+        CaptureEvent(0x80, Key, Velocity, MidiChannel, FragmentPos);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -212,6 +247,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchPitchbend(int Pitch, uint MidiChannel) {
         if (Pitch < -8192 || Pitch > 8191 || MidiChannel > 16) return;
+        CaptureEvent(0xe0, (Pitch + 8192) & 0x7f, ((Pitch + 8192) >> 7) & 0x7f, MidiChannel, -1);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -230,6 +266,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchPitchbend(int Pitch, uint MidiChannel, int32_t FragmentPos) {
         if (Pitch < -8192 || Pitch > 8191 || MidiChannel > 16) return;
+        CaptureEvent(0xe0, (Pitch + 8192) & 0x7f, ((Pitch + 8192) >> 7) & 0x7f, MidiChannel, FragmentPos);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -248,6 +285,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchChannelPressure(uint8_t Value, uint MidiChannel) {
         if (Value > 127 || MidiChannel > 16) return;
+        CaptureEvent(0xd0, Value, 0, MidiChannel, -1);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -266,6 +304,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchChannelPressure(uint8_t Value, uint MidiChannel, int32_t FragmentPos) {
         if (Value > 127 || MidiChannel > 16) return;
+        CaptureEvent(0xd0, Value, 0, MidiChannel, FragmentPos);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -284,6 +323,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchPolyphonicKeyPressure(uint8_t Key, uint8_t Value, uint MidiChannel) {
         if (Key > 127 || Value > 127 || MidiChannel > 16) return;
+        CaptureEvent(0xa0, Key, Value, MidiChannel, -1);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -302,6 +342,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchPolyphonicKeyPressure(uint8_t Key, uint8_t Value, uint MidiChannel, int32_t FragmentPos) {
         if (Key > 127 || Value > 127 || MidiChannel > 16) return;
+        CaptureEvent(0xa0, Key, Value, MidiChannel, FragmentPos);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -320,6 +361,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchControlChange(uint8_t Controller, uint8_t Value, uint MidiChannel) {
         if (Controller > 128 || Value > 127 || MidiChannel > 16) return;
+        CaptureEvent(0xb0, Controller, Value, MidiChannel, -1);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -345,6 +387,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchControlChange(uint8_t Controller, uint8_t Value, uint MidiChannel, int32_t FragmentPos) {
         if (Controller > 128 || Value > 127 || MidiChannel > 16) return;
+        CaptureEvent(0xb0, Controller, Value, MidiChannel, FragmentPos);
         const MidiChannelMap_t& midiChannelMap = MidiChannelMapReader.Lock();
         // dispatch event for engines listening to the same MIDI channel
         {
@@ -369,6 +412,11 @@ namespace LinuxSampler {
     }
 
     void MidiInputPort::DispatchSysex(void* pData, uint Size) {
+        {
+            MidiEventRecorder* pRecorder = captureRecorderReader.Lock();
+            if (pRecorder) pRecorder->Record((const uint8_t*)pData, Size, -1);
+            captureRecorderReader.Unlock();
+        }
         const std::set<Engine*> allEngines = SysexListenersReader.Lock();
         // dispatch event to all engine instances
         std::set<Engine*>::iterator engineiter = allEngines.begin();
@@ -379,6 +427,7 @@ namespace LinuxSampler {
 
     void MidiInputPort::DispatchProgramChange(uint8_t Program, uint MidiChannel) {
         if (Program > 127 || MidiChannel > 16) return;
+        CaptureEvent(0xc0, Program, 0, MidiChannel, -1);
         if (!pDevice || !pDevice->pSampler) {
             std::cerr << "MidiInputPort: ERROR, no sampler instance to handle program change."
                       << "This is a bug, please report it!\n" << std::flush;
@@ -588,6 +637,43 @@ namespace LinuxSampler {
         }
     }
 
+    void MidiInputPort::SetCaptureFile(String FileName) {
+        LockGuard lock(captureRecorderMutex);
+        MidiEventRecorder* pOldRecorder = captureRecorder.GetConfigForUpdate();
+        MidiEventRecorder* pNewRecorder = NULL;
+        if (!FileName.empty()) {
+            // the sample clock of the audio device of a connected sampler
+            // channel is used for timestamping the captured events
+            AudioOutputDevice* pClock = NULL;
+            {
+                LockGuard mapLock(MidiChannelMapMutex);
+                MidiChannelMap_t& midiChannelMap = MidiChannelMap.GetConfigForUpdate();
+                for (int i = 0; i <= 16 && !pClock; ++i) {
+                    std::set<EngineChannel*>::iterator it = midiChannelMap[i].begin();
+                    for (; it != midiChannelMap[i].end() && !pClock; ++it)
+                        pClock = (*it)->GetAudioOutputDevice();
+                }
+            }
+            if (!pClock)
+                throw MidiInputException("MIDI capture requires this port to be connected to a sampler channel with an audio output device");
+            pNewRecorder = new MidiEventRecorder(FileName, pClock);
+        }
+        captureRecorder.GetConfigForUpdate() = pNewRecorder;
+        captureRecorder.SwitchConfig() = pNewRecorder;
+        // MIDI thread is no longer using the old recorder at this point
+        if (pOldRecorder) delete pOldRecorder;
+    }
+
+    void MidiInputPort::CaptureEvent(uint8_t Status, uint8_t Data1, uint8_t Data2, uint MidiChannel, int32_t FragmentPos) {
+        MidiEventRecorder* pRecorder = captureRecorderReader.Lock();
+        if (pRecorder) {
+            const uint8_t data[3] = { uint8_t(Status | (MidiChannel & 0x0f)), Data1, Data2 };
+            const uint size = (Status == 0xc0 || Status == 0xd0) ? 2 : 3;
+            pRecorder->Record(data, size, FragmentPos);
+        }
+        captureRecorderReader.Unlock();
+    }
+
     void MidiInputPort::Connect(EngineChannel* pEngineChannel, midi_chan_t MidiChannel) {
         if (MidiChannel < 0 || MidiChannel > 16)
             throw MidiInputException("MIDI channel index out of bounds");
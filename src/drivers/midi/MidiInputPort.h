@@ -39,6 +39,7 @@ namespace LinuxSampler {
     class MidiInputDevice;
     class EngineChannel;
     class VirtualMidiDevice;
+    class MidiEventRecorder;
 
     class MidiInputPort {
         public:
@@ -62,6 +63,23 @@ namespace LinuxSampler {
                     MidiInputPort* pPort;
             };
 
+            /** MIDI Port Parameter 'CAPTURE_FILE'
+             *
+             * Setting a file name starts capturing all MIDI events of this
+             * port to that file (see MidiEventRecorder), setting an empty
+             * string stops capturing.
+             */
+            class ParameterCaptureFile : public DeviceRuntimeParameterString {
+                public:
+                    ParameterCaptureFile(MidiInputPort* pPort);
+                    virtual String Description() OVERRIDE;
+                    virtual bool   Fix() OVERRIDE;
+                    virtual std::vector<String> PossibilitiesAsString() OVERRIDE;
+                    virtual void OnSetValue(String s) throw (Exception) OVERRIDE;
+                protected:
+                    MidiInputPort* pPort;
+            };
+
 
 
             /////////////////////////////////////////////////////////////////
@@ -157,6 +175,22 @@ namespace LinuxSampler {
              */
             void SetNoteOnVelocityFilter(const std::vector<uint8_t>& filter);
 
+            /**
+             * Starts capturing all MIDI events arriving on this port to the
+             * given file, timestamped with the sample clock of the audio
+             * output device of a sampler channel connected to this port
+             * when capturing starts. The resulting capture file can be
+             * replayed with the "SMF" MIDI input driver. Passing an empty
+             * string stops capturing.
+             *
+             * @param FileName - path of the capture file or empty string
+             * @throws MidiInputException - if file cannot be opened or if
+             *                              port is not connected to any
+             *                              sampler channel with an audio
+             *                              output device
+             */
+            void SetCaptureFile(String FileName);
+
 
             /////////////////////////////////////////////////////////////////
             // dispatch methods
@@ -480,6 +514,9 @@ namespace LinuxSampler {
             SynchronizedConfig<std::vector<uint8_t> >::Reader noteOnVelocityFilterReader;
             Mutex noteOnVelocityFilterMutex;
             uint8_t runningStatusBuf[3];
+            SynchronizedConfig<MidiEventRecorder*> captureRecorder; ///< Recorder for capturing MIDI events to a file (NULL if not capturing).
+            SynchronizedConfig<MidiEventRecorder*>::Reader captureRecorderReader; ///< MIDI thread access to captureRecorder
+            Mutex captureRecorderMutex;
 
             /**
              * Constructor
@@ -515,6 +552,7 @@ namespace LinuxSampler {
             static SynchronizedConfig<std::set<Engine*> > SysexListeners; ///< All engines that are listening to sysex messages.
             
             uint8_t* handleRunningStatus(uint8_t* pData);
+            void CaptureEvent(uint8_t Status, uint8_t Data1, uint8_t Data2, uint MidiChannel, int32_t FragmentPos);
     };
 
 } // namsepace LinuxSampler
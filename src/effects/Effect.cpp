@@ -25,6 +25,7 @@ namespace LinuxSampler {
 Effect::Effect() {
     pParent = NULL;
     iID = -1;
+    fCpuLoad = 0.0f;
 }
 
 Effect::~Effect() {
@@ -84,4 +85,13 @@ int Effect::ID() const {
     return iID;
 }
 
+float Effect::CpuLoad() const {
+    return fCpuLoad;
+}
+
+void Effect::UpdateCpuLoad(float fLoad) {
+    // exponential moving average over roughly the last 16 cycles
+    fCpuLoad += (fLoad - fCpuLoad) * 0.0625f;
+}
+
 } // namespace LinuxSampler
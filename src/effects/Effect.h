@@ -53,6 +53,14 @@ public:
      * Use the input audio signal given with @a ppInputChannels, render the
      * effect and mix the result into the effect's output channels.
      *
+     * The effect chain might let the input channels refer to the output
+     * buffers of the previous effect in the chain for the duration of this
+     * call, so the effect must retrieve the channels' buffers on each call
+     * and must not modify its input signal. Input buffers should be
+     * retrieved with AudioChannel::ConstBuffer(), output buffers have to be
+     * retrieved with AudioChannel::Buffer() though, so the output channels
+     * are not regarded as silent anymore.
+     *
      * @param Samples - amount of sample points to process
      */
     virtual void RenderAudio(uint Samples) = 0;
@@ -150,6 +158,23 @@ public:
      */
     int ID() const;
 
+    /**
+     * Returns the average share of the audio fragment cycle time spent in
+     * RenderAudio() of this effect (in percent), as measured by the effect
+     * chain the effect is part of. Bypassed effects and effects skipped due
+     * to silence don't consume any time.
+     */
+    float CpuLoad() const;
+
+    /**
+     * Updates the average returned by CpuLoad() with a new measurement.
+     * This method is usually only called by the EffectChain class.
+     *
+     * @param fLoad - share of the current audio fragment cycle time spent
+     *                in RenderAudio() (in percent)
+     */
+    void UpdateCpuLoad(float fLoad);
+
 protected:
     std::vector<AudioChannel*> vInputChannels;
     std::vector<AudioChannel*> vOutputChannels;
@@ -157,6 +182,7 @@ protected:
     std::vector<EffectControl*> vOutputControls; ///< yet unused
     void* pParent;
     int iID;
+    float fCpuLoad;
 };
 
 } // namespace LinuxSampler
@@ -21,19 +21,51 @@
 #include "EffectChain.h"
 
 #include "../common/global_private.h"
+#include "../common/RTMath.h"
+#include "../drivers/audio/AudioOutputDevice.h"
+
+/// Signals whose peak stays below this level (-120 dB) are regarded as silent.
+#define SILENCE_THRESHOLD 0.000001f
 
 namespace LinuxSampler {
 
+/// Whether the first @a Samples sample points of the given channel are silent.
+static bool _isSilent(AudioChannel* pChannel, uint Samples) {
+    const float* pBuffer = pChannel->ConstBuffer();
+    const uint n = std::min(Samples, pChannel->SilentFrom());
+    for (uint i = 0; i < n; ++i)
+        if (pBuffer[i] > SILENCE_THRESHOLD || pBuffer[i] < -SILENCE_THRESHOLD)
+            return false;
+    return true;
+}
+
+static bool _isInputSilent(Effect* pEffect, uint Samples) {
+    for (int i = 0; i < pEffect->InputChannelCount(); ++i)
+        if (!_isSilent(pEffect->InputChannel(i), Samples)) return false;
+    return true;
+}
+
+static bool _isOutputSilent(Effect* pEffect, uint Samples) {
+    for (int i = 0; i < pEffect->OutputChannelCount(); ++i)
+        if (!_isSilent(pEffect->OutputChannel(i), Samples)) return false;
+    return true;
+}
+
 EffectChain::EffectChain(AudioOutputDevice* pDevice, int iEffectChainId) {
     this->pDevice = pDevice;
     iID = iEffectChainId;
+    pOutput = NULL;
+    bOutputIsInput = false;
+    tsLastCycle = 0;
+    UpdateSilenceHold();
 }
 
 void EffectChain::AppendEffect(Effect* pEffect) {
     pEffect->InitEffect(pDevice);
-    _ChainEntry entry = { pEffect, true };
+    _ChainEntry entry = { pEffect, true, false, 0 };
     vEntries.push_back(entry);
     pEffect->SetParent(this);
+    UpdateInputBufferCache();
 }
 
 void EffectChain::InsertEffect(Effect* pEffect, int iChainPos) throw (Exception) {
@@ -45,9 +77,10 @@ void EffectChain::InsertEffect(Effect* pEffect, int iChainPos) throw (Exception)
     pEffect->InitEffect(pDevice); // might throw Exception !
     std::vector<_ChainEntry>::iterator iter = vEntries.begin();
     for (int i = 0; i < iChainPos; ++i) ++iter;
-    _ChainEntry entry = { pEffect, true };
+    _ChainEntry entry = { pEffect, true, false, 0 };
     vEntries.insert(iter, entry);
     pEffect->SetParent(this);
+    UpdateInputBufferCache();
 }
 
 void EffectChain::RemoveEffect(int iChainPos) throw (Exception) {
@@ -61,30 +94,101 @@ void EffectChain::RemoveEffect(int iChainPos) throw (Exception) {
     Effect* pEffect = (*iter).pEffect;
     vEntries.erase(iter);
     pEffect->SetParent(NULL); // mark effect as not in use anymore
+    if (pOutput == pEffect) pOutput = NULL;
 }
 
 void EffectChain::RenderAudio(uint Samples) {
+    const RTMath::time_stamp_t tsCycle = RTMath::CreateTimeStamp();
+    const RTMath::time_stamp_t tsPeriod = tsCycle - tsLastCycle;
+    const bool bMeasure = tsLastCycle && tsPeriod; // not on the very first cycle
+    tsLastCycle = tsCycle;
+
+    // the signal between the effects, being either the output or the input
+    // channels of the effect pSignal (NULL if silent)
+    Effect* pSignal = NULL;
+    bool bSignalIsInput = false;
+
     for (int i = 0; i < vEntries.size(); ++i) {
-        Effect* pCurrentEffect = vEntries[i].pEffect;
-        if (i) { // import signal from previous effect
-            Effect* pPrevEffect = vEntries[i - 1].pEffect;
-            for (int iChan = 0; iChan < pPrevEffect->OutputChannelCount() && iChan < pCurrentEffect->InputChannelCount(); ++iChan) {
-                pPrevEffect->OutputChannel(iChan)->MixTo(
-                    pCurrentEffect->InputChannel(iChan),
-                    Samples
-                );
+        _ChainEntry& entry = vEntries[i];
+        Effect* pCurrentEffect = entry.pEffect;
+        // whether something was sent directly to this effect (i.e. by a FX send)
+        const bool bOwnInputSilent = _isInputSilent(pCurrentEffect, Samples);
+        const int nSignalChannels = !pSignal ? 0 : (bSignalIsInput)
+            ? pSignal->InputChannelCount() : pSignal->OutputChannelCount();
+        const int nChannels = std::min(nSignalChannels, (int)pCurrentEffect->InputChannelCount());
+
+        if (!bOwnInputSilent && pSignal) { // import signal from previous effect
+            for (int iChan = 0; iChan < nChannels; ++iChan) {
+                AudioChannel* pSrc = (bSignalIsInput)
+                    ? pSignal->InputChannel(iChan) : pSignal->OutputChannel(iChan);
+                pSrc->MixTo(pCurrentEffect->InputChannel(iChan), Samples);
             }
         }
-        if (IsEffectActive(i)) pCurrentEffect->RenderAudio(Samples);
-        else { //TODO: lazy, suboptimal implementation of inactive, bypassed effects
-            for (int iChan = 0; iChan < pCurrentEffect->OutputChannelCount() && iChan < pCurrentEffect->InputChannelCount(); ++iChan) {
-                pCurrentEffect->InputChannel(iChan)->MixTo(
-                    pCurrentEffect->OutputChannel(iChan),
-                    Samples
-                );
+
+        if (!entry.bActive) { // bypass
+            if (!bOwnInputSilent) {
+                pSignal = pCurrentEffect;
+                bSignalIsInput = true;
+            }
+            if (bMeasure) pCurrentEffect->UpdateCpuLoad(0.0f);
+            continue;
+        }
+
+        const bool bInputSilent = bOwnInputSilent && !pSignal;
+        if (bInputSilent && entry.bIdle) { // nothing to do until there is some input again
+            if (bMeasure) pCurrentEffect->UpdateCpuLoad(0.0f);
+            continue;
+        }
+
+        // let the input channels refer to the previous effect's output
+        // buffers directly if there is nothing to be mixed with
+        const bool bZeroCopy = bOwnInputSilent && pSignal;
+        if (bZeroCopy) {
+            for (int iChan = 0; iChan < nChannels; ++iChan) {
+                AudioChannel* pSrc = (bSignalIsInput)
+                    ? pSignal->InputChannel(iChan) : pSignal->OutputChannel(iChan);
+                AudioChannel* pDst = pCurrentEffect->InputChannel(iChan);
+                vInputBuffers[iChan] = pDst->Buffer();
+                pDst->SetBuffer(pSrc->Buffer());
             }
         }
+
+        const RTMath::time_stamp_t tsStart = RTMath::CreateTimeStamp();
+        pCurrentEffect->RenderAudio(Samples);
+        const RTMath::time_stamp_t tsEnd = RTMath::CreateTimeStamp();
+        if (bMeasure)
+            pCurrentEffect->UpdateCpuLoad(100.0f * float(tsEnd - tsStart) / float(tsPeriod));
+
+        if (bZeroCopy) {
+            for (int iChan = 0; iChan < nChannels; ++iChan)
+                pCurrentEffect->InputChannel(iChan)->SetBuffer(vInputBuffers[iChan]);
+        }
+
+        // without input, the effect can be skipped as soon as its tail decayed
+        const bool bSilent = bInputSilent && _isOutputSilent(pCurrentEffect, Samples);
+        if (!bSilent) entry.uiSilentSamples = 0;
+        else if (entry.uiSilentSamples < uiSilenceHold) entry.uiSilentSamples += Samples;
+        #if CONFIG_FX_SILENCE_HOLD
+        entry.bIdle = bSilent && entry.uiSilentSamples >= uiSilenceHold;
+        #endif
+        pSignal = (bSilent) ? NULL : pCurrentEffect;
+        bSignalIsInput = false;
     }
+
+    pOutput = pSignal;
+    bOutputIsInput = bSignalIsInput;
+}
+
+AudioChannel* EffectChain::OutputChannel(uint iChannel) const {
+    if (!pOutput) return NULL;
+    return (bOutputIsInput)
+        ? pOutput->InputChannel(iChannel) : pOutput->OutputChannel(iChannel);
+}
+
+uint EffectChain::OutputChannelCount() const {
+    if (!pOutput) return 0;
+    return (bOutputIsInput)
+        ? pOutput->InputChannelCount() : pOutput->OutputChannelCount();
 }
 
 Effect* EffectChain::GetEffect(int iChainPos) const {
@@ -97,10 +201,28 @@ int EffectChain::EffectCount() const {
 }
     
 void EffectChain::Reconnect(AudioOutputDevice* pDevice) {
+    this->pDevice = pDevice;
     for (int i = 0; i < vEntries.size(); ++i) {
         Effect* pEffect = vEntries[i].pEffect;
         pEffect->InitEffect(pDevice);
+        vEntries[i].bIdle = false;
+        vEntries[i].uiSilentSamples = 0;
     }
+    pOutput = NULL;
+    tsLastCycle = 0;
+    UpdateInputBufferCache();
+    UpdateSilenceHold();
+}
+
+void EffectChain::UpdateInputBufferCache() {
+    uint n = 0;
+    for (int i = 0; i < vEntries.size(); ++i)
+        n = std::max(n, vEntries[i].pEffect->InputChannelCount());
+    vInputBuffers.resize(n);
+}
+
+void EffectChain::UpdateSilenceHold() {
+    uiSilenceHold = (pDevice) ? CONFIG_FX_SILENCE_HOLD * pDevice->SampleRate() : 0;
 }
 
 void EffectChain::SetEffectActive(int iChainPos, bool bOn) throw (Exception) {
@@ -110,6 +232,8 @@ void EffectChain::SetEffectActive(int iChainPos, bool bOn) throw (Exception) {
             ToString(iChainPos) + ", index out of bounds."
         );
     vEntries[iChainPos].bActive = bOn;
+    vEntries[iChainPos].bIdle = false;
+    vEntries[iChainPos].uiSilentSamples = 0;
 }
 
 bool EffectChain::IsEffectActive(int iChainPos) const {
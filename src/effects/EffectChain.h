@@ -32,6 +32,14 @@ class AudioOutputDevice;
  * Container for a series of effects. The effects are sequentially processed,
  * that is the output of the first effect is passed to the input of the next
  * effect in the chain and so on.
+ *
+ * The signal is passed between the effects without copying wherever
+ * possible: if nothing was sent directly to an effect's input channels, its
+ * input channels simply refer to the output buffers of the previous effect
+ * while it is rendered. Disabled effects are bypassed without touching the
+ * signal at all. Effects whose input is silent are skipped entirely as soon
+ * as their output was silent for a while as well (i.e. after the tail of a
+ * reverb decayed, see configure option --enable-fx-silence-hold).
  */
 class EffectChain {
 public:
@@ -68,12 +76,27 @@ public:
 
     /**
      * Sequentially render the whole effects chain. The final signal
-     * will be available in the output channels of the last effect in
-     * the chain after this call, which then has to be copied to the
-     * desired destination (e.g. the AudioOutputDevice's output channels).
+     * will be available in the chain's output channels (see OutputChannel())
+     * after this call, which then has to be copied to the desired
+     * destination (e.g. the AudioOutputDevice's output channels).
      */
     void RenderAudio(uint Samples);
 
+    /**
+     * Returns the channel with index @a iChannel of the final signal of the
+     * last RenderAudio() call, or NULL if index out of bounds. Depending on
+     * which effects were bypassed, this is either an output or an input
+     * channel of one of the effects in the chain.
+     */
+    AudioChannel* OutputChannel(uint iChannel) const;
+
+    /**
+     * Returns the amount of channels of the final signal of the last
+     * RenderAudio() call. Returns 0 if the final signal was silent, in
+     * which case there is nothing to be copied at all.
+     */
+    uint OutputChannelCount() const;
+
     /**
      * Returns effect at chain position @a iChainPos .
      */
@@ -85,9 +108,8 @@ public:
     int EffectCount() const;
 
     /**
-     * Enable / disable the given effect. Currently, disabled effects are
-     * automatically bypassed. We might add explicit "bypass" control in
-     * future though.
+     * Enable / disable the given effect. Disabled effects are bypassed,
+     * that is the signal is passed to the next effect unaltered.
      *
      * @throw Exception - if chain position is invalid
      */
@@ -132,11 +154,21 @@ private:
     struct _ChainEntry {
         Effect* pEffect;
         bool    bActive;
+        bool    bIdle;           ///< Whether the effect is skipped until there is some input again.
+        uint    uiSilentSamples; ///< For how long input and output of the effect were silent.
     };
 
     std::vector<_ChainEntry> vEntries;
     AudioOutputDevice*       pDevice;
     int                      iID;
+    Effect*                  pOutput;       ///< Effect providing the final signal (NULL if silent).
+    bool                     bOutputIsInput; ///< Whether the final signal is in pOutput's input channels.
+    std::vector<float*>      vInputBuffers; ///< Own input buffers of the effect currently rendered.
+    uint32_t                 tsLastCycle;   ///< Time stamp (RTMath::CreateTimeStamp()) of the previous RenderAudio() call.
+    uint                     uiSilenceHold; ///< After how many silent sample points effects are skipped.
+
+    void UpdateInputBufferCache();
+    void UpdateSilenceHold();
 };
 
 } // namespace LinuxSampler
@@ -238,7 +238,7 @@ void LadspaEffect::RenderAudio(uint Samples) {
         LADSPA_PortDescriptor pPortDescriptor = pDescriptor->PortDescriptors[iPort];
         if (LADSPA_IS_PORT_AUDIO(pPortDescriptor)) {
             if (LADSPA_IS_PORT_INPUT(pPortDescriptor)) {
-                pDescriptor->connect_port(hEffect, iPort, vInputChannels[iInputPort++]->Buffer());
+                pDescriptor->connect_port(hEffect, iPort, const_cast<float*>(vInputChannels[iInputPort++]->ConstBuffer()));
             } else if (LADSPA_IS_PORT_OUTPUT(pPortDescriptor)) {
                 pDescriptor->connect_port(hEffect, iPort, vOutputChannels[iOutputPort++]->Buffer());
             }
@@ -28,6 +28,8 @@
 #include "EngineFactory.h"
 #include "../common/global_private.h"
 #include "../effects/EffectFactory.h"
+#include "common/FilterBank.h"
+#include "common/LFOBank.h"
 
 namespace LinuxSampler {
 
@@ -84,6 +86,8 @@ namespace LinuxSampler {
         FrameTime          = 0;
         RandomSeed         = 0;
         pDedicatedVoiceChannelLeft = pDedicatedVoiceChannelRight = NULL;
+        pFilterBank        = NULL;
+        pLFOBank           = NULL;
         pScriptVM          = NULL;
     }
 
@@ -95,6 +99,8 @@ namespace LinuxSampler {
         if (pSysexBuffer) delete pSysexBuffer;
         if (pDedicatedVoiceChannelLeft) delete pDedicatedVoiceChannelLeft;
         if (pDedicatedVoiceChannelRight) delete pDedicatedVoiceChannelRight;
+        if (pFilterBank) delete pFilterBank;
+        if (pLFOBank) delete pLFOBank;
         if (pScriptVM) delete pScriptVM;
         Unregister();
     }
@@ -105,6 +111,23 @@ namespace LinuxSampler {
         pScriptVM = new InstrumentScriptVM; // format independent script runner
     }
 
+    /**
+     * (Re)creates the filter bank for the current amount of voices and
+     * audio fragment size. Must only be called while the engine is
+     * suspended.
+     */
+    void AbstractEngine::CreateFilterBank() {
+        if (pFilterBank) {
+            delete pFilterBank;
+            pFilterBank = NULL;
+        }
+        #if CONFIG_MAX_FILTER_BANK_VOICES > 0
+        if (!pAudioOutputDevice) return;
+        const uint slots = RTMath::Min(uint(MaxVoices()), uint(CONFIG_MAX_FILTER_BANK_VOICES));
+        if (slots) pFilterBank = new FilterBank(slots, MaxSamplesPerCycle);
+        #endif
+    }
+
     /**
      * Once an engine channel is disconnected from an audio output device,
      * it will immediately call this method to unregister itself from the
@@ -222,13 +245,44 @@ namespace LinuxSampler {
         pGlobalEvents->clear();
     }
 
+    /**
+     * Collects the destinations of one source channel, so the source can be
+     * mixed to all of them in one pass (see AudioChannel::MixTo()).
+     */
+    class _MixDestinations {
+        public:
+            _MixDestinations(AudioChannel* pSource, uint Samples) : pSource(pSource), Samples(Samples), n(0) {}
+
+            void Add(AudioChannel* pDst, float fLevel) {
+                if (n == MAX_DESTINATIONS) Flush();
+                ppDst[n]   = pDst;
+                fLevels[n] = fLevel;
+                ++n;
+            }
+
+            void Flush() {
+                if (n) pSource->MixTo(ppDst, fLevels, n, Samples);
+                n = 0;
+            }
+
+        private:
+            enum { MAX_DESTINATIONS = 8 };
+
+            AudioChannel* pSource;
+            uint          Samples;
+            uint          n;
+            AudioChannel* ppDst[MAX_DESTINATIONS];
+            float         fLevels[MAX_DESTINATIONS];
+    };
+
     /**
      * Will be called in case the respective engine channel sports FX send
      * channels. In this particular case, engine channel local buffers are
      * used to render and mix all voices to. This method is responsible for
      * copying the audio data from those local buffers to the master audio
      * output channels as well as to the FX send audio output channels with
-     * their respective FX send levels.
+     * their respective FX send levels. Each local buffer is only read once
+     * for its dry destination and all its FX send destinations.
      *
      * @param pEngineChannel - engine channel from which audio should be
      *                         routed
@@ -241,22 +295,25 @@ namespace LinuxSampler {
             pChannel->pChannelLeft,
             pChannel->pChannelRight
         };
-        // route dry signal
-        {
-            AudioChannel* pDstL = pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelLeft);
-            AudioChannel* pDstR = pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelRight);
-            ppSource[0]->MixTo(pDstL, Samples);
-            ppSource[1]->MixTo(pDstR, Samples);
-        }
-        // route FX send signal (wet)
+        // nothing rendered by this engine channel in this cycle
+        if (ppSource[0]->IsSilent() && ppSource[1]->IsSilent()) return;
         {
+            _MixDestinations dstL(ppSource[0], Samples);
+            _MixDestinations dstR(ppSource[1], Samples);
+            // dry signal
+            dstL.Add(pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelLeft), 1.0f);
+            dstR.Add(pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelRight), 1.0f);
+            // FX send signal (wet)
             for (int iFxSend = 0; iFxSend < pChannel->GetFxSendCount(); iFxSend++) {
                 FxSend* pFxSend = pChannel->GetFxSend(iFxSend);
-                const bool success = RouteFxSend(pFxSend, ppSource, pFxSend->Level(), Samples);
-                if (!success) goto channel_cleanup;
+                AudioChannel* ppDst[2];
+                if (!GetFxSendDestinations(pFxSend, ppDst)) break;
+                dstL.Add(ppDst[0], pFxSend->Level());
+                dstR.Add(ppDst[1], pFxSend->Level());
             }
+            dstL.Flush();
+            dstR.Flush();
         }
-        channel_cleanup:
         // reset buffers with silence (zero out) for the next audio cycle
         ppSource[0]->Clear();
         ppSource[1]->Clear();
@@ -274,43 +331,44 @@ namespace LinuxSampler {
             pDedicatedVoiceChannelLeft,
             pDedicatedVoiceChannelRight
         };
-        // route dry signal
-        {
-            AudioChannel* pDstL = pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelLeft);
-            AudioChannel* pDstR = pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelRight);
-            ppSource[0]->MixTo(pDstL, Samples);
-            ppSource[1]->MixTo(pDstR, Samples);
-        }
-        // route FX send signals (wet)
-        // (we simply hard code the voices 'reverb send' to the 1st effect
-        // send bus, and the voioces 'chorus send' to the 2nd effect send bus)
         {
+            _MixDestinations dstL(ppSource[0], Samples);
+            _MixDestinations dstR(ppSource[1], Samples);
+            // dry signal
+            dstL.Add(pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelLeft), 1.0f);
+            dstR.Add(pAudioOutputDevice->Channel(pChannel->AudioDeviceChannelRight), 1.0f);
+            // FX send signals (wet)
+            // (we simply hard code the voices 'reverb send' to the 1st effect
+            // send bus, and the voioces 'chorus send' to the 2nd effect send bus)
             for (int iFxSend = 0; iFxSend < 2 && iFxSend < pChannel->GetFxSendCount(); iFxSend++) {
                 // no voice specific FX send level defined for this effect? 
                 if (!FxSendLevels[iFxSend]) continue; // ignore this effect then
                 
                 FxSend* pFxSend = pChannel->GetFxSend(iFxSend);
-                const bool success = RouteFxSend(pFxSend, ppSource, *FxSendLevels[iFxSend], Samples);
-                if (!success) goto channel_cleanup;
+                AudioChannel* ppDst[2];
+                if (!GetFxSendDestinations(pFxSend, ppDst)) break;
+                dstL.Add(ppDst[0], *FxSendLevels[iFxSend]);
+                dstR.Add(ppDst[1], *FxSendLevels[iFxSend]);
             }
+            dstL.Flush();
+            dstR.Flush();
         }
-        channel_cleanup:
         // reset buffers with silence (zero out) for the next dedicated voice rendering/routing process
         ppSource[0]->Clear();
         ppSource[1]->Clear();
     }
     
     /**
-     * Route the audio signal given by @a ppSource to the effect send bus
-     * defined by @a pFxSend (wet signal only).
+     * Resolve the audio channels the effect send bus defined by @a pFxSend
+     * is routed to.
      *
      * @param pFxSend - definition of effect send bus
-     * @param ppSource - the 2 channels of the audio signal to be routed
-     * @param FxSendLevel - the effect send level to by applied
-     * @param Samples - amount of sample points to be processed
-     * @returns true if signal was routed successfully, false on error
+     * @param ppDst - (output) destination channels of the left and right
+     *                channel of the signal
+     * @returns true if both destination channels were resolved
+     *          successfully, false on error
      */
-    bool AbstractEngine::RouteFxSend(FxSend* pFxSend, AudioChannel* ppSource[2], float FxSendLevel, uint Samples) {
+    bool AbstractEngine::GetFxSendDestinations(FxSend* pFxSend, AudioChannel* ppDst[2]) {
         for (int iChan = 0; iChan < 2; ++iChan) {
             const int iDstChan = pFxSend->DestinationChannel(iChan);
             if (iDstChan < 0) {
@@ -343,7 +401,7 @@ namespace LinuxSampler {
                 dmsg(1,("Engine::RouteAudio() Error: invalid FX send (%s) destination channel (%d->%d)", ((iChan) ? "R" : "L"), iChan, iDstChan));
                 return false; // error
             }
-            ppSource[iChan]->MixTo(pDstChan, Samples, FxSendLevel);
+            ppDst[iChan] = pDstChan;
         }
         return true; // success
     }
@@ -38,10 +38,13 @@
 #include "common/Note.h"
 #include "common/SignalUnitRack.h"
 #include "common/InstrumentScriptVM.h"
+#include "common/ScriptExecContextPool.h"
 
 namespace LinuxSampler {
 
     class AbstractEngineChannel;
+    class FilterBank;
+    class LFOBank;
 
     class AbstractEngine: public Engine {
 
@@ -72,6 +75,14 @@ namespace LinuxSampler {
 
             void SetVoiceCount(uint Count);
 
+            /**
+             * Called by the MIDI input thread(s) right when a note-on event
+             * arrived, that is before the audio thread processes it. Engines
+             * may use this hint i.e. to launch disk streams in advance. The
+             * default implementation does nothing.
+             */
+            virtual void HintNoteOn(EngineChannel* pEngineChannel, uint8_t Key, uint8_t Velocity) { }
+
             /**
              * Returns event with the given event ID.
              */
@@ -106,6 +117,8 @@ namespace LinuxSampler {
             //TODO: should be protected
             AudioChannel* pDedicatedVoiceChannelLeft;  ///< encapsulates a special audio rendering buffer (left) for rendering and routing audio on a per voice basis (this is a very special case and only used for voices which lie on a note which was set with individual, dedicated FX send level)
             AudioChannel* pDedicatedVoiceChannelRight; ///< encapsulates a special audio rendering buffer (right) for rendering and routing audio on a per voice basis (this is a very special case and only used for voices which lie on a note which was set with individual, dedicated FX send level)
+            FilterBank*   pFilterBank; ///< Filters all voices with biquad based filter types together, after all voices were rendered (NULL if disabled).
+            LFOBank*      pLFOBank;    ///< State of the LFOs of all voices, renders the LFOs of all voices together at the beginning of each audio fragment (NULL if not connected to an audio output device).
 
             friend class AbstractVoice;
             friend class AbstractEngineChannel;
@@ -129,6 +142,7 @@ namespace LinuxSampler {
             atomic_t                   ActiveVoiceCount;      ///< number of currently active voices
             int                        VoiceSpawnsLeft;       ///< We only allow CONFIG_MAX_VOICES voices to be spawned per audio fragment, we use this variable to ensure this limit.
             InstrumentScriptVM*        pScriptVM; ///< Real-time instrument script virtual machine runner for this engine.
+            ScriptExecContextPoolManager scriptExecContextPools; ///< VM execution contexts for the instrument scripts of this engine, shared by all its engine channels.
 
             void RouteAudio(EngineChannel* pEngineChannel, uint Samples);
             void RouteDedicatedVoiceChannels(EngineChannel* pEngineChannel, optional<float> FxSendLevels[2], uint Samples);
@@ -154,6 +168,7 @@ namespace LinuxSampler {
             virtual int  GetMinFadeOutSamples() = 0;
             virtual note_id_t LaunchNewNote(LinuxSampler::EngineChannel* pEngineChannel, Event* pNoteOnEvent) = 0;
             virtual void CreateInstrumentScriptVM();
+            void CreateFilterBank();
 
         private:
             static std::map<Format, std::map<AudioOutputDevice*,AbstractEngine*> > engines;
@@ -164,7 +179,7 @@ namespace LinuxSampler {
             static float* InitCrossfadeCurve();
             static float* InitCurve(const float* segments, int size = 128);
 
-            bool RouteFxSend(FxSend* pFxSend, AudioChannel* ppSource[2], float FxSendLevel, uint Samples);
+            bool GetFxSendDestinations(FxSend* pFxSend, AudioChannel* ppDst[2]);
     };
 
 } // namespace LinuxSampler
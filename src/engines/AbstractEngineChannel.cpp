@@ -48,6 +48,7 @@ namespace LinuxSampler {
         PortamentoMode = false;
         PortamentoTime = CONFIG_PORTAMENTO_TIME_DEFAULT;
         pScript = NULL;
+        bScriptProfiling = false;
     }
 
     AbstractEngineChannel::~AbstractEngineChannel() {
@@ -96,6 +97,47 @@ namespace LinuxSampler {
         return InstrumentStat;
     }
 
+    void AbstractEngineChannel::SetScriptProfiling(bool bEnable) {
+        InstrumentScript* script = pScript;
+        if (bEnable && !bScriptProfiling && script) {
+            // start with fresh statistics (cleared by the audio thread, since
+            // it might be updating them right now)
+            atomic_set(&script->profileResetRequested, 1);
+        }
+        bScriptProfiling = bEnable;
+    }
+
+    bool AbstractEngineChannel::GetScriptProfiling() {
+        return bScriptProfiling;
+    }
+
+    bool AbstractEngineChannel::GetScriptProfile(VMScriptProfile& profile) {
+        InstrumentScript* script = pScript;
+        if (!script) return false;
+        LockGuard lock(script->profileMutex);
+        // the audio thread does not lock, so retry until we got a copy which
+        // was not modified by the audio thread while copying
+        while (true) {
+            const int seq = script->profileSequence.load(memory_order_acquire);
+            if (!(seq & 1)) {
+                profile = script->profile;
+                atomic_thread_fence(memory_order_acquire);
+                if (script->profileSequence.load(memory_order_relaxed) == seq)
+                    break;
+            }
+            usleep(1000);
+        }
+        // reset requested, but not applied by the audio thread yet
+        if (atomic_read(&script->profileResetRequested))
+            profile.reset();
+        return true;
+    }
+
+    uint AbstractEngineChannel::GetScriptBudgetOverruns() {
+        InstrumentScript* script = pScript;
+        return (script) ? atomic_read(&script->budgetOverruns) : 0;
+    }
+
     String AbstractEngineChannel::EngineName() {
         return AbstractEngine::GetFormatString(GetEngineFormat());
     }
@@ -384,7 +426,11 @@ namespace LinuxSampler {
             event.Param.Note.Velocity = Velocity;
             event.Param.Note.Channel  = MidiChannel;
             event.pEngineChannel      = this;
-            if (this->pEventQueue->write_space() > 0) this->pEventQueue->push(&event);
+            if (this->pEventQueue->write_space() > 0) {
+                this->pEventQueue->push(&event);
+                // let the engine i.e. launch disk streams in advance
+                pEngine->HintNoteOn(this, Key, Velocity);
+            }
             else dmsg(1,("EngineChannel: Input event queue full!"));
             // inform connected virtual MIDI devices if any ...
             // (e.g. virtual MIDI keyboard in instrument editor(s))
@@ -425,7 +471,11 @@ namespace LinuxSampler {
             event.Param.Note.Velocity = Velocity;
             event.Param.Note.Channel  = MidiChannel;
             event.pEngineChannel      = this;
-            if (this->pEventQueue->write_space() > 0) this->pEventQueue->push(&event);
+            if (this->pEventQueue->write_space() > 0) {
+                this->pEventQueue->push(&event);
+                // let the engine i.e. launch disk streams in advance
+                pEngine->HintNoteOn(this, Key, Velocity);
+            }
             else dmsg(1,("EngineChannel: Input event queue full!"));
             // inform connected virtual MIDI devices if any ...
             // (e.g. virtual MIDI keyboard in instrument editor(s))
@@ -42,7 +42,7 @@ namespace LinuxSampler {
 
     class MidiKeyboardManagerBase;
 
-    class AbstractEngineChannel: public EngineChannel, public InstrumentScriptConsumer {
+    class AbstractEngineChannel: public EngineChannel, public InstrumentScriptConsumer, public ScriptExecContextPoolConsumer {
         public:
             // implementation of abstract methods derived from interface class 'LinuxSampler::EngineChannel'
             virtual void    PrepareLoadInstrument(const char* FileName, uint Instrument) OVERRIDE;
@@ -88,6 +88,10 @@ namespace LinuxSampler {
             virtual FxSend* GetFxSend(uint FxSendIndex) OVERRIDE;
             virtual uint    GetFxSendCount() OVERRIDE;
             virtual void    RemoveFxSend(FxSend* pFxSend) OVERRIDE;
+            virtual void    SetScriptProfiling(bool bEnable) OVERRIDE;
+            virtual bool    GetScriptProfiling() OVERRIDE;
+            virtual bool    GetScriptProfile(VMScriptProfile& profile) OVERRIDE;
+            virtual uint    GetScriptBudgetOverruns() OVERRIDE;
             virtual void    Connect(VirtualMidiDevice* pDevice) OVERRIDE;
             virtual void    Disconnect(VirtualMidiDevice* pDevice) OVERRIDE;
 
@@ -96,6 +100,10 @@ namespace LinuxSampler {
             virtual void ResourceUpdated(VMParserContext* pOldResource, VMParserContext* pNewResource, void* pUpdateArg) OVERRIDE {}
             virtual void OnResourceProgress(float fProgress) OVERRIDE {}
 
+            // implementation of abstract methods derived from ScriptExecContextPoolConsumer
+            virtual void ResourceToBeUpdated(ScriptExecContextPool* pResource, void*& pUpdateArg) OVERRIDE {}
+            virtual void ResourceUpdated(ScriptExecContextPool* pOldResource, ScriptExecContextPool* pNewResource, void* pUpdateArg) OVERRIDE {}
+
             virtual AbstractEngine::Format GetEngineFormat() = 0;
             virtual MidiKeyboardManagerBase* GetMidiKeyboardManager() = 0;
 
@@ -126,7 +134,7 @@ namespace LinuxSampler {
             struct _DelayedEvents {
                 RTList<Event>*            pList; ///< Unsorted list where all delayed events are moved to and remain here until they're finally processed.
                 Pool<ScheduledEvent>      schedulerNodes; ///< Nodes used to sort the delayed events (stored on pList) with time sorted queue.
-                RTAVLTree<ScheduledEvent> queue; ///< Used to access the delayed events (from pList) in time sorted manner.
+                RTTimingWheel<ScheduledEvent> queue; ///< Used to access the delayed events (from pList) in time sorted manner.
 
                 _DelayedEvents() : pList(NULL), schedulerNodes(CONFIG_MAX_EVENTS_PER_FRAGMENT) {}
 
@@ -154,6 +162,7 @@ namespace LinuxSampler {
             int                       iEngineIndexSelf;         ///< Reflects the index of this EngineChannel in the Engine's ArrayList.
             bool                      bStatusChanged;           ///< true in case an engine parameter has changed (e.g. new instrument, another volumet)
             uint32_t                  RoundRobinIndex;          ///< counter for round robin sample selection, incremented for each note on
+            bool                      bScriptProfiling;         ///< Whether execution statistics of the instrument script shall be collected (see SetScriptProfiling()).
             InstrumentScript*         pScript;                  ///< Points to the real-time instrument script(s) to be executed, NULL if current instrument does not have an instrument script. Even though the underlying VM representation of the script is shared among multiple sampler channels, the InstrumentScript object here is not shared though, it exists for each sampler channel separately.
 
             SynchronizedConfig< ArrayList<VirtualMidiDevice*> > virtualMidiDevices;
@@ -57,6 +57,8 @@ namespace LinuxSampler {
             virtual bool   DiskStreamSupported() = 0;
             virtual uint   DiskStreamCount() = 0;
             virtual uint   DiskStreamCountMax() = 0;
+            virtual uint   DiskStreamPrelaunchHits() = 0;
+            virtual uint   DiskStreamPrelaunchMisses() = 0;
             virtual int    MaxDiskStreams() = 0;
             virtual void   SetMaxDiskStreams(int iStreams) throw (Exception) = 0;
             virtual String DiskStreamBufferFillBytes() = 0;
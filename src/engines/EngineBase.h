@@ -30,6 +30,8 @@
 #include "EngineChannelBase.h"
 #include "common/DiskThreadBase.h"
 #include "common/MidiKeyboardManager.h"
+#include "common/FilterBank.h"
+#include "common/LFOBank.h"
 #include "InstrumentManager.h"
 #include "../common/global_private.h"
 
@@ -181,6 +183,10 @@ namespace LinuxSampler {
                     ProcessEvents(engineChannels[i], Samples);
                 }
 
+                // calculate the LFOs of all voices of this audio fragment at once
+                if (pLFOBank)
+                    pLFOBank->Render((Samples + CONFIG_DEFAULT_SUBFRAGMENT_SIZE - 1) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
+
                 // render all 'normal', active voices on all engine channels
                 for (int i = 0; i < engineChannels.size(); i++) {
                     RenderActiveVoices(engineChannels[i], Samples);
@@ -189,6 +195,10 @@ namespace LinuxSampler {
                 // now that all ordinary voices on ALL engine channels are rendered, render new stolen voices
                 RenderStolenVoices(Samples);
 
+                // filter all voices deferred to the filter bank at once and
+                // mix them to their engine channels' audio buffers
+                if (pFilterBank) pFilterBank->Process();
+
                 // handle audio routing for engine channels with FX sends
                 for (int i = 0; i < engineChannels.size(); i++) {
                     AbstractEngineChannel* pChannel = static_cast<AbstractEngineChannel*>(engineChannels[i]);
@@ -283,14 +293,41 @@ namespace LinuxSampler {
                 pNotePool->clear();
 
                 PostSetMaxVoices(iVoices);
+                CreateFilterBank();
+                CreateLFOBank();
                 ResumeAll();
             }
             
             /** Called after the new max number of voices is set and before resuming the engine. */
             virtual void PostSetMaxVoices(int iVoices) { }
 
+            /**
+             * (Re)creates the LFO bank for the current amount of voices and
+             * audio fragment size and assigns its lanes to the LFOs of all
+             * voices. Must only be called while the engine is suspended.
+             */
+            void CreateLFOBank() {
+                if (pLFOBank) {
+                    delete pLFOBank;
+                    pLFOBank = NULL;
+                }
+                if (pAudioOutputDevice) {
+                    const uint steps = (MaxSamplesPerCycle + CONFIG_DEFAULT_SUBFRAGMENT_SIZE - 1) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE;
+                    pLFOBank = new LFOBank(MaxVoices(), 3, steps);
+                }
+                uint voice = 0;
+                for (VoiceIterator iterVoice = pVoicePool->allocAppend();
+                     iterVoice; iterVoice = pVoicePool->allocAppend())
+                {
+                    iterVoice->SetLFOBank(pLFOBank, voice++);
+                }
+                pVoicePool->clear();
+            }
+
             virtual uint DiskStreamCount() OVERRIDE { return (pDiskThread) ? pDiskThread->GetActiveStreamCount() : 0; }
             virtual uint DiskStreamCountMax() OVERRIDE { return (pDiskThread) ? pDiskThread->ActiveStreamCountMax : 0; }
+            virtual uint DiskStreamPrelaunchHits() OVERRIDE { return (pDiskThread) ? pDiskThread->GetPrelaunchHits() : 0; }
+            virtual uint DiskStreamPrelaunchMisses() OVERRIDE { return (pDiskThread) ? pDiskThread->GetPrelaunchMisses() : 0; }
             virtual int  MaxDiskStreams() OVERRIDE { return iMaxDiskStreams; }
 
             virtual void SetMaxDiskStreams(int iStreams) throw (Exception) OVERRIDE {
@@ -312,6 +349,10 @@ namespace LinuxSampler {
             virtual String DiskStreamBufferFillPercentage() OVERRIDE { return (pDiskThread) ? pDiskThread->GetBufferFillPercentage() : ""; }
             virtual InstrumentManager* GetInstrumentManager() OVERRIDE { return &instruments; }
 
+            virtual void HintNoteOn(EngineChannel* pEngineChannel, uint8_t Key, uint8_t Velocity) OVERRIDE {
+                if (pDiskThread) pDiskThread->OrderPrelaunch(pEngineChannel, Key, Velocity);
+            }
+
             /**
              * Connect this engine instance with the given audio output device.
              * This method will be called when an Engine instance is created.
@@ -382,6 +423,15 @@ namespace LinuxSampler {
                 if (pEventGenerator) delete pEventGenerator;
                 pEventGenerator = new EventGenerator(pAudioOut->SampleRate());
 
+                // the new event generator starts counting from 0 again, so the
+                // engine channels' scheduler queues (delayed events, suspended
+                // scripts) must be cleared to forget their old current time
+                for (int i = 0; i < engineChannels.size(); i++) {
+                    AbstractEngineChannel* pEngineChannel =
+                        static_cast<AbstractEngineChannel*>(engineChannels[i]);
+                    pEngineChannel->ResetInternal(false/*don't reset engine*/);
+                }
+
                 dmsg(1,("Starting disk thread..."));
                 pDiskThread->StartThread();
                 dmsg(1,("OK\n"));
@@ -408,6 +458,10 @@ namespace LinuxSampler {
                 if (pDedicatedVoiceChannelRight) delete pDedicatedVoiceChannelRight;
                 pDedicatedVoiceChannelLeft  = new AudioChannel(0, MaxSamplesPerCycle);
                 pDedicatedVoiceChannelRight = new AudioChannel(1, MaxSamplesPerCycle);
+
+                // (re)create filter bank and LFO bank for the new audio fragment size
+                CreateFilterBank();
+                CreateLFOBank();
             }
         
             // Implementattion for abstract method derived from Engine.
@@ -887,6 +941,42 @@ namespace LinuxSampler {
                 pLastStolenChannel        = NULL;
             }
 
+            /**
+             * Assigns a VM execution context from the script's shared
+             * execution context pool to the given script event, if the event
+             * does not have one already. If the pool is running low on
+             * execution contexts, the disk thread is ordered to grow the pool.
+             *
+             * @param pChannel - engine channel the script event belongs to
+             * @param itScriptEvent - script event which needs a context
+             * @returns false if no execution context was left in the pool
+             */
+            bool AcquireScriptExecContext(AbstractEngineChannel* pChannel, RTList<ScriptEvent>::Iterator& itScriptEvent) {
+                if (itScriptEvent->execCtx) return true;
+                ScriptExecContextPool* pPool = pChannel->pScript->pExecContextPool;
+                itScriptEvent->execCtx = pPool->acquire();
+                if (pPool->requestGrowth() && pDiskThread)
+                    pDiskThread->OrderScriptExecContextPoolGrowth(&scriptExecContextPools);
+                if (!itScriptEvent->execCtx) {
+                    dmsg(1,("Script execution context pool empty!\n"));
+                    return false;
+                }
+                return true;
+            }
+
+            /**
+             * Returns the VM execution context of the given script event to
+             * the script's shared execution context pool. Must be called
+             * before a script event is freed, unless the script event is
+             * kept for passing its polyphonic variable data to another
+             * event handler.
+             */
+            void ReleaseScriptExecContext(AbstractEngineChannel* pChannel, RTList<ScriptEvent>::Iterator& itScriptEvent) {
+                if (!itScriptEvent->execCtx) return;
+                pChannel->pScript->pExecContextPool->release(itScriptEvent->execCtx);
+                itScriptEvent->execCtx = NULL;
+            }
+
             /**
              * Run all suspended script execution instances which are scheduled
              * to be resumed for the current audio fragment cycle.
@@ -965,6 +1055,10 @@ namespace LinuxSampler {
              */
             void ProcessScriptEvent(AbstractEngineChannel* pChannel, RTList<Event>::Iterator& itEvent, VMEventHandler* pEventHandler, RTList<ScriptEvent>::Iterator& itScriptEvent) {
                 if (!itScriptEvent) return; // not a valid script event (i.e. because no free script event was left in the script event pool)
+                if (!AcquireScriptExecContext(pChannel, itScriptEvent)) {
+                    pChannel->pScript->pEvents->free(itScriptEvent);
+                    return;
+                }
 
                 // fill the list of script handlers to be executed by this event
                 int i = 0;
@@ -991,12 +1085,19 @@ namespace LinuxSampler {
                     // in case the script was suspended, keep it on the allocated
                     // ScriptEvent list to be resume at the scheduled time in future,
                     // additionally insert it into a sorted time queue
-                    pEventGenerator->scheduleAheadMicroSec(
-                        pChannel->pScript->suspendedEvents, // scheduler queue
-                        *itScriptEvent, // script event
-                        itScriptEvent->cause.FragmentPos(), // current time of script event (basis for its next execution)
-                        itScriptEvent->execCtx->suspensionTimeMicroseconds() // how long shall it be suspended
-                    );
+                    if (res & VM_EXEC_PREEMPTED) { // script exhausted its execution budget ...
+                        // ... so resume it right at the start of the next audio fragment
+                        itScriptEvent->scheduleTime = pEventGenerator->schedTimeAtCurrentFragmentEnd();
+                        pChannel->pScript->suspendedEvents.insert(*itScriptEvent);
+                        atomic_inc(&pChannel->pScript->budgetOverruns);
+                    } else {
+                        pEventGenerator->scheduleAheadMicroSec(
+                            pChannel->pScript->suspendedEvents, // scheduler queue
+                            *itScriptEvent, // script event
+                            itScriptEvent->cause.FragmentPos(), // current time of script event (basis for its next execution)
+                            itScriptEvent->execCtx->suspensionTimeMicroseconds() // how long shall it be suspended
+                        );
+                    }
                 } else { // script execution has finished without 'suspended' status ...
                     // if "polyphonic" variable data is passed from script's
                     // "note" event handler to its "release" event handler, then
@@ -1014,6 +1115,7 @@ namespace LinuxSampler {
                         // script's execution has finished without suspension
                         // status, then free the script event for a new future
                         // script event to be triggered from start
+                        ReleaseScriptExecContext(pChannel, itScriptEvent);
                         pChannel->pScript->pEvents->free(itScriptEvent);
                     }
                 }
@@ -1048,12 +1150,19 @@ namespace LinuxSampler {
                     // in case the script was suspended, keep it on the allocated
                     // ScriptEvent list to be resume at the scheduled time in future,
                     // additionally insert it into a sorted time queue
-                    pEventGenerator->scheduleAheadMicroSec(
-                        pChannel->pScript->suspendedEvents, // scheduler queue
-                        *itScriptEvent, // script event
-                        itScriptEvent->cause.FragmentPos(), // current time of script event (basis for its next execution)
-                        itScriptEvent->execCtx->suspensionTimeMicroseconds() // how long shall it be suspended
-                    );
+                    if (res & VM_EXEC_PREEMPTED) { // script exhausted its execution budget ...
+                        // ... so resume it right at the start of the next audio fragment
+                        itScriptEvent->scheduleTime = pEventGenerator->schedTimeAtCurrentFragmentEnd();
+                        pChannel->pScript->suspendedEvents.insert(*itScriptEvent);
+                        atomic_inc(&pChannel->pScript->budgetOverruns);
+                    } else {
+                        pEventGenerator->scheduleAheadMicroSec(
+                            pChannel->pScript->suspendedEvents, // scheduler queue
+                            *itScriptEvent, // script event
+                            itScriptEvent->cause.FragmentPos(), // current time of script event (basis for its next execution)
+                            itScriptEvent->execCtx->suspensionTimeMicroseconds() // how long shall it be suspended
+                        );
+                    }
                 } else { // script execution has finished without 'suspended' status ...
                     // if "polyphonic" variable data is passed from script's
                     // "note" event handler to its "release" event handler, then
@@ -1071,6 +1180,7 @@ namespace LinuxSampler {
                         // script's execution has finished without suspension
                         // status, then free the script event for a new future
                         // script event to be triggered from start
+                        ReleaseScriptExecContext(pChannel, itScriptEvent);
                         pChannel->pScript->pEvents->free(itScriptEvent);
                     }
                 }
@@ -1249,9 +1359,12 @@ namespace LinuxSampler {
                             itScriptEvent->handlers[0] = pEngineChannel->pScript->handlerInit;
                             itScriptEvent->handlers[1] = NULL;
 
-                            VMExecStatus_t res = pScriptVM->exec(
-                                pEngineChannel->pScript->parserContext, &*itScriptEvent
-                            );
+                            if (AcquireScriptExecContext(pEngineChannel, itScriptEvent)) {
+                                VMExecStatus_t res = pScriptVM->exec(
+                                    pEngineChannel->pScript->parserContext, &*itScriptEvent
+                                );
+                                ReleaseScriptExecContext(pEngineChannel, itScriptEvent);
+                            }
 
                             pEngineChannel->pScript->pEvents->free(itScriptEvent);
                         }
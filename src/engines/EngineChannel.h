@@ -38,6 +38,7 @@ namespace LinuxSampler {
     class AudioOutputDevice;
     class MidiInputPort;
     class FxSend;
+    struct VMScriptProfile;
 
 
     /** @brief Channel Interface for LinuxSampler Sampler Engines
@@ -123,6 +124,12 @@ namespace LinuxSampler {
             virtual uint    GetFxSendCount() = 0;
             virtual void    RemoveFxSend(FxSend* pFxSend) = 0;
 
+            // instrument script profiling
+            virtual void    SetScriptProfiling(bool bEnable) = 0; ///< Starts (with reset statistics) or stops collecting execution statistics of the instrument script.
+            virtual bool    GetScriptProfiling() = 0;
+            virtual bool    GetScriptProfile(VMScriptProfile& profile) = 0; ///< Copies the execution statistics of the instrument script currently in use, returns false if there is no script.
+            virtual uint    GetScriptBudgetOverruns() = 0; ///< How often the instrument script currently in use was preempted by the VM, because it exhausted its execution budget.
+
 
             /////////////////////////////////////////////////////////////////
             // normal methods
@@ -374,7 +374,8 @@ namespace LinuxSampler {
         protected:
             EngineChannelBase() :
                 MidiKeyboardManager<V>(this),
-                InstrumentChangeCommandReader(InstrumentChangeCommand)
+                InstrumentChangeCommandReader(InstrumentChangeCommand),
+                InstrumentChangeCommandReaderDiskThread(InstrumentChangeCommand)
             {
                 pInstrument = NULL;
 
@@ -451,6 +452,7 @@ namespace LinuxSampler {
 
             SynchronizedConfig<InstrumentChangeCmd<R, I> > InstrumentChangeCommand;
             SyncConfInstrChangeCmdReader InstrumentChangeCommandReader;
+            SyncConfInstrChangeCmdReader InstrumentChangeCommandReaderDiskThread; ///< Disk thread access to InstrumentChangeCommand (for launching streams in advance).
 
             /** This method is not thread safe! */
             virtual void ResetInternal(bool bResetEngine) OVERRIDE {
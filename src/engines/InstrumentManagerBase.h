@@ -91,9 +91,23 @@ namespace LinuxSampler {
                 this->HandBack(pResource, pConsumer, true);
             }
 
+            /**
+             * Take an additional reference to a region of a currently
+             * loaded instrument, so the region and its sample are not
+             * deleted before the region was given back with
+             * HandBackRegion(), even if the instrument is unloaded
+             * meanwhile.
+             */
+            void BorrowRegion(R* pRegion) {
+                LockGuard lock(RegionInfoMutex);
+                RegionInfo[pRegion].refCount++;
+                SampleRefCount[pRegion->pSample]++;
+            }
+
             /**
              * Give back a region that belongs to an instrument that
-             * was previously handed back.
+             * was previously handed back (or that was borrowed with
+             * BorrowRegion()).
              */
             virtual void HandBackRegion(R* pRegion) {
                 LockGuard lock(RegionInfoMutex);
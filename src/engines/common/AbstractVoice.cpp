@@ -23,14 +23,17 @@
  ***************************************************************************/
 
 #include "AbstractVoice.h"
+#include "FilterBank.h"
+
+#include <string.h>
 
 namespace LinuxSampler {
 
     AbstractVoice::AbstractVoice(SignalUnitRack* pRack): pSignalUnitRack(pRack) {
         pEngineChannel = NULL;
-        pLFO1 = new LFOUnsigned(1.0f);  // amplitude LFO (0..1 range)
-        pLFO2 = new LFOUnsigned(1.0f);  // filter LFO (0..1 range)
-        pLFO3 = new LFOSigned(1200.0f); // pitch LFO (-1200..+1200 range)
+        pLFO1 = new LFOBank::LFO(range_unsigned, 1.0f);  // amplitude LFO (0..1 range)
+        pLFO2 = new LFOBank::LFO(range_unsigned, 1.0f);  // filter LFO (0..1 range)
+        pLFO3 = new LFOBank::LFO(range_signed, 1200.0f); // pitch LFO (-1200..+1200 range)
         PlaybackState = playback_state_end;
         SynthesisMode = 0; // set all mode bits to 0 first
         // select synthesis implementation (asm core is not supported ATM)
@@ -43,6 +46,8 @@ namespace LinuxSampler {
 
         finalSynthesisParameters.filterLeft.Reset();
         finalSynthesisParameters.filterRight.Reset();
+        finalSynthesisParameters.pRawLeft  = NULL;
+        finalSynthesisParameters.pRawRight = NULL;
         
         pEq          = NULL;
         bEqSupport   = false;
@@ -63,6 +68,13 @@ namespace LinuxSampler {
         pEq->InitEffect(GetEngine()->pAudioOutputDevice);
     }
 
+    void AbstractVoice::SetLFOBank(LFOBank* pBank, uint Voice) {
+        if (!pBank) return;
+        pLFO1->Bind(pBank, pBank->Lane(Voice, 0));
+        pLFO2->Bind(pBank, pBank->Lane(Voice, 1));
+        pLFO3->Bind(pBank, pBank->Lane(Voice, 2));
+    }
+
     /**
      *  Resets voice variables. Should only be called if rendering process is
      *  suspended / not running.
@@ -312,11 +324,7 @@ namespace LinuxSampler {
         const bool bEq =
             pSignalUnitRack != NULL && pSignalUnitRack->HasEq() && pEq->HasSupport();
 
-        if (bEq) {
-            pEq->GetInChannelLeft()->Clear();
-            pEq->GetInChannelRight()->Clear();
-            pEq->RenderAudio(GetEngine()->pAudioOutputDevice->MaxSamplesPerCycle());
-        }
+        if (bEq) pEq->Reset();
 
         return 0; // success
     }
@@ -361,13 +369,22 @@ namespace LinuxSampler {
         const bool bEq =
             pSignalUnitRack != NULL && pSignalUnitRack->HasEq() && pEq->HasSupport();
 
-        if (bEq) {
-            pEq->GetInChannelLeft()->Clear();
-            pEq->GetInChannelRight()->Clear();
-            finalSynthesisParameters.pOutLeft  = &pEq->GetInChannelLeft()->Buffer()[Skip];
-            finalSynthesisParameters.pOutRight = &pEq->GetInChannelRight()->Buffer()[Skip];
-            pSignalUnitRack->UpdateEqSettings(pEq);
-        } else if (bVoiceRequiresDedicatedRouting) {
+        if (bEq) pSignalUnitRack->UpdateEqSettings(pEq);
+
+        // voices with biquad based filters are filtered together with all
+        // other such voices after all voices were rendered (if possible)
+        FilterBank::Slot* pBankSlot = NULL;
+        if (!delay && !bEq && !bVoiceRequiresDedicatedRouting &&
+            SYNTHESIS_MODE_GET_FILTER(SynthesisMode) && GetEngine()->pFilterBank)
+        {
+            pBankSlot = GetEngine()->pFilterBank->Assign(
+                finalSynthesisParameters.filterLeft,
+                finalSynthesisParameters.filterRight,
+                SYNTHESIS_MODE_GET_CHANNELS(SynthesisMode) ? 2 : 1
+            );
+        }
+
+        if (bVoiceRequiresDedicatedRouting) {
             finalSynthesisParameters.pOutLeft  = &GetEngine()->pDedicatedVoiceChannelLeft->Buffer()[Skip];
             finalSynthesisParameters.pOutRight = &GetEngine()->pDedicatedVoiceChannelRight->Buffer()[Skip];
         } else {
@@ -418,6 +435,16 @@ namespace LinuxSampler {
             }
         }
 
+        // temporary buffers for passing the voice's signal through the EQ
+        float eqBufferLeft[CONFIG_DEFAULT_SUBFRAGMENT_SIZE];
+        float eqBufferRight[CONFIG_DEFAULT_SUBFRAGMENT_SIZE];
+
+#if CONFIG_ADAPTIVE_SUBFRAGMENTS
+        // synthesis parameters of the previous subfragment
+        bool  bPrevParams = false;
+        float fPrevVolume = 0.0f, fPrevCutoff = 0.0f, fPrevResonance = 0.0f, fPrevPitch = 0.0f;
+#endif
+
         uint i = Skip;
         while (i < Samples) {
             int iSubFragmentEnd = RTMath::Min(i + CONFIG_DEFAULT_SUBFRAGMENT_SIZE, Samples);
@@ -444,6 +471,11 @@ namespace LinuxSampler {
             processTransitionEvents(itNoteEvent, iSubFragmentEnd);
             processGroupEvents(itGroupEvent, iSubFragmentEnd);
             
+#if CONFIG_ADAPTIVE_SUBFRAGMENTS
+            // volume without the amplitude EG's contribution
+            const float fVolumeBase = fFinalVolume;
+#endif
+
             if (pSignalUnitRack == NULL) {
                 // if the voice was killed in this subfragment, or if the
                 // filter EG is finished, switch EG1 to fade out stage
@@ -516,10 +548,60 @@ namespace LinuxSampler {
             // limit the pitch so we don't read outside the buffer
             finalSynthesisParameters.fFinalPitch = RTMath::Min(finalSynthesisParameters.fFinalPitch, float(1 << CONFIG_MAX_PITCH));
 
-            // if filter enabled then update filter coefficients
-            if (SYNTHESIS_MODE_GET_FILTER(SynthesisMode)) {
-                finalSynthesisParameters.filterLeft.SetParameters(fFinalCutoff, fFinalResonance, GetEngine()->SampleRate);
-                finalSynthesisParameters.filterRight.SetParameters(fFinalCutoff, fFinalResonance, GetEngine()->SampleRate);
+#if CONFIG_ADAPTIVE_SUBFRAGMENTS
+            // if the synthesis parameters did not change since the previous
+            // subfragment (apart from the amplitude EG) and only change
+            // linearly before the next event, render as many subfragments
+            // as possible at once
+            if (bPrevParams && pSignalUnitRack == NULL && !bEq &&
+                fVolumeBase     == fPrevVolume    &&
+                (!SYNTHESIS_MODE_GET_FILTER(SynthesisMode) ||
+                 (fFinalCutoff == fPrevCutoff && fFinalResonance == fPrevResonance)) &&
+                finalSynthesisParameters.fFinalPitch == fPrevPitch &&
+                CanRenderBlock())
+            {
+                // stop right before the next event would be processed
+                uint end = Samples;
+                if (itCCEvent && uint(itCCEvent->FragmentPos()) <= end)
+                    end = itCCEvent->FragmentPos() - 1;
+                if (itNoteEvent && uint(itNoteEvent->FragmentPos()) <= end)
+                    end = itNoteEvent->FragmentPos() - 1;
+                if (itGroupEvent && uint(itGroupEvent->FragmentPos()) <= end)
+                    end = itGroupEvent->FragmentPos() - 1;
+                if (itKillEvent && killPos <= end)
+                    end = killPos - 1;
+                uint n = end - i;
+                if (end < Samples) // only whole subfragments before an event
+                    n -= n % CONFIG_DEFAULT_SUBFRAGMENT_SIZE;
+                // don't skip the end of an envelope stage
+                int maxSubFragments = pEG1->toStageEndLeft();
+                if (pEG2->active()) maxSubFragments = RTMath::Min(maxSubFragments, pEG2->toStageEndLeft());
+                if (uint(maxSubFragments) < (n + CONFIG_DEFAULT_SUBFRAGMENT_SIZE - 1) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE)
+                    n = maxSubFragments * CONFIG_DEFAULT_SUBFRAGMENT_SIZE;
+                if (i + n > uint(iSubFragmentEnd)) {
+                    // advance the envelopes to the end of the block in
+                    // closed form (the first step was already processed);
+                    // EG1 is linear, so the volume ramp over the whole
+                    // block is the same as the ones of the single subfragments
+                    const int iSteps = (n + CONFIG_DEFAULT_SUBFRAGMENT_SIZE - 1) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE - 1;
+                    fFinalVolume = fVolumeBase * pEG1->processSteps(iSteps);
+                    pEG2->processSteps(iSteps);
+                    iSubFragmentEnd = i + n;
+                }
+            }
+            bPrevParams    = true;
+            fPrevVolume    = fVolumeBase;
+            fPrevCutoff    = fFinalCutoff;
+            fPrevResonance = fFinalResonance;
+            fPrevPitch     = finalSynthesisParameters.fFinalPitch;
+#endif
+
+            // if filter enabled then update filter coefficients (ramped
+            // over this subfragment to avoid zipper noise)
+            if (SYNTHESIS_MODE_GET_FILTER(SynthesisMode) && !pBankSlot) {
+                const uint uiRamp = iSubFragmentEnd - i;
+                finalSynthesisParameters.filterLeft.SetParameters(fFinalCutoff, fFinalResonance, GetEngine()->SampleRate, uiRamp);
+                finalSynthesisParameters.filterRight.SetParameters(fFinalCutoff, fFinalResonance, GetEngine()->SampleRate, uiRamp);
             }
 
             // do we need resampling?
@@ -545,7 +627,24 @@ namespace LinuxSampler {
                 fFinalVolume * VolumeRight * PanRightSmoother.render();
 #endif
             // render audio for one subfragment
-            if (!delay) RunSynthesisFunction(SynthesisMode, &finalSynthesisParameters, &loop);
+            if (!delay && bEq) {
+                // render into temporary buffers, EQ mixes it to actual output
+                const uint n = iSubFragmentEnd - i;
+                float* pOutLeft  = finalSynthesisParameters.pOutLeft;
+                float* pOutRight = finalSynthesisParameters.pOutRight;
+                memset(eqBufferLeft,  0, n * sizeof(float));
+                memset(eqBufferRight, 0, n * sizeof(float));
+                finalSynthesisParameters.pOutLeft  = eqBufferLeft;
+                finalSynthesisParameters.pOutRight = eqBufferRight;
+                RunSynthesisFunction(SynthesisMode, &finalSynthesisParameters, &loop);
+                pEq->RenderAudio(eqBufferLeft, eqBufferRight, pOutLeft, pOutRight, n);
+                finalSynthesisParameters.pOutLeft  = pOutLeft  + n;
+                finalSynthesisParameters.pOutRight = pOutRight + n;
+            } else if (!delay) {
+                if (pBankSlot) // filter and volume are applied by the filter bank
+                    pBankSlot->AddSegment(finalSynthesisParameters, fFinalCutoff, fFinalResonance, GetEngine()->SampleRate);
+                RunSynthesisFunction(SynthesisMode, &finalSynthesisParameters, &loop);
+            }
 
             if (pSignalUnitRack == NULL) {
                 // stop the rendering if volume EG is finished
@@ -558,6 +657,10 @@ namespace LinuxSampler {
             const double newPos = Pos + (iSubFragmentEnd - i) * finalSynthesisParameters.fFinalPitch;
 
             if (pSignalUnitRack == NULL) {
+                // amount of (default sized) subfragments rendered in this cycle
+                const int iSubFragments =
+                    (iSubFragmentEnd - i + CONFIG_DEFAULT_SUBFRAGMENT_SIZE - 1) / CONFIG_DEFAULT_SUBFRAGMENT_SIZE;
+
                 // increment envelopes' positions
                 if (pEG1->active()) {
 
@@ -566,14 +669,14 @@ namespace LinuxSampler {
                         pEG1->update(EG::event_hold_end, GetEngine()->SampleRate / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
                     }
 
-                    pEG1->increment(1);
+                    pEG1->increment(iSubFragments);
                     if (!pEG1->toStageEndLeft()) pEG1->update(EG::event_stage_end, GetEngine()->SampleRate / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
                 }
                 if (pEG2->active()) {
-                    pEG2->increment(1);
+                    pEG2->increment(iSubFragments);
                     if (!pEG2->toStageEndLeft()) pEG2->update(EG::event_stage_end, GetEngine()->SampleRate / CONFIG_DEFAULT_SUBFRAGMENT_SIZE);
                 }
-                EG3.increment(1);
+                EG3.increment(iSubFragments);
                 if (!EG3.toEndLeft()) EG3.update(); // neutralize envelope coefficient if end reached
             } else {
                     // if sample has a loop and loop start has been reached in this subfragment, send a special event to EG1 to let it finish the attack hold stage
@@ -588,27 +691,53 @@ namespace LinuxSampler {
             Pos = newPos;
             i = iSubFragmentEnd;
         }
+        finalSynthesisParameters.pRawLeft  = NULL;
+        finalSynthesisParameters.pRawRight = NULL;
+
+        // if the voice is going to be rendered entirely in the next audio
+        // fragment as well, let the engine's LFO bank calculate its LFOs
+        // together with the ones of the other voices
+        if (i >= Samples && pSignalUnitRack == NULL) {
+            if (bLFO1Enabled) pLFO1->enlist();
+            if (bLFO2Enabled) pLFO2->enlist();
+            if (bLFO3Enabled) pLFO3->enlist();
+        }
         
         if (delay) return;
 
         if (bVoiceRequiresDedicatedRouting) {
-            if (bEq) {
-                pEq->RenderAudio(Samples);
-                pEq->GetOutChannelLeft()->CopyTo(GetEngine()->pDedicatedVoiceChannelLeft, Samples);
-                pEq->GetOutChannelRight()->CopyTo(GetEngine()->pDedicatedVoiceChannelRight, Samples);
-            }
             optional<float> effectSendLevels[2] = {
                 pMidiKeyInfo->ReverbSend,
                 pMidiKeyInfo->ChorusSend
             };
             GetEngine()->RouteDedicatedVoiceChannels(pEngineChannel, effectSendLevels, Samples);
-        } else if (bEq) {
-            pEq->RenderAudio(Samples);
-            pEq->GetOutChannelLeft()->MixTo(pChannel->pChannelLeft, Samples);
-            pEq->GetOutChannelRight()->MixTo(pChannel->pChannelRight, Samples);
         }
     }
 
+    /**
+     * Returns @c true if this voice's synthesis parameters change at most
+     * linearly until the next event arrives (or until the end of the
+     * current envelope stage), so several subfragments can be rendered at
+     * once with one linear volume ramp: that is if the amplitude EG is in a
+     * linear segment, the filter EG is in a flat stage (i.e. sustain) or
+     * the filter is disabled, no LFO is enabled, the pitch EG has ended and
+     * no volume or pan smoothing is in progress. Only applies to voices
+     * without signal unit rack.
+     */
+    bool AbstractVoice::CanRenderBlock() {
+        if (bLFO1Enabled || bLFO2Enabled || bLFO3Enabled || EG3.active()) return false;
+        if (pEG1->getSegmentType() != EG::segment_lin) return false;
+#ifndef CONFIG_INTERPOLATE_VOLUME
+        // volume is constant for each block, so it must not change at all
+        if (!pEG1->flat()) return false;
+#endif
+        if (SYNTHESIS_MODE_GET_FILTER(SynthesisMode) && !pEG2->flat()) return false;
+        // EG1 still has to be informed when the sample's loop start is reached
+        if (SmplInfo.HasLoops && Pos <= SmplInfo.LoopStart) return false;
+        return VolumeSmoother.settled() && CrossfadeSmoother.settled() &&
+               PanLeftSmoother.settled() && PanRightSmoother.settled();
+    }
+
     /**
      * Process given list of MIDI control change, aftertouch and pitch bend
      * events for the given time.
@@ -30,6 +30,7 @@
 #include "../../common/global_private.h"
 #include "../AbstractEngineChannel.h"
 #include "../common/LFOBase.h"
+#include "LFOBank.h"
 #include "../EngineBase.h"
 #include "EG.h"
 #include "../gig/EGADSR.h"
@@ -106,6 +107,15 @@ namespace LinuxSampler {
             /** Invoked when the voice is freed - gone from active to inactive. */
             virtual void VoiceFreed() { }
 
+            /**
+             * Assigns the lanes of the engine's LFO bank to this voice's
+             * LFOs.
+             *
+             * @param pBank - the engine's LFO bank
+             * @param Voice - unique index of this voice within the engine
+             */
+            void SetLFOBank(LFOBank* pBank, uint Voice);
+
             virtual void Synthesize(uint Samples, sample_t* pSrc, uint Skip);
             
             uint GetSampleRate() { return GetEngine()->SampleRate; }
@@ -126,6 +136,7 @@ namespace LinuxSampler {
             void processResonanceEvent(RTList<Event>::Iterator& itEvent);
             void processTransitionEvents(RTList<Event>::Iterator& itEvent, uint End);
             void processGroupEvents(RTList<Event>::Iterator& itEvent, uint End);
+            bool CanRenderBlock();
             void UpdatePortamentoPos(Pool<Event>::Iterator& itNoteOffEvent);
             void Kill(Pool<Event>::Iterator& itKillEvent);
             void CreateEq();
@@ -161,9 +172,9 @@ namespace LinuxSampler {
             gig::EGDecay                EG3;                ///< Envelope Generator 3 (Pitch) TODO: use common EG instead?
             midi_ctrl                   VCFCutoffCtrl;
             midi_ctrl                   VCFResonanceCtrl;
-            LFOUnsigned*                pLFO1;               ///< Low Frequency Oscillator 1 (Amplification)
-            LFOUnsigned*                pLFO2;               ///< Low Frequency Oscillator 2 (Filter cutoff frequency)
-            LFOSigned*                  pLFO3;               ///< Low Frequency Oscillator 3 (Pitch)
+            LFOBank::LFO*               pLFO1;               ///< Low Frequency Oscillator 1 (Amplification)
+            LFOBank::LFO*               pLFO2;               ///< Low Frequency Oscillator 2 (Filter cutoff frequency)
+            LFOBank::LFO*               pLFO3;               ///< Low Frequency Oscillator 3 (Pitch)
             bool                        bLFO1Enabled;        ///< Should we use the Amplitude LFO for this voice?
             bool                        bLFO2Enabled;        ///< Should we use the Filter Cutoff LFO for this voice?
             bool                        bLFO3Enabled;        ///< Should we use the Pitch LFO for this voice?
@@ -27,8 +27,10 @@
 #define __LS_DISKTHREADBASE_H__
 
 #include <map>
+#include <sys/time.h>
 
 #include "StreamBase.h"
+#include "ScriptExecContextPool.h"
 #include "../EngineChannel.h"
 #include "../InstrumentManagerBase.h"
 
@@ -36,6 +38,8 @@
 
 #include "../../common/Thread.h"
 #include "../../common/RingBuffer.h"
+#include "../../common/Mutex.h"
+#include "../../common/Condition.h"
 #include "../../common/atomic.h"
 
 namespace LinuxSampler {
@@ -53,6 +57,21 @@ namespace LinuxSampler {
      */
     template <class R /* Resource */, class IM /* Instrument Manager */>
     class DiskThreadBase : public Thread {
+        protected:
+            /**
+             * Note-on hint for launching disk streams in advance (see
+             * OrderPrelaunch()), including a snapshot of the engine
+             * channel's state at the time the hint was queued.
+             */
+            struct prelaunch_command_t {
+                EngineChannel* pEngineChannel;
+                uint8_t        Key;
+                uint8_t        Velocity;
+                uint8_t        ControllerTable[130]; ///< MIDI controller values of the engine channel.
+                float          KeyDimension;         ///< Current keyswitching position of the engine channel.
+                uint32_t       RoundRobinIndex;      ///< Round robin counter of the engine channel.
+                uint32_t       KeyRoundRobinIndex;   ///< Round robin counter of the region on @c Key.
+            };
         private:
             // Private Types
             struct create_command_t {
@@ -73,6 +92,13 @@ namespace LinuxSampler {
                 uint32_t Program;
                 EngineChannel* pEngineChannel;
             };
+            struct prelaunched_stream_t {
+                Stream*        pStream;
+                R*             pRegion;
+                unsigned long  SampleOffset;
+                bool           DoLoop;
+                double         LaunchTime;
+            };
             // Attributes
             bool                           IsIdle;
             uint                           Streams;
@@ -82,6 +108,16 @@ namespace LinuxSampler {
             RingBuffer<Stream::Handle,false>    DeletionNotificationQueue;          ///< In case the original sender requested a notification for its stream deletion order, this queue will receive the handle of the respective stream once actually be deleted by the disk thread.
             RingBuffer<R*,false>*               DeleteRegionQueue;          ///< Contains dimension regions that are not used anymore and should be handed back to the instrument resource manager
             RingBuffer<program_change_command_t,false> ProgramChangeQueue;          ///< Contains requests for MIDI program change
+            RingBuffer<prelaunch_command_t,false> PrelaunchQueue;                   ///< Contains note-on hints sent by MIDI thread(s), for launching disk streams in advance
+            RingBuffer<ScriptExecContextPoolManager*,false> ScriptExecContextPoolQueue; ///< Contains requests for growing the engine's script VM execution context pools
+            Mutex                          PrelaunchQueueMutex;                    ///< Protects PrelaunchQueue against concurrent MIDI input threads (only try-locked, hints are dropped on contention).
+            Condition                      PrelaunchHint;                          ///< Set when a note-on hint was queued, to wake up the idle disk thread early.
+            prelaunched_stream_t           PrelaunchedStreams[CONFIG_MAX_PRELAUNCH_STREAMS + 1]; ///< Streams launched in advance, not yet claimed by a voice.
+            int                            PrelaunchedStreamCount;
+            uint                           PrelaunchHits;                          ///< How many pre-launched streams were claimed by a voice.
+            uint                           PrelaunchMisses;                        ///< How many pre-launched streams expired unclaimed.
+            double                         PrelaunchLeadTime;                      ///< Sum of time between pre-launch and claim of all hits (in seconds).
+            uint64_t                       PrelaunchBufferedSamples;               ///< Sum of sample words already buffered on claim of all hits.
             unsigned int                   RefillStreamsPerRun;                    ///< How many streams should be refilled in each loop run
             Stream**                       pStreams; ///< Contains all disk streams (whether used or unused)
             Stream**                       pCreatedStreams; ///< This is where the voice (audio thread) picks up it's meanwhile hopefully created disk stream.
@@ -89,22 +125,30 @@ namespace LinuxSampler {
 
             // Methods
 
-            void CreateStream(create_command_t& Command) {
-                // search for unused stream
-                Stream* newstream = NULL;
+            Stream* FindUnusedStream() {
                 for (int i = Streams - 1; i >= 0; i--) {
-                    if (pStreams[i]->GetState() == Stream::state_unused) {
-                        newstream = pStreams[i];
-                        break;
-                    }
+                    if (pStreams[i]->GetState() == Stream::state_unused)
+                        return pStreams[i];
                 }
-                if (!newstream) {
-                    std::cerr << "No unused stream found (OrderID:" << Command.OrderID;
-                    std::cerr << ") - report if this happens, this is a bug!\n" << std::flush;
-                    return;
+                return NULL;
+            }
+
+            void CreateStream(create_command_t& Command) {
+                // if a stream was already launched in advance for this region, hand it over
+                Stream* newstream = ClaimPrelaunchedStream(Command);
+                if (newstream) {
+                    dmsg(4,("pre-launched Stream claimed (OrderID:%d,StreamHandle:%d)\n", Command.OrderID, Command.hStream));
+                } else {
+                    // search for unused stream
+                    newstream = FindUnusedStream();
+                    if (!newstream) {
+                        std::cerr << "No unused stream found (OrderID:" << Command.OrderID;
+                        std::cerr << ") - report if this happens, this is a bug!\n" << std::flush;
+                        return;
+                    }
+                    LaunchStream(newstream, Command.hStream, Command.pStreamRef, Command.pRegion, Command.SampleOffset, Command.DoLoop);
+                    dmsg(4,("new Stream launched by disk thread (OrderID:%d,StreamHandle:%d)\n", Command.OrderID, Command.hStream));
                 }
-                LaunchStream(newstream, Command.hStream, Command.pStreamRef, Command.pRegion, Command.SampleOffset, Command.DoLoop);
-                dmsg(4,("new Stream launched by disk thread (OrderID:%d,StreamHandle:%d)\n", Command.OrderID, Command.hStream));
                 if (pCreatedStreams[Command.OrderID] != SLOT_RESERVED) {
                     std::cerr << "DiskThread: Slot " << Command.OrderID << " already occupied! Please report this!\n" << std::flush;
                     newstream->Kill();
@@ -144,6 +188,18 @@ namespace LinuxSampler {
                 }
             }
 
+            /// Returns number of refilled sample points or a value < 0 on error.
+            int RefillStream(Stream* pStream, int writespace) {
+                int capped_writespace = writespace;
+                // if there is too much buffer space available then cut the read/write
+                // size to CONFIG_STREAM_MAX_REFILL_SIZE which is by default 65536 samples = 256KBytes
+                if (writespace > CONFIG_STREAM_MAX_REFILL_SIZE) capped_writespace = CONFIG_STREAM_MAX_REFILL_SIZE;
+
+                // adjust the amount to read in order to ensure that the buffer wraps correctly
+                int read_amount = pStream->AdjustWriteSpaceToAvoidBoundary(writespace, capped_writespace);
+                return pStream->ReadAhead(read_amount);
+            }
+
             void RefillStreams() {
                 // sort the streams by most empty stream
                 qsort(pStreams, Streams, sizeof(Stream*), CompareStreamWriteSpace);
@@ -151,6 +207,9 @@ namespace LinuxSampler {
                 // refill the most empty streams
                 for (uint i = 0; i < RefillStreamsPerRun; i++) {
                     if (pStreams[i]->GetState() == Stream::state_active) {
+                        // pre-launched stream not claimed by a voice yet, don't
+                        // waste disk bandwidth on it, it was filled on launch
+                        if (!pStreams[i]->pExportReference) continue;
 
                         //float filledpercentage = (float) pStreams[i]->GetReadSpace() / 131072.0 * 100.0;
                         //dmsg(("\nbuffer fill: %.1f%\n", filledpercentage));
@@ -158,20 +217,68 @@ namespace LinuxSampler {
                         int writespace = pStreams[i]->GetWriteSpaceToEnd();
                         if (writespace == 0) break;
 
-                        int capped_writespace = writespace;
-                        // if there is too much buffer space available then cut the read/write
-                        // size to CONFIG_STREAM_MAX_REFILL_SIZE which is by default 65536 samples = 256KBytes
-                        if (writespace > CONFIG_STREAM_MAX_REFILL_SIZE) capped_writespace = CONFIG_STREAM_MAX_REFILL_SIZE;
-
-                        // adjust the amount to read in order to ensure that the buffer wraps correctly
-                        int read_amount = pStreams[i]->AdjustWriteSpaceToAvoidBoundary(writespace, capped_writespace);
                         // if we wasn't able to refill one of the stream buffers by more than
                         // CONFIG_STREAM_MIN_REFILL_SIZE we'll send the disk thread to sleep later
-                        if (pStreams[i]->ReadAhead(read_amount) > CONFIG_STREAM_MIN_REFILL_SIZE) this->IsIdle = false;
+                        if (RefillStream(pStreams[i], writespace) > CONFIG_STREAM_MIN_REFILL_SIZE) this->IsIdle = false;
                     }
                 }
             }
 
+            static double CurrentTime() {
+                timeval tv;
+                gettimeofday(&tv, NULL);
+                return double(tv.tv_sec) + double(tv.tv_usec) / 1000000.0;
+            }
+
+            /// Removes the @a i th pre-launched stream and releases its region.
+            void RemovePrelaunchedStream(int i) {
+                pInstruments->HandBackRegion(PrelaunchedStreams[i].pRegion);
+                PrelaunchedStreams[i] = PrelaunchedStreams[--PrelaunchedStreamCount];
+            }
+
+            /// Kills all pre-launched streams which were not claimed yet.
+            void KillPrelaunchedStreams() {
+                while (PrelaunchedStreamCount) {
+                    PrelaunchedStreams[0].pStream->Kill();
+                    RemovePrelaunchedStream(0);
+                }
+            }
+
+            /**
+             * Returns the stream pre-launched for exactly the same region,
+             * offset and loop mode as ordered by the given command (if any)
+             * and binds it to the ordering voice.
+             */
+            Stream* ClaimPrelaunchedStream(create_command_t& Command) {
+                for (int i = 0; i < PrelaunchedStreamCount; i++) {
+                    const prelaunched_stream_t& prelaunched = PrelaunchedStreams[i];
+                    if (prelaunched.pRegion != Command.pRegion ||
+                        prelaunched.SampleOffset != Command.SampleOffset ||
+                        prelaunched.DoLoop != Command.DoLoop) continue;
+                    Stream* pStream = prelaunched.pStream;
+                    PrelaunchHits++;
+                    PrelaunchLeadTime += CurrentTime() - prelaunched.LaunchTime;
+                    PrelaunchBufferedSamples += pStream->GetReadSpace();
+                    RemovePrelaunchedStream(i);
+                    pStream->hThis            = Command.hStream;
+                    pStream->pExportReference = Command.pStreamRef;
+                    pStream->SetState(pStream->GetState()); // export current state to the voice
+                    return pStream;
+                }
+                return NULL;
+            }
+
+            /// Kills all pre-launched streams which were not claimed in time.
+            void ExpirePrelaunchedStreams() {
+                const double now = CurrentTime();
+                for (int i = PrelaunchedStreamCount - 1; i >= 0; i--) {
+                    if (now - PrelaunchedStreams[i].LaunchTime < PRELAUNCH_TIMEOUT_MS / 1000.0) continue;
+                    PrelaunchedStreams[i].pStream->Kill();
+                    PrelaunchMisses++;
+                    RemovePrelaunchedStream(i);
+                }
+            }
+
             Stream::Handle CreateHandle() {
                 static uint32_t counter = 0;
                 if (counter == 0xffffffff) counter = 1; // we use '0' as 'invalid handle' only, so we skip 0
@@ -199,7 +306,9 @@ namespace LinuxSampler {
                 Thread(true, false, 1, -2),
                 pInstruments(pInstruments),
                 DeletionNotificationQueue(4*MaxStreams),
-                ProgramChangeQueue(512)
+                ProgramChangeQueue(512),
+                PrelaunchQueue(512),
+                ScriptExecContextPoolQueue(64)
             {
                 CreationQueue       = new RingBuffer<create_command_t,false>(4*MaxStreams);
                 DeletionQueue       = new RingBuffer<delete_command_t,false>(4*MaxStreams);
@@ -214,9 +323,18 @@ namespace LinuxSampler {
                     pCreatedStreams[i] = NULL;
                 }
                 ActiveStreamCountMax = 0;
+                PrelaunchedStreamCount = 0;
+                PrelaunchHits = PrelaunchMisses = 0;
+                PrelaunchLeadTime = 0.0;
+                PrelaunchBufferedSamples = 0;
             }
 
             virtual ~DiskThreadBase() {
+                if (PrelaunchHits || PrelaunchMisses) {
+                    dmsg(1,("DiskThread: pre-launched streams: %u hits, %u misses, avg. lead time %.1f ms, avg. buffered %.0f samples on claim\n",
+                            PrelaunchHits, PrelaunchMisses, GetPrelaunchLeadTime() * 1000.0, GetPrelaunchBufferedSamples()));
+                }
+                KillPrelaunchedStreams();
                 for (int i = 0; i < Streams; i++) {
                     if (pStreams[i]) delete pStreams[i];
                 }
@@ -252,6 +370,8 @@ namespace LinuxSampler {
                 CreationQueue->init();
                 DeletionQueue->init();
                 DeletionNotificationQueue.init();
+                PrelaunchQueue.init();
+                KillPrelaunchedStreams();
 
                 // make sure that all DimensionRegions are released
                 while (DeleteRegionQueue->read_space() > 0) {
@@ -399,6 +519,57 @@ namespace LinuxSampler {
                 return 0;
             }
 
+            /**
+             * Tell the disk thread to grow the script VM execution context
+             * pools of the engine, because the audio thread is running low on
+             * execution contexts.
+             *
+             * @returns 0 on success, -1 if command queue is full
+             */
+            int OrderScriptExecContextPoolGrowth(ScriptExecContextPoolManager* pPools) {
+                dmsg(4,("Disk Thread: script exec context pool growth ordered\n"));
+                if (ScriptExecContextPoolQueue.write_space() < 1) {
+                    dmsg(1,("DiskThread: ScriptExecContextPool queue full!\n"));
+                    return -1;
+                }
+                ScriptExecContextPoolQueue.push(&pPools);
+                return 0;
+            }
+
+            /**
+             * Hint the disk thread that a note-on event for the given key just
+             * arrived on the given engine channel, so it can already launch
+             * the disk streams which will most probably be ordered by the
+             * voices triggered by that event (called by MIDI input thread(s)
+             * long before the audio thread processes the event). Depending
+             * on the MIDI driver this is the audio thread itself though, so
+             * this method never blocks: if another thread is queuing a hint
+             * at the same time, the hint is simply dropped.
+             *
+             * @returns 0 on success, -1 if the hint was dropped
+             */
+            int OrderPrelaunch(EngineChannel* pEngineChannel, uint8_t Key, uint8_t Velocity) {
+                if (!CONFIG_MAX_PRELAUNCH_STREAMS) return 0;
+                prelaunch_command_t cmd;
+                cmd.pEngineChannel = pEngineChannel;
+                cmd.Key            = Key;
+                cmd.Velocity       = Velocity;
+                PrelaunchSnapshot(cmd);
+
+                if (!PrelaunchQueueMutex.Trylock()) return -1;
+                if (PrelaunchQueue.write_space() < 1) {
+                    PrelaunchQueueMutex.Unlock();
+                    dmsg(3,("DiskThread: Prelaunch queue full!\n"));
+                    return -1;
+                }
+                PrelaunchQueue.push(&cmd);
+                PrelaunchQueueMutex.Unlock();
+                // if the disk thread misses this, it handles the hint on its
+                // next regular run
+                PrelaunchHint.TrySet(true);
+                return 0;
+            }
+
             /**
              * Returns the pointer to a disk stream if the ordered disk stream
              * represented by the \a StreamOrderID was already activated by the disk
@@ -446,7 +617,18 @@ namespace LinuxSampler {
             void SetActiveStreamCount(uint Streams) { atomic_set(&ActiveStreamCount, Streams); }
             int ActiveStreamCountMax;
 
+            /// Number of pre-launched streams which were claimed by a voice.
+            uint GetPrelaunchHits() { return PrelaunchHits; }
+            /// Number of pre-launched streams which expired without being claimed.
+            uint GetPrelaunchMisses() { return PrelaunchMisses; }
+            /// Average time (in seconds) a stream was launched before a voice claimed it.
+            double GetPrelaunchLeadTime() { return (PrelaunchHits) ? PrelaunchLeadTime / PrelaunchHits : 0.0; }
+            /// Average amount of sample words already buffered when a pre-launched stream was claimed.
+            double GetPrelaunchBufferedSamples() { return (PrelaunchHits) ? double(PrelaunchBufferedSamples) / PrelaunchHits : 0.0; }
+
         protected:
+            enum { PRELAUNCH_TIMEOUT_MS = 100 }; ///< Time after which unclaimed pre-launched streams are killed.
+
             IM* pInstruments;   ///< The instrument resource manager of the engine that is using this disk thread. Used by the dimension region deletion feature.
 
         // #########################################################################
@@ -483,6 +665,21 @@ namespace LinuxSampler {
                         if (!found) GhostQueue->push(&ghostStream); // put ghost stream handle back to the queue
                     }
 
+                    // launch streams in advance for recent note-on hints
+                    while (PrelaunchQueue.read_space() > 0) {
+                        prelaunch_command_t command;
+                        PrelaunchQueue.pop(&command);
+                        const int first = PrelaunchedStreamCount;
+                        PrelaunchStreams(command);
+                        // fill their buffers only after PrelaunchStreams()
+                        // released the instrument, the streams keep their
+                        // regions alive anyway
+                        for (int i = first; i < PrelaunchedStreamCount; i++) {
+                            Stream* pStream = PrelaunchedStreams[i].pStream;
+                            RefillStream(pStream, pStream->GetWriteSpaceToEnd());
+                        }
+                    }
+
                     // if there are creation commands, create new streams
                     while (Stream::UnusedStreams > 0 && CreationQueue->read_space() > 0) {
                         create_command_t command;
@@ -524,11 +721,37 @@ namespace LinuxSampler {
                         }
                     }
 
+                    // create new script VM execution contexts
+                    while (ScriptExecContextPoolQueue.read_space() > 0) {
+                        ScriptExecContextPoolManager* pPools;
+                        ScriptExecContextPoolQueue.pop(&pPools);
+                        pPools->GrowPools();
+                    }
+
+                    if (PrelaunchedStreamCount) ExpirePrelaunchedStreams();
+
                     RefillStreams(); // refill the most empty streams
 
                     // if nothing was done during this iteration (eg no streambuffer
                     // filled with data) then sleep for 30ms
-                    if (IsIdle) usleep(30000);
+                    if (IsIdle) {
+                        #if CONFIG_MAX_PRELAUNCH_STREAMS
+                        // ... but wake up early on note-on hints (the thread
+                        // must not be cancelled while it owns the condition's
+                        // mutex)
+                        #if !defined(WIN32)
+                        int cancelState;
+                        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+                        #endif
+                        PrelaunchHint.WaitAndUnlockIf(false, 0L, 30000000L);
+                        PrelaunchHint.Set(false);
+                        #if !defined(WIN32)
+                        pthread_setcancelstate(cancelState, NULL);
+                        #endif
+                        #else
+                        usleep(30000);
+                        #endif
+                    }
 
                     int streamsInUsage = 0;
                     for (int i = Streams - 1; i >= 0; i--) {
@@ -558,6 +781,59 @@ namespace LinuxSampler {
                 bool                  DoLoop
             ) = 0;
 
+            /**
+             * Called by OrderPrelaunch() in the context of the hinting thread
+             * (i.e. a MIDI input thread), to store the engine channel's
+             * current state needed by PrelaunchStreams() in the command, so
+             * that the disk thread does not have to read it from the engine
+             * channel later on. Must be real-time safe. The default
+             * implementation does nothing.
+             */
+            virtual void PrelaunchSnapshot(prelaunch_command_t& command) { }
+
+            /**
+             * Called by the disk thread for each note-on hint (see
+             * OrderPrelaunch()). Implementations resolve the regions the note
+             * will most probably trigger and call PrelaunchStream() for each
+             * of them. The default implementation does nothing.
+             */
+            virtual void PrelaunchStreams(const prelaunch_command_t& command) { }
+
+            /**
+             * Launches a disk stream for the given region in advance. Its
+             * buffer is filled by the disk thread as soon as
+             * PrelaunchStreams() returned. If a voice orders a stream with
+             * exactly the same parameters within PRELAUNCH_TIMEOUT_MS, it gets
+             * this stream instead of a freshly launched one. The caller must
+             * ensure that the region is not unloaded during this call, after
+             * this call the pre-launched stream holds a reference to the
+             * region until it is claimed or killed.
+             */
+            void PrelaunchStream(R* pRegion, unsigned long SampleOffset, bool DoLoop) {
+                if (PrelaunchedStreamCount >= CONFIG_MAX_PRELAUNCH_STREAMS) return;
+                // always keep enough streams for the orders of the audio thread
+                if (int(Stream::UnusedStreams) <= CreationQueue->read_space() + 1) return;
+                for (int i = 0; i < PrelaunchedStreamCount; i++) {
+                    if (PrelaunchedStreams[i].pRegion == pRegion &&
+                        PrelaunchedStreams[i].SampleOffset == SampleOffset &&
+                        PrelaunchedStreams[i].DoLoop == DoLoop) return; // already launched
+                }
+                Stream* pStream = FindUnusedStream();
+                if (!pStream) return;
+                // keep the region (and its sample) alive until the stream is
+                // claimed or killed, even if its instrument is unloaded
+                pInstruments->BorrowRegion(pRegion);
+                LaunchStream(pStream, CreateHandle(), NULL, pRegion, SampleOffset, DoLoop);
+
+                prelaunched_stream_t& prelaunched = PrelaunchedStreams[PrelaunchedStreamCount++];
+                prelaunched.pStream      = pStream;
+                prelaunched.pRegion      = pRegion;
+                prelaunched.SampleOffset = SampleOffset;
+                prelaunched.DoLoop       = DoLoop;
+                prelaunched.LaunchTime   = CurrentTime();
+                dmsg(4,("DiskThread: stream pre-launched (StreamHandle:%d)\n", pStream->GetHandle()));
+            }
+
             friend class Stream;
     };
 } // namespace LinuxSampler
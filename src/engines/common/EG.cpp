@@ -36,6 +36,33 @@ namespace LinuxSampler {
         FadeOutCoeff = -1.0f / killSteps;
     }
 
+    float EG::processSteps(int Steps) {
+        if (Steps <= 0) return Level;
+        switch (Segment) {
+            case segment_lin:
+                Level += Coeff * Steps;
+                break;
+            case segment_exp: {
+                // Level(n) = Level * Coeff^n + Offset * (1 + Coeff + ... + Coeff^(n-1)),
+                // calculated in double precision since Coeff is usually very
+                // close to 1
+                const double c  = Coeff;
+                const double cn = pow(c, Steps);
+                const double sum = (c == 1.0) ? double(Steps) : (1.0 - cn) / (1.0 - c);
+                Level = float(Level * cn + Offset * sum);
+                break;
+            }
+            case segment_pow:
+                X += XDelta * (Steps - 1);
+                Level = Offset + Coeff * powf(X, Exp);
+                X += XDelta;
+                break;
+            case segment_end:
+                break; // noop
+        }
+        return Level;
+    }
+
     void EG::enterFadeOutStage() {
         Stage     = stage_fadeout;
         Segment   = segment_lin;
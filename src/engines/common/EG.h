@@ -77,6 +77,14 @@ namespace LinuxSampler {
             StepsLeft = RTMath::Max(0, StepsLeft - SamplePoints);
         }
 
+        /**
+         * Returns true if the envelope level does not change anymore until
+         * the end of the current stage (i.e. sustain stage).
+         */
+        bool flat() {
+            return Segment == segment_lin && Coeff == 0.0f;
+        }
+
         /**
          * Returns amount of steps until the end of current envelope stage.
          */
@@ -129,6 +137,18 @@ namespace LinuxSampler {
             return Level;
         }
 
+        /**
+         * Calculates the next @a Steps sample points of the current segment
+         * at once (in closed form). Equivalent to calling processLin(),
+         * processExp() or processPow() (according to the current segment
+         * type) @a Steps times, but in constant time. @a Steps must not
+         * exceed toStageEndLeft(). Like those methods, this does not
+         * advance the envelope's position, call increment() for that.
+         *
+         * @returns envelope level after the last step
+         */
+        float processSteps(int Steps);
+
         /**
          * Returns current envelope level without modifying anything. This
          * might be needed once the envelope reached its final end state,
@@ -70,14 +70,11 @@ namespace LinuxSampler {
      * @param end - you @b MUST always pass EventGenerator::schedTimeAtCurrentFragmentEnd()
      *              here reflecting the current audio fragment's scheduler end time
      */
-    RTList<ScheduledEvent>::Iterator EventGenerator::popNextScheduledEvent(RTAVLTree<ScheduledEvent>& queue, Pool<ScheduledEvent>& pool, sched_time_t end) {
-        if (queue.isEmpty())
-            return RTList<ScheduledEvent>::Iterator(); // return invalid iterator
-        ScheduledEvent& e = queue.lowest();
-        if (e.scheduleTime >= end)
+    RTList<ScheduledEvent>::Iterator EventGenerator::popNextScheduledEvent(RTTimingWheel<ScheduledEvent>& queue, Pool<ScheduledEvent>& pool, sched_time_t end) {
+        ScheduledEvent* e = queue.popNext(end);
+        if (!e)
             return RTList<ScheduledEvent>::Iterator(); // no event scheduled before 'end'
-        RTList<ScheduledEvent>::Iterator itEvent = pool.fromPtr(&e);
-        queue.erase(e);
+        RTList<ScheduledEvent>::Iterator itEvent = pool.fromPtr(e);
         if (!itEvent || !itEvent->itEvent) {
             dmsg(1,("EventGenerator::popNextScheduledEvent(): !itEvent\n"));
             return itEvent; // should never happen at this point, but just to be sure
@@ -110,14 +107,11 @@ namespace LinuxSampler {
      * @param end - you @b MUST always pass EventGenerator::schedTimeAtCurrentFragmentEnd()
      *              here reflecting the current audio fragment's scheduler end time
      */
-    RTList<ScriptEvent>::Iterator EventGenerator::popNextScheduledScriptEvent(RTAVLTree<ScriptEvent>& queue, Pool<ScriptEvent>& pool, sched_time_t end) {
-        if (queue.isEmpty())
-            return RTList<ScriptEvent>::Iterator(); // return invalid iterator
-        ScriptEvent& e = queue.lowest();
-        if (e.scheduleTime >= end)
+    RTList<ScriptEvent>::Iterator EventGenerator::popNextScheduledScriptEvent(RTTimingWheel<ScriptEvent>& queue, Pool<ScriptEvent>& pool, sched_time_t end) {
+        ScriptEvent* e = queue.popNext(end);
+        if (!e)
             return RTList<ScriptEvent>::Iterator(); // no event scheduled before 'end'
-        RTList<ScriptEvent>::Iterator itEvent = pool.fromPtr(&e);
-        queue.erase(e);
+        RTList<ScriptEvent>::Iterator itEvent = pool.fromPtr(e);
         if (!itEvent) { // should never happen at this point, but just to be sure
             dmsg(1,("EventGenerator::popNextScheduledScriptEvent(): !itEvent\n"));
             return itEvent;
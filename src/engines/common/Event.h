@@ -26,7 +26,7 @@
 
 #include "../../common/global.h"
 #include "../../common/RTMath.h"
-#include "../../common/RTAVLTree.h"
+#include "../../common/RTTimingWheel.h"
 #include "../../common/Pool.h"
 #include "../EngineChannel.h"
 
@@ -61,10 +61,10 @@ namespace LinuxSampler {
             Event CreateEvent(int32_t FragmentPos);
 
             template<typename T>
-            void scheduleAheadMicroSec(RTAVLTree<T>& queue, T& node, int32_t fragmentPosBase, uint64_t microseconds);
+            void scheduleAheadMicroSec(RTTimingWheel<T>& queue, T& node, int32_t fragmentPosBase, uint64_t microseconds);
 
-            RTList<ScheduledEvent>::Iterator popNextScheduledEvent(RTAVLTree<ScheduledEvent>& queue, Pool<ScheduledEvent>& pool, sched_time_t end);
-            RTList<ScriptEvent>::Iterator popNextScheduledScriptEvent(RTAVLTree<ScriptEvent>& queue, Pool<ScriptEvent>& pool, sched_time_t end);
+            RTList<ScheduledEvent>::Iterator popNextScheduledEvent(RTTimingWheel<ScheduledEvent>& queue, Pool<ScheduledEvent>& pool, sched_time_t end);
+            RTList<ScriptEvent>::Iterator popNextScheduledScriptEvent(RTTimingWheel<ScriptEvent>& queue, Pool<ScriptEvent>& pool, sched_time_t end);
 
             /**
              * Returns the scheduler time for the first sample point of the next
@@ -220,19 +220,9 @@ namespace LinuxSampler {
      * queue. This class is just intended as base class and should be derived
      * for its actual purpose (for the precise data type being scheduled).
      */
-    class SchedulerNode : public RTAVLNode {
+    class SchedulerNode : public RTTimingWheelNode {
     public:
         sched_time_t scheduleTime; ///< Time ahead in future (in sample points) when this object shall be processed. This value is compared with EventGenerator's uiTotalSamplesProcessed member variable.
-
-        /// Required operator implementation for RTAVLTree class.
-        inline bool operator==(const SchedulerNode& other) const {
-            return this->scheduleTime == other.scheduleTime;
-        }
-
-        /// Required operator implementation for RTAVLTree class.
-        inline bool operator<(const SchedulerNode& other) const {
-            return this->scheduleTime < other.scheduleTime;
-        }
     };
 
     /**
@@ -289,7 +279,7 @@ namespace LinuxSampler {
      * @param microseconds - timing of node from "now" (in microseconds)
      */
     template<typename T>
-    void EventGenerator::scheduleAheadMicroSec(RTAVLTree<T>& queue, T& node, int32_t fragmentPosBase, uint64_t microseconds) {
+    void EventGenerator::scheduleAheadMicroSec(RTTimingWheel<T>& queue, T& node, int32_t fragmentPosBase, uint64_t microseconds) {
         node.scheduleTime = uiTotalSamplesProcessed + fragmentPosBase + float(uiSampleRate) * (float(microseconds) / 1000000.f);
         queue.insert(node);
     }
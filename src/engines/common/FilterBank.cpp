@@ -0,0 +1,376 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#include "FilterBank.h"
+
+#include <string.h>
+
+#if CONFIG_ASM && ARCH_X86 && defined(__SSE__)
+# include <xmmintrin.h>
+# define FILTER_BANK_SSE 1
+#endif
+
+namespace LinuxSampler {
+
+    FilterBank::FilterBank(uint Slots, uint MaxSamplesPerCycle) {
+        uiSlots = Slots;
+        uiSlotsUsed = 0;
+        uiMaxSamplesPerCycle = MaxSamplesPerCycle;
+        // one segment per subfragment, plus the partial subfragments at the
+        // beginning and end of the voice's rendering
+        const uint maxSegments = MaxSamplesPerCycle / CONFIG_DEFAULT_SUBFRAGMENT_SIZE + 2;
+        pSlots       = new Slot[Slots];
+        pBuffers     = new float[Slots * 2 * MaxSamplesPerCycle];
+        pSegmentPool = new Segment[Slots * maxSegments];
+        pDummy       = new float[MaxSamplesPerCycle];
+        memset(pDummy, 0, MaxSamplesPerCycle * sizeof(float));
+        for (uint i = 0; i < Slots; ++i) {
+            pSlots[i].pBuffer[0]    = &pBuffers[(2 * i) * MaxSamplesPerCycle];
+            pSlots[i].pBuffer[1]    = &pBuffers[(2 * i + 1) * MaxSamplesPerCycle];
+            pSlots[i].pSegments     = &pSegmentPool[i * maxSegments];
+            pSlots[i].uiMaxSegments = maxSegments;
+        }
+    }
+
+    FilterBank::~FilterBank() {
+        delete[] pSlots;
+        delete[] pBuffers;
+        delete[] pSegmentPool;
+        delete[] pDummy;
+    }
+
+    FilterBank::Slot* FilterBank::Assign(Filter& filterLeft, Filter& filterRight, int channels) {
+        if (uiSlotsUsed >= uiSlots) return NULL;
+        const int stages = filterLeft.BiquadStages();
+        if (!stages) return NULL;
+        Slot& slot = pSlots[uiSlotsUsed++];
+        slot.pFilter[0] = &filterLeft;
+        slot.pFilter[1] = &filterRight;
+        slot.channels   = channels;
+        slot.stages     = stages;
+        slot.bImmediate = !filterLeft.bCoeffsValid;
+        for (int c = 0; c < channels; ++c) {
+            slot.generation[c] = slot.pFilter[c]->uiGeneration;
+            slot.start[c]      = slot.pFilter[c]->d;
+        }
+        slot.uiSamples  = 0;
+        slot.uiSegments = 0;
+        return &slot;
+    }
+
+    void FilterBank::Slot::AddSegment(gig::SynthesisParam& param, float cutoff, float resonance, float fs) {
+        if (uiSegments < uiMaxSegments) {
+            Segment& seg = pSegments[uiSegments++];
+            seg.offset    = uiSamples;
+            seg.n         = param.uiToGo;
+            seg.pOutLeft  = param.pOutLeft;
+            seg.pOutRight = param.pOutRight;
+            seg.volumeLeft  = param.fFinalVolumeLeft;
+            seg.volumeRight = param.fFinalVolumeRight;
+            #ifdef CONFIG_INTERPOLATE_VOLUME
+            seg.volumeDeltaLeft  = param.fFinalVolumeDeltaLeft;
+            seg.volumeDeltaRight = param.fFinalVolumeDeltaRight;
+            #else
+            seg.volumeDeltaLeft = seg.volumeDeltaRight = 0;
+            #endif
+            FilterData target = start[0];
+            pFilter[0]->pFilter->SetParameters(target, cutoff, resonance, fs);
+            const BiquadFilterData* stage[3] = { &target, &target.d2, &target.d3 };
+            for (int k = 0; k < stages; ++k) {
+                seg.target[k].b0 = stage[k]->b0;
+                seg.target[k].b1 = stage[k]->b1;
+                seg.target[k].b2 = stage[k]->b2;
+                seg.target[k].a1 = stage[k]->a1;
+                seg.target[k].a2 = stage[k]->a2;
+            }
+        } else {
+            // should never happen, but better keep filtering with the last
+            // coefficients than writing beyond the segment array
+            pSegments[uiSegments - 1].n += param.uiToGo;
+        }
+        param.pRawLeft  = pBuffer[0] + uiSamples;
+        param.pRawRight = (channels == 2) ? pBuffer[1] + uiSamples : NULL;
+        uiSamples += param.uiToGo;
+    }
+
+    void FilterBank::Process() {
+        if (!uiSlotsUsed) return;
+        for (int stage = 0; stage < 3; ++stage)
+            ProcessStage(stage);
+        for (uint i = 0; i < uiSlotsUsed; ++i) {
+            Mix(pSlots[i]);
+            WriteBack(pSlots[i]);
+        }
+        uiSlotsUsed = 0;
+    }
+
+    void FilterBank::ProcessStage(int stage) {
+        Lane lanes[4];
+        int count = 0;
+        for (uint i = 0; i < uiSlotsUsed; ++i) {
+            Slot& slot = pSlots[i];
+            if (slot.stages <= stage || !slot.uiSegments) continue;
+            for (int c = 0; c < slot.channels; ++c) {
+                Lane& lane = lanes[count++];
+                lane.pBuffer    = slot.pBuffer[c];
+                lane.pSegments  = slot.pSegments;
+                lane.uiSegments = slot.uiSegments;
+                lane.stage      = stage;
+                lane.bImmediate = slot.bImmediate;
+                lane.pData      = (stage == 0) ? static_cast<BiquadFilterData*>(&slot.start[c]) :
+                                  (stage == 1) ? &slot.start[c].d2 : &slot.start[c].d3;
+                if (count == 4) {
+                    ProcessLanes(lanes, count);
+                    count = 0;
+                }
+            }
+        }
+        if (count) ProcessLanes(lanes, count);
+    }
+
+    /**
+     * Calculates the coefficient increments for the given segment, exactly
+     * like Filter::SetParameters() does for a ramp over one subfragment.
+     */
+    static inline void SegmentStart(const FilterBank::Coefficients& target, uint n, bool bImmediate,
+                                    float& b0, float& b1, float& b2, float& a1, float& a2,
+                                    float& db0, float& db1, float& db2, float& da1, float& da2)
+    {
+        if (bImmediate) {
+            b0 = target.b0; b1 = target.b1; b2 = target.b2;
+            a1 = target.a1; a2 = target.a2;
+            db0 = db1 = db2 = da1 = da2 = 0;
+        } else {
+            const float scale = 1.0f / float(n);
+            db0 = (target.b0 - b0) * scale;
+            db1 = (target.b1 - b1) * scale;
+            db2 = (target.b2 - b2) * scale;
+            da1 = (target.a1 - a1) * scale;
+            da2 = (target.a2 - a2) * scale;
+        }
+    }
+
+#if FILTER_BANK_SSE
+
+    namespace {
+        union vec_t {
+            __m128 v;
+            float  f[4];
+        };
+    }
+
+    void FilterBank::ProcessLanes(Lane* lanes, int count) {
+        vec_t b0, b1, b2, a1, a2, x1, x2, y1, y2;
+        vec_t db0, db1, db2, da1, da2;
+        float* p[4];
+        uint segment[4], segmentEnd[4], length[4];
+        bool active[4];
+        for (int k = 0; k < 4; ++k) {
+            if (k < count) {
+                const BiquadFilterData& d = *lanes[k].pData;
+                b0.f[k] = d.b0; b1.f[k] = d.b1; b2.f[k] = d.b2;
+                a1.f[k] = d.a1; a2.f[k] = d.a2;
+                x1.f[k] = d.x1; x2.f[k] = d.x2;
+                y1.f[k] = d.y1; y2.f[k] = d.y2;
+                const Segment& last = lanes[k].pSegments[lanes[k].uiSegments - 1];
+                length[k] = last.offset + last.n;
+                p[k] = lanes[k].pBuffer;
+                active[k] = true;
+            } else {
+                length[k] = 0;
+                active[k] = false;
+            }
+            segment[k] = segmentEnd[k] = 0;
+            if (!active[k]) {
+                b0.f[k] = b1.f[k] = b2.f[k] = a1.f[k] = a2.f[k] = 0;
+                x1.f[k] = x2.f[k] = y1.f[k] = y2.f[k] = 0;
+                p[k] = pDummy;
+            }
+        }
+        const __m128 denormal = _mm_set1_ps(1e-18f);
+        for (uint t = 0; ; ) {
+            // start new segments and retire finished lanes
+            uint m = uiMaxSamplesPerCycle;
+            bool bAnyActive = false;
+            for (int k = 0; k < 4; ++k) {
+                if (!active[k]) continue;
+                if (t >= length[k]) {
+                    BiquadFilterData& d = *lanes[k].pData;
+                    d.b0 = b0.f[k]; d.b1 = b1.f[k]; d.b2 = b2.f[k];
+                    d.a1 = a1.f[k]; d.a2 = a2.f[k];
+                    d.x1 = x1.f[k]; d.x2 = x2.f[k];
+                    d.y1 = y1.f[k]; d.y2 = y2.f[k];
+                    b0.f[k] = b1.f[k] = b2.f[k] = a1.f[k] = a2.f[k] = 0;
+                    db0.f[k] = db1.f[k] = db2.f[k] = da1.f[k] = da2.f[k] = 0;
+                    x1.f[k] = x2.f[k] = y1.f[k] = y2.f[k] = 0;
+                    p[k] = pDummy;
+                    active[k] = false;
+                    continue;
+                }
+                if (t == segmentEnd[k]) {
+                    const Segment& seg = lanes[k].pSegments[segment[k]];
+                    SegmentStart(
+                        seg.target[lanes[k].stage], seg.n,
+                        lanes[k].bImmediate && segment[k] == 0,
+                        b0.f[k], b1.f[k], b2.f[k], a1.f[k], a2.f[k],
+                        db0.f[k], db1.f[k], db2.f[k], da1.f[k], da2.f[k]
+                    );
+                    segmentEnd[k] = seg.offset + seg.n;
+                    segment[k]++;
+                }
+                bAnyActive = true;
+                if (segmentEnd[k] - t < m) m = segmentEnd[k] - t;
+            }
+            if (!bAnyActive) break;
+
+            // filter the next m sample points of all lanes
+            uint i = 0;
+            for (; i + 4 <= m; i += 4) {
+                __m128 r[4] = {
+                    _mm_loadu_ps(p[0] + i), _mm_loadu_ps(p[1] + i),
+                    _mm_loadu_ps(p[2] + i), _mm_loadu_ps(p[3] + i)
+                };
+                _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+                for (int j = 0; j < 4; ++j) {
+                    b0.v = _mm_add_ps(b0.v, db0.v);
+                    b1.v = _mm_add_ps(b1.v, db1.v);
+                    b2.v = _mm_add_ps(b2.v, db2.v);
+                    a1.v = _mm_add_ps(a1.v, da1.v);
+                    a2.v = _mm_add_ps(a2.v, da2.v);
+                    __m128 y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(b0.v, r[j]), _mm_mul_ps(b1.v, x1.v)),
+                        _mm_mul_ps(b2.v, x2.v)), _mm_mul_ps(a1.v, y1.v)),
+                        _mm_mul_ps(a2.v, y2.v));
+                    y = _mm_sub_ps(_mm_add_ps(y, denormal), denormal);
+                    x2.v = x1.v;
+                    x1.v = r[j];
+                    y2.v = y1.v;
+                    y1.v = y;
+                    r[j] = y;
+                }
+                _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+                _mm_storeu_ps(p[0] + i, r[0]);
+                _mm_storeu_ps(p[1] + i, r[1]);
+                _mm_storeu_ps(p[2] + i, r[2]);
+                _mm_storeu_ps(p[3] + i, r[3]);
+            }
+            for (; i < m; ++i) {
+                vec_t x;
+                x.v = _mm_set_ps(p[3][i], p[2][i], p[1][i], p[0][i]);
+                b0.v = _mm_add_ps(b0.v, db0.v);
+                b1.v = _mm_add_ps(b1.v, db1.v);
+                b2.v = _mm_add_ps(b2.v, db2.v);
+                a1.v = _mm_add_ps(a1.v, da1.v);
+                a2.v = _mm_add_ps(a2.v, da2.v);
+                vec_t y;
+                y.v = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(b0.v, x.v), _mm_mul_ps(b1.v, x1.v)),
+                    _mm_mul_ps(b2.v, x2.v)), _mm_mul_ps(a1.v, y1.v)),
+                    _mm_mul_ps(a2.v, y2.v));
+                y.v = _mm_sub_ps(_mm_add_ps(y.v, denormal), denormal);
+                x2.v = x1.v;
+                x1.v = x.v;
+                y2.v = y1.v;
+                y1.v = y.v;
+                p[0][i] = y.f[0]; p[1][i] = y.f[1];
+                p[2][i] = y.f[2]; p[3][i] = y.f[3];
+            }
+            for (int k = 0; k < 4; ++k)
+                if (active[k]) p[k] += m;
+            t += m;
+        }
+    }
+
+#else // no SSE
+
+    void FilterBank::ProcessLanes(Lane* lanes, int count) {
+        for (int k = 0; k < count; ++k) {
+            BiquadFilterData& d = *lanes[k].pData;
+            float b0 = d.b0, b1 = d.b1, b2 = d.b2, a1 = d.a1, a2 = d.a2;
+            float x1 = d.x1, x2 = d.x2, y1 = d.y1, y2 = d.y2;
+            float db0, db1, db2, da1, da2;
+            for (uint s = 0; s < lanes[k].uiSegments; ++s) {
+                const Segment& seg = lanes[k].pSegments[s];
+                SegmentStart(
+                    seg.target[lanes[k].stage], seg.n, lanes[k].bImmediate && s == 0,
+                    b0, b1, b2, a1, a2, db0, db1, db2, da1, da2
+                );
+                float* pBuf = lanes[k].pBuffer + seg.offset;
+                for (uint i = 0; i < seg.n; ++i) {
+                    b0 += db0; b1 += db1; b2 += db2; a1 += da1; a2 += da2;
+                    const float x = pBuf[i];
+                    float y = b0 * x + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+                    y += 1e-18f; // kill denormals
+                    y -= 1e-18f;
+                    x2 = x1;
+                    x1 = x;
+                    y2 = y1;
+                    y1 = y;
+                    pBuf[i] = y;
+                }
+            }
+            d.b0 = b0; d.b1 = b1; d.b2 = b2; d.a1 = a1; d.a2 = a2;
+            d.x1 = x1; d.x2 = x2; d.y1 = y1; d.y2 = y2;
+        }
+    }
+
+#endif // FILTER_BANK_SSE
+
+    void FilterBank::Mix(const Slot& slot) {
+        for (uint s = 0; s < slot.uiSegments; ++s) {
+            const Segment& seg = slot.pSegments[s];
+            const float* pSrcL = slot.pBuffer[0] + seg.offset;
+            const float* pSrcR = (slot.channels == 2) ? slot.pBuffer[1] + seg.offset : pSrcL;
+            float* pOutL = seg.pOutLeft;
+            float* pOutR = seg.pOutRight;
+            float fVolumeL = seg.volumeLeft;
+            float fVolumeR = seg.volumeRight;
+            #ifdef CONFIG_INTERPOLATE_VOLUME
+            const float fDeltaL = seg.volumeDeltaLeft;
+            const float fDeltaR = seg.volumeDeltaRight;
+            for (uint i = 0; i < seg.n; ++i) {
+                fVolumeL += fDeltaL;
+                fVolumeR += fDeltaR;
+                pOutL[i] += pSrcL[i] * fVolumeL;
+                pOutR[i] += pSrcR[i] * fVolumeR;
+            }
+            #else
+            for (uint i = 0; i < seg.n; ++i) {
+                pOutL[i] += pSrcL[i] * fVolumeL;
+                pOutR[i] += pSrcR[i] * fVolumeR;
+            }
+            #endif
+        }
+    }
+
+    void FilterBank::WriteBack(Slot& slot) {
+        for (int c = 0; c < slot.channels; ++c) {
+            Filter* pFilter = slot.pFilter[c];
+            // the voice might have been freed and re-triggered meanwhile
+            if (pFilter->uiGeneration != slot.generation[c]) continue;
+            pFilter->d = slot.start[c];
+            pFilter->uiRampLeft   = 0;
+            pFilter->bCoeffsValid = true;
+        }
+    }
+
+} // namespace LinuxSampler
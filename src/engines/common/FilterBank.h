@@ -0,0 +1,171 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#ifndef __LS_FILTERBANK_H__
+#define __LS_FILTERBANK_H__
+
+#include "../../common/global_private.h"
+#include "../gig/SynthesisParam.h"
+
+namespace LinuxSampler {
+
+    /** @brief Filters many voices at once.
+     *
+     * An IIR filter can't be vectorized along time, since each output
+     * sample depends on the previous ones. Filtering many voices with the
+     * same filter topology however is perfectly parallel. So instead of
+     * filtering each voice on its own while it is being rendered, voices
+     * using one of the biquad based filter types are deferred to this bank:
+     * the voice just renders its (resampled) sample points into a slot of
+     * the bank and records its filter coefficients and volume for each
+     * subfragment. After all voices of the engine were rendered, Process()
+     * filters the biquad stages of 4 voices (or voice channels) at a time,
+     * each one in its own SIMD lane with its own coefficients, and mixes the
+     * result with the recorded volumes to the voices' output buffers.
+     *
+     * The results are identical to filtering each voice on its own with
+     * Filter::ApplyBlock(), including the linear coefficient ramps over each
+     * subfragment. All memory is allocated by the constructor, all other
+     * methods are real-time safe.
+     */
+    class FilterBank {
+        public:
+            /**
+             * Coefficients of one biquad stage.
+             */
+            struct Coefficients {
+                float b0, b1, b2;
+                float a1, a2;
+            };
+
+            /**
+             * Part of a voice's audio fragment rendered with the same
+             * filter coefficient target and volume ramp (usually one
+             * subfragment).
+             */
+            struct Segment {
+                uint   offset;              ///< Position of the segment's first sample point in the slot's buffers.
+                uint   n;                   ///< Length of the segment in sample points.
+                float* pOutLeft;            ///< Where the segment is mixed to (left channel).
+                float* pOutRight;           ///< Where the segment is mixed to (right channel).
+                float  volumeLeft;          ///< Left volume at the segment's start.
+                float  volumeRight;         ///< Right volume at the segment's start.
+                float  volumeDeltaLeft;     ///< Per sample increment of the left volume.
+                float  volumeDeltaRight;    ///< Per sample increment of the right volume.
+                Coefficients target[3];     ///< Coefficients of each biquad stage at the segment's end.
+            };
+
+            /**
+             * One voice's data of the current audio fragment.
+             */
+            class Slot {
+                public:
+                    /**
+                     * Starts a new segment with the current rendering
+                     * parameters of the voice and redirects its synthesis
+                     * output to this slot.
+                     *
+                     * @param param     - final synthesis parameters of the
+                     *                    voice, uiToGo must already be set
+                     * @param cutoff    - filter cutoff frequency
+                     * @param resonance - filter resonance
+                     * @param fs        - sample rate
+                     */
+                    void AddSegment(gig::SynthesisParam& param, float cutoff, float resonance, float fs);
+
+                protected:
+                    Filter*      pFilter[2];     ///< Filter of each voice channel (state is written back on Process()).
+                    uint         generation[2];  ///< Generation counter of each filter on Assign().
+                    FilterData   start[2];       ///< Filter state and coefficients on Assign().
+                    bool         bImmediate;     ///< First segment's coefficients are set without ramp.
+                    int          channels;       ///< 1 for mono and 2 for stereo voices.
+                    int          stages;         ///< Amount of cascaded biquad stages.
+                    float*       pBuffer[2];     ///< Rendered sample points of each voice channel.
+                    uint         uiSamples;      ///< Amount of sample points rendered to the buffers.
+                    Segment*     pSegments;
+                    uint         uiSegments;
+                    uint         uiMaxSegments;
+
+                    friend class FilterBank;
+            };
+
+            /**
+             * @param Slots              - max. amount of voices per audio
+             *                             fragment
+             * @param MaxSamplesPerCycle - max. audio fragment size
+             */
+            FilterBank(uint Slots, uint MaxSamplesPerCycle);
+            virtual ~FilterBank();
+
+            /**
+             * Assigns a free slot of this bank to a voice for the current
+             * audio fragment.
+             *
+             * @param filterLeft  - the voice's left filter
+             * @param filterRight - the voice's right filter
+             * @param channels    - 1 for mono, 2 for stereo voices
+             * @returns slot, or NULL if all slots are in use or the voice's
+             *          filter type is not supported by this bank (in both
+             *          cases the voice has to filter on its own)
+             */
+            Slot* Assign(Filter& filterLeft, Filter& filterRight, int channels);
+
+            /**
+             * Filters all voices assigned in the current audio fragment,
+             * mixes them to their output buffers and frees all slots.
+             */
+            void Process();
+
+            /**
+             * Max. amount of voices per audio fragment.
+             */
+            uint Slots() const { return uiSlots; }
+
+        protected:
+            /// One biquad stage of one voice channel in a SIMD lane.
+            struct Lane {
+                float*          pBuffer;
+                const Segment*  pSegments;
+                uint            uiSegments;
+                int             stage;
+                bool            bImmediate;  ///< First segment's coefficients are set without ramp.
+                BiquadFilterData* pData;     ///< Stage's state and coefficients (updated by ProcessLanes()).
+            };
+
+            void ProcessStage(int stage);
+            void ProcessLanes(Lane* lanes, int count);
+            void Mix(const Slot& slot);
+            void WriteBack(Slot& slot);
+
+        private:
+            uint      uiSlots;
+            uint      uiSlotsUsed;
+            uint      uiMaxSamplesPerCycle;
+            Slot*     pSlots;
+            float*    pBuffers;
+            Segment*  pSegmentPool;
+            float*    pDummy;        ///< Buffer for unused SIMD lanes.
+    };
+
+} // namespace LinuxSampler
+
+#endif // __LS_FILTERBANK_H__
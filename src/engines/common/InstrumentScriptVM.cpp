@@ -12,6 +12,7 @@
 #include "../../common/global_private.h"
 #include "AbstractInstrumentManager.h"
 #include "MidiKeyboardManager.h"
+#include "ScriptExecContextPool.h"
 
 namespace LinuxSampler {
 
@@ -60,9 +61,13 @@ namespace LinuxSampler {
         handlerRelease = NULL;
         handlerController = NULL;
         pEvents = NULL;
+        pExecContextPool = NULL;
         for (int i = 0; i < 128; ++i)
             pKeyEvents[i] = NULL;
         this->pEngineChannel = pEngineChannel;
+        atomic_set(&budgetOverruns, 0);
+        profileSequence.store(0, memory_order_relaxed);
+        atomic_set(&profileResetRequested, 0);
         for (int i = 0; i < INSTR_SCRIPT_EVENT_GROUPS; ++i)
             eventGroups[i].setScript(this);
     }
@@ -115,6 +120,13 @@ namespace LinuxSampler {
         bHasValidScript =
             handlerInit || handlerNote || handlerRelease || handlerController;
 
+        // prepare the execution statistics for the new script
+        {
+            LockGuard lock(profileMutex);
+            pEngineChannel->pEngine->pScriptVM->prepareProfile(parserContext, &profile);
+        }
+        atomic_set(&budgetOverruns, 0);
+
         // amount of script handlers each script event has to execute
         int handlerExecCount = 0;
         if (handlerNote || handlerRelease || handlerController) // only one of these are executed after "init" handler
@@ -127,12 +139,14 @@ namespace LinuxSampler {
                 pKeyEvents[i] = new RTList<ScriptEvent>(pEvents);
         }
 
-        // create new VM execution contexts for new script
+        // get the engine's VM execution contexts for the new script, which
+        // are assigned to the script events by the engine on demand
+        pExecContextPool = pEngineChannel->pEngine->scriptExecContextPools.Borrow(
+            parserContext, pEngineChannel
+        );
         while (!pEvents->poolIsEmpty()) {
             RTList<ScriptEvent>::Iterator it = pEvents->allocAppend();
-            it->execCtx = pEngineChannel->pEngine->pScriptVM->createExecContext(
-                parserContext
-            );
+            it->execCtx = NULL;
             it->handlers = new VMEventHandler*[handlerExecCount+1];
         }
         pEvents->clear();
@@ -159,21 +173,29 @@ namespace LinuxSampler {
 
         resetEvents();
 
-        // free allocated VM execution contexts
+        // hand back VM execution contexts still assigned to script events
         if (pEvents) {
             pEvents->clear();
             while (!pEvents->poolIsEmpty()) {
                 RTList<ScriptEvent>::Iterator it = pEvents->allocAppend();
                 if (it->execCtx) {
-                    // free VM execution context object
-                    delete it->execCtx;
+                    pExecContextPool->handBack(it->execCtx);
                     it->execCtx = NULL;
+                }
+                if (it->handlers) {
                     // free C array of handler pointers
                     delete [] it->handlers;
+                    it->handlers = NULL;
                 }
             }
             pEvents->clear();
         }
+        if (pExecContextPool) {
+            pEngineChannel->pEngine->scriptExecContextPools.HandBack(
+                pExecContextPool, pEngineChannel
+            );
+            pExecContextPool = NULL;
+        }
         // hand back VM representation of script
         if (parserContext) {
             AbstractInstrumentManager* pManager =
@@ -219,7 +241,7 @@ namespace LinuxSampler {
     // class 'InstrumentScriptVM'
 
     InstrumentScriptVM::InstrumentScriptVM() :
-        m_event(NULL), m_fnPlayNote(this), m_fnSetController(this),
+        m_event(NULL), m_fnPlayNote(this), m_fnPlayNotes(this), m_fnSetController(this),
         m_fnIgnoreEvent(this), m_fnIgnoreController(this), m_fnNoteOff(this),
         m_fnSetEventMark(this), m_fnDeleteEventMark(this), m_fnByMarks(this)
     {
@@ -240,6 +262,25 @@ namespace LinuxSampler {
         m_CC.data = (int8_t*) &pEngineChannel->ControllerTable[0];
         m_KEY_DOWN.data = &pEngineChannel->GetMidiKeyboardManager()->KeyDown[0];
 
+        // let the VM collect execution statistics if requested
+        InstrumentScript* pScript = pEngineChannel->pScript;
+        VMScriptProfile* pProfile =
+            (pEngineChannel->bScriptProfiling && pScript) ? &pScript->profile : NULL;
+        if (pProfile) {
+            // mark the statistics as being updated (odd sequence number), see
+            // AbstractEngineChannel::GetScriptProfile() for the reading side
+            pScript->profileSequence.store(
+                pScript->profileSequence.load(memory_order_relaxed) + 1,
+                memory_order_relaxed
+            );
+            atomic_thread_fence(memory_order_release);
+            if (atomic_read(&pScript->profileResetRequested)) {
+                atomic_set(&pScript->profileResetRequested, 0);
+                pProfile->reset();
+            }
+        }
+        event->execCtx->setProfile(pProfile);
+
         // if script is in start condition, then do mandatory MIDI event
         // preprocessing tasks, which essentially means updating i.e. controller
         // table with new CC value in case of a controller event, because the
@@ -268,7 +309,15 @@ namespace LinuxSampler {
                 parserCtx, event->execCtx, event->handlers[event->currentHandler]
             );
             event->executionSlices++;
-            if (res & VM_EXEC_SUSPENDED || res & VM_EXEC_ERROR) return res;
+            if (res & VM_EXEC_SUSPENDED || res & VM_EXEC_ERROR) break;
+        }
+
+        if (pProfile) {
+            // statistics are consistent again (even sequence number)
+            pScript->profileSequence.store(
+                pScript->profileSequence.load(memory_order_relaxed) + 1,
+                memory_order_release
+            );
         }
 
         return res;
@@ -316,6 +365,7 @@ namespace LinuxSampler {
     VMFunction* InstrumentScriptVM::functionByName(const String& name) {
         // built-in script functions of this class
         if      (name == "play_note") return &m_fnPlayNote;
+        else if (name == "play_notes") return &m_fnPlayNotes;
         else if (name == "set_controller") return &m_fnSetController;
         else if (name == "ignore_event") return &m_fnIgnoreEvent;
         else if (name == "ignore_controller") return &m_fnIgnoreController;
@@ -15,6 +15,9 @@
 #include "../../scriptvm/ScriptVM.h"
 #include "Event.h"
 #include "../../common/Pool.h"
+#include "../../common/Mutex.h"
+#include "../../common/atomic.h"
+#include "../../common/lsatomic.h"
 #include "InstrumentScriptVMFunctions.h"
 
 /**
@@ -39,6 +42,7 @@ namespace LinuxSampler {
 
     class AbstractEngineChannel;
     class InstrumentScript;
+    class ScriptExecContextPool;
 
     /** @brief Convert IDs between script scope and engine internal scope.
      *
@@ -177,12 +181,18 @@ namespace LinuxSampler {
         VMEventHandler*       handlerNote; ///< VM representation of script's MIDI note on callback or NULL if current script did not define such an event handler.
         VMEventHandler*       handlerRelease; ///< VM representation of script's MIDI note off callback or NULL if current script did not define such an event handler.
         VMEventHandler*       handlerController; ///< VM representation of script's MIDI controller callback or NULL if current script did not define such an event handler.
-        Pool<ScriptEvent>*    pEvents; ///< Pool of all available script execution instances. ScriptEvents available to be allocated from the Pool are currently unused / not executiong, whereas the ScriptEvents allocated on the list are currently suspended / have not finished execution yet (@see pKeyEvents).
+        Pool<ScriptEvent>*    pEvents; ///< Pool of all available script execution instances (without VM execution context, @see pExecContextPool). ScriptEvents available to be allocated from the Pool are currently unused / not executiong, whereas the ScriptEvents allocated on the list are currently suspended / have not finished execution yet (@see pKeyEvents).
         RTList<ScriptEvent>*  pKeyEvents[128]; ///< Stores previously finished executed "note on" script events for the respective active note/key as long as the key/note is active. This is however only done if there is a "note" script event handler and a "release" script event handler defined in the script and both handlers use (reference) polyphonic variables. If that is not the case, then this list is not used at all. So the purpose of pKeyEvents is only to implement preserving/passing polyphonic variable data from "on note .. end on" script block to the respective "on release .. end on" script block.
-        RTAVLTree<ScriptEvent> suspendedEvents; ///< Contains pointers to all suspended events, sorted by time when those script events are to be resumed next.
+        ScriptExecContextPool* pExecContextPool; ///< VM execution contexts for the script events of this script, shared with all other engine channels of the same engine using the same script. Script events get a context assigned from this pool when they are spawned and return it when they are freed by the engine.
+        RTTimingWheel<ScriptEvent> suspendedEvents; ///< Contains pointers to all suspended events, sorted by time when those script events are to be resumed next.
         AbstractEngineChannel* pEngineChannel;
         String                code; ///< Source code of the instrument script. Used in case the sampler engine is changed, in that case a new ScriptVM object is created for the engine and VMParserContext object for this script needs to be recreated as well. Thus the script is then parsed again by passing the source code to recreate the parser context.
         EventGroup            eventGroups[INSTR_SCRIPT_EVENT_GROUPS]; ///< Used for built-in script functions: by_event_marks(), set_event_mark(), delete_event_mark().
+        VMScriptProfile       profile; ///< Execution statistics of this script on this engine channel, only collected while AbstractEngineChannel::bScriptProfiling is set.
+        Mutex                 profileMutex; ///< Protects @c profile from being resized (by load()) while it is read by another thread. Not used by the audio thread.
+        atomic<int>           profileSequence; ///< Odd while the audio thread is updating @c profile, incremented once before and once after each update, so other threads can detect (and retry) a copy of @c profile which was torn by the audio thread.
+        atomic_t              profileResetRequested; ///< Set by other threads to let the audio thread clear @c profile before it updates it the next time (the audio thread is the only one writing to @c profile).
+        atomic_t              budgetOverruns; ///< How often an event handler of this script exhausted its execution budget and was preempted by the VM since the script was loaded.
 
         InstrumentScript(AbstractEngineChannel* pEngineChannel);
         ~InstrumentScript();
@@ -226,6 +236,7 @@ namespace LinuxSampler {
 
         // buil-in script functions
         InstrumentScriptVMFunction_play_note m_fnPlayNote;
+        InstrumentScriptVMFunction_play_notes m_fnPlayNotes;
         InstrumentScriptVMFunction_set_controller m_fnSetController;
         InstrumentScriptVMFunction_ignore_event m_fnIgnoreEvent;
         InstrumentScriptVMFunction_ignore_controller m_fnIgnoreController;
@@ -235,6 +246,7 @@ namespace LinuxSampler {
         InstrumentScriptVMFunction_by_marks m_fnByMarks;
 
         friend class InstrumentScriptVMFunction_play_note;
+        friend class InstrumentScriptVMFunction_play_notes;
         friend class InstrumentScriptVMFunction_set_controller;
         friend class InstrumentScriptVMFunction_ignore_event;
         friend class InstrumentScriptVMFunction_ignore_controller;
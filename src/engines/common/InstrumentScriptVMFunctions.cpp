@@ -79,6 +79,88 @@ namespace LinuxSampler {
         return successResult( ScriptID::fromNoteID(id) );
     }
 
+    InstrumentScriptVMFunction_play_notes::InstrumentScriptVMFunction_play_notes(InstrumentScriptVM* parent)
+        : m_vm(parent)
+    {
+    }
+
+    bool InstrumentScriptVMFunction_play_notes::acceptsArgType(int iArg, ExprType_t type) const {
+        return (iArg < 2) ? type == INT_ARR_EXPR : type == INT_EXPR;
+    }
+
+    VMFnResult* InstrumentScriptVMFunction_play_notes::exec(VMFnArgs* args) {
+        VMIntArrayExpr* notes = args->arg(0)->asIntArray();
+        VMIntArrayExpr* ids = args->arg(1)->asIntArray();
+        int velocity = (args->argsCount() >= 3) ? args->arg(2)->asInt()->evalInt() : 127;
+        int sampleoffset = (args->argsCount() >= 4) ? args->arg(3)->asInt()->evalInt() : 0;
+        int duration = (args->argsCount() >= 5) ? args->arg(4)->asInt()->evalInt() : 0;
+
+        if (velocity < 0 || velocity > 127) {
+            errMsg("play_notes(): argument 3 is an invalid velocity value");
+            return errorResult(0);
+        }
+
+        if (sampleoffset < 0) {
+            errMsg("play_notes(): argument 4 may not be a negative sample offset");
+            return errorResult(0);
+        } else if (sampleoffset != 0) {
+            wrnMsg("play_notes(): argument 4 does not support a sample offset other than 0 yet");
+        }
+
+        if (duration < -1) {
+            errMsg("play_notes(): argument 5 must be a duration value of at least -1 or higher");
+            return errorResult(0);
+        }
+
+        AbstractEngineChannel* pEngineChannel =
+            static_cast<AbstractEngineChannel*>(m_vm->m_event->cause.pEngineChannel);
+
+        // the note-on event is prepared only once for all notes
+        Event e = m_vm->m_event->cause; // copy to get fragment time for "now"
+        e.Init(); // clear IDs
+        // make the new notes dependent to the life time of the original note
+        if (duration == -1) {
+            if (m_vm->currentVMEventHandler()->eventHandlerType() != VM_EVENT_HANDLER_NOTE) {
+                errMsg("play_notes(): -1 for argument 5 may only be used for note event handlers");
+                return errorResult(0);
+            }
+            e.Param.Note.ParentNoteID = m_vm->m_event->cause.Param.Note.ID;
+        }
+
+        // trigger all notes of the array, invalid note numbers (i.e. -1 for
+        // unused array elements) are skipped and get ID 0
+        int triggered = 0;
+        const int n = notes->arraySize();
+        const int nIDs = ids->arraySize();
+        for (int i = 0; i < n; ++i) {
+            const int note = notes->evalIntElement(i);
+            note_id_t id = 0;
+            if (note >= 0 && note <= 127) {
+                e.Type = Event::type_note_on;
+                e.Param.Note.Key = note;
+                e.Param.Note.Velocity = velocity;
+                id = pEngineChannel->ScheduleNoteMicroSec(&e, 0);
+
+                // if a duration is supplied (and note-on event was scheduled
+                // successfully above), then schedule a subsequent note-off event
+                if (id && duration > 0) {
+                    e.Type = Event::type_note_off;
+                    e.Param.Note.Velocity = 127;
+                    pEngineChannel->ScheduleEventMicroSec(&e, duration);
+                }
+                if (id) triggered++;
+            }
+            // notes skipped or not scheduled get a plain 0, which (unlike
+            // ScriptID::fromNoteID(0)) scripts can test for
+            if (i < nIDs) ids->assignIntElement(i, id ? ScriptID::fromNoteID(id) : ScriptID(0));
+        }
+
+        // like play_note(), don't abort the script if the engine could not
+        // schedule all notes under heavy load, the amount of notes actually
+        // triggered is returned instead
+        return successResult(triggered);
+    }
+
     InstrumentScriptVMFunction_set_controller::InstrumentScriptVMFunction_set_controller(InstrumentScriptVM* parent)
         : m_vm(parent)
     {
@@ -235,8 +317,22 @@ namespace LinuxSampler {
     {
     }
 
+    bool InstrumentScriptVMFunction_set_event_mark::acceptsArgType(int iArg, ExprType_t type) const {
+        return type == INT_EXPR || (iArg == 0 && type == INT_ARR_EXPR);
+    }
+
+    /// Returns true if the event or note with the given script ID still exists.
+    static bool _eventExists(AbstractEngineChannel* pEngineChannel, const ScriptID& id) {
+        switch (id.type()) {
+            case ScriptID::EVENT:
+                return pEngineChannel->pEngine->EventByID( id.eventID() );
+            case ScriptID::NOTE:
+                return pEngineChannel->pEngine->NoteByID( id.noteID() );
+        }
+        return false;
+    }
+
     VMFnResult* InstrumentScriptVMFunction_set_event_mark::exec(VMFnArgs* args) {
-        const ScriptID id = args->arg(0)->asInt()->evalInt();
         const int groupID = args->arg(1)->asInt()->evalInt();
 
         if (groupID < 0 || groupID >= INSTR_SCRIPT_EVENT_GROUPS) {
@@ -246,23 +342,22 @@ namespace LinuxSampler {
 
         AbstractEngineChannel* pEngineChannel =
             static_cast<AbstractEngineChannel*>(m_vm->m_event->cause.pEngineChannel);
+        EventGroup& group = pEngineChannel->pScript->eventGroups[groupID];
 
-        // check if the event/note still exists
-        switch (id.type()) {
-            case ScriptID::EVENT: {
-                RTList<Event>::Iterator itEvent = pEngineChannel->pEngine->EventByID( id.eventID() );
-                if (!itEvent) return successResult();
-                break;
-            }
-            case ScriptID::NOTE: {
-                NoteBase* pNote = pEngineChannel->pEngine->NoteByID( id.noteID() );
-                if (!pNote) return successResult();
-                break;
+        if (args->arg(0)->exprType() == INT_EXPR) {
+            const ScriptID id = args->arg(0)->asInt()->evalInt();
+            // check if the event/note still exists
+            if (_eventExists(pEngineChannel, id))
+                group.insert(id);
+        } else if (args->arg(0)->exprType() == INT_ARR_EXPR) {
+            VMIntArrayExpr* ids = args->arg(0)->asIntArray();
+            for (int i = 0; i < ids->arraySize(); ++i) {
+                const ScriptID id = ids->evalIntElement(i);
+                if (id && _eventExists(pEngineChannel, id))
+                    group.insert(id);
             }
         }
 
-        pEngineChannel->pScript->eventGroups[groupID].insert(id);
-
         return successResult();
     }
 
@@ -271,8 +366,11 @@ namespace LinuxSampler {
     {
     }
 
+    bool InstrumentScriptVMFunction_delete_event_mark::acceptsArgType(int iArg, ExprType_t type) const {
+        return type == INT_EXPR || (iArg == 0 && type == INT_ARR_EXPR);
+    }
+
     VMFnResult* InstrumentScriptVMFunction_delete_event_mark::exec(VMFnArgs* args) {
-        const ScriptID id = args->arg(0)->asInt()->evalInt();
         const int groupID = args->arg(1)->asInt()->evalInt();
 
         if (groupID < 0 || groupID >= INSTR_SCRIPT_EVENT_GROUPS) {
@@ -282,8 +380,16 @@ namespace LinuxSampler {
 
         AbstractEngineChannel* pEngineChannel =
             static_cast<AbstractEngineChannel*>(m_vm->m_event->cause.pEngineChannel);
+        EventGroup& group = pEngineChannel->pScript->eventGroups[groupID];
 
-        pEngineChannel->pScript->eventGroups[groupID].erase(id);
+        if (args->arg(0)->exprType() == INT_EXPR) {
+            const ScriptID id = args->arg(0)->asInt()->evalInt();
+            group.erase(id);
+        } else if (args->arg(0)->exprType() == INT_ARR_EXPR) {
+            VMIntArrayExpr* ids = args->arg(0)->asIntArray();
+            for (int i = 0; i < ids->arraySize(); ++i)
+                group.erase(ids->evalIntElement(i));
+        }
 
         return successResult();
     }
@@ -30,6 +30,18 @@ namespace LinuxSampler {
         InstrumentScriptVM* m_vm;
     };
 
+    class InstrumentScriptVMFunction_play_notes : public VMIntResultFunction {
+    public:
+        InstrumentScriptVMFunction_play_notes(InstrumentScriptVM* parent);
+        int minRequiredArgs() const { return 2; }
+        int maxAllowedArgs() const { return 5; }
+        bool acceptsArgType(int iArg, ExprType_t type) const;
+        ExprType_t argType(int iArg) const { return (iArg < 2) ? INT_ARR_EXPR : INT_EXPR; }
+        VMFnResult* exec(VMFnArgs* args);
+    protected:
+        InstrumentScriptVM* m_vm;
+    };
+
     class InstrumentScriptVMFunction_set_controller : public VMIntResultFunction {
     public:
         InstrumentScriptVMFunction_set_controller(InstrumentScriptVM* parent);
@@ -83,7 +95,7 @@ namespace LinuxSampler {
         InstrumentScriptVMFunction_set_event_mark(InstrumentScriptVM* parent);
         int minRequiredArgs() const { return 2; }
         int maxAllowedArgs() const { return 2; }
-        bool acceptsArgType(int iArg, ExprType_t type) const { return type == INT_EXPR;}
+        bool acceptsArgType(int iArg, ExprType_t type) const;
         ExprType_t argType(int iArg) const { return INT_EXPR; }
         VMFnResult* exec(VMFnArgs* args);
     protected:
@@ -95,7 +107,7 @@ namespace LinuxSampler {
         InstrumentScriptVMFunction_delete_event_mark(InstrumentScriptVM* parent);
         int minRequiredArgs() const { return 2; }
         int maxAllowedArgs() const { return 2; }
-        bool acceptsArgType(int iArg, ExprType_t type) const { return type == INT_EXPR;}
+        bool acceptsArgType(int iArg, ExprType_t type) const;
         ExprType_t argType(int iArg) const { return INT_EXPR; }
         VMFnResult* exec(VMFnArgs* args);
     protected:
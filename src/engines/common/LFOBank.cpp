@@ -0,0 +1,466 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#include "LFOBank.h"
+#include "LFOTriangleDiHarmonic.h"
+#include "../../common/global_private.h"
+
+#include <string.h>
+
+#if CONFIG_ASM && ARCH_X86 && defined(__SSE2__)
+# include <emmintrin.h>
+# define LFO_BANK_SSE2 1
+#endif
+
+namespace LinuxSampler {
+
+    int LFOBank::iSignedTriangleAlgorithm   = CONFIG_SIGNED_TRIANG_ALGO;
+    int LFOBank::iUnsignedTriangleAlgorithm = CONFIG_UNSIGNED_TRIANG_ALGO;
+
+    namespace {
+        const unsigned int intLimit = (unsigned int) -1; // all 0xFFFF...
+
+        // sin(2 * PI * phase / 2^32), as Taylor series of the phase folded
+        // to -PI/2 .. +PI/2 (max. error below 1e-7)
+        inline float sinePhase(uint32_t phase) {
+            float q = float(int32_t(phase ^ 0x80000000)) * (1.0f / 4294967296.0f); // phase - 0.5
+            if (q > 0.25f) q = 0.5f - q;
+            else if (q < -0.25f) q = -0.5f - q;
+            const float y  = q * float(2.0 * M_PI);
+            const float y2 = y * y;
+            const float s = y * (1.0f + y2 * (-1.0f / 6.0f + y2 * (1.0f / 120.0f + y2 * (-1.0f / 5040.0f + y2 * (1.0f / 362880.0f + y2 * (-1.0f / 39916800.0f))))));
+            return -s;
+        }
+    }
+
+    // *************** LFOBank ***************
+    // *
+
+    LFOBank::LFOBank(unsigned int Voices, unsigned int LFOsPerVoice, unsigned int MaxSteps) {
+        uiLanesPerLFO = (Voices + 3) & ~3;
+        uiLanes       = uiLanesPerLFO * LFOsPerVoice;
+        uiMaxSteps    = MaxSteps;
+        pLevel    = new int32_t[uiLanes];
+        pInc      = new int32_t[uiLanes];
+        pWidth    = new uint32_t[uiLanes];
+        pReal1    = new float[uiLanes];
+        pImag1    = new float[uiLanes];
+        pReal2    = new float[uiLanes];
+        pImag2    = new float[uiLanes];
+        pC1       = new float[uiLanes];
+        pC2       = new float[uiLanes];
+        pWave     = new uint8_t[uiLanes];
+        pEnlisted = new uint8_t[uiLanes / 4];
+        pLFOs     = new LFO*[uiLanes];
+        pBuffer   = new float[uiLanes * MaxSteps];
+        memset(pLevel,    0, uiLanes * sizeof(int32_t));
+        memset(pInc,      0, uiLanes * sizeof(int32_t));
+        memset(pWidth,    0, uiLanes * sizeof(uint32_t));
+        memset(pReal1,    0, uiLanes * sizeof(float));
+        memset(pImag1,    0, uiLanes * sizeof(float));
+        memset(pReal2,    0, uiLanes * sizeof(float));
+        memset(pImag2,    0, uiLanes * sizeof(float));
+        memset(pC1,       0, uiLanes * sizeof(float));
+        memset(pC2,       0, uiLanes * sizeof(float));
+        memset(pWave,     wave_triangle_int_math, uiLanes);
+        memset(pEnlisted, 0, uiLanes / 4);
+        memset(pLFOs,     0, uiLanes * sizeof(LFO*));
+    }
+
+    LFOBank::~LFOBank() {
+        delete[] pLevel;
+        delete[] pInc;
+        delete[] pWidth;
+        delete[] pReal1;
+        delete[] pImag1;
+        delete[] pReal2;
+        delete[] pImag2;
+        delete[] pC1;
+        delete[] pC2;
+        delete[] pWave;
+        delete[] pEnlisted;
+        delete[] pLFOs;
+        delete[] pBuffer;
+    }
+
+    bool LFOBank::SetTriangleAlgorithm(range_type_t Range, int Algorithm) {
+        if (Algorithm != INT_MATH_SOLUTION && Algorithm != INT_ABS_MATH_SOLUTION &&
+            Algorithm != DI_HARMONIC_SOLUTION) return false;
+        if (Range == range_signed) iSignedTriangleAlgorithm = Algorithm;
+        else iUnsignedTriangleAlgorithm = Algorithm;
+        return true;
+    }
+
+    int LFOBank::GetTriangleAlgorithm(range_type_t Range) {
+        return (Range == range_signed) ? iSignedTriangleAlgorithm : iUnsignedTriangleAlgorithm;
+    }
+
+    void LFOBank::Render(unsigned int Steps) {
+        const unsigned int chunks = uiLanes / 4;
+        for (unsigned int chunk = 0; chunk < chunks; ++chunk) {
+            const int mask = pEnlisted[chunk];
+            const unsigned int first = chunk * 4;
+            if (!mask || Steps > uiMaxSteps) {
+                for (int k = 0; k < 4; ++k)
+                    if (pLFOs[first + k]) pLFOs[first + k]->uiLeft = 0;
+                pEnlisted[chunk] = 0;
+                continue;
+            }
+            RenderChunk(chunk, Steps, mask);
+            for (int k = 0; k < 4; ++k) {
+                LFO* pLFO = pLFOs[first + k];
+                if (!pLFO) continue;
+                if (mask & (1 << k)) {
+                    pLFO->pNext  = &pBuffer[BufferPos(first + k, 0)];
+                    pLFO->uiLeft = Steps;
+                } else pLFO->uiLeft = 0;
+            }
+            pEnlisted[chunk] = 0;
+        }
+    }
+
+    float LFOBank::RenderStep(unsigned int Lane) {
+        switch (pWave[Lane]) {
+            case wave_triangle_int_math: {
+                const int32_t level = int32_t(uint32_t(pLevel[Lane]) + uint32_t(pInc[Lane]));
+                pLevel[Lane] = level;
+                const int32_t sign = level >> 31;
+                return float(int32_t(uint32_t(level ^ sign) - uint32_t(sign)));
+            }
+            case wave_triangle_di_harmonic:
+                pReal1[Lane] -= pC1[Lane] * pImag1[Lane];
+                pImag1[Lane] += pC1[Lane] * pReal1[Lane];
+                pReal2[Lane] -= pC2[Lane] * pImag2[Lane];
+                pImag2[Lane] += pC2[Lane] * pReal2[Lane];
+                return pReal1[Lane] + pReal2[Lane] * AMP2;
+            case wave_sine:
+                pLevel[Lane] = int32_t(uint32_t(pLevel[Lane]) + uint32_t(pInc[Lane]));
+                return sinePhase(uint32_t(pLevel[Lane]));
+            case wave_saw_up:
+                pLevel[Lane] = int32_t(uint32_t(pLevel[Lane]) + uint32_t(pInc[Lane]));
+                return float(uint32_t(pLevel[Lane]));
+            case wave_saw_down:
+                pLevel[Lane] = int32_t(uint32_t(pLevel[Lane]) + uint32_t(pInc[Lane]));
+                return float(intLimit - uint32_t(pLevel[Lane]));
+            case wave_pulse:
+                pLevel[Lane] = int32_t(uint32_t(pLevel[Lane]) + uint32_t(pInc[Lane]));
+                return (uint32_t(pLevel[Lane]) <= pWidth[Lane]) ? 1.0f : 0.0f;
+        }
+        return 0.0f;
+    }
+
+    void LFOBank::RenderChunkScalar(unsigned int Chunk, unsigned int Steps, int Mask) {
+        for (int k = 0; k < 4; ++k) {
+            if (!(Mask & (1 << k))) continue;
+            const unsigned int lane = Chunk * 4 + k;
+            float* out = &pBuffer[BufferPos(lane, 0)];
+            for (unsigned int s = 0; s < Steps; ++s)
+                out[s * 4] = RenderStep(lane);
+        }
+    }
+
+#if LFO_BANK_SSE2
+
+    namespace {
+        // converts unsigned 32 bit integers to float (SSE2 only converts
+        // signed ones), rounded the same way as a scalar conversion
+        inline __m128 toFloat(__m128i u) {
+            const __m128 hi = _mm_cvtepi32_ps(_mm_srli_epi32(u, 16));
+            const __m128 lo = _mm_cvtepi32_ps(_mm_and_si128(u, _mm_set1_epi32(0xffff)));
+            return _mm_add_ps(_mm_mul_ps(hi, _mm_set1_ps(65536.0f)), lo);
+        }
+    }
+
+    void LFOBank::RenderChunk(unsigned int Chunk, unsigned int Steps, int Mask) {
+        // all enlisted lanes must share the same wave form, otherwise they
+        // are calculated one by one
+        const unsigned int first = Chunk * 4;
+        int wave = -1;
+        for (int k = 0; k < 4; ++k) {
+            if (!(Mask & (1 << k))) continue;
+            if (wave < 0) wave = pWave[first + k];
+            else if (wave != pWave[first + k]) {
+                RenderChunkScalar(Chunk, Steps, Mask);
+                return;
+            }
+        }
+
+        // lanes which are not enlisted keep their state by advancing them
+        // with an increment of zero
+        const __m128i mask = _mm_set_epi32((Mask & 8) ? -1 : 0, (Mask & 4) ? -1 : 0,
+                                           (Mask & 2) ? -1 : 0, (Mask & 1) ? -1 : 0);
+        const __m128i signBit = _mm_set1_epi32(0x80000000);
+        float* out = &pBuffer[BufferPos(first, 0)];
+
+        if (wave == wave_triangle_di_harmonic) {
+            __m128 real1 = _mm_loadu_ps(&pReal1[first]);
+            __m128 imag1 = _mm_loadu_ps(&pImag1[first]);
+            __m128 real2 = _mm_loadu_ps(&pReal2[first]);
+            __m128 imag2 = _mm_loadu_ps(&pImag2[first]);
+            const __m128 c1 = _mm_and_ps(_mm_loadu_ps(&pC1[first]), _mm_castsi128_ps(mask));
+            const __m128 c2 = _mm_and_ps(_mm_loadu_ps(&pC2[first]), _mm_castsi128_ps(mask));
+            const __m128 amp2 = _mm_set1_ps(AMP2);
+            for (unsigned int s = 0; s < Steps; ++s) {
+                real1 = _mm_sub_ps(real1, _mm_mul_ps(c1, imag1));
+                imag1 = _mm_add_ps(imag1, _mm_mul_ps(c1, real1));
+                real2 = _mm_sub_ps(real2, _mm_mul_ps(c2, imag2));
+                imag2 = _mm_add_ps(imag2, _mm_mul_ps(c2, real2));
+                _mm_storeu_ps(&out[s * 4], _mm_add_ps(real1, _mm_mul_ps(real2, amp2)));
+            }
+            _mm_storeu_ps(&pReal1[first], real1);
+            _mm_storeu_ps(&pImag1[first], imag1);
+            _mm_storeu_ps(&pReal2[first], real2);
+            _mm_storeu_ps(&pImag2[first], imag2);
+            return;
+        }
+
+        __m128i level = _mm_loadu_si128((const __m128i*) &pLevel[first]);
+        const __m128i inc = _mm_and_si128(_mm_loadu_si128((const __m128i*) &pInc[first]), mask);
+        switch (wave) {
+            case wave_triangle_int_math:
+                for (unsigned int s = 0; s < Steps; ++s) {
+                    level = _mm_add_epi32(level, inc);
+                    const __m128i sign = _mm_srai_epi32(level, 31);
+                    const __m128i abs  = _mm_sub_epi32(_mm_xor_si128(level, sign), sign);
+                    _mm_storeu_ps(&out[s * 4], _mm_cvtepi32_ps(abs));
+                }
+                break;
+            case wave_sine: {
+                const __m128 scale = _mm_set1_ps(1.0f / 4294967296.0f);
+                const __m128 half  = _mm_set1_ps(0.5f);
+                const __m128 twoPi = _mm_set1_ps(float(2.0 * M_PI));
+                const __m128 t3  = _mm_set1_ps(-1.0f / 6.0f);
+                const __m128 t5  = _mm_set1_ps(1.0f / 120.0f);
+                const __m128 t7  = _mm_set1_ps(-1.0f / 5040.0f);
+                const __m128 t9  = _mm_set1_ps(1.0f / 362880.0f);
+                const __m128 t11 = _mm_set1_ps(-1.0f / 39916800.0f);
+                for (unsigned int s = 0; s < Steps; ++s) {
+                    level = _mm_add_epi32(level, inc);
+                    // fold the phase to -1/4 .. +1/4 (see sinePhase())
+                    __m128 q = _mm_mul_ps(_mm_cvtepi32_ps(_mm_xor_si128(level, signBit)), scale);
+                    const __m128 upper = _mm_cmpgt_ps(q, _mm_set1_ps(0.25f));
+                    const __m128 lower = _mm_cmplt_ps(q, _mm_set1_ps(-0.25f));
+                    q = _mm_or_ps(_mm_and_ps(upper, _mm_sub_ps(half, q)), _mm_andnot_ps(upper, q));
+                    q = _mm_or_ps(_mm_and_ps(lower, _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(half, q))), _mm_andnot_ps(lower, q));
+                    const __m128 y  = _mm_mul_ps(q, twoPi);
+                    const __m128 y2 = _mm_mul_ps(y, y);
+                    __m128 p = _mm_add_ps(t9, _mm_mul_ps(y2, t11));
+                    p = _mm_add_ps(t7, _mm_mul_ps(y2, p));
+                    p = _mm_add_ps(t5, _mm_mul_ps(y2, p));
+                    p = _mm_add_ps(t3, _mm_mul_ps(y2, p));
+                    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(y2, p));
+                    _mm_storeu_ps(&out[s * 4], _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(y, p)));
+                }
+                break;
+            }
+            case wave_saw_up:
+                for (unsigned int s = 0; s < Steps; ++s) {
+                    level = _mm_add_epi32(level, inc);
+                    _mm_storeu_ps(&out[s * 4], toFloat(level));
+                }
+                break;
+            case wave_saw_down: {
+                const __m128i ones = _mm_set1_epi32(-1);
+                for (unsigned int s = 0; s < Steps; ++s) {
+                    level = _mm_add_epi32(level, inc);
+                    _mm_storeu_ps(&out[s * 4], toFloat(_mm_xor_si128(level, ones)));
+                }
+                break;
+            }
+            case wave_pulse: {
+                // unsigned comparison by flipping the sign bits
+                const __m128i width = _mm_xor_si128(_mm_loadu_si128((const __m128i*) &pWidth[first]), signBit);
+                const __m128  one   = _mm_set1_ps(1.0f);
+                for (unsigned int s = 0; s < Steps; ++s) {
+                    level = _mm_add_epi32(level, inc);
+                    const __m128i above = _mm_cmpgt_epi32(_mm_xor_si128(level, signBit), width);
+                    _mm_storeu_ps(&out[s * 4], _mm_andnot_ps(_mm_castsi128_ps(above), one));
+                }
+                break;
+            }
+        }
+        _mm_storeu_si128((__m128i*) &pLevel[first], level);
+    }
+
+#else // no SSE2
+
+    void LFOBank::RenderChunk(unsigned int Chunk, unsigned int Steps, int Mask) {
+        RenderChunkScalar(Chunk, Steps, Mask);
+    }
+
+#endif // LFO_BANK_SSE2
+
+    // *************** LFOBank::LFO ***************
+    // *
+
+    LFOBank::LFO::LFO(range_type_t Range, float Max) {
+        ExtController = 0;
+        pBank         = NULL;
+        uiLane        = 0;
+        pNext         = NULL;
+        uiLeft        = 0;
+        Wave          = wave_triangle_int_math;
+        InternalDepth = ExtControlDepthCoeff = 0.0f;
+        normalizer    = offset = 0.0f;
+        this->Range   = Range;
+        this->Max     = Max;
+    }
+
+    void LFOBank::LFO::Bind(LFOBank* pBank, unsigned int Lane) {
+        this->pBank  = pBank;
+        this->uiLane = Lane;
+        this->uiLeft = 0;
+        pBank->pLFOs[Lane] = this;
+    }
+
+    void LFOBank::LFO::trigger(shape_t Shape, float Frequency, start_level_t StartLevel, uint16_t InternalDepth, uint16_t ExtControlDepth, bool FlipPhase, unsigned int SampleRate, float PulseWidth) {
+        const unsigned int lane = uiLane;
+        switch (Shape) {
+            case shape_triangle:
+                Wave = (GetTriangleAlgorithm(Range) == DI_HARMONIC_SOLUTION) ?
+                           wave_triangle_di_harmonic : wave_triangle_int_math;
+                break;
+            case shape_sine:
+                Wave = wave_sine;
+                break;
+            case shape_saw_up:
+                Wave = wave_saw_up;
+                break;
+            case shape_saw_down:
+                Wave = wave_saw_down;
+                break;
+            case shape_pulse:
+                Wave = wave_pulse;
+                break;
+        }
+
+        this->InternalDepth        = (InternalDepth / 1200.0f) * this->Max;
+        this->ExtControlDepthCoeff = (((float) ExtControlDepth / 1200.0f) / 127.0f) * this->Max;
+
+        const float r = Frequency / (float) SampleRate; // frequency alteration quotient
+        int c = (int) (intLimit * r);
+        uint32_t level = 0;
+
+        if (Wave == wave_triangle_di_harmonic) {
+            const float harmonicCompensation = 1.0f + fabsf(AMP2); // to compensate the 2nd harmonic's amplitude overhead
+            this->InternalDepth        /= harmonicCompensation;
+            this->ExtControlDepthCoeff /= harmonicCompensation;
+
+            pBank->pC1[lane] = 2.0f * M_PI * Frequency / (float) SampleRate;
+            pBank->pC2[lane] = 2.0f * M_PI * Frequency / (float) SampleRate * 3.0f;
+
+            double phi; // phase displacement
+            switch (StartLevel) {
+                case start_level_mid: // same as LFOTriangleDiHarmonic
+                case start_level_max:
+                    phi = (FlipPhase) ? M_PI : 0.0;
+                    break;
+                case start_level_min:
+                default:
+                    phi = (FlipPhase) ? 0.0 : M_PI;
+                    break;
+            }
+            pBank->pReal1[lane] = pBank->pReal2[lane] = cos(phi);
+            pBank->pImag1[lane] = pBank->pImag2[lane] = sin(phi);
+        } else if (Wave == wave_triangle_int_math) {
+            if (Range == range_unsigned) {
+                this->InternalDepth        *= 2.0f;
+                this->ExtControlDepthCoeff *= 2.0f;
+            }
+            switch (StartLevel) {
+                case start_level_max:
+                    level = (FlipPhase) ? 0 : intLimit >> 1;
+                    break;
+                case start_level_mid:
+                    if (FlipPhase) c = -c; // wave should go down
+                    level = intLimit >> 2;
+                    break;
+                case start_level_min:
+                    level = (FlipPhase) ? intLimit >> 1 : 0;
+                    break;
+            }
+        } else if (Wave == wave_pulse) {
+            pBank->pWidth[lane] = (PulseWidth / 100.0) * intLimit;
+        }
+
+        pBank->pWave[lane]  = Wave;
+        pBank->pLevel[lane] = int32_t(level);
+        pBank->pInc[lane]   = c;
+
+        // levels calculated for the lane's previous LFO are obsolete
+        uiLeft = 0;
+        pBank->pEnlisted[lane >> 2] &= ~(1 << (lane & 3));
+    }
+
+    void LFOBank::LFO::update(const uint16_t& ExtControlValue) {
+        const float max = this->InternalDepth + ExtControlValue * this->ExtControlDepthCoeff;
+        switch (Wave) {
+            case wave_triangle_int_math:
+                if (Range == range_unsigned) {
+                    normalizer = max / (float) intLimit;
+                    offset     = 0.0f;
+                } else { // signed range
+                    normalizer = max / (float) intLimit * 4.0f;
+                    offset     = -max;
+                }
+                break;
+            case wave_triangle_di_harmonic:
+                if (Range == range_unsigned) {
+                    const float harmonicCompensation = 1.0f + fabsf(AMP2); // to compensate the compensation ;) (see trigger())
+                    normalizer = max * 0.5f;
+                    offset     = normalizer * harmonicCompensation;
+                } else { // signed range
+                    normalizer = max;
+                    offset     = 0.0f;
+                }
+                break;
+            case wave_sine:
+                if (Range == range_unsigned) {
+                    normalizer = offset = max / 2.0f;
+                } else { // signed range
+                    normalizer = max;
+                    offset     = 0.0f;
+                }
+                break;
+            case wave_saw_up:
+            case wave_saw_down:
+                if (Range == range_unsigned) {
+                    normalizer = max / (float) intLimit;
+                    offset     = 0.0f;
+                } else { // signed range
+                    normalizer = max / (float) intLimit * 2.0f;
+                    offset     = -max;
+                }
+                break;
+            case wave_pulse:
+                if (Range == range_unsigned) {
+                    normalizer = max;
+                    offset     = 0.0f;
+                } else { // signed range
+                    normalizer = max * 2.0f;
+                    offset     = -max;
+                }
+                break;
+        }
+    }
+
+} // namespace LinuxSampler
@@ -0,0 +1,255 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#ifndef __LS_LFOBANK_H__
+#define __LS_LFOBANK_H__
+
+#include "LFOBase.h"
+
+namespace LinuxSampler {
+
+    /** @brief Renders the LFOs of many voices at once.
+     *
+     * The state of every LFO of every voice of an engine lives in this bank,
+     * one array per state variable (structure of arrays), so the LFOs with
+     * the same index of 4 neighbouring voices can be advanced together in
+     * one SIMD register. At the beginning of each audio fragment Render()
+     * calculates the raw wave levels of all LFOs which were enlisted by
+     * their voice during the previous audio fragment, for all subfragments
+     * of the upcoming audio fragment at once. The voices then just read the
+     * precalculated levels with LFO::render() and scale them to their
+     * current depth.
+     *
+     * LFOs which were not enlisted (i.e. the ones of voices triggered in the
+     * current audio fragment) are calculated one step at a time by
+     * LFO::render() instead, directly on the bank's state, so the result is
+     * the same in both cases.
+     *
+     * All memory is allocated by the constructor, all other methods are
+     * real-time safe.
+     */
+    class LFOBank {
+        public:
+            /**
+             * Wave form of an LFO.
+             */
+            enum shape_t {
+                shape_triangle,  ///< Triangle wave (algorithm selected with SetTriangleAlgorithm()).
+                shape_sine,      ///< Sine wave.
+                shape_saw_up,    ///< Rising saw tooth wave.
+                shape_saw_down,  ///< Falling saw tooth wave.
+                shape_pulse      ///< Pulse wave.
+            };
+
+            /** @brief One LFO of a voice.
+             *
+             * Drop-in replacement for the voice's triangle LFO classes
+             * (LFOTriangleIntMath, LFOTriangleDiHarmonic, ...), whose state
+             * is stored in a LFOBank. Bind() has to be called before the
+             * LFO is triggered for the first time.
+             */
+            class LFO {
+                public:
+                    uint8_t ExtController; ///< MIDI control change controller number if the LFO is controlled by an external controller, 0 otherwise.
+
+                    /**
+                     * @param Range - whether the LFO should have positive
+                     *                and negative value range or just
+                     *                positive values
+                     * @param Max   - maximum value of the output levels
+                     */
+                    LFO(range_type_t Range, float Max);
+
+                    /**
+                     * Assigns a lane of the given bank to this LFO.
+                     */
+                    void Bind(LFOBank* pBank, unsigned int Lane);
+
+                    /**
+                     * Will be called by the voice when the key / voice was
+                     * triggered. Starts a triangle wave with the triangle
+                     * algorithm currently selected for this LFO's range.
+                     *
+                     * @param Frequency       - frequency of the oscillator in Hz
+                     * @param StartLevel      - on which level the wave should start
+                     * @param InternalDepth   - firm, internal oscillator amplitude
+                     * @param ExtControlDepth - defines how strong the external MIDI
+                     *                          controller has influence on the
+                     *                          oscillator amplitude
+                     * @param FlipPhase       - inverts the oscillator wave against
+                     *                          a horizontal axis
+                     * @param SampleRate      - current sample rate of the engines
+                     *                          audio output signal
+                     */
+                    void trigger(float Frequency, start_level_t StartLevel, uint16_t InternalDepth, uint16_t ExtControlDepth, bool FlipPhase, unsigned int SampleRate) {
+                        trigger(shape_triangle, Frequency, StartLevel, InternalDepth, ExtControlDepth, FlipPhase, SampleRate);
+                    }
+
+                    /**
+                     * Same as above, but with the given wave form. The start
+                     * level and phase flipping are only implemented for
+                     * triangle waves, like with the other LFO classes.
+                     *
+                     * @param PulseWidth - pulse width in percent (only for
+                     *                     pulse waves)
+                     */
+                    void trigger(shape_t Shape, float Frequency, start_level_t StartLevel, uint16_t InternalDepth, uint16_t ExtControlDepth, bool FlipPhase, unsigned int SampleRate, float PulseWidth = 50.0f);
+
+                    /**
+                     * Update LFO depth with a new external controller value.
+                     *
+                     * @param ExtControlValue - new external controller value
+                     */
+                    void update(const uint16_t& ExtControlValue);
+
+                    /**
+                     * Returns the LFO level of the next subfragment.
+                     */
+                    inline float render() {
+                        float level;
+                        if (uiLeft) {
+                            level = *pNext;
+                            pNext += 4; // lanes are interleaved
+                            --uiLeft;
+                        } else level = pBank->RenderStep(uiLane);
+                        return level * normalizer + offset;
+                    }
+
+                    /**
+                     * Lets the bank calculate this LFO's levels of the next
+                     * audio fragment on the next Render() call. Has to be
+                     * called by the voice at the end of each audio fragment
+                     * the voice will be rendered for entirely (starting with
+                     * its first sample point) in the next audio fragment.
+                     */
+                    inline void enlist() {
+                        pBank->pEnlisted[uiLane >> 2] |= 1 << (uiLane & 3);
+                    }
+
+                protected:
+                    LFOBank*     pBank;
+                    unsigned int uiLane;
+                    const float* pNext;   ///< Next level calculated by the bank.
+                    unsigned int uiLeft;  ///< Amount of levels calculated by the bank not read yet.
+                    range_type_t Range;
+                    int          Wave;
+                    float        Max;
+                    float        InternalDepth;
+                    float        ExtControlDepthCoeff;
+                    float        normalizer;
+                    float        offset;
+
+                    friend class LFOBank;
+            };
+
+            /**
+             * @param Voices       - amount of voices of the engine
+             * @param LFOsPerVoice - amount of LFOs of each voice
+             * @param MaxSteps     - max. amount of LFO steps (subfragments)
+             *                       per audio fragment
+             */
+            LFOBank(unsigned int Voices, unsigned int LFOsPerVoice, unsigned int MaxSteps);
+            virtual ~LFOBank();
+
+            /**
+             * Returns the lane of the given LFO of the given voice. The same
+             * LFO of neighbouring voices share one SIMD register.
+             */
+            inline unsigned int Lane(unsigned int Voice, unsigned int LFO) const {
+                return LFO * uiLanesPerLFO + Voice;
+            }
+
+            /**
+             * Calculates the next @a Steps levels of all enlisted LFOs,
+             * hands them to the LFOs and withdraws their enlistment. Has to
+             * be called at the beginning of each audio fragment, before any
+             * voice is rendered.
+             *
+             * @param Steps - amount of subfragments of the audio fragment
+             */
+            void Render(unsigned int Steps);
+
+            /**
+             * Selects the triangle wave algorithm used by all LFOs of the
+             * given range which are triggered from now on. Both integer math
+             * solutions produce the same results in the bank.
+             *
+             * @param Range     - range of the LFOs to be affected
+             * @param Algorithm - INT_MATH_SOLUTION, INT_ABS_MATH_SOLUTION
+             *                    or DI_HARMONIC_SOLUTION
+             * @returns @c false if the algorithm is unknown
+             */
+            static bool SetTriangleAlgorithm(range_type_t Range, int Algorithm);
+
+            /**
+             * Returns the triangle wave algorithm currently used for new
+             * LFOs of the given range (by default the one selected with
+             * CONFIG_SIGNED_TRIANG_ALGO and CONFIG_UNSIGNED_TRIANG_ALGO).
+             */
+            static int GetTriangleAlgorithm(range_type_t Range);
+
+        protected:
+            /// Wave form and algorithm of a lane.
+            enum wave_t {
+                wave_triangle_int_math,
+                wave_triangle_di_harmonic,
+                wave_sine,
+                wave_saw_up,
+                wave_saw_down,
+                wave_pulse
+            };
+
+            inline unsigned int BufferPos(unsigned int Lane, unsigned int Step) const {
+                return ((Lane >> 2) * uiMaxSteps + Step) * 4 + (Lane & 3);
+            }
+
+            float RenderStep(unsigned int Lane);
+            void RenderChunk(unsigned int Chunk, unsigned int Steps, int Mask);
+            void RenderChunkScalar(unsigned int Chunk, unsigned int Steps, int Mask);
+
+        private:
+            unsigned int uiLanes;
+            unsigned int uiLanesPerLFO;  ///< Amount of voices, rounded up to a multiple of 4.
+            unsigned int uiMaxSteps;
+            int32_t*  pLevel;     ///< Integer phase (signed level with integer math triangle waves).
+            int32_t*  pInc;       ///< Phase increment per step.
+            uint32_t* pWidth;     ///< Pulse width (in phase units).
+            float*    pReal1;     ///< Di-harmonic triangle wave state.
+            float*    pImag1;
+            float*    pReal2;
+            float*    pImag2;
+            float*    pC1;
+            float*    pC2;
+            uint8_t*  pWave;      ///< wave_t of each lane.
+            uint8_t*  pEnlisted;  ///< Bit mask of the enlisted lanes of each group of 4 lanes.
+            LFO**     pLFOs;      ///< LFO bound to each lane (NULL if none).
+            float*    pBuffer;    ///< Calculated levels, 4 interleaved lanes per group.
+
+            static int iSignedTriangleAlgorithm;
+            static int iUnsignedTriangleAlgorithm;
+
+            friend class LFO;
+    };
+
+} // namespace LinuxSampler
+
+#endif // __LS_LFOBANK_H__
@@ -24,18 +24,18 @@
 #ifdef HAVE_CONFIG_H
 # include "../../common/global.h"
 # include "../../common/RTMath.h"
-
-// IDs of the two possible implementations
-// we get the implementation to pick from config.h
-// the implementation IDs should be the same like in benchmarks/triang.cpp !
-# define INT_MATH_SOLUTION		2
-# define DI_HARMONIC_SOLUTION	3
-# define INT_ABS_MATH_SOLUTION          5
 #else
 # include <math.h>
 # include <stdint.h>
 #endif
 
+// IDs of the possible implementations
+// we get the implementation to pick from config.h (or at runtime, see LFOBank)
+// the implementation IDs should be the same like in benchmarks/triang.cpp !
+#define INT_MATH_SOLUTION		2
+#define DI_HARMONIC_SOLUTION	3
+#define INT_ABS_MATH_SOLUTION          5
+
 namespace LinuxSampler {
 
     // *************** types ***************
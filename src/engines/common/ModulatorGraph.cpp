@@ -21,124 +21,109 @@
  ***************************************************************************/
 
 #include "SignalUnitRack.h"
-#include "../../effects/EffectFactory.h"
+#include "../../drivers/audio/AudioOutputDevice.h"
+
+#include <math.h>
+
+#ifndef LIMIT
+# define LIMIT(v,l,u)  (v < l ? l : (v > u ? u : v))
+#endif
 
 namespace LinuxSampler {
-    
-    /**
-     * Searches for know EQ effects and create one if the search succeed.
-     */
+
     EqSupport::EqSupport() {
-        pEffect = pEffect2 = NULL;
-        BandCount = 0;
-        GainIdxs = FreqIdxs = BandwidthIdxs = NULL;
-        
-        Install();
-    }
-    
-    void EqSupport::Install() {
-        Uninstall();
-        for (int i = 0; i < EffectFactory::AvailableEffectsCount(); i++) {
-            EffectInfo* pEffectInfo = EffectFactory::GetEffectInfo(i);
-            /*if (!pEffectInfo->Name().compare("tap_equalizer_bw")) {
-                try { pEffect = EffectFactory::Create(pEffectInfo); }
-                catch(Exception e) { std::cerr << e.Message(); continue; }
-                
-                BandCount = 8;
-                GainIdxs = new int[BandCount];
-                FreqIdxs = new int[BandCount];
-                BandwidthIdxs = new int[BandCount];
-                for(int i = 0; i < BandCount; i++) {
-                    GainIdxs[i] = i;
-                    FreqIdxs[i] = i + 8;
-                    BandwidthIdxs[i] = i + 16;
-                }
-                dmsg(1,("EQ support: %s\n", pEffectInfo->Description().c_str()));
-                break;
-            }*/
-            
-            if (!pEffectInfo->Name().compare("triplePara")) {
-                try {
-                    pEffect = EffectFactory::Create(pEffectInfo);
-                    pEffect2 = EffectFactory::Create(pEffectInfo);
-                } catch(Exception e) { std::cerr << e.Message(); continue; }
-                
-                BandCount = 3;
-                GainIdxs = new int[BandCount];
-                FreqIdxs = new int[BandCount];
-                BandwidthIdxs = new int[BandCount];
-                for(int i = 0; i < BandCount; i++) {
-                    GainIdxs[i] = i*3 + 3;
-                    FreqIdxs[i] = i*3 + 4;
-                    BandwidthIdxs[i] = i*3 + 5;
-                }
-                
-                pEffect->InputControl(0)->SetValue(0); // Low-shelving gain (0dB)
-                pEffect->InputControl(12)->SetValue(0); // High-shelving gain (0dB)
-                
-                pEffect2->InputControl(0)->SetValue(0); // Low-shelving gain (0dB)
-                pEffect2->InputControl(12)->SetValue(0); // High-shelving gain (0dB)
-                
-                break;
-            }
+        fSampleRate = 44100;
+        for (int i = 0; i < EQ_BAND_COUNT; i++) {
+            bands[i].freq      = 1000;
+            bands[i].bandwidth = 1;
         }
-        
-        if (pEffect == NULL) return;
-        
         Reset();
     }
-    
-    void EqSupport::PrintInfo() {
-        if (!HasSupport()) {
-            dmsg(1,("EQ support: no\n"));
-        } else {
-            dmsg(1,("EQ support: %s\n", pEffect->GetEffectInfo()->Description().c_str()));
+
+    void EqSupport::InitEffect(AudioOutputDevice* pDevice) {
+        if (!pDevice) return;
+        fSampleRate = pDevice->SampleRate();
+        for (int i = 0; i < EQ_BAND_COUNT; i++) bands[i].bDirty = true;
+    }
+
+    void EqSupport::Reset() {
+        for (int i = 0; i < EQ_BAND_COUNT; i++) {
+            bands[i].gain   = 0; // 0dB
+            bands[i].bDirty = true;
+            bands[i].left.x1  = bands[i].left.x2  = 0;
+            bands[i].left.y1  = bands[i].left.y2  = 0;
+            bands[i].right.x1 = bands[i].right.x2 = 0;
+            bands[i].right.y1 = bands[i].right.y2 = 0;
         }
     }
-    
+
+    void EqSupport::PrintInfo() {
+        dmsg(1,("EQ support: built-in %d band parametric EQ\n", EQ_BAND_COUNT));
+    }
+
     void EqSupport::SetGain(int band, float gain) {
-        if (!HasSupport()) return;
-        if (band < 0 || band >= BandCount) throw Exception("EQ support: invalid band");
-        
-        EffectControl* ctrl = pEffect->InputControl(GainIdxs[band]);
-        gain = check(ctrl->MinValue(), ctrl->MaxValue(), gain);
-        ctrl->SetValue(gain);
-        if (pEffect2 != NULL) pEffect2->InputControl(GainIdxs[band])->SetValue(gain);
+        if (band < 0 || band >= EQ_BAND_COUNT) throw Exception("EQ support: invalid band");
+        gain = LIMIT(gain, -96.0f, 24.0f);
+        if (gain == bands[band].gain) return;
+        bands[band].gain   = gain;
+        bands[band].bDirty = true;
     }
-    
+
     void EqSupport::SetFreq(int band, float freq) {
-        if (!HasSupport()) return;
-        if (band < 0 || band >= BandCount) throw Exception("EQ support: invalid band");
-        
-        EffectControl* ctrl = pEffect->InputControl(FreqIdxs[band]);
-        freq = check(ctrl->MinValue(), ctrl->MaxValue(), freq);
-        ctrl->SetValue(freq);
-        if (pEffect2 != NULL) pEffect2->InputControl(FreqIdxs[band])->SetValue(freq);
+        if (band < 0 || band >= EQ_BAND_COUNT) throw Exception("EQ support: invalid band");
+        const float maxFreq = fSampleRate * 0.49f;
+        freq = LIMIT(freq, 1.0f, maxFreq);
+        if (freq == bands[band].freq) return;
+        bands[band].freq   = freq;
+        bands[band].bDirty = true;
     }
-    
+
     void EqSupport::SetBandwidth(int band, float octaves) {
-        if (!HasSupport()) return;
-        if (band < 0 || band >= BandCount) throw Exception("EQ support: invalid band");
-        
-        EffectControl* ctrl = pEffect->InputControl(BandwidthIdxs[band]);
-        octaves = check(ctrl->MinValue(), ctrl->MaxValue(), octaves);
-        ctrl->SetValue(octaves);
-        if (pEffect2 != NULL) pEffect2->InputControl(BandwidthIdxs[band])->SetValue(octaves);
+        if (band < 0 || band >= EQ_BAND_COUNT) throw Exception("EQ support: invalid band");
+        octaves = LIMIT(octaves, 0.001f, 4.0f);
+        if (octaves == bands[band].bandwidth) return;
+        bands[band].bandwidth = octaves;
+        bands[band].bDirty    = true;
     }
-    
-    void EqSupport::Uninstall() {
-        if (pEffect != NULL) EffectFactory::Destroy(pEffect);
-        if (pEffect2 != NULL) EffectFactory::Destroy(pEffect2);
-        if (GainIdxs != NULL) delete[] GainIdxs;
-        if (FreqIdxs != NULL) delete[] FreqIdxs;
-        if (BandwidthIdxs != NULL) delete[] BandwidthIdxs;
 
-        pEffect = pEffect2 = NULL;
-        BandCount = 0;
-        GainIdxs = FreqIdxs = BandwidthIdxs = NULL;
+    void EqSupport::UpdateCoefficients(Band& band) {
+        const float omega = 2.0 * M_PI * band.freq / fSampleRate;
+        const float sn    = sin(omega);
+        const float cs    = cos(omega);
+        const float alpha = sn * sinh(M_LN2 / 2.0 * band.bandwidth * omega / sn);
+        const float A     = pow(10.0f, band.gain / 40.0f);
+        const float a0r   = 1.0 / (1.0 + alpha / A);
+
+        band.b0 = a0r * (1.0 + alpha * A);
+        band.b1 = a0r * -(2.0 * cs);
+        band.b2 = a0r * (1.0 - alpha * A);
+        band.a1 = a0r * (2.0 * cs);
+        band.a2 = a0r * (alpha / A - 1.0);
+        band.bDirty = false;
     }
-    
-    EqSupport::~EqSupport() {
-        Uninstall();
+
+    void EqSupport::RenderAudio(float* pInLeft, float* pInRight, float* pOutLeft, float* pOutRight, uint Samples) {
+        if (!Samples) return;
+        for (int b = 0; b < EQ_BAND_COUNT; b++) {
+            Band& band = bands[b];
+            if (band.gain == 0) {
+                // neutral band, just keep its history up to date
+                for (uint i = (Samples > 2) ? Samples - 2 : 0; i < Samples; i++) {
+                    Bypass(band.left,  pInLeft[i]);
+                    Bypass(band.right, pInRight[i]);
+                }
+                continue;
+            }
+            if (band.bDirty) UpdateCoefficients(band);
+            for (uint i = 0; i < Samples; i++) {
+                pInLeft[i]  = Apply(band, band.left,  pInLeft[i]);
+                pInRight[i] = Apply(band, band.right, pInRight[i]);
+            }
+        }
+        for (uint i = 0; i < Samples; i++) {
+            pOutLeft[i]  += pInLeft[i];
+            pOutRight[i] += pInRight[i];
+        }
     }
+
 } // namespace LinuxSampler
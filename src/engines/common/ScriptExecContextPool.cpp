@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026 agent
+ *
+ * http://www.linuxsampler.org
+ *
+ * This file is part of LinuxSampler and released under the same terms.
+ * See README file for details.
+ */
+
+#include "ScriptExecContextPool.h"
+#include "../AbstractEngine.h"
+#include "../AbstractEngineChannel.h"
+
+namespace LinuxSampler {
+
+    ///////////////////////////////////////////////////////////////////////
+    // class 'ScriptExecContextPool'
+
+    ScriptExecContextPool::ScriptExecContextPool(ScriptVM* pVM, VMParserContext* pParserContext) :
+        pVM(pVM), pParserContext(pParserContext), incoming(MAX_SIZE + 1, 0),
+        freeCount(0), inUse(0)
+    {
+        freeList = new VMExecContext*[MAX_SIZE];
+        atomic_set(&handedBack, 0);
+        atomic_set(&peakInUse, 0);
+        atomic_set(&growthRequested, 0);
+        atomic_set(&created, 0);
+        grow(CONFIG_MAX_EVENTS_PER_FRAGMENT);
+    }
+
+    /**
+     * Frees all execution contexts of this pool. All contexts must have been
+     * released or handed back to the pool before.
+     */
+    ScriptExecContextPool::~ScriptExecContextPool() {
+        freeCount += incoming.read(freeList + freeCount, incoming.read_space());
+        if (freeCount != atomic_read(&created))
+            dmsg(1,("ScriptExecContextPool: %d execution contexts were not handed back!\n",
+                    atomic_read(&created) - freeCount));
+        for (int i = 0; i < slabs.size(); ++i)
+            delete slabs[i];
+        delete [] freeList;
+    }
+
+    /**
+     * Returns an unused execution context for a new script event, or NULL if
+     * the pool is currently exhausted. This method is real-time safe and may
+     * only be called by the audio thread.
+     */
+    VMExecContext* ScriptExecContextPool::acquire() {
+        if (!freeCount) // pick up the contexts created meanwhile
+            freeCount = incoming.read(freeList, incoming.read_space());
+        if (!freeCount) return NULL;
+        // account the contexts handed back by non real-time threads meanwhile
+        const int n = atomic_read(&handedBack);
+        if (n) {
+            atomic_sub(n, &handedBack);
+            inUse -= n;
+        }
+        if (++inUse > atomic_read(&peakInUse)) atomic_set(&peakInUse, inUse);
+        return freeList[--freeCount];
+    }
+
+    /**
+     * Returns the execution context @a pContext previously retrieved by
+     * acquire() to this pool. This method is real-time safe and may only be
+     * called by the audio thread.
+     */
+    void ScriptExecContextPool::release(VMExecContext* pContext) {
+        freeList[freeCount++] = pContext;
+        --inUse;
+    }
+
+    /**
+     * Should be called by the audio thread after acquire(). Returns true if
+     * the pool is running low on execution contexts and the caller should
+     * order a non real-time thread to call grow() (respectively
+     * ScriptExecContextPoolManager::GrowPools()). Returns false if the pool
+     * still has enough spare contexts, if growing it was already requested
+     * or if it already reached its maximum size.
+     */
+    bool ScriptExecContextPool::requestGrowth() {
+        if (atomic_read(&growthRequested)) return false;
+        const int total = atomic_read(&created);
+        if (total >= MAX_SIZE) return false;
+        const int available = freeCount + incoming.read_space();
+        if (available * 4 > total) return false; // still more than 25% left
+        atomic_set(&growthRequested, 1);
+        return true;
+    }
+
+    /**
+     * Returns the execution context @a pContext previously retrieved by
+     * acquire() from a non real-time thread to this pool. This is used to
+     * return the contexts still assigned to the script events of an engine
+     * channel when it unloads its script, while the engine's audio thread
+     * might still be using the pool for other engine channels. The audio
+     * thread subtracts the contexts handed back from its usage count on its
+     * next acquire() call.
+     */
+    void ScriptExecContextPool::handBack(VMExecContext* pContext) {
+        LockGuard lock(mutex);
+        incoming.push(&pContext);
+        atomic_inc(&handedBack);
+    }
+
+    /**
+     * Creates new execution contexts, such that the pool has twice as many
+     * contexts as were used simultaneously so far. If the audio thread
+     * requested growing the pool (because it was running low on contexts),
+     * the pool is grown by at least @c CONFIG_SCRIPT_EXEC_CONTEXTS contexts.
+     * This method is not real-time safe.
+     */
+    void ScriptExecContextPool::grow() {
+        int target = 2 * atomic_read(&peakInUse);
+        if (atomic_read(&growthRequested)) {
+            const int step = atomic_read(&created) + CONFIG_SCRIPT_EXEC_CONTEXTS;
+            if (target < step) target = step;
+        }
+        grow(target);
+        atomic_set(&growthRequested, 0);
+    }
+
+    /**
+     * Creates new execution contexts until the pool has a total of @a target
+     * contexts (or @c MAX_SIZE contexts).
+     */
+    void ScriptExecContextPool::grow(int target) {
+        LockGuard lock(mutex);
+        if (target > MAX_SIZE) target = MAX_SIZE;
+        const int total = atomic_read(&created);
+        if (total >= target) return;
+        VMExecContextSlab* pSlab = pVM->createExecContextSlab(pParserContext, target - total);
+        slabs.push_back(pSlab);
+        for (int i = 0; i < pSlab->size(); ++i) {
+            VMExecContext* pContext = pSlab->execContext(i);
+            incoming.push(&pContext);
+        }
+        atomic_set(&created, target);
+        dmsg(2,("ScriptExecContextPool: grown to %d execution contexts (peak usage %d).\n",
+                target, atomic_read(&peakInUse)));
+    }
+
+    /**
+     * Returns the total amount of execution contexts created for this pool.
+     */
+    int ScriptExecContextPool::size() const {
+        return atomic_read(&created);
+    }
+
+    ///////////////////////////////////////////////////////////////////////
+    // class 'ScriptExecContextPoolManager'
+
+    /**
+     * Grows all pools of this engine as far as required by their usage so
+     * far. Called by the engine's disk thread, after the audio thread ordered
+     * it to do so.
+     */
+    void ScriptExecContextPoolManager::GrowPools() {
+        Lock();
+        std::vector<ScriptExecContextPool*> pools = Resources(false);
+        for (int i = 0; i < pools.size(); ++i)
+            pools[i]->grow();
+        Unlock();
+    }
+
+    ScriptExecContextPool* ScriptExecContextPoolManager::Create(VMParserContext* Key, ScriptExecContextPoolConsumer* pConsumer, void*& pArg) {
+        AbstractEngineChannel* pEngineChannel = dynamic_cast<AbstractEngineChannel*>(pConsumer);
+        return new ScriptExecContextPool(pEngineChannel->pEngine->pScriptVM, Key);
+    }
+
+    void ScriptExecContextPoolManager::Destroy(ScriptExecContextPool* pResource, void* pArg) {
+        delete pResource;
+    }
+
+} // namespace LinuxSampler
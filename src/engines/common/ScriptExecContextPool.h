@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 agent
+ *
+ * http://www.linuxsampler.org
+ *
+ * This file is part of LinuxSampler and released under the same terms.
+ * See README file for details.
+ */
+
+#ifndef LS_SCRIPTEXECCONTEXTPOOL_H
+#define LS_SCRIPTEXECCONTEXTPOOL_H
+
+#include "../../common/global_private.h"
+#include "../../common/atomic.h"
+#include "../../common/Mutex.h"
+#include "../../common/RingBuffer.h"
+#include "../../common/ResourceManager.h"
+#include "../../scriptvm/ScriptVM.h"
+#include <vector>
+
+namespace LinuxSampler {
+
+    /** @brief Shared pool of VM execution contexts of one instrument script.
+     *
+     * Provides the VM execution contexts (execution stack and polyphonic
+     * variable memory) for the script events of all engine channels of one
+     * sampler engine, which are using the same instrument script. Instead of
+     * allocating execution contexts for the theoretical maximum amount of
+     * script events on each engine channel, the pool starts with
+     * @c CONFIG_MAX_EVENTS_PER_FRAGMENT contexts (so a single engine channel
+     * never runs out of contexts) and is grown by a non real-time thread (the
+     * engine's disk thread) in steps of at least @c CONFIG_SCRIPT_EXEC_CONTEXTS
+     * contexts, according to the highest amount of contexts that were
+     * simultaneously in use so far. The contexts created by each growth step
+     * are allocated as one contiguous VMExecContextSlab.
+     *
+     * acquire(), release() and requestGrowth() may only be called by the
+     * audio thread of the engine the pool belongs to, all other methods may
+     * only be called by non real-time threads.
+     */
+    class ScriptExecContextPool {
+    public:
+        enum {
+            MAX_SIZE = 4 * CONFIG_MAX_EVENTS_PER_FRAGMENT ///< The pool never grows beyond this amount of execution contexts.
+        };
+
+        ScriptExecContextPool(ScriptVM* pVM, VMParserContext* pParserContext);
+        ~ScriptExecContextPool();
+
+        VMExecContext* acquire();
+        void release(VMExecContext* pContext);
+        bool requestGrowth();
+
+        void handBack(VMExecContext* pContext);
+        void grow();
+        int size() const;
+
+    protected:
+        void grow(int target);
+
+    private:
+        ScriptVM*        pVM;
+        VMParserContext* pParserContext;
+        RingBuffer<VMExecContext*,false> incoming; ///< Contexts newly created or handed back by non real-time threads, not yet picked up by the audio thread.
+        VMExecContext**  freeList; ///< Unused contexts picked up by the audio thread (only accessed by the audio thread).
+        int              freeCount; ///< Amount of contexts on @c freeList.
+        int              inUse; ///< Amount of contexts currently assigned to script events (only accessed by the audio thread).
+        atomic_t         handedBack; ///< Amount of contexts returned by handBack(), not yet subtracted from @c inUse by the audio thread.
+        atomic_t         peakInUse; ///< Highest amount of contexts simultaneously assigned to script events so far.
+        atomic_t         growthRequested; ///< Set by the audio thread when running low on contexts, cleared by grow().
+        atomic_t         created; ///< Total amount of contexts created for this pool.
+        Mutex            mutex; ///< Serializes the non real-time threads writing to @c incoming.
+        std::vector<VMExecContextSlab*> slabs; ///< Memory of all contexts of this pool, one slab for each time the pool was grown.
+    };
+
+    typedef ResourceConsumer<ScriptExecContextPool> ScriptExecContextPoolConsumer;
+
+    /** @brief Manages the shared VM execution context pools of one engine.
+     *
+     * Each sampler engine has one instance of this class, which provides one
+     * ScriptExecContextPool for each instrument script (identified by its
+     * parsed VM representation) used on any of the engine's channels.
+     */
+    class ScriptExecContextPoolManager : public ResourceManager<VMParserContext*, ScriptExecContextPool> {
+    public:
+        ScriptExecContextPoolManager() {}
+        virtual ~ScriptExecContextPoolManager() {}
+        void GrowPools();
+    protected:
+        // implementation of derived abstract methods from 'ResourceManager'
+        virtual ScriptExecContextPool* Create(VMParserContext* Key, ScriptExecContextPoolConsumer* pConsumer, void*& pArg);
+        virtual void Destroy(ScriptExecContextPool* pResource, void* pArg);
+        virtual void OnBorrow(ScriptExecContextPool* pResource, ScriptExecContextPoolConsumer* pConsumer, void*& pArg) {} // ignore
+    };
+
+} // namespace LinuxSampler
+
+#endif // LS_SCRIPTEXECCONTEXTPOOL_H
@@ -484,12 +484,33 @@ namespace LinuxSampler {
                 if (pSmoother != NULL) hasSmoothCtrls = true;
             }
             
-            virtual void RemoveAllCCs() { pCtrls->clear(); }
+            virtual void RemoveAllCCs() {
+                pCtrls->clear();
+                hasSmoothCtrls = isSmoothingOut = false;
+            }
             
             int GetCCCount() { return pCtrls->count(); }
             
             bool HasCCs() { return GetCCCount() > 0; }
             
+            /**
+             * Whether some of the controllers of this unit are smoothed out.
+             * Increment() has nothing to do otherwise.
+             */
+            bool HasSmoothCCs() { return hasSmoothCtrls; }
+            
+            /**
+             * Sets the bits of the controllers of this unit in the given
+             * mask of 256 bits (one bit per controller number).
+             */
+            void AddToCCMask(uint32_t* pMask) {
+                RTList<CC>::Iterator ctrl = pCtrls->first();
+                RTList<CC>::Iterator end  = pCtrls->end();
+                for(; ctrl != end; ++ctrl) {
+                    pMask[(*ctrl).Controller >> 5] |= 1u << ((*ctrl).Controller & 31);
+                }
+            }
+            
             virtual void Increment() {
                 if (hasSmoothCtrls && isSmoothingOut) Calculate();
             }
@@ -29,86 +29,99 @@
 
 
 namespace LinuxSampler {
-    
+
+    class AudioOutputDevice;
+
+    /** @brief Built-in per voice equalizer.
+     *
+     * Native 3 band parametric (peaking) equalizer, as required i.e. by the
+     * sfz eqN_* opcodes. The voice renders each sub-fragment into a small
+     * temporary buffer on the stack and passes it through RenderAudio(),
+     * which filters it and mixes it to the voice's actual output buffers,
+     * so no audio buffers are allocated for the equalizer at all.
+     *
+     * Filter coefficients are only recalculated when the parameters of a
+     * band actually changed, and bands set to 0 dB are skipped entirely.
+     */
     class EqSupport {
-        private:
-            int  BandCount;
-            int* GainIdxs; ///< the indices of the gain controls
-            int* FreqIdxs; ///< the indices of the frequency controls
-            int* BandwidthIdxs; ///< the indices of the bandwidth controls
-            Effect* pEffect;
-            Effect* pEffect2; // If the effect is mono we'll need two effects
-            
-            inline float check(optional<float> minimum, optional<float> maximum, float value) {
-                if (minimum) {
-                    float min = *minimum;
-                    if (value < min) value = min;
-                }
-                if (maximum) {
-                    float max = *maximum;
-                    if (value > max) value = max;
-                }
-                
-                return value;
-            }
-            
         public:
             EqSupport();
-            ~EqSupport();
-            
+
             void PrintInfo();
 
-            /**
-             * Searches for know EQ effects and create one if the search succeed.
-             * If the initialization is successful and EQ effect is selected,
-             * HasSupport() returns true;
-             */
-            void Install();
+            /** Returns true if an EQ is created and is ready for use. */
+            bool HasSupport() { return true; }
 
-            void Uninstall();
+            /** Reset the gains of all bands to 0dB and clear filter history. */
+            void Reset();
 
-            /** Returns true if an EQ is created and is ready for use. */
-            bool HasSupport() { return pEffect != NULL; }
- 
-            /** Reset the gains of all bands to 0dB. */
-            void Reset() {
-                if (!HasSupport()) return;
-                for (int i = 0; i < BandCount; i++) {
-                    pEffect->InputControl(GainIdxs[i])->SetValue(0); // 0dB
-                    if (pEffect2 != NULL) pEffect2->InputControl(GainIdxs[i])->SetValue(0); // 0dB
-                }
-            }
-            
-            void InitEffect(AudioOutputDevice* pDevice) {
-                if (pEffect != NULL) pEffect->InitEffect(pDevice);
-                if (pEffect2 != NULL) pEffect2->InitEffect(pDevice);
-            }
-                
-            int GetBandCount() { return BandCount; }
+            /** Adjusts the EQ to the sample rate of the given device. */
+            void InitEffect(AudioOutputDevice* pDevice);
+
+            int GetBandCount() { return EQ_BAND_COUNT; }
 
             void SetGain(int band, float gain);
             void SetFreq(int band, float freq);
             void SetBandwidth(int band, float octaves);
-            
-            AudioChannel* GetInChannelLeft() {
-                return pEffect->InputChannel(0);
-            }
-            
-            AudioChannel* GetInChannelRight() {
-                return pEffect2 != NULL ? pEffect2->InputChannel(0) : pEffect->InputChannel(1);
-            }
-            
-            AudioChannel* GetOutChannelLeft() {
-                return pEffect->OutputChannel(0);
-            }
-            
-            AudioChannel* GetOutChannelRight() {
-                return pEffect2 != NULL ? pEffect2->OutputChannel(0) : pEffect->OutputChannel(1);
+
+            /**
+             * Filters the given input signal (in place) and mixes it to the
+             * given output buffers.
+             *
+             * @param pInLeft   - left input channel (will be overwritten)
+             * @param pInRight  - right input channel (will be overwritten)
+             * @param pOutLeft  - left output channel to be mixed to
+             * @param pOutRight - right output channel to be mixed to
+             * @param Samples   - amount of sample points to be processed
+             */
+            void RenderAudio(float* pInLeft, float* pInRight, float* pOutLeft, float* pOutRight, uint Samples);
+
+        private:
+            enum { EQ_BAND_COUNT = 3 };
+
+            /// Filter history of one channel of one band.
+            struct BandState {
+                float x1, x2;
+                float y1, y2;
+            };
+
+            /// One peaking EQ band (biquad, Robert Bristow-Johnson's Audio EQ Cookbook).
+            struct Band {
+                float gain;      ///< dB
+                float freq;      ///< Hz
+                float bandwidth; ///< octaves
+                bool  bDirty;    ///< Whether coefficients have to be recalculated.
+                float b0, b1, b2, a1, a2;
+                BandState left;
+                BandState right;
+            } bands[EQ_BAND_COUNT];
+
+            float fSampleRate;
+
+            void UpdateCoefficients(Band& band);
+
+            inline float Apply(const Band& band, BandState& s, float x) {
+                float y = band.b0 * x + band.b1 * s.x1 + band.b2 * s.x2 +
+                          band.a1 * s.y1 + band.a2 * s.y2;
+                y += 1e-18f; // kill denormals
+                y -= 1e-18f;
+                s.x2 = s.x1;
+                s.x1 = x;
+                s.y2 = s.y1;
+                s.y1 = y;
+                return y;
             }
-            
-            void RenderAudio(uint Samples) {
-                pEffect->RenderAudio(Samples);
-                if (pEffect2 != NULL) pEffect2->RenderAudio(Samples);
+
+            /**
+             * Feeds sample \a x through the history as if the band was
+             * neutral (0 dB), which allows to skip bands at 0 dB without
+             * causing clicks when they become active again.
+             */
+            inline void Bypass(BandState& s, float x) {
+                s.x2 = s.x1;
+                s.x1 = x;
+                s.y2 = s.y1;
+                s.y1 = x;
             }
     };
             
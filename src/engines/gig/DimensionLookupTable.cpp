@@ -0,0 +1,148 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#include "DimensionLookupTable.h"
+
+#include <string.h>
+#include <iostream>
+
+namespace LinuxSampler { namespace gig {
+
+    DimensionLookupTable::DimensionLookupTable() {
+        pRegion = NULL;
+        Dimensions = 0;
+        VelocityDimension = -1;
+        VelocityBitPos = 0;
+    }
+
+    int DimensionLookupTable::DimensionController(::gig::dimension_t dimension) {
+        switch (dimension) {
+            case ::gig::dimension_channelaftertouch: return 128;
+            case ::gig::dimension_modwheel:          return 1;
+            case ::gig::dimension_breath:            return 2;
+            case ::gig::dimension_foot:              return 4;
+            case ::gig::dimension_portamentotime:    return 5;
+            case ::gig::dimension_effect1:           return 12;
+            case ::gig::dimension_effect2:           return 13;
+            case ::gig::dimension_genpurpose1:       return 16;
+            case ::gig::dimension_genpurpose2:       return 17;
+            case ::gig::dimension_genpurpose3:       return 18;
+            case ::gig::dimension_genpurpose4:       return 19;
+            case ::gig::dimension_sustainpedal:      return 64;
+            case ::gig::dimension_portamento:        return 65;
+            case ::gig::dimension_sostenutopedal:    return 66;
+            case ::gig::dimension_softpedal:         return 67;
+            case ::gig::dimension_genpurpose5:       return 80;
+            case ::gig::dimension_genpurpose6:       return 81;
+            case ::gig::dimension_genpurpose7:       return 82;
+            case ::gig::dimension_genpurpose8:       return 83;
+            case ::gig::dimension_effect1depth:      return 91;
+            case ::gig::dimension_effect2depth:      return 92;
+            case ::gig::dimension_effect3depth:      return 93;
+            case ::gig::dimension_effect4depth:      return 94;
+            case ::gig::dimension_effect5depth:      return 95;
+            default:                                 return -1;
+        }
+    }
+
+    void DimensionLookupTable::Build(::gig::Region* pRegion) {
+        this->pRegion     = pRegion;
+        Dimensions        = pRegion->Dimensions;
+        VelocityDimension = -1;
+        VelocityBitPos    = 0;
+
+        int bitpos = 0;
+        for (int i = 0; i < Dimensions; i++) {
+            const ::gig::dimension_def_t& def = pRegion->pDimensionDefinitions[i];
+            dimension_t& dim = Dimension[i];
+            dim.zones      = def.zones;
+            dim.controller = 0;
+            memset(dim.bits, 0, sizeof(dim.bits));
+
+            switch (def.dimension) {
+                case ::gig::dimension_velocity:
+                    dim.source = source_velocity;
+                    break;
+                case ::gig::dimension_layer:
+                    dim.source = source_layer;
+                    break;
+                case ::gig::dimension_releasetrigger:
+                    dim.source = source_releasetrigger;
+                    break;
+                case ::gig::dimension_keyboard:
+                    dim.source = source_keyboard;
+                    break;
+                case ::gig::dimension_roundrobin:
+                    dim.source = source_roundrobin;
+                    break;
+                case ::gig::dimension_roundrobinkeyboard:
+                    dim.source = source_roundrobinkeyboard;
+                    break;
+                case ::gig::dimension_random:
+                    dim.source = source_random;
+                    break;
+                case ::gig::dimension_samplechannel: //TODO: we currently ignore this dimension
+                case ::gig::dimension_smartmidi:
+                    dim.source = source_none;
+                    break;
+                default: {
+                    const int controller = DimensionController(def.dimension);
+                    if (controller < 0) {
+                        std::cerr << "gig::DimensionLookupTable: Unknown dimension\n" << std::flush;
+                        dim.source = source_none;
+                    } else {
+                        dim.source = source_controller;
+                        dim.controller = controller;
+                    }
+                }
+            }
+
+            if (dim.source == source_velocity) {
+                // resolved last, with the velocity table of the dimension
+                // region selected by all other dimensions
+                VelocityDimension = i;
+                VelocityBitPos    = bitpos;
+            } else {
+                // same zone resolution as libgig's
+                // Region::GetDimensionRegionIndexByValue()
+                for (uint value = 0; value < 128; value++) {
+                    uint zone;
+                    if (def.split_type == ::gig::split_type_bit) {
+                        zone = value & ((1 << def.bits) - 1);
+                    } else if (pRegion->pDimensionRegions[0] && pRegion->pDimensionRegions[0]->DimensionUpperLimits[i]) {
+                        // gig v3: custom zone ranges
+                        for (zone = 0; zone < def.zones; zone++) {
+                            ::gig::DimensionRegion* pDimRgn = pRegion->pDimensionRegions[(zone << bitpos) & 255];
+                            if (pDimRgn && value <= pDimRgn->DimensionUpperLimits[i]) break;
+                        }
+                    } else {
+                        zone = value / def.zone_size;
+                    }
+                    dim.bits[value] = uint8_t(zone << bitpos);
+                }
+            }
+
+            bitpos += def.bits;
+        }
+    }
+
+}} // namespace LinuxSampler::gig
@@ -0,0 +1,138 @@
+/***************************************************************************
+ *                                                                         *
+ *   LinuxSampler - modular, streaming capable sampler                     *
+ *                                                                         *
+ *   Copyright (C) 2026 agent                                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston,                 *
+ *   MA  02111-1307  USA                                                   *
+ ***************************************************************************/
+
+#ifndef __LS_GIG_DIMENSIONLOOKUPTABLE_H__
+#define __LS_GIG_DIMENSIONLOOKUPTABLE_H__
+
+#include "../../common/global.h"
+#include <gig.h>
+
+namespace LinuxSampler { namespace gig {
+
+    /** @brief Precomputed dimension region selection of one gig::Region.
+     *
+     * Resolving the dimension region to be played on a note-on event with
+     * libgig's Region::GetDimensionRegionByValue() means evaluating the
+     * dimension type of each dimension, dividing by zone sizes and (for gig
+     * v3 files) linearly searching custom zone upper limits. This table is
+     * built once at instrument load time instead (i.e. by the instrument
+     * loader thread) and maps the value of each dimension directly to its
+     * already shifted dimension region index bits, so the engine just has
+     * to OR together one table entry per dimension on note-on.
+     *
+     * The velocity dimension is resolved last (with the velocity table of
+     * the dimension region selected by the other dimensions), exactly the
+     * way libgig does it, so the result is always identical to
+     * Region::GetDimensionRegionIndexByValue().
+     *
+     * A table has to be rebuilt whenever the dimensions of its region were
+     * modified (i.e. by an instrument editor).
+     */
+    class DimensionLookupTable {
+        public:
+            /**
+             * Where the value of a dimension is taken from on note-on.
+             */
+            enum source_t {
+                source_none,               ///< Dimension is ignored, value is always zero.
+                source_controller,         ///< Value is read from the engine channel's ControllerTable.
+                source_velocity,           ///< Note-on velocity.
+                source_layer,              ///< Layer index of the voice to be launched.
+                source_releasetrigger,     ///< Whether a release triggered voice shall be launched.
+                source_keyboard,           ///< Current keyswitching position.
+                source_roundrobin,         ///< Round robin counter of the region.
+                source_roundrobinkeyboard, ///< Round robin counter of the engine channel.
+                source_random              ///< Random zone.
+            };
+
+            /**
+             * Precomputed information about one dimension.
+             */
+            struct dimension_t {
+                source_t source;         ///< Where the dimension's value comes from.
+                uint8_t  controller;     ///< ControllerTable index (only if source is source_controller).
+                uint8_t  zones;          ///< Amount of zones of this dimension.
+                uint8_t  bits[128];      ///< Shifted dimension region index bits for each possible dimension value (empty for the velocity dimension).
+            };
+
+            ::gig::Region* pRegion;      ///< Region this table was built for (NULL if table is not built yet).
+            int          Dimensions;     ///< Amount of dimensions of the region at the time the table was built.
+            int          VelocityDimension; ///< Index of the velocity dimension or -1 if region has no velocity dimension.
+            dimension_t  Dimension[8];
+
+            DimensionLookupTable();
+
+            /**
+             * (Re)builds this table for the given region. This method does
+             * not allocate any memory, but it is far too expensive to be
+             * called on each note-on, so it should rather be called whenever
+             * the instrument is loaded or modified.
+             */
+            void Build(::gig::Region* pRegion);
+
+            /**
+             * Returns @c true if this table was built for the given region
+             * and the region's amount of dimensions did not change since.
+             */
+            inline bool IsValidFor(::gig::Region* pRegion) const {
+                return this->pRegion == pRegion && Dimensions == pRegion->Dimensions;
+            }
+
+            /**
+             * Returns the dimension region index for the given dimension
+             * values. Equivalent to Region::GetDimensionRegionIndexByValue(),
+             * but without any dimension type evaluation or zone search.
+             *
+             * @param DimValues - value for each dimension (0 .. 127)
+             * @returns dimension region index or -1 if no dimension region
+             *          exists for the given values
+             */
+            inline int GetDimensionRegionIndex(const uint DimValues[8]) const {
+                int index = 0;
+                for (int i = 0; i < Dimensions; i++)
+                    index |= Dimension[i].bits[DimValues[i] & 127];
+                if (VelocityDimension < 0) return index;
+                // the velocity dimension's zones might be custom defined
+                // for each dimension region separately
+                ::gig::DimensionRegion* pDimRgn = pRegion->pDimensionRegions[index];
+                if (!pDimRgn) return -1;
+                const ::gig::dimension_def_t& def = pRegion->pDimensionDefinitions[VelocityDimension];
+                const uint velocity = DimValues[VelocityDimension] & 127;
+                const uint8_t zone = (pDimRgn->VelocityTable) ? pDimRgn->VelocityTable[velocity] : uint8_t(velocity / def.zone_size);
+                return index | (((zone & ((1 << def.bits) - 1)) << VelocityBitPos) & 255);
+            }
+
+            /**
+             * Returns the ControllerTable index of the MIDI controller which
+             * selects the zone of the given controller dimension, 128 for
+             * channel aftertouch, or -1 if the dimension is not controlled
+             * by a MIDI controller.
+             */
+            static int DimensionController(::gig::dimension_t dimension);
+
+        private:
+            int VelocityBitPos;
+    };
+
+}} // namespace LinuxSampler::gig
+
+#endif // __LS_GIG_DIMENSIONLOOKUPTABLE_H__
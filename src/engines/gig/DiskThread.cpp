@@ -24,6 +24,7 @@
 
 #include "DiskThread.h"
 #include "Stream.h"
+#include "EngineChannel.h"
 #include "../../common/global_private.h"
 
 namespace LinuxSampler {
@@ -60,5 +61,99 @@ namespace gig {
         if(!pGigStream) throw Exception("Invalid stream type");
         pGigStream->Launch(hStream, pExportReference, pRgn, SampleOffset, DoLoop);
     }
+
+    /**
+     * Stores the engine channel's current controller values, keyswitching
+     * position and round robin counters in the note-on hint (called by the
+     * MIDI input thread queuing the hint).
+     */
+    void DiskThread::PrelaunchSnapshot(prelaunch_command_t& command) {
+        EngineChannel* pChannel = static_cast<EngineChannel*>(command.pEngineChannel);
+        memcpy(command.ControllerTable, pChannel->ControllerTable, sizeof(command.ControllerTable));
+        command.KeyDimension    = pChannel->CurrentKeyDimension;
+        command.RoundRobinIndex = pChannel->RoundRobinIndex;
+        const uint32_t* pIndex  = pChannel->pMIDIKeyInfo[command.Key].pRoundRobinIndex;
+        command.KeyRoundRobinIndex = (pIndex) ? *pIndex : 0;
+    }
+
+    /**
+     * Resolves the dimension regions a note-on on the given key will most
+     * probably trigger (the same way Engine::LaunchVoice() does, but based
+     * on the engine channel's state when the hint was queued) and launches
+     * disk streams for them in advance. Dimension regions selected randomly
+     * or by instrument scripts cannot be predicted and are simply skipped.
+     */
+    void DiskThread::PrelaunchStreams(const prelaunch_command_t& command) {
+        EngineChannel* pChannel = static_cast<EngineChannel*>(command.pEngineChannel);
+        if (!pChannel->pEngine) return;
+
+        // prevents the instrument from being unloaded while we are using it
+        const InstrumentChangeCmd< ::gig::DimensionRegion, ::gig::Instrument>& cmd =
+            pChannel->InstrumentChangeCommandReaderDiskThread.Lock();
+        ::gig::Region* pRegion = (cmd.pInstrument) ? cmd.pInstrument->GetRegion(command.Key) : NULL;
+        if (!pRegion) {
+            pChannel->InstrumentChangeCommandReaderDiskThread.Unlock();
+            return;
+        }
+
+        DimensionLookupTable fallbackTable;
+        const DimensionLookupTable* pLookup = pChannel->GetDimensionLookupTable(pRegion, command.Key, fallbackTable);
+        uint DimValues[8] = { 0 };
+        int layerDimension = -1;
+        for (int i = pLookup->Dimensions - 1; i >= 0; i--) {
+            const DimensionLookupTable::dimension_t& dim = pLookup->Dimension[i];
+            switch (dim.source) {
+                case DimensionLookupTable::source_controller:
+                    DimValues[i] = command.ControllerTable[dim.controller];
+                    break;
+                case DimensionLookupTable::source_velocity:
+                    DimValues[i] = command.Velocity;
+                    break;
+                case DimensionLookupTable::source_layer:
+                    layerDimension = i;
+                    break;
+                case DimensionLookupTable::source_keyboard:
+                    DimValues[i] = (uint) (command.KeyDimension * dim.zones);
+                    break;
+                case DimensionLookupTable::source_roundrobin:
+                    DimValues[i] = uint(command.KeyRoundRobinIndex % dim.zones);
+                    break;
+                case DimensionLookupTable::source_roundrobinkeyboard:
+                    DimValues[i] = uint(command.RoundRobinIndex % dim.zones);
+                    break;
+                case DimensionLookupTable::source_random: // unpredictable
+                    pChannel->InstrumentChangeCommandReaderDiskThread.Unlock();
+                    return;
+                case DimensionLookupTable::source_releasetrigger: // only normal voices are launched on note-on
+                case DimensionLookupTable::source_none:
+                    break;
+            }
+        }
+
+        // launch the streams of all layers, their buffers are filled after
+        // we released the instrument (see DiskThreadBase::Main())
+        const int layers = (layerDimension >= 0) ? pLookup->Dimension[layerDimension].zones : 1;
+        const uint maxPitchSamples = pChannel->pEngine->MaxSamplesPerCycle << CONFIG_MAX_PITCH;
+        for (int iLayer = 0; iLayer < layers; iLayer++) {
+            if (layerDimension >= 0) DimValues[layerDimension] = iLayer;
+            const int index = pLookup->GetDimensionRegionIndex(DimValues);
+            if (index < 0) continue;
+            ::gig::DimensionRegion* pDimRgn = pRegion->pDimensionRegions[index & 255];
+            if (!pDimRgn || !pDimRgn->pSample || !pDimRgn->pSample->SamplesTotal) continue;
+            ::gig::Sample* pSample = pDimRgn->pSample;
+
+            // same calculations as done by the voice on trigger
+            const long cachedsamples = pSample->GetCache().Size / pSample->FrameSize;
+            if (cachedsamples >= pSample->SamplesTotal) continue; // RAM only voice
+            const unsigned long MaxRAMPos =
+                (cachedsamples > maxPitchSamples) ? cachedsamples - maxPitchSamples / pSample->Channels : 0;
+            const bool RAMLoop = pDimRgn->SampleLoops &&
+                (pDimRgn->pSampleLoops[0].LoopStart + pDimRgn->pSampleLoops[0].LoopLength) <= MaxRAMPos;
+
+            PrelaunchStream(pDimRgn, MaxRAMPos, !RAMLoop);
+        }
+
+        pChannel->InstrumentChangeCommandReaderDiskThread.Unlock();
+    }
 }} // namespace LinuxSampler::gig
 
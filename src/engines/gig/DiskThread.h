@@ -47,6 +47,9 @@ namespace LinuxSampler { namespace gig {
                 bool                     DoLoop
             );
 
+            virtual void PrelaunchSnapshot(prelaunch_command_t& command) OVERRIDE;
+            virtual void PrelaunchStreams(const prelaunch_command_t& command) OVERRIDE;
+
         public:
             DiskThread(int MaxStreams, uint BufferWrapElements, InstrumentResourceManager* pInstruments);
             virtual ~DiskThread();
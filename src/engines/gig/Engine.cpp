@@ -219,114 +219,39 @@ namespace LinuxSampler { namespace gig {
         // get current dimension values to select the right dimension region
         //TODO: for stolen voices this dimension region selection block is processed twice, this should be changed
         //FIXME: controller values for selecting the dimension region here are currently not sample accurate
+        DimensionLookupTable fallbackTable;
+        const DimensionLookupTable* pLookup = pChannel->GetDimensionLookupTable(pRegion, MIDIKey, fallbackTable);
         uint DimValues[8] = { 0 };
-        for (int i = pRegion->Dimensions - 1; i >= 0; i--) {
-            switch (pRegion->pDimensionDefinitions[i].dimension) {
-                case ::gig::dimension_samplechannel:
-                    DimValues[i] = 0; //TODO: we currently ignore this dimension
+        for (int i = pLookup->Dimensions - 1; i >= 0; i--) {
+            const DimensionLookupTable::dimension_t& dim = pLookup->Dimension[i];
+            switch (dim.source) {
+                case DimensionLookupTable::source_controller:
+                    DimValues[i] = pChannel->ControllerTable[dim.controller];
                     break;
-                case ::gig::dimension_layer:
-                    DimValues[i] = iLayer;
-                    break;
-                case ::gig::dimension_velocity:
+                case DimensionLookupTable::source_velocity:
                     DimValues[i] = itNoteOnEvent->Param.Note.Velocity;
                     break;
-                case ::gig::dimension_channelaftertouch:
-                    DimValues[i] = pChannel->ControllerTable[128];
+                case DimensionLookupTable::source_layer:
+                    DimValues[i] = iLayer;
                     break;
-                case ::gig::dimension_releasetrigger:
+                case DimensionLookupTable::source_releasetrigger:
                     VoiceType = (ReleaseTriggerVoice) ? Voice::type_release_trigger : (!iLayer) ? Voice::type_release_trigger_required : Voice::type_normal;
                     DimValues[i] = (uint) ReleaseTriggerVoice;
                     break;
-                case ::gig::dimension_keyboard:
-                    DimValues[i] = (uint) (pChannel->CurrentKeyDimension * pRegion->pDimensionDefinitions[i].zones);
-                    break;
-                case ::gig::dimension_roundrobin:
-                    DimValues[i] = uint(*pChannel->pMIDIKeyInfo[MIDIKey].pRoundRobinIndex % pRegion->pDimensionDefinitions[i].zones); // RoundRobinIndex is incremented for each note on in this Region
-                    break;
-                case ::gig::dimension_roundrobinkeyboard:
-                    DimValues[i] = uint(pChannel->RoundRobinIndex % pRegion->pDimensionDefinitions[i].zones); // RoundRobinIndex is incremented for each note on
-                    break;
-                case ::gig::dimension_random:
-                    DimValues[i] = uint(Random() * pRegion->pDimensionDefinitions[i].zones);
-                    break;
-                case ::gig::dimension_smartmidi:
-                    DimValues[i] = 0;
-                    break;
-                case ::gig::dimension_modwheel:
-                    DimValues[i] = pChannel->ControllerTable[1];
-                    break;
-                case ::gig::dimension_breath:
-                    DimValues[i] = pChannel->ControllerTable[2];
-                    break;
-                case ::gig::dimension_foot:
-                    DimValues[i] = pChannel->ControllerTable[4];
-                    break;
-                case ::gig::dimension_portamentotime:
-                    DimValues[i] = pChannel->ControllerTable[5];
-                    break;
-                case ::gig::dimension_effect1:
-                    DimValues[i] = pChannel->ControllerTable[12];
-                    break;
-                case ::gig::dimension_effect2:
-                    DimValues[i] = pChannel->ControllerTable[13];
-                    break;
-                case ::gig::dimension_genpurpose1:
-                    DimValues[i] = pChannel->ControllerTable[16];
-                    break;
-                case ::gig::dimension_genpurpose2:
-                    DimValues[i] = pChannel->ControllerTable[17];
-                    break;
-                case ::gig::dimension_genpurpose3:
-                    DimValues[i] = pChannel->ControllerTable[18];
-                    break;
-                case ::gig::dimension_genpurpose4:
-                    DimValues[i] = pChannel->ControllerTable[19];
-                    break;
-                case ::gig::dimension_sustainpedal:
-                    DimValues[i] = pChannel->ControllerTable[64];
-                    break;
-                case ::gig::dimension_portamento:
-                    DimValues[i] = pChannel->ControllerTable[65];
-                    break;
-                case ::gig::dimension_sostenutopedal:
-                    DimValues[i] = pChannel->ControllerTable[66];
-                    break;
-                case ::gig::dimension_softpedal:
-                    DimValues[i] = pChannel->ControllerTable[67];
-                    break;
-                case ::gig::dimension_genpurpose5:
-                    DimValues[i] = pChannel->ControllerTable[80];
-                    break;
-                case ::gig::dimension_genpurpose6:
-                    DimValues[i] = pChannel->ControllerTable[81];
-                    break;
-                case ::gig::dimension_genpurpose7:
-                    DimValues[i] = pChannel->ControllerTable[82];
-                    break;
-                case ::gig::dimension_genpurpose8:
-                    DimValues[i] = pChannel->ControllerTable[83];
-                    break;
-                case ::gig::dimension_effect1depth:
-                    DimValues[i] = pChannel->ControllerTable[91];
-                    break;
-                case ::gig::dimension_effect2depth:
-                    DimValues[i] = pChannel->ControllerTable[92];
+                case DimensionLookupTable::source_keyboard:
+                    DimValues[i] = (uint) (pChannel->CurrentKeyDimension * dim.zones);
                     break;
-                case ::gig::dimension_effect3depth:
-                    DimValues[i] = pChannel->ControllerTable[93];
+                case DimensionLookupTable::source_roundrobin:
+                    DimValues[i] = uint(*pChannel->pMIDIKeyInfo[MIDIKey].pRoundRobinIndex % dim.zones); // RoundRobinIndex is incremented for each note on in this Region
                     break;
-                case ::gig::dimension_effect4depth:
-                    DimValues[i] = pChannel->ControllerTable[94];
+                case DimensionLookupTable::source_roundrobinkeyboard:
+                    DimValues[i] = uint(pChannel->RoundRobinIndex % dim.zones); // RoundRobinIndex is incremented for each note on
                     break;
-                case ::gig::dimension_effect5depth:
-                    DimValues[i] = pChannel->ControllerTable[95];
+                case DimensionLookupTable::source_random:
+                    DimValues[i] = uint(Random() * dim.zones);
                     break;
-                case ::gig::dimension_none:
-                    std::cerr << "gig::Engine::LaunchVoice() Error: dimension=none\n" << std::flush;
+                case DimensionLookupTable::source_none:
                     break;
-                default:
-                    std::cerr << "gig::Engine::LaunchVoice() Error: Unknown dimension\n" << std::flush;
             }
         }
 
@@ -338,15 +263,14 @@ namespace LinuxSampler { namespace gig {
         NoteIterator itNote = GetNotePool()->fromID(itNoteOnEvent->Param.Note.ID);
 
         ::gig::DimensionRegion* pDimRgn;
-        if (!itNote->Format.Gig.DimMask) { // normal case ...
-            pDimRgn = pRegion->GetDimensionRegionByValue(DimValues);
-        } else { // some dimension zones were overridden (i.e. by instrument script) ...
+        int index = pLookup->GetDimensionRegionIndex(DimValues);
+        if (index < 0) return Pool<Voice>::Iterator(); // error (could not resolve dimension region)
+        if (itNote->Format.Gig.DimMask) { // some dimension zones were overridden (i.e. by instrument script) ...
             dmsg(3,("trigger with dim mask=%d val=%d\n", itNote->Format.Gig.DimMask, itNote->Format.Gig.DimBits));
-            int index = pRegion->GetDimensionRegionIndexByValue(DimValues);
             index &= ~itNote->Format.Gig.DimMask;
             index |=  itNote->Format.Gig.DimBits & itNote->Format.Gig.DimMask;
-            pDimRgn = pRegion->pDimensionRegions[index & 255];
         }
+        pDimRgn = pRegion->pDimensionRegions[index & 255];
         if (!pDimRgn) return Pool<Voice>::Iterator(); // error (could not resolve dimension region)
 
         // no need to continue if sample is silent
@@ -29,6 +29,7 @@
 namespace LinuxSampler { namespace gig {
     EngineChannel::EngineChannel() {
         CurrentGigScript = NULL;
+        for (int i = 0; i < 128; i++) pKeyDimensionLookup[i] = NULL;
     }
 
     EngineChannel::~EngineChannel() {
@@ -157,6 +158,8 @@ namespace LinuxSampler { namespace gig {
             region++;
         }
 
+        BuildDimensionLookupTables(newInstrument);
+
         InstrumentIdxName = newInstrument->pInfo->Name;
         InstrumentStat = 100;
 
@@ -197,6 +200,62 @@ namespace LinuxSampler { namespace gig {
         }
     }
 
+    /**
+     * (Re)builds the dimension lookup tables for all regions of the given
+     * instrument. This method must only be called while the audio thread is
+     * not using this engine channel's lookup tables, that is either while
+     * no instrument is assigned to the audio thread's side (instrument
+     * loading) or while the engine is suspended (instrument editor).
+     *
+     * @param pInstrument - instrument currently loaded on this channel
+     */
+    void EngineChannel::BuildDimensionLookupTables(::gig::Instrument* pInstrument) {
+        for (int i = 0; i < 128; i++) pKeyDimensionLookup[i] = NULL;
+        DimensionLookupTables.clear();
+        if (!pInstrument) return;
+
+        for (::gig::Region* pRegion = pInstrument->GetFirstRegion(); pRegion; pRegion = pInstrument->GetNextRegion()) {
+            DimensionLookupTables.push_back(DimensionLookupTable());
+            DimensionLookupTables.back().Build(pRegion);
+        }
+        // assign keys only after the vector is complete (stable addresses)
+        for (int i = 0; i < DimensionLookupTables.size(); i++) {
+            ::gig::Region* pRegion = DimensionLookupTables[i].pRegion;
+            for (int iKey = pRegion->KeyRange.low; iKey <= pRegion->KeyRange.high && iKey < 128; iKey++)
+                pKeyDimensionLookup[iKey] = &DimensionLookupTables[i];
+        }
+    }
+
+    /**
+     * Called by the instrument resource manager after the given region was
+     * modified by an instrument editor, to rebuild its dimension lookup
+     * table. The region must be suspended while calling this method.
+     */
+    void EngineChannel::RebuildDimensionLookupTable(::gig::Region* pRegion) {
+        for (int i = 0; i < DimensionLookupTables.size(); i++) {
+            DimensionLookupTable& table = DimensionLookupTables[i];
+            if (table.pRegion != pRegion) continue;
+            table.Build(pRegion);
+            for (int iKey = pRegion->KeyRange.low; iKey <= pRegion->KeyRange.high && iKey < 128; iKey++)
+                pKeyDimensionLookup[iKey] = &table;
+            return;
+        }
+    }
+
+    /**
+     * Returns the dimension lookup table for the given region on the given
+     * MIDI key. If the table is not up to date (i.e. because the instrument
+     * was modified by other means than the instrument editor API), the
+     * table is built on the fly into @a fallback instead.
+     */
+    const DimensionLookupTable* EngineChannel::GetDimensionLookupTable(::gig::Region* pRegion, int Key, DimensionLookupTable& fallback) {
+        const DimensionLookupTable* pTable = pKeyDimensionLookup[Key & 127];
+        if (pTable && pTable->IsValidFor(pRegion)) return pTable;
+        dmsg(2,("gig::EngineChannel: dimension lookup table of key %d outdated\n", Key));
+        fallback.Build(pRegion);
+        return &fallback;
+    }
+
     void EngineChannel::ProcessKeySwitchChange(int key) {
         // Change key dimension value if key is in keyswitching area
         {
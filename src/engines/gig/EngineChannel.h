@@ -30,7 +30,9 @@
 #include "../EngineChannelBase.h"
 #include "../EngineChannelFactory.h"
 #include "Voice.h"
+#include "DimensionLookupTable.h"
 #include <gig.h>
+#include <vector>
 
 namespace LinuxSampler { namespace gig {
     class Voice;
@@ -46,9 +48,12 @@ namespace LinuxSampler { namespace gig {
             virtual AbstractEngine::Format GetEngineFormat();
 
             void reloadScript(::gig::Script* script);
+            void BuildDimensionLookupTables(::gig::Instrument* pInstrument);
+            void RebuildDimensionLookupTable(::gig::Region* pRegion);
 
             friend class Voice;
             friend class Engine;
+            friend class DiskThread;
             friend class LinuxSampler::EngineChannelFactory;
 
         protected:
@@ -57,6 +62,10 @@ namespace LinuxSampler { namespace gig {
 
             float CurrentKeyDimension;      ///< Current value (0-1.0) for the keyboard dimension, altered by pressing a keyswitching key.
             ::gig::Script* CurrentGigScript; ///< Only used when a script is updated (i.e. by instrument editor), to check whether this engine channel is actually using that specific script reference.
+            std::vector<DimensionLookupTable> DimensionLookupTables; ///< Precomputed dimension region selection for each region of the current instrument.
+            DimensionLookupTable* pKeyDimensionLookup[128]; ///< Dimension lookup table of the region on the respective MIDI key (NULL if no region on that key).
+
+            const DimensionLookupTable* GetDimensionLookupTable(::gig::Region* pRegion, int Key, DimensionLookupTable& fallback);
 
             virtual void ProcessKeySwitchChange(int key);
 
@@ -25,12 +25,17 @@
 #ifndef __LS_GIG_FILTER_H__
 #define __LS_GIG_FILTER_H__
 
-#include "../../common/global.h"
+#include "../../common/global_private.h"
 
 #include <gig.h>
 
 #include <cmath>
 
+#if CONFIG_ASM && ARCH_X86 && defined(__SSE2__)
+# include <emmintrin.h>
+# define FILTER_SSE_CASCADE 1
+#endif
+
 /* TODO: This file contains both generic filters (used by the sfz
    engine) and gig specific filters. It should probably be split up,
    and the generic parts should be moved out of the gig directory. */
@@ -84,6 +89,14 @@ namespace LinuxSampler {
 
     /**
      * Abstract base class for all filter implementations.
+     *
+     * Besides the per sample Apply() method, each filter implementation
+     * provides a block processing method ApplyBlock(), which filters a
+     * whole buffer in place with one virtual call, keeping the filter state
+     * in registers for the whole block. ApplyBlock() optionally ramps the
+     * filter coefficients linearly towards new values, one increment per
+     * sample (see GetDeltas()), which avoids the zipper noise caused by
+     * changing the coefficients abruptly once per subfragment.
      */
     class FilterBase {
     public:
@@ -91,17 +104,63 @@ namespace LinuxSampler {
         virtual void SetParameters(FilterData& d, float fc, float r,
                                    float fs) const = 0;
         virtual void Reset(FilterData& d) const = 0;
+
+        /**
+         * Filters @a n samples of @a pBuf in place.
+         *
+         * @param d      - filter state and current coefficients
+         * @param pDelta - per sample increment of each coefficient (as
+         *                 calculated by GetDeltas()), or NULL if the
+         *                 coefficients shall stay constant
+         * @param pBuf   - input and output buffer
+         * @param n      - amount of sample points to process
+         */
+        virtual void ApplyBlock(FilterData& d, const FilterData* pDelta,
+                                float* pBuf, uint n) const = 0;
+
+        /**
+         * Calculates the per sample increments of all coefficients used by
+         * this filter type, for ramping the coefficients of @a from towards
+         * the coefficients of @a to.
+         *
+         * @param from  - current coefficients
+         * @param to    - target coefficients
+         * @param delta - output: coefficient increments
+         * @param scale - reciprocal of the ramp length in sample points
+         */
+        virtual void GetDeltas(const FilterData& from, const FilterData& to,
+                               FilterData& delta, float scale) const = 0;
     protected:
         void KillDenormal(float& f) const {
             f += 1e-18f;
             f -= 1e-18f;
         }
+
+        static void Ramp(float& c, const float& from, const float& to,
+                         float scale) {
+            c = (to - from) * scale;
+        }
     };
 
     /**
      * One-pole lowpass filter.
      */
     class LowpassFilter1p : public FilterBase {
+    private:
+        template<bool RAMP>
+        void Process(FilterData& d, float da1, float* pBuf, uint n) const {
+            float a1 = d.a1, y1 = d.y1;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) a1 += da1;
+                const float x = pBuf[i];
+                float y = x + a1 * (x - y1);
+                KillDenormal(y);
+                pBuf[i] = y1 = y;
+            }
+            d.a1 = a1;
+            d.y1 = y1;
+        }
+
     public:
         LowpassFilter1p() { }
 
@@ -112,6 +171,15 @@ namespace LinuxSampler {
             return y;
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) Process<true>(d, pDelta->a1, pBuf, n);
+            else        Process<false>(d, 0, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            Ramp(delta.a1, from.a1, to.a1, scale);
+        }
+
         void SetParameters(FilterData& d, float fc, float r, float fs) const {
             float omega = 2.0 * M_PI * fc / fs;
             float c     = 2 - cos(omega);
@@ -128,6 +196,23 @@ namespace LinuxSampler {
      * One pole highpass filter.
      */
     class HighpassFilter1p : public FilterBase {
+    private:
+        template<bool RAMP>
+        void Process(FilterData& d, float da1, float* pBuf, uint n) const {
+            float a1 = d.a1, x1 = d.x1, y1 = d.y1;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) a1 += da1;
+                const float x = pBuf[i];
+                float y = a1 * (-x + x1 - y1);
+                KillDenormal(y);
+                x1 = x;
+                pBuf[i] = y1 = y;
+            }
+            d.a1 = a1;
+            d.x1 = x1;
+            d.y1 = y1;
+        }
+
     public:
         HighpassFilter1p() { }
 
@@ -140,6 +225,15 @@ namespace LinuxSampler {
             return y;
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) Process<true>(d, pDelta->a1, pBuf, n);
+            else        Process<false>(d, 0, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            Ramp(delta.a1, from.a1, to.a1, scale);
+        }
+
         void SetParameters(FilterData& d, float fc, float r, float fs) const {
             float omega = 2.0 * M_PI * fc / fs;
             float c     = 2 - cos(omega);
@@ -170,11 +264,175 @@ namespace LinuxSampler {
             return y;
         }
 
+        /**
+         * Filters a whole block with one biquad stage.
+         */
+        template<bool RAMP>
+        void ApplyBQBlock(BiquadFilterData& d, const BiquadFilterData* pDelta, float* pBuf, uint n) const {
+            float b0 = d.b0, b1 = d.b1, b2 = d.b2, a1 = d.a1, a2 = d.a2;
+            float x1 = d.x1, x2 = d.x2, y1 = d.y1, y2 = d.y2;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) {
+                    b0 += pDelta->b0;
+                    b1 += pDelta->b1;
+                    b2 += pDelta->b2;
+                    a1 += pDelta->a1;
+                    a2 += pDelta->a2;
+                }
+                const float x = pBuf[i];
+                float y = b0 * x + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+                KillDenormal(y);
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                pBuf[i] = y;
+            }
+            d.b0 = b0; d.b1 = b1; d.b2 = b2; d.a1 = a1; d.a2 = a2;
+            d.x1 = x1; d.x2 = x2; d.y1 = y1; d.y2 = y2;
+        }
+
+        /**
+         * Filters a whole block with @a STAGES cascaded biquad stages.
+         *
+         * If SSE2 is available, the stages are processed in a pipelined
+         * manner: each stage occupies one lane of a SIMD vector and stage k
+         * processes sample t - k while stage 0 processes sample t, so all
+         * stages are calculated with one vector operation per sample.
+         * Otherwise the stages are applied one after another on the whole
+         * block.
+         */
+        template<int STAGES, bool RAMP>
+        void ApplyCascadeBlock(BiquadFilterData* const* stage, const BiquadFilterData* const* delta, float* pBuf, uint n) const {
+            #if FILTER_SSE_CASCADE
+            if (n >= STAGES) {
+                ApplyCascadeBlockV<STAGES,RAMP>(stage, delta, pBuf, n);
+                return;
+            }
+            #endif
+            for (int k = 0; k < STAGES; ++k)
+                ApplyBQBlock<RAMP>(*stage[k], (RAMP) ? delta[k] : NULL, pBuf, n);
+        }
+
+        static void GetDeltasBQ(const BiquadFilterData& from, const BiquadFilterData& to, BiquadFilterData& delta, float scale) {
+            Ramp(delta.b0, from.b0, to.b0, scale);
+            Ramp(delta.b1, from.b1, to.b1, scale);
+            Ramp(delta.b2, from.b2, to.b2, scale);
+            Ramp(delta.a1, from.a1, to.a1, scale);
+            Ramp(delta.a2, from.a2, to.a2, scale);
+        }
+
+    private:
+        #if FILTER_SSE_CASCADE
+        union vec_t {
+            __m128 v;
+            float  f[4];
+        };
+
+        template<int STAGES, bool RAMP>
+        void ApplyCascadeBlockV(BiquadFilterData* const* stage, const BiquadFilterData* const* delta, float* pBuf, uint n) const {
+            vec_t b0, b1, b2, a1, a2, x1, x2, y1, y2;
+            vec_t db0, db1, db2, da1, da2;
+            for (int k = 0; k < 4; ++k) {
+                if (k < STAGES) {
+                    const BiquadFilterData& s = *stage[k];
+                    b0.f[k] = s.b0; b1.f[k] = s.b1; b2.f[k] = s.b2;
+                    a1.f[k] = s.a1; a2.f[k] = s.a2;
+                    x1.f[k] = s.x1; x2.f[k] = s.x2;
+                    y1.f[k] = s.y1; y2.f[k] = s.y2;
+                    if (RAMP) {
+                        db0.f[k] = delta[k]->b0; db1.f[k] = delta[k]->b1;
+                        db2.f[k] = delta[k]->b2; da1.f[k] = delta[k]->a1;
+                        da2.f[k] = delta[k]->a2;
+                    }
+                } else { // unused lane, always outputs silence
+                    b0.f[k] = b1.f[k] = b2.f[k] = a1.f[k] = a2.f[k] = 0;
+                    x1.f[k] = x2.f[k] = y1.f[k] = y2.f[k] = 0;
+                    db0.f[k] = db1.f[k] = db2.f[k] = da1.f[k] = da2.f[k] = 0;
+                }
+            }
+            // fill the pipeline: only the first t + 1 stages have input yet
+            for (int t = 0; t < STAGES - 1; ++t)
+                for (int k = t; k >= 0; --k)
+                    StepLane<RAMP>(k, (k) ? y1.f[k - 1] : pBuf[t], b0, b1, b2, a1, a2, x1, x2, y1, y2, db0, db1, db2, da1, da2);
+            // all stages busy
+            const __m128 denormal = _mm_set1_ps(1e-18f);
+            vec_t x, y;
+            for (uint t = STAGES - 1; t < n; ++t) {
+                if (RAMP) {
+                    b0.v = _mm_add_ps(b0.v, db0.v);
+                    b1.v = _mm_add_ps(b1.v, db1.v);
+                    b2.v = _mm_add_ps(b2.v, db2.v);
+                    a1.v = _mm_add_ps(a1.v, da1.v);
+                    a2.v = _mm_add_ps(a2.v, da2.v);
+                }
+                // input of stage k is the previous output of stage k - 1
+                x.v = _mm_move_ss(
+                    _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y1.v), 4)),
+                    _mm_set_ss(pBuf[t])
+                );
+                // terms not depending on the previous step's output first,
+                // to keep the dependency chain between steps short
+                const __m128 acc = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(b1.v, x1.v), _mm_mul_ps(b2.v, x2.v)),
+                    _mm_mul_ps(a2.v, y2.v)
+                );
+                y.v = _mm_add_ps(acc, _mm_add_ps(_mm_mul_ps(a1.v, y1.v), _mm_mul_ps(b0.v, x.v)));
+                y.v = _mm_sub_ps(_mm_add_ps(y.v, denormal), denormal);
+                x2.v = x1.v;
+                x1.v = x.v;
+                y2.v = y1.v;
+                y1.v = y.v;
+                pBuf[t - (STAGES - 1)] = y.f[STAGES - 1];
+            }
+            // drain the pipeline: stage k still has to process sample t - k
+            for (int t = n; t < int(n) + STAGES - 1; ++t) {
+                for (int k = STAGES - 1; k > t - int(n); --k)
+                    StepLane<RAMP>(k, y1.f[k - 1], b0, b1, b2, a1, a2, x1, x2, y1, y2, db0, db1, db2, da1, da2);
+                pBuf[t - (STAGES - 1)] = y1.f[STAGES - 1];
+            }
+            for (int k = 0; k < STAGES; ++k) {
+                BiquadFilterData& s = *stage[k];
+                s.b0 = b0.f[k]; s.b1 = b1.f[k]; s.b2 = b2.f[k];
+                s.a1 = a1.f[k]; s.a2 = a2.f[k];
+                s.x1 = x1.f[k]; s.x2 = x2.f[k];
+                s.y1 = y1.f[k]; s.y2 = y2.f[k];
+            }
+        }
+
+        template<bool RAMP>
+        void StepLane(int k, float x, vec_t& b0, vec_t& b1, vec_t& b2, vec_t& a1, vec_t& a2,
+                      vec_t& x1, vec_t& x2, vec_t& y1, vec_t& y2,
+                      const vec_t& db0, const vec_t& db1, const vec_t& db2, const vec_t& da1, const vec_t& da2) const
+        {
+            if (RAMP) {
+                b0.f[k] += db0.f[k]; b1.f[k] += db1.f[k]; b2.f[k] += db2.f[k];
+                a1.f[k] += da1.f[k]; a2.f[k] += da2.f[k];
+            }
+            float y = b0.f[k] * x + b1.f[k] * x1.f[k] + b2.f[k] * x2.f[k] +
+                      a1.f[k] * y1.f[k] + a2.f[k] * y2.f[k];
+            KillDenormal(y);
+            x2.f[k] = x1.f[k];
+            x1.f[k] = x;
+            y2.f[k] = y1.f[k];
+            y1.f[k] = y;
+        }
+        #endif // FILTER_SSE_CASCADE
+
     public:
         float Apply(FilterData& d, float x) const {
             return ApplyBQ(d, x);
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) ApplyBQBlock<true>(d, pDelta, pBuf, n);
+            else        ApplyBQBlock<false>(d, NULL, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            GetDeltasBQ(from, to, delta, scale);
+        }
+
         void Reset(FilterData& d) const {
             d.x1 = d.x2 = 0;
             d.y1 = d.y2 = 0;
@@ -190,6 +448,21 @@ namespace LinuxSampler {
             return ApplyBQ(d.d2, BiquadFilter::Apply(d, x));
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            BiquadFilterData* stage[2] = { &d, &d.d2 };
+            if (pDelta) {
+                const BiquadFilterData* delta[2] = { pDelta, &pDelta->d2 };
+                ApplyCascadeBlock<2,true>(stage, delta, pBuf, n);
+            } else {
+                ApplyCascadeBlock<2,false>(stage, NULL, pBuf, n);
+            }
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            GetDeltasBQ(from, to, delta, scale);
+            GetDeltasBQ(from.d2, to.d2, delta.d2, scale);
+        }
+
         void Reset(FilterData& d) const {
             BiquadFilter::Reset(d);
             d.d2.x1 = d.d2.x2 = 0;
@@ -206,6 +479,21 @@ namespace LinuxSampler {
             return ApplyBQ(d.d3, DoubleBiquadFilter::Apply(d, x));
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            BiquadFilterData* stage[3] = { &d, &d.d2, &d.d3 };
+            if (pDelta) {
+                const BiquadFilterData* delta[3] = { pDelta, &pDelta->d2, &pDelta->d3 };
+                ApplyCascadeBlock<3,true>(stage, delta, pBuf, n);
+            } else {
+                ApplyCascadeBlock<3,false>(stage, NULL, pBuf, n);
+            }
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            DoubleBiquadFilter::GetDeltas(from, to, delta, scale);
+            GetDeltasBQ(from.d3, to.d3, delta.d3, scale);
+        }
+
         void Reset(FilterData& d) const {
             DoubleBiquadFilter::Reset(d);
             d.d3.x1 = d.d3.x2 = 0;
@@ -454,6 +742,44 @@ namespace gig {
             d.y1 = y;
             return y;
         }
+
+        /**
+         * Register copy of the recursive part shared by all gig filters,
+         * used for block processing.
+         */
+        struct PolesA {
+            float a1, a2, a3;
+            float y1, y2, y3;
+
+            PolesA(const FilterData& d) :
+                a1(d.a1), a2(d.a2), a3(d.a3), y1(d.y1), y2(d.y2), y3(d.y3) { }
+
+            void Store(FilterData& d) const {
+                d.a1 = a1; d.a2 = a2; d.a3 = a3;
+                d.y1 = y1; d.y2 = y2; d.y3 = y3;
+            }
+
+            void Ramp(const FilterData& delta) {
+                a1 += delta.a1;
+                a2 += delta.a2;
+                a3 += delta.a3;
+            }
+        };
+
+        float ApplyA(PolesA& p, float x) const {
+            float y = x - p.a1 * p.y1 - p.a2 * p.y2 - p.a3 * p.y3;
+            KillDenormal(y);
+            p.y3 = p.y2;
+            p.y2 = p.y1;
+            p.y1 = y;
+            return y;
+        }
+
+        static void GetDeltasA(const FilterData& from, const FilterData& to, FilterData& delta, float scale) {
+            Ramp(delta.a1, from.a1, to.a1, scale);
+            Ramp(delta.a2, from.a2, to.a2, scale);
+            Ramp(delta.a3, from.a3, to.a3, scale);
+        }
     };
 
 #define GIG_PARAM_INIT                                                  \
@@ -469,6 +795,34 @@ namespace gig {
             return ApplyA(d, d.b0 * x);
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) Process<true>(d, pDelta, pBuf, n);
+            else        Process<false>(d, NULL, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            GetDeltasA(from, to, delta, scale);
+            Ramp(delta.b0, from.b0, to.b0, scale);
+        }
+
+    private:
+        template<bool RAMP>
+        void Process(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            PolesA p(d);
+            float b0 = d.b0;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) {
+                    p.Ramp(*pDelta);
+                    b0 += pDelta->b0;
+                }
+                pBuf[i] = ApplyA(p, b0 * pBuf[i]);
+            }
+            p.Store(d);
+            d.b0 = b0;
+        }
+
+    public:
+
         void SetParameters(FilterData& d, float fc, float r, float fs) const {
             GIG_PARAM_INIT;
 
@@ -491,6 +845,40 @@ namespace gig {
             return y;
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) Process<true>(d, pDelta, pBuf, n);
+            else        Process<false>(d, NULL, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            GetDeltasA(from, to, delta, scale);
+            Ramp(delta.b0, from.b0, to.b0, scale);
+            Ramp(delta.b2, from.b2, to.b2, scale);
+        }
+
+    private:
+        template<bool RAMP>
+        void Process(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            PolesA p(d);
+            float b0 = d.b0, b2 = d.b2, x1 = d.x1, x2 = d.x2;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) {
+                    p.Ramp(*pDelta);
+                    b0 += pDelta->b0;
+                    b2 += pDelta->b2;
+                }
+                const float x = pBuf[i];
+                pBuf[i] = ApplyA(p, b0 * x + b2 * x2);
+                x2 = x1;
+                x1 = x;
+            }
+            p.Store(d);
+            d.b0 = b0; d.b2 = b2;
+            d.x1 = x1; d.x2 = x2;
+        }
+
+    public:
+
         void SetParameters(FilterData& d, float fc, float r, float fs) const {
             GIG_PARAM_INIT;
 
@@ -514,6 +902,39 @@ namespace gig {
             return y * d.scale;
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) Process<true>(d, pDelta, pBuf, n);
+            else        Process<false>(d, NULL, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            GetDeltasA(from, to, delta, scale);
+            Ramp(delta.scale, from.scale, to.scale, scale);
+        }
+
+    private:
+        template<bool RAMP>
+        void Process(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            PolesA p(d);
+            float scale = d.scale, x1 = d.x1, x2 = d.x2, x3 = d.x3;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) {
+                    p.Ramp(*pDelta);
+                    scale += pDelta->scale;
+                }
+                const float x = pBuf[i];
+                pBuf[i] = ApplyA(p, -x + x1 + x2 - x3) * scale;
+                x3 = x2;
+                x2 = x1;
+                x1 = x;
+            }
+            p.Store(d);
+            d.scale = scale;
+            d.x1 = x1; d.x2 = x2; d.x3 = x3;
+        }
+
+    public:
+
         void SetParameters(FilterData& d, float fc, float r, float fs) const {
             GIG_PARAM_INIT;
 
@@ -536,6 +957,41 @@ namespace gig {
             return y * d.scale;
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) Process<true>(d, pDelta, pBuf, n);
+            else        Process<false>(d, NULL, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            GetDeltasA(from, to, delta, scale);
+            Ramp(delta.b2, from.b2, to.b2, scale);
+            Ramp(delta.scale, from.scale, to.scale, scale);
+        }
+
+    private:
+        template<bool RAMP>
+        void Process(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            PolesA p(d);
+            float b2 = d.b2, scale = d.scale, x1 = d.x1, x2 = d.x2, x3 = d.x3;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) {
+                    p.Ramp(*pDelta);
+                    b2    += pDelta->b2;
+                    scale += pDelta->scale;
+                }
+                const float x = pBuf[i];
+                pBuf[i] = ApplyA(p, x - x1 + b2 * x2 + x3) * scale;
+                x3 = x2;
+                x2 = x1;
+                x1 = x;
+            }
+            p.Store(d);
+            d.b2 = b2; d.scale = scale;
+            d.x1 = x1; d.x2 = x2; d.x3 = x3;
+        }
+
+    public:
+
         void SetParameters(FilterData& d, float fc, float r, float fs) const {
             GIG_PARAM_INIT;
 
@@ -561,6 +1017,42 @@ namespace gig {
             return y;
         }
 
+        void ApplyBlock(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            if (pDelta) Process<true>(d, pDelta, pBuf, n);
+            else        Process<false>(d, NULL, pBuf, n);
+        }
+
+        void GetDeltas(const FilterData& from, const FilterData& to, FilterData& delta, float scale) const {
+            LowpassFilter::GetDeltas(from, to, delta, scale);
+            Ramp(delta.b20, from.b20, to.b20, scale);
+        }
+
+    private:
+        template<bool RAMP>
+        void Process(FilterData& d, const FilterData* pDelta, float* pBuf, uint n) const {
+            PolesA p(d);
+            float b0 = d.b0, b20 = d.b20;
+            float y1 = d.y21, y2 = d.y22, y3 = d.y23;
+            for (uint i = 0; i < n; ++i) {
+                if (RAMP) {
+                    p.Ramp(*pDelta);
+                    b0  += pDelta->b0;
+                    b20 += pDelta->b20;
+                }
+                float y = b20 * ApplyA(p, b0 * pBuf[i])
+                    - p.a1 * y1 - p.a2 * y2 - p.a3 * y3;
+                KillDenormal(y);
+                y3 = y2;
+                y2 = y1;
+                pBuf[i] = y1 = y;
+            }
+            p.Store(d);
+            d.b0 = b0; d.b20 = b20;
+            d.y21 = y1; d.y22 = y2; d.y23 = y3;
+        }
+
+    public:
+
         void SetParameters(FilterData& d, float fc, float r, float fs) const {
             LowpassFilter::SetParameters(d, fc, r, fs);
             d.b20 = d.b0 * 0.5;
@@ -594,13 +1086,22 @@ namespace gig {
             static const gig::LowpassTurboFilter LPTFilter;
 
             FilterData d;
+            FilterData delta; ///< Per sample coefficient increments while ramping.
             const FilterBase* pFilter;
+            uint uiRampLeft;  ///< Remaining sample points of the current coefficient ramp.
+            bool bCoeffsValid; ///< Whether coefficients were calculated since the last filter type change.
+            uint uiGeneration; ///< Incremented on each filter type change and reset.
+
+            friend class FilterBank;
 
         public:
             Filter() {
                 // set filter type to 'lowpass' by default
                 pFilter = &LPFilter;
                 pFilter->Reset(d);
+                uiRampLeft   = 0;
+                bCoeffsValid = false;
+                uiGeneration = 0;
             }
 
             enum vcf_type_t {
@@ -669,19 +1170,76 @@ namespace gig {
                         pFilter = &LPFilter;
                 }
                 pFilter->Reset(d);
+                uiRampLeft   = 0;
+                bCoeffsValid = false;
+                uiGeneration++;
+            }
+
+            /**
+             * Returns the amount of cascaded biquad stages of the current
+             * filter type, or 0 if it is not a biquad based filter type.
+             */
+            int BiquadStages() const {
+                if (pFilter == &lp2p || pFilter == &hp2p || pFilter == &bp2p || pFilter == &br2p)
+                    return 1;
+                if (pFilter == &lp4p || pFilter == &hp4p)
+                    return 2;
+                if (pFilter == &lp6p || pFilter == &hp6p)
+                    return 3;
+                return 0;
             }
 
-            void SetParameters(float cutoff, float resonance, float fs) {
-                pFilter->SetParameters(d, cutoff, resonance, fs);
+            /**
+             * Calculates new filter coefficients for the given cutoff
+             * frequency and resonance.
+             *
+             * If @a RampSamples is not zero, the coefficients are not
+             * changed immediately, but rather linearly ramped from their
+             * current values to the new ones over the next @a RampSamples
+             * sample points processed by ApplyBlock(). For the biquad
+             * filters this is always stable, since the coefficients of
+             * both end points lie in the (convex) stability triangle.
+             * The first call after a filter type change always sets the
+             * coefficients immediately.
+             */
+            void SetParameters(float cutoff, float resonance, float fs, uint RampSamples = 0) {
+                if (!RampSamples || !bCoeffsValid) {
+                    pFilter->SetParameters(d, cutoff, resonance, fs);
+                    uiRampLeft   = 0;
+                    bCoeffsValid = true;
+                    return;
+                }
+                FilterData target = d;
+                pFilter->SetParameters(target, cutoff, resonance, fs);
+                pFilter->GetDeltas(d, target, delta, 1.0f / float(RampSamples));
+                uiRampLeft = RampSamples;
             }
 
             void Reset() {
+                uiRampLeft = 0;
+                uiGeneration++;
                 return pFilter->Reset(d);
             }
 
             float Apply(float in) {
                 return pFilter->Apply(d, in);
             }
+
+            /**
+             * Filters @a n sample points of @a pBuf in place, ramping the
+             * coefficients as long as a ramp started by SetParameters() is
+             * in progress.
+             */
+            void ApplyBlock(float* pBuf, uint n) {
+                if (uiRampLeft) {
+                    const uint nRamp = (n < uiRampLeft) ? n : uiRampLeft;
+                    pFilter->ApplyBlock(d, &delta, pBuf, nRamp);
+                    uiRampLeft -= nRamp;
+                    pBuf += nRamp;
+                    n    -= nRamp;
+                }
+                if (n) pFilter->ApplyBlock(d, NULL, pBuf, n);
+            }
     };
 
 } //namespace LinuxSampler
@@ -456,9 +456,24 @@ namespace LinuxSampler { namespace gig {
         dmsg(5,("gig::InstrumentResourceManager::OnDataStructureChanged(%s)\n", sStructType.c_str()));
         //TODO: remove code duplication
         if (sStructType == "gig::File") {
+            // the engines are still suspended, so we can safely rebuild the
+            // dimension lookup tables of all instruments of that file
+            ::gig::File* pFile = (::gig::File*) pStruct;
+            Lock();
+            std::vector< ::gig::Instrument*> instruments =
+                GetInstrumentsCurrentlyUsedOf(pFile, false/*don't lock again*/);
+            for (int i = 0; i < instruments.size(); i++)
+                RebuildDimensionLookupTables(instruments[i]);
+            Unlock();
             // resume all previously suspended engines
             ResumeAllEngines();
         } else if (sStructType == "gig::Instrument") {
+            // the engines are still suspended, so we can safely rebuild the
+            // dimension lookup tables of the instrument
+            ::gig::Instrument* pInstrument = (::gig::Instrument*) pStruct;
+            Lock();
+            RebuildDimensionLookupTables(pInstrument);
+            Unlock();
             // resume all previously suspended engines
             ResumeAllEngines();
         } else if (sStructType == "gig::Sample") {
@@ -490,6 +505,9 @@ namespace LinuxSampler { namespace gig {
             ::gig::Instrument* pInstrument =
                 (::gig::Instrument*) pRegion->GetParent();
             Lock();
+            // region is still suspended, so we can safely rebuild its
+            // dimension lookup tables
+            RebuildDimensionLookupTable(pRegion);
             std::set<Engine*> engines =
                 GetEnginesUsing(pInstrument, false/*don't lock again*/);
             std::set<Engine*>::iterator iter = engines.begin();
@@ -505,6 +523,9 @@ namespace LinuxSampler { namespace gig {
             ::gig::Instrument* pInstrument =
                 (::gig::Instrument*) pRegion->GetParent();
             Lock();
+            // region is still suspended, so we can safely rebuild its
+            // dimension lookup tables
+            RebuildDimensionLookupTable(pRegion);
             std::set<Engine*> engines =
                 GetEnginesUsing(pInstrument, false/*don't lock again*/);
             std::set<Engine*>::iterator iter = engines.begin();
@@ -534,6 +555,33 @@ namespace LinuxSampler { namespace gig {
         }
     }
 
+    /**
+     * Rebuilds the dimension lookup tables of all engine channels using the
+     * given instrument. Must only be called while the respective engines are
+     * suspended. Caller must lock the resource manager.
+     */
+    void InstrumentResourceManager::RebuildDimensionLookupTables(::gig::Instrument* pInstrument) {
+        std::set<EngineChannel*> engineChannels =
+            GetEngineChannelsUsing(pInstrument, false/*don't lock again*/);
+        std::set<EngineChannel*>::iterator iter = engineChannels.begin();
+        std::set<EngineChannel*>::iterator end  = engineChannels.end();
+        for (; iter != end; ++iter) (*iter)->BuildDimensionLookupTables(pInstrument);
+    }
+
+    /**
+     * Rebuilds the dimension lookup table of the given region on all engine
+     * channels using the region's instrument. Must only be called while the
+     * region is suspended. Caller must lock the resource manager.
+     */
+    void InstrumentResourceManager::RebuildDimensionLookupTable(::gig::Region* pRegion) {
+        ::gig::Instrument* pInstrument = (::gig::Instrument*) pRegion->GetParent();
+        std::set<EngineChannel*> engineChannels =
+            GetEngineChannelsUsing(pInstrument, false/*don't lock again*/);
+        std::set<EngineChannel*>::iterator iter = engineChannels.begin();
+        std::set<EngineChannel*>::iterator end  = engineChannels.end();
+        for (; iter != end; ++iter) (*iter)->RebuildDimensionLookupTable(pRegion);
+    }
+
     void InstrumentResourceManager::OnSampleReferenceChanged(void* pOldSample, void* pNewSample, InstrumentEditor* pSender) {
         // uncache old sample in case it's not used by anybody anymore
         if (pOldSample) {
@@ -124,6 +124,8 @@ namespace LinuxSampler { namespace gig {
             void SuspendEnginesUsing(::gig::Instrument* pInstrument);
             void SuspendEnginesUsing(::gig::File* pFile);
             void ResumeAllEngines();
+            void RebuildDimensionLookupTables(::gig::Instrument* pInstrument);
+            void RebuildDimensionLookupTable(::gig::Region* pRegion);
 
             Mutex InstrumentEditorProxiesMutex; ///< protects the 'InstrumentEditorProxies' map
             ArrayList<InstrumentConsumer*> InstrumentEditorProxies; ///< here we store the objects that react on instrument specific notifications on behalf of the respective instrument editor
@@ -57,6 +57,13 @@ namespace LinuxSampler { namespace gig {
              */
             float render() { return moving ? process() : volume; }
 
+            /**
+             * Returns @c true if render() will return the same value on
+             * all subsequent calls (as long as update() is not called
+             * with a different value).
+             */
+            bool settled() const { return !moving || goal == volume; }
+
         private:
             bool moving;
             float goal;
@@ -30,6 +30,8 @@ namespace LinuxSampler { namespace gig {
         sample_t* pSrc;
         float*    pOutLeft;
         float*    pOutRight;
+        float*    pRawLeft;  ///< If not NULL: filtering is deferred to the FilterBank, unfiltered sample points are written here (left / mono).
+        float*    pRawRight; ///< If not NULL: filtering is deferred to the FilterBank, unfiltered sample points are written here (right).
         uint      uiToGo;
     };
 
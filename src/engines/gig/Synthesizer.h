@@ -47,6 +47,9 @@
 #define SYNTHESIS_MODE_GET_BITDEPTH24(iMode)            iMode & 0x10
 #define SYNTHESIS_MODE_GET_IMPLEMENTATION(iMode)        iMode & 0x20
 
+/// Amount of sample points filtered at once by the block filter kernels.
+#define SYNTHESIS_FILTER_BLOCK_SIZE     64
+
 
 namespace LinuxSampler { namespace gig {
 
@@ -152,7 +155,103 @@ namespace LinuxSampler { namespace gig {
                 }
             }
 
+            /**
+             * Reads (and resamples if required) the next @a n sample points
+             * from the source into the given buffers (@a pRight is unused
+             * for mono samples).
+             */
+            inline static void ReadBlock(SynthesisParam* pFinalParam, float* pLeft, float* pRight, uint n) {
+                sample_t* pSrc = pFinalParam->pSrc;
+                if (INTERPOLATE) {
+                    double dPos  = pFinalParam->dPos;
+                    float fPitch = pFinalParam->fFinalPitch;
+                    if (CHANNELS == MONO) {
+                        for (uint i = 0; i < n; ++i)
+                            pLeft[i] = Interpolate1StepMonoCPP(pSrc, &dPos, fPitch);
+                    } else {
+                        for (uint i = 0; i < n; ++i) {
+                            stereo_sample_t samplePoint = Interpolate1StepStereoCPP(pSrc, &dPos, fPitch);
+                            pLeft[i]  = samplePoint.left;
+                            pRight[i] = samplePoint.right;
+                        }
+                    }
+                    pFinalParam->dPos = dPos;
+                } else {
+                    if (CHANNELS == MONO) {
+                        const int pos_offset = (int) pFinalParam->dPos;
+                        for (uint i = 0; i < n; ++i)
+                            pLeft[i] = getSample(pSrc, i + pos_offset);
+                    } else {
+                        const int pos_offset = ((int) pFinalParam->dPos) << 1;
+                        for (uint i = 0, ii = 0; i < n; ++i, ii += 2) {
+                            pLeft[i]  = getSample(pSrc, ii + pos_offset);
+                            pRight[i] = getSample(pSrc, ii + pos_offset + 1);
+                        }
+                    }
+                    pFinalParam->dPos += n;
+                }
+            }
+
+            /**
+             * Filtered synthesis: the sample points are read block wise into
+             * a temporary buffer, which is then filtered with one call per
+             * block and finally amplified and mixed to the output.
+             */
+            static void SynthesizeFilteredSubSubFragment(SynthesisParam* pFinalParam, uint uiToGo) {
+                float fVolumeL = pFinalParam->fFinalVolumeLeft;
+                float fVolumeR = pFinalParam->fFinalVolumeRight;
+#ifdef CONFIG_INTERPOLATE_VOLUME
+                const float fDeltaL = pFinalParam->fFinalVolumeDeltaLeft;
+                const float fDeltaR = pFinalParam->fFinalVolumeDeltaRight;
+#endif
+                if (pFinalParam->pRawLeft) {
+                    // filter and amplification is done later by the FilterBank
+                    ReadBlock(pFinalParam, pFinalParam->pRawLeft, pFinalParam->pRawRight, uiToGo);
+                    pFinalParam->pRawLeft += uiToGo;
+                    if (CHANNELS == STEREO) pFinalParam->pRawRight += uiToGo;
+#ifdef CONFIG_INTERPOLATE_VOLUME
+                    pFinalParam->fFinalVolumeLeft  += fDeltaL * uiToGo;
+                    pFinalParam->fFinalVolumeRight += fDeltaR * uiToGo;
+#endif
+                    pFinalParam->pOutRight += uiToGo;
+                    pFinalParam->pOutLeft  += uiToGo;
+                    pFinalParam->uiToGo    -= uiToGo;
+                    return;
+                }
+                float bufL[SYNTHESIS_FILTER_BLOCK_SIZE];
+                float bufR[(CHANNELS == STEREO) ? SYNTHESIS_FILTER_BLOCK_SIZE : 1];
+                float* pOutL = pFinalParam->pOutLeft;
+                float* pOutR = pFinalParam->pOutRight;
+                for (uint uiDone = 0; uiDone < uiToGo; ) {
+                    const uint n = Min(uiToGo - uiDone, uint(SYNTHESIS_FILTER_BLOCK_SIZE));
+                    ReadBlock(pFinalParam, bufL, bufR, n);
+                    pFinalParam->filterLeft.ApplyBlock(bufL, n);
+                    if (CHANNELS == STEREO) pFinalParam->filterRight.ApplyBlock(bufR, n);
+                    const float* pR = (CHANNELS == STEREO) ? bufR : bufL;
+                    for (uint i = 0; i < n; ++i) {
+#ifdef CONFIG_INTERPOLATE_VOLUME
+                        fVolumeL += fDeltaL;
+                        fVolumeR += fDeltaR;
+#endif
+                        pOutL[i] += bufL[i] * fVolumeL;
+                        pOutR[i] += pR[i]   * fVolumeR;
+                    }
+                    pOutL  += n;
+                    pOutR  += n;
+                    uiDone += n;
+                }
+                pFinalParam->fFinalVolumeLeft = fVolumeL;
+                pFinalParam->fFinalVolumeRight = fVolumeR;
+                pFinalParam->pOutRight += uiToGo;
+                pFinalParam->pOutLeft  += uiToGo;
+                pFinalParam->uiToGo    -= uiToGo;
+            }
+
             static void SynthesizeSubSubFragment(SynthesisParam* pFinalParam, uint uiToGo) {
+                if (USEFILTER) {
+                    SynthesizeFilteredSubSubFragment(pFinalParam, uiToGo);
+                    return;
+                }
                 float fVolumeL = pFinalParam->fFinalVolumeLeft;
                 float fVolumeR = pFinalParam->fFinalVolumeRight;
                 sample_t* pSrc = pFinalParam->pSrc;
@@ -168,54 +267,26 @@ namespace LinuxSampler { namespace gig {
                         if (INTERPOLATE) {
                             double dPos    = pFinalParam->dPos;
                             float fPitch   = pFinalParam->fFinalPitch;
-                            if (USEFILTER) {
-                                Filter& filterL = pFinalParam->filterLeft;
-                                for (int i = 0; i < uiToGo; ++i) {
-                                    samplePoint = Interpolate1StepMonoCPP(pSrc, &dPos, fPitch);
-                                    samplePoint = filterL.Apply(samplePoint);
+                            for (int i = 0; i < uiToGo; ++i) {
+                                samplePoint = Interpolate1StepMonoCPP(pSrc, &dPos, fPitch);
 #ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
+                                fVolumeL += fDeltaL;
+                                fVolumeR += fDeltaR;
 #endif
-                                    pOutL[i] += samplePoint * fVolumeL;
-                                    pOutR[i] += samplePoint * fVolumeR;
-                                }
-                            } else { // no filter needed
-                                for (int i = 0; i < uiToGo; ++i) {
-                                    samplePoint = Interpolate1StepMonoCPP(pSrc, &dPos, fPitch);
-#ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
-#endif
-                                    pOutL[i] += samplePoint * fVolumeL;
-                                    pOutR[i] += samplePoint * fVolumeR;
-                                }
+                                pOutL[i] += samplePoint * fVolumeL;
+                                pOutR[i] += samplePoint * fVolumeR;
                             }
                             pFinalParam->dPos = dPos;
                         } else { // no interpolation
                             int pos_offset = (int) pFinalParam->dPos;
-                            if (USEFILTER) {
-                                Filter& filterL = pFinalParam->filterLeft;
-                                for (int i = 0; i < uiToGo; ++i) {
-                                    samplePoint = getSample(pSrc, i + pos_offset);
-                                    samplePoint = filterL.Apply(samplePoint);
-#ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
-#endif
-                                    pOutL[i] += samplePoint * fVolumeL;
-                                    pOutR[i] += samplePoint * fVolumeR;
-                                }
-                            } else { // no filter needed
-                                for (int i = 0; i < uiToGo; ++i) {
-                                    samplePoint = getSample(pSrc, i + pos_offset);
+                            for (int i = 0; i < uiToGo; ++i) {
+                                samplePoint = getSample(pSrc, i + pos_offset);
 #ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
+                                fVolumeL += fDeltaL;
+                                fVolumeR += fDeltaR;
 #endif
-                                    pOutL[i] += samplePoint * fVolumeL;
-                                    pOutR[i] += samplePoint * fVolumeR;
-                                }
+                                pOutL[i] += samplePoint * fVolumeL;
+                                pOutR[i] += samplePoint * fVolumeR;
                             }
                             pFinalParam->dPos += uiToGo;
                         }
@@ -226,60 +297,27 @@ namespace LinuxSampler { namespace gig {
                         if (INTERPOLATE) {
                             double dPos    = pFinalParam->dPos;
                             float fPitch   = pFinalParam->fFinalPitch;
-                            if (USEFILTER) {
-                                Filter& filterL = pFinalParam->filterLeft;
-                                Filter& filterR = pFinalParam->filterRight;
-                                for (int i = 0; i < uiToGo; ++i) {
-                                    samplePoint = Interpolate1StepStereoCPP(pSrc, &dPos, fPitch);
-                                    samplePoint.left  = filterL.Apply(samplePoint.left);
-                                    samplePoint.right = filterR.Apply(samplePoint.right);
-#ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
-#endif
-                                    pOutL[i] += samplePoint.left  * fVolumeL;
-                                    pOutR[i] += samplePoint.right * fVolumeR;
-                                }
-                            } else { // no filter needed
-                                for (int i = 0; i < uiToGo; ++i) {
-                                    samplePoint = Interpolate1StepStereoCPP(pSrc, &dPos, fPitch);
+                            for (int i = 0; i < uiToGo; ++i) {
+                                samplePoint = Interpolate1StepStereoCPP(pSrc, &dPos, fPitch);
 #ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
+                                fVolumeL += fDeltaL;
+                                fVolumeR += fDeltaR;
 #endif
-                                    pOutL[i] += samplePoint.left  * fVolumeL;
-                                    pOutR[i] += samplePoint.right * fVolumeR;
-                                }
+                                pOutL[i] += samplePoint.left  * fVolumeL;
+                                pOutR[i] += samplePoint.right * fVolumeR;
                             }
                             pFinalParam->dPos = dPos;
                         } else { // no interpolation
                             int pos_offset = ((int) pFinalParam->dPos) << 1;
-                            if (USEFILTER) {
-                                Filter& filterL = pFinalParam->filterLeft;
-                                Filter& filterR = pFinalParam->filterRight;
-                                for (int i = 0, ii = 0; i < uiToGo; ++i, ii+=2) {
-                                    samplePoint.left = getSample(pSrc, ii + pos_offset);
-                                    samplePoint.right = getSample(pSrc, ii + pos_offset + 1);
-                                    samplePoint.left  = filterL.Apply(samplePoint.left);
-                                    samplePoint.right = filterR.Apply(samplePoint.right);
-#ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
-#endif
-                                    pOutL[i] += samplePoint.left  * fVolumeL;
-                                    pOutR[i] += samplePoint.right * fVolumeR;
-                                }
-                            } else { // no filter needed
-                                for (int i = 0, ii = 0; i < uiToGo; ++i, ii+=2) {
-                                    samplePoint.left = getSample(pSrc, ii + pos_offset);
-                                    samplePoint.right = getSample(pSrc, ii + pos_offset + 1);
+                            for (int i = 0, ii = 0; i < uiToGo; ++i, ii+=2) {
+                                samplePoint.left = getSample(pSrc, ii + pos_offset);
+                                samplePoint.right = getSample(pSrc, ii + pos_offset + 1);
 #ifdef CONFIG_INTERPOLATE_VOLUME
-                                    fVolumeL += fDeltaL;
-                                    fVolumeR += fDeltaR;
+                                fVolumeL += fDeltaL;
+                                fVolumeR += fDeltaR;
 #endif
-                                    pOutL[i] += samplePoint.left  * fVolumeL;
-                                    pOutR[i] += samplePoint.right * fVolumeR;
-                                }
+                                pOutL[i] += samplePoint.left  * fVolumeL;
+                                pOutR[i] += samplePoint.right * fVolumeR;
                             }
                             pFinalParam->dPos += uiToGo;
                         }
@@ -783,8 +783,12 @@ namespace LinuxSampler { namespace sfz {
         suVolOnCC(this), suPitchOnCC(this), suCutoffOnCC(this), suResOnCC(this),
         suAmpLFO(this), suPitchLFO(this), suFilLFO(this),
         LFOs(maxLfoCount), volLFOs(maxLfoCount), pitchLFOs(maxLfoCount),
-        filLFOs(maxLfoCount), resLFOs(maxLfoCount), panLFOs(maxLfoCount), eqLFOs(maxLfoCount)
+        filLFOs(maxLfoCount), resLFOs(maxLfoCount), panLFOs(maxLfoCount), eqLFOs(maxLfoCount),
+        ccUnits(MaxUnitCount), smoothUnits(MaxUnitCount), lfoUnits(maxLfoCount + 3),
+        adsrUnits(maxLfoCount + 6)
     {
+        memset(ccMask, 0, sizeof(ccMask));
+        
         suEndpoint.pVoice = suEndpoint.suXFInCC.pVoice = suEndpoint.suXFOutCC.pVoice = suEndpoint.suPanOnCC.pVoice = voice;
         suVolEG.pVoice = suFilEG.pVoice = suPitchEG.pVoice = voice;
         suAmpLFO.pVoice = suPitchLFO.pVoice = suFilLFO.pVoice = voice;
@@ -1053,62 +1057,133 @@ namespace LinuxSampler { namespace sfz {
         suAmpLFO.suFreqOnCC.SetCCs(pRegion->amplfo_freqcc);
         
         Units.clear();
+        ccUnits.clear();
+        smoothUnits.clear();
+        memset(ccMask, 0, sizeof(ccMask));
         
         EqUnitSupport::ImportUnits(this);
         
-        Units.add(&suVolOnCC);
-        Units.add(&suPitchOnCC);
-        Units.add(&suCutoffOnCC);
-        Units.add(&suResOnCC);
+        AddCCUnit(&suVolOnCC);
+        AddCCUnit(&suPitchOnCC);
+        AddCCUnit(&suCutoffOnCC);
+        AddCCUnit(&suResOnCC);
         
         Units.add(&suVolEG);
         Units.add(&suFilEG);
         Units.add(&suPitchEG);
         
-        Units.add(&suPitchLFO.suFreqOnCC); // Don't change order! (should be triggered before the LFO)
+        AddCCUnit(&suPitchLFO.suFreqOnCC); // Don't change order! (should be triggered before the LFO)
         Units.add(&suPitchLFO);
-        Units.add(&suPitchLFO.suDepthOnCC);
+        AddCCUnit(&suPitchLFO.suDepthOnCC);
         Units.add(&suPitchLFO.suFadeEG);
         
-        Units.add(&suAmpLFO.suFreqOnCC); // Don't change order! (should be triggered before the LFO)
-        Units.add(&suAmpLFO.suDepthOnCC);
+        AddCCUnit(&suAmpLFO.suFreqOnCC); // Don't change order! (should be triggered before the LFO)
+        AddCCUnit(&suAmpLFO.suDepthOnCC);
         Units.add(&suAmpLFO);
         Units.add(&suAmpLFO.suFadeEG);
         
-        Units.add(&suFilLFO.suFreqOnCC); // Don't change order! (should be triggered before the LFO)
-        Units.add(&suFilLFO.suDepthOnCC);
+        AddCCUnit(&suFilLFO.suFreqOnCC); // Don't change order! (should be triggered before the LFO)
+        AddCCUnit(&suFilLFO.suDepthOnCC);
         Units.add(&suFilLFO);
         Units.add(&suFilLFO.suFadeEG);
         
         for (int i = 0; i < EGs.size(); i++) {
             Units.add(EGs[i]);
-            Units.add(&(EGs[i]->suAmpOnCC));
-            Units.add(&(EGs[i]->suVolOnCC));
-            Units.add(&(EGs[i]->suPitchOnCC));
-            Units.add(&(EGs[i]->suCutoffOnCC));
-            Units.add(&(EGs[i]->suResOnCC));
-            Units.add(&(EGs[i]->suPanOnCC));
+            AddCCUnit(&(EGs[i]->suAmpOnCC));
+            AddCCUnit(&(EGs[i]->suVolOnCC));
+            AddCCUnit(&(EGs[i]->suPitchOnCC));
+            AddCCUnit(&(EGs[i]->suCutoffOnCC));
+            AddCCUnit(&(EGs[i]->suResOnCC));
+            AddCCUnit(&(EGs[i]->suPanOnCC));
             EGs[i]->ImportUnits(this); // class EqUnitSupport
         }
         
         for (int i = 0; i < LFOs.size(); i++) {
-            Units.add(&(LFOs[i]->suFreqOnCC)); // Don't change order! (should be triggered before the LFO)
+            AddCCUnit(&(LFOs[i]->suFreqOnCC)); // Don't change order! (should be triggered before the LFO)
             Units.add(LFOs[i]);
             Units.add(&(LFOs[i]->suFadeEG));
-            Units.add(&(LFOs[i]->suVolOnCC));
-            Units.add(&(LFOs[i]->suPitchOnCC));
-            Units.add(&(LFOs[i]->suPanOnCC));
-            Units.add(&(LFOs[i]->suCutoffOnCC));
-            Units.add(&(LFOs[i]->suResOnCC));
+            AddCCUnit(&(LFOs[i]->suVolOnCC));
+            AddCCUnit(&(LFOs[i]->suPitchOnCC));
+            AddCCUnit(&(LFOs[i]->suPanOnCC));
+            AddCCUnit(&(LFOs[i]->suCutoffOnCC));
+            AddCCUnit(&(LFOs[i]->suResOnCC));
             LFOs[i]->ImportUnits(this); // class EqUnitSupport
         }
         
         Units.add(&suEndpoint);
-        Units.add(&suEndpoint.suXFInCC);
-        Units.add(&suEndpoint.suXFOutCC);
-        Units.add(&suEndpoint.suPanOnCC);
+        AddCCUnit(&suEndpoint.suXFInCC);
+        AddCCUnit(&suEndpoint.suXFOutCC);
+        AddCCUnit(&suEndpoint.suPanOnCC);
         
         SignalUnitRack::Trigger();
+        
+        CompileUnits();
+    }
+    
+    void SfzSignalUnitRack::AddCCUnit(CCSignalUnit* pUnit) {
+        Units.add(pUnit);
+        
+        if (!pUnit->HasCCs()) return; // nothing to do for it besides triggering
+        ccUnits.add(pUnit);
+        if (pUnit->HasSmoothCCs()) smoothUnits.add(pUnit);
+        pUnit->AddToCCMask(ccMask);
+    }
+    
+    void SfzSignalUnitRack::CompileUnits() {
+        lfoUnits.clear();
+        adsrUnits.clear();
+        
+        // the levels of inactive v1 LFOs and of v1 pitch / filter EGs with
+        // zero depth are never used
+        adsrUnits.add(&suVolEG);
+        if (suFilEG.depth != 0) adsrUnits.add(&suFilEG);
+        if (suPitchEG.depth != 0) adsrUnits.add(&suPitchEG);
+        
+        LFOUnit* v1LFOs[] = { &suPitchLFO, &suAmpLFO, &suFilLFO };
+        for (int i = 0; i < 3; i++) {
+            if (!v1LFOs[i]->Active()) continue;
+            lfoUnits.add(v1LFOs[i]);
+            if (v1LFOs[i]->suFadeEG.Active()) adsrUnits.add(&v1LFOs[i]->suFadeEG);
+        }
+        
+        for (int i = 0; i < LFOs.size(); i++) {
+            lfoUnits.add(LFOs[i]);
+            if (LFOs[i]->suFadeEG.Active()) adsrUnits.add(&LFOs[i]->suFadeEG);
+        }
+    }
+    
+    void SfzSignalUnitRack::Increment() {
+        CurrentStep++;
+        
+        // None of these unit types overrides Increment(), so the calls are
+        // qualified to avoid virtual dispatch. The smoothed CCs have to be
+        // incremented first, since they may change the LFOs' frequency, and
+        // the LFOs before their fade EGs. The remaining units of the rack
+        // don't have to be incremented at all, since they have no parameters
+        // and no smoothed controllers.
+        for (int i = 0; i < smoothUnits.size(); i++) {
+            smoothUnits[i]->CCSignalUnit::Increment();
+        }
+        for (int i = 0; i < lfoUnits.size(); i++) {
+            lfoUnits[i]->LFOUnit::Increment();
+        }
+        for (int i = 0; i < adsrUnits.size(); i++) {
+            adsrUnits[i]->EGUnit<EGADSR>::Increment();
+        }
+        for (int i = 0; i < EGs.size(); i++) {
+            EGs[i]->EGUnit< ::LinuxSampler::sfz::EG>::Increment();
+        }
+    }
+    
+    void SfzSignalUnitRack::ProcessCCEvent(RTList<Event>::Iterator& itEvent) {
+        if ( !(itEvent->Type == Event::type_control_change && itEvent->Param.CC.Controller) ) return;
+        
+        const uint8_t Controller = itEvent->Param.CC.Controller;
+        if (!(ccMask[Controller >> 5] & (1u << (Controller & 31)))) return;
+        
+        for (int i = 0; i < ccUnits.size(); i++) {
+            ccUnits[i]->CCSignalUnit::ProcessCCEvent(Controller, itEvent->Param.CC.Value);
+        }
     }
     
     EndpointSignalUnit* SfzSignalUnitRack::GetEndpointUnit() {
@@ -1272,15 +1347,15 @@ namespace LinuxSampler { namespace sfz {
     }
     
     void EqUnitSupport::ImportUnits(SfzSignalUnitRack* pRack) {
-        if (suEq1GainOnCC.HasCCs()) pRack->Units.add(&suEq1GainOnCC);
-        if (suEq2GainOnCC.HasCCs()) pRack->Units.add(&suEq2GainOnCC);
-        if (suEq3GainOnCC.HasCCs()) pRack->Units.add(&suEq3GainOnCC);
-        if (suEq1FreqOnCC.HasCCs()) pRack->Units.add(&suEq1FreqOnCC);
-        if (suEq2FreqOnCC.HasCCs()) pRack->Units.add(&suEq2FreqOnCC);
-        if (suEq3FreqOnCC.HasCCs()) pRack->Units.add(&suEq3FreqOnCC);
-        if (suEq1BwOnCC.HasCCs()) pRack->Units.add(&suEq1BwOnCC);
-        if (suEq2BwOnCC.HasCCs()) pRack->Units.add(&suEq2BwOnCC);
-        if (suEq3BwOnCC.HasCCs()) pRack->Units.add(&suEq3BwOnCC);
+        if (suEq1GainOnCC.HasCCs()) pRack->AddCCUnit(&suEq1GainOnCC);
+        if (suEq2GainOnCC.HasCCs()) pRack->AddCCUnit(&suEq2GainOnCC);
+        if (suEq3GainOnCC.HasCCs()) pRack->AddCCUnit(&suEq3GainOnCC);
+        if (suEq1FreqOnCC.HasCCs()) pRack->AddCCUnit(&suEq1FreqOnCC);
+        if (suEq2FreqOnCC.HasCCs()) pRack->AddCCUnit(&suEq2FreqOnCC);
+        if (suEq3FreqOnCC.HasCCs()) pRack->AddCCUnit(&suEq3FreqOnCC);
+        if (suEq1BwOnCC.HasCCs()) pRack->AddCCUnit(&suEq1BwOnCC);
+        if (suEq2BwOnCC.HasCCs()) pRack->AddCCUnit(&suEq2BwOnCC);
+        if (suEq3BwOnCC.HasCCs()) pRack->AddCCUnit(&suEq3BwOnCC);
     }
     
     void EqUnitSupport::ResetUnits() {
@@ -463,6 +463,27 @@ namespace LinuxSampler { namespace sfz {
             // used for optimization - contains only the ones that are modulating EQ
             FixedArray<LFOv2Unit*> eqLFOs;
             
+            // Flat processing program of the units used by the current region,
+            // compiled on Trigger() and sorted by unit type, so Increment() and
+            // ProcessCCEvent() can process them in tight loops without virtual
+            // method calls and without visiting unused units.
+            
+            // CC units with at least one controller
+            FixedArray<CCSignalUnit*> ccUnits;
+            
+            // CC units with smoothed controllers (the only ones which have to be incremented)
+            FixedArray<CCSignalUnit*> smoothUnits;
+            
+            // v1 and v2 LFOs which are in use
+            FixedArray<LFOUnit*> lfoUnits;
+            
+            // v1 EGs and LFO fade EGs which are in use (the v2 EGs are in EGs)
+            FixedArray<EGUnit<EGADSR>*> adsrUnits;
+            
+            // bit mask of all controllers of ccUnits
+            uint32_t ccMask[8];
+            
+            void CompileUnits();
 
         public:
             Voice* const pVoice;
@@ -476,6 +497,14 @@ namespace LinuxSampler { namespace sfz {
             virtual EndpointSignalUnit* GetEndpointUnit();
             
             virtual void Trigger();
+            virtual void Increment();
+            virtual void ProcessCCEvent(RTList<Event>::Iterator& itEvent);
+            
+            /**
+             * Adds the given CC unit to the rack's units on Trigger() and to
+             * the flat processing program if it has any controllers.
+             */
+            void AddCCUnit(CCSignalUnit* pUnit);
             virtual void EnterFadeOutStage();
             virtual void EnterFadeOutStage(int maxFadeOutSteps);
             
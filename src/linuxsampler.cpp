@@ -38,6 +38,7 @@
 #include "Sampler.h"
 #include "common/global_private.h"
 #include "engines/EngineFactory.h"
+#include "engines/common/LFOBank.h"
 #include "plugins/InstrumentEditorFactory.h"
 #include "drivers/midi/MidiInputDeviceFactory.h"
 #include "drivers/audio/AudioOutputDeviceFactory.h"
@@ -232,9 +233,10 @@ int main(int argc, char **argv) {
             std::set<Engine*>::iterator itEngine = engines.begin();
             for (int i = 0; itEngine != engines.end(); itEngine++, i++) {
                 Engine* pEngine = *itEngine;
-                printf("Engine %d) Voices: %3.3d (Max: %3.3d) Streams: %3.3d (Max: %3.3d)\n", i,
+                printf("Engine %d) Voices: %3.3d (Max: %3.3d) Streams: %3.3d (Max: %3.3d) Pre-launched Streams: %u hits, %u misses\n", i,
                     pEngine->VoiceCount(), pEngine->VoiceCountMax(),
-                    pEngine->DiskStreamCount(), pEngine->DiskStreamCountMax()
+                    pEngine->DiskStreamCount(), pEngine->DiskStreamCountMax(),
+                    pEngine->DiskStreamPrelaunchHits(), pEngine->DiskStreamPrelaunchMisses()
                 );
                 fflush(stdout);
             }
@@ -345,6 +347,8 @@ void parse_options(int argc, char **argv) {
             {"lscp-port",1,0,0},
             {"stacktrace",0,0,0},
             {"exec-after-init",1,0,0},
+            {"signed-triang-algo",1,0,0},
+            {"unsigned-triang-algo",1,0,0},
             {0,0,0,0}
         };
 
@@ -371,6 +375,10 @@ void parse_options(int argc, char **argv) {
                     printf("--stacktrace                automatically shows stacktrace if crashes\n");
                     printf("                            (broken on most systems at the moment)\n");
                     printf("--exec-after-init           executes a command after initialization\n");
+                    printf("--signed-triang-algo        triangle LFO algorithm for signed LFOs\n");
+                    printf("                            (intmath, intmathabs or diharmonic)\n");
+                    printf("--unsigned-triang-algo      triangle LFO algorithm for unsigned LFOs\n");
+                    printf("                            (intmath, intmathabs or diharmonic)\n");
                     exit(EXIT_SUCCESS);
                     break;
                 case 1: // --version
@@ -466,6 +474,17 @@ void parse_options(int argc, char **argv) {
                 case 10: // --exec-after-init
                     ExecAfterInit = optarg;
                     break;
+                case 11: // --signed-triang-algo
+                case 12: { // --unsigned-triang-algo
+                    const range_type_t range = (option_index == 11) ? range_signed : range_unsigned;
+                    int algo = -1;
+                    if      (!strcmp(optarg, "intmath"))    algo = INT_MATH_SOLUTION;
+                    else if (!strcmp(optarg, "intmathabs")) algo = INT_ABS_MATH_SOLUTION;
+                    else if (!strcmp(optarg, "diharmonic")) algo = DI_HARMONIC_SOLUTION;
+                    if (!LFOBank::SetTriangleAlgorithm(range, algo))
+                        printf("WARNING: Unknown triangle LFO algorithm '%s', ignoring!\n", optarg);
+                    break;
+                }
             }
         }
     }
@@ -0,0 +1,662 @@
+/*
+ * Copyright (c) 2026 agent
+ *
+ * http://www.linuxsampler.org
+ *
+ * This program is part of LinuxSampler and released under the same terms.
+ * See README file for details.
+ */
+
+#include "common/global_private.h"
+#include "common/RTMath.h"
+#include "scriptvm/ScriptVM.h"
+#include "scriptvm/ScriptVMFactory.h"
+#include "scriptvm/CoreVMFunctions.h"
+#include "shell/CFmt.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <new>
+#include <map>
+#include <vector>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  This command line tool runs a real-time instrument script outside of the
+  sampler, for benchmarking the script VM and instrument scripts without any
+  audio hardware or instrument files being involved. You can use it like this:
+
+  ls_instr_script_bench gig myscript.nksp events.txt
+
+  The script's event handlers are executed for each event of the given event
+  stream file (or for a synthetic event stream if no file is given), and the
+  amount of VM instructions, suspensions, the execution time and heap
+  allocations per event handler are reported afterwards. All built-in
+  functions of the sampler engine (i.e. play_note(), set_controller(),
+  ignore_event()) are replaced by stubs which just accept their arguments
+  and return a neutral result. The built-in core functions (i.e. wait(),
+  message()) are executed for real.
+ */
+
+using namespace LinuxSampler;
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////
+// heap allocation counting
+
+// With CONFIG_DEVMODE the script VM already replaces the global operator
+// new to assert that no heap allocation happens while a script is executed.
+#if !(CONFIG_DEVMODE && defined(__GNUC__))
+# define COUNT_ALLOCATIONS 1
+
+static bool countAllocations = false;
+static uint64_t allocations = 0;
+
+#if __cplusplus >= 201103L
+# define _OPERATOR_NEW_THROW_SPEC
+#else
+# define _OPERATOR_NEW_THROW_SPEC throw (std::bad_alloc)
+#endif
+
+void* operator new(size_t size) _OPERATOR_NEW_THROW_SPEC {
+    if (countAllocations) ++allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+#else
+# define COUNT_ALLOCATIONS 0
+#endif
+
+///////////////////////////////////////////////////////////////////////////
+// stubbed built-in functions of sampler engines
+
+/**
+ * Replaces a built-in function of a sampler engine. The original function is
+ * only used for its signature, so the script parser checks the script's
+ * function calls exactly like the sampler would.
+ */
+class BenchStubFunction : public VMFunction {
+public:
+    BenchStubFunction(VMFunction* fn) : m_fn(fn), m_nextID(0) {}
+    virtual ~BenchStubFunction() {}
+    ExprType_t returnType() OVERRIDE { return m_fn->returnType(); }
+    int minRequiredArgs() const OVERRIDE { return m_fn->minRequiredArgs(); }
+    int maxAllowedArgs() const OVERRIDE { return m_fn->maxAllowedArgs(); }
+    ExprType_t argType(int iArg) const OVERRIDE { return m_fn->argType(iArg); }
+    bool acceptsArgType(int iArg, ExprType_t type) const OVERRIDE { return m_fn->acceptsArgType(iArg, type); }
+
+    VMFnResult* exec(VMFnArgs* args) OVERRIDE {
+        // evaluate all arguments, as the real function would do
+        for (int i = 0; i < args->argsCount(); ++i) {
+            VMIntExpr* expr = dynamic_cast<VMIntExpr*>(args->arg(i));
+            if (expr) expr->evalInt();
+        }
+        switch (m_fn->returnType()) {
+            case INT_EXPR:
+                m_intResult.value = ++m_nextID; // i.e. ID of a new event
+                return &m_intResult;
+            case INT_ARR_EXPR:
+                return &m_intArrayResult;
+            case STRING_EXPR:
+                return &m_stringResult;
+            default:
+                return &m_emptyResult;
+        }
+    }
+
+protected:
+    class IntArrayResult : public VMFnResult, public VMIntArrayExpr {
+    public:
+        int arraySize() const OVERRIDE { return 0; }
+        int evalIntElement(uint i) OVERRIDE { return 0; }
+        void assignIntElement(uint i, int value) OVERRIDE {}
+        VMExpr* resultValue() OVERRIDE { return this; }
+    };
+
+    VMFunction* m_fn;
+    int m_nextID;
+    VMEmptyResult m_emptyResult;
+    VMIntResult m_intResult;
+    IntArrayResult m_intArrayResult;
+    VMStringResult m_stringResult;
+};
+
+/// Built-in integer variable of a sampler engine not emulated by this tool.
+class BenchIntVariable : public VMIntRelPtr {
+public:
+    BenchIntVariable() : value(0) {}
+    virtual ~BenchIntVariable() {}
+    int evalInt() OVERRIDE { return value; }
+    void assign(int i) OVERRIDE { value = i; }
+    int value;
+};
+
+/// Built-in variables the script can access of the event currently executed.
+struct BenchEvent {
+    int id;
+    int note;
+    int velocity;
+    int ccNum;
+};
+
+/**
+ * Core script VM extended by the built-in variables and (stubbed) built-in
+ * functions of the sampler engine given by @a engine.
+ */
+class BenchScriptVM : public ScriptVM {
+public:
+    BenchScriptVM(ScriptVM* engineVM, bool quiet) :
+        m_engineVM(engineVM), m_quietMessage(NULL), m_event(NULL)
+    {
+        m_EVENT_ID = DECLARE_VMINT(m_event, struct BenchEvent, id);
+        m_EVENT_NOTE = DECLARE_VMINT(m_event, struct BenchEvent, note);
+        m_EVENT_VELOCITY = DECLARE_VMINT(m_event, struct BenchEvent, velocity);
+        m_CC_NUM = DECLARE_VMINT(m_event, struct BenchEvent, ccNum);
+        if (quiet) m_quietMessage = new BenchStubFunction(ScriptVM::functionByName("message"));
+
+        // provide memory for all built-in array variables of the engine
+        std::map<String,VMInt8Array*> arrays = m_engineVM->builtInIntArrayVariables();
+        for (std::map<String,VMInt8Array*>::iterator it = arrays.begin(); it != arrays.end(); ++it) {
+            std::vector<int8_t>& data = m_arrayData[it->first];
+            data.resize(it->second->size);
+            m_arrays[it->first].data = (data.empty()) ? NULL : &data[0];
+            m_arrays[it->first].size = data.size();
+        }
+    }
+
+    ~BenchScriptVM() {
+        for (std::map<String,BenchStubFunction*>::iterator it = m_stubs.begin(); it != m_stubs.end(); ++it)
+            delete it->second;
+        for (std::map<String,BenchIntVariable*>::iterator it = m_otherInts.begin(); it != m_otherInts.end(); ++it)
+            delete it->second;
+        if (m_quietMessage) delete m_quietMessage;
+    }
+
+    VMFunction* functionByName(const String& name) OVERRIDE {
+        if (name == "message" && m_quietMessage) return m_quietMessage;
+        VMFunction* fn = ScriptVM::functionByName(name);
+        if (fn) return fn;
+        fn = m_engineVM->functionByName(name);
+        if (!fn) return NULL;
+        BenchStubFunction*& stub = m_stubs[name];
+        if (!stub) stub = new BenchStubFunction(fn);
+        return stub;
+    }
+
+    std::map<String,VMIntRelPtr*> builtInIntVariables() OVERRIDE {
+        std::map<String,VMIntRelPtr*> m = ScriptVM::builtInIntVariables();
+        std::map<String,VMIntRelPtr*> engine = m_engineVM->builtInIntVariables();
+        for (std::map<String,VMIntRelPtr*>::iterator it = engine.begin(); it != engine.end(); ++it) {
+            const String& name = it->first;
+            if      (name == "$EVENT_ID") m[name] = &m_EVENT_ID;
+            else if (name == "$EVENT_NOTE") m[name] = &m_EVENT_NOTE;
+            else if (name == "$EVENT_VELOCITY") m[name] = &m_EVENT_VELOCITY;
+            else if (name == "$CC_NUM") m[name] = &m_CC_NUM;
+            else {
+                BenchIntVariable*& var = m_otherInts[name];
+                if (!var) var = new BenchIntVariable;
+                m[name] = var;
+            }
+        }
+        return m;
+    }
+
+    std::map<String,VMInt8Array*> builtInIntArrayVariables() OVERRIDE {
+        std::map<String,VMInt8Array*> m = ScriptVM::builtInIntArrayVariables();
+        for (std::map<String,VMInt8Array>::iterator it = m_arrays.begin(); it != m_arrays.end(); ++it)
+            m[it->first] = &it->second;
+        return m;
+    }
+
+    std::map<String,int> builtInConstIntVariables() OVERRIDE {
+        std::map<String,int> m = ScriptVM::builtInConstIntVariables();
+        std::map<String,int> engine = m_engineVM->builtInConstIntVariables();
+        m.insert(engine.begin(), engine.end());
+        return m;
+    }
+
+    /// Selects the event whose built-in variables are seen by the script.
+    void setEvent(BenchEvent* event) {
+        m_event = event;
+    }
+
+    /// Changes element @a i of built-in array variable @a name (if the engine has it).
+    void setArrayElement(const String& name, int i, int value) {
+        std::map<String,VMInt8Array>::iterator it = m_arrays.find(name);
+        if (it != m_arrays.end() && i >= 0 && i < it->second.size)
+            it->second.data[i] = value;
+    }
+
+protected:
+    ScriptVM* m_engineVM;
+    BenchStubFunction* m_quietMessage;
+    BenchEvent* m_event;
+    VMIntRelPtr m_EVENT_ID;
+    VMIntRelPtr m_EVENT_NOTE;
+    VMIntRelPtr m_EVENT_VELOCITY;
+    VMIntRelPtr m_CC_NUM;
+    std::map<String,BenchStubFunction*> m_stubs;
+    std::map<String,BenchIntVariable*> m_otherInts;
+    std::map<String,std::vector<int8_t> > m_arrayData;
+    std::map<String,VMInt8Array> m_arrays;
+};
+
+///////////////////////////////////////////////////////////////////////////
+// event stream
+
+enum BenchEventType_t {
+    BENCH_NOTE,
+    BENCH_RELEASE,
+    BENCH_CONTROLLER
+};
+
+struct BenchStreamEvent {
+    uint64_t time; ///< in microseconds
+    BenchEventType_t type;
+    int param1; ///< note or controller number
+    int param2; ///< velocity or controller value
+
+    bool operator<(const BenchStreamEvent& other) const {
+        return time < other.time;
+    }
+};
+
+/*
+ * Reads the event stream from file @a name. Each line consists of the time
+ * in microseconds, the event type and its parameters, i.e.:
+ *
+ *     # time  type     parameters
+ *     0       note     60 100
+ *     250000  cc       1 64
+ *     500000  release  60
+ */
+static bool readEventStream(const String& name, std::vector<BenchStreamEvent>& events) {
+    std::ifstream f(name.c_str());
+    if (!f) {
+        cerr << "Could not open event stream file '" << name << "'" << endl;
+        return false;
+    }
+    String line;
+    for (int iLine = 1; std::getline(f, line); ++iLine) {
+        if (line.find('#') != String::npos) line.erase(line.find('#'));
+        std::istringstream ss(line);
+        BenchStreamEvent e = BenchStreamEvent();
+        String type;
+        if (!(ss >> e.time)) continue; // empty line
+        ss >> type >> e.param1;
+        if (type == "note") {
+            e.type = BENCH_NOTE;
+            ss >> e.param2;
+        } else if (type == "release") {
+            e.type = BENCH_RELEASE;
+        } else if (type == "cc") {
+            e.type = BENCH_CONTROLLER;
+            ss >> e.param2;
+        } else {
+            cerr << name << ":" << iLine << ": unknown event type '" << type << "'" << endl;
+            return false;
+        }
+        if (ss.fail()) {
+            cerr << name << ":" << iLine << ": missing event parameters" << endl;
+            return false;
+        }
+        events.push_back(e);
+    }
+    std::stable_sort(events.begin(), events.end());
+    return true;
+}
+
+/*
+ * Generates a reproducible stream of @a notes notes, each with a random key,
+ * velocity and duration, and a modulation wheel change after every 4th note.
+ */
+static void generateEventStream(int notes, std::vector<BenchStreamEvent>& events) {
+    srand(1);
+    uint64_t time = 0;
+    for (int i = 0; i < notes; ++i) {
+        BenchStreamEvent e = BenchStreamEvent();
+        e.time = time;
+        e.type = BENCH_NOTE;
+        e.param1 = 36 + rand() % 60;
+        e.param2 = 1 + rand() % 127;
+        events.push_back(e);
+        e.time = time + 10000 + rand() % 500000;
+        e.type = BENCH_RELEASE;
+        events.push_back(e);
+        if (i % 4 == 3) {
+            e.time = time;
+            e.type = BENCH_CONTROLLER;
+            e.param1 = 1;
+            e.param2 = rand() % 128;
+            events.push_back(e);
+        }
+        time += 1000 + rand() % 50000;
+    }
+    std::stable_sort(events.begin(), events.end());
+}
+
+///////////////////////////////////////////////////////////////////////////
+// execution
+
+/// One execution instance of an event handler (as ScriptEvent in the sampler).
+struct BenchInstance {
+    VMExecContext* execCtx;
+    VMEventHandler* handler;
+    BenchEvent event;
+};
+
+struct BenchHandlerStats {
+    uint64_t allocations;
+    uint64_t errors;
+
+    BenchHandlerStats() : allocations(0), errors(0) {}
+};
+
+class BenchRunner {
+public:
+    BenchRunner(BenchScriptVM* vm, VMParserContext* parserContext, VMScriptProfile* profile) :
+        m_vm(vm), m_parserContext(parserContext), m_profile(profile), m_nextID(0)
+    {
+        m_handlerNote = parserContext->eventHandlerByName("note");
+        m_handlerRelease = parserContext->eventHandlerByName("release");
+        m_handlerController = parserContext->eventHandlerByName("controller");
+    }
+
+    ~BenchRunner() {
+        for (int i = 0; i < m_instances.size(); ++i) {
+            delete m_instances[i]->execCtx;
+            delete m_instances[i];
+        }
+    }
+
+    void runInit() {
+        VMEventHandler* handler = m_parserContext->eventHandlerByName("init");
+        if (!handler) return;
+        run(acquire(handler), 0);
+        // like the sampler, never resume the init handler (its execution
+        // context is not reused then, since it would resume there)
+        m_suspended.clear();
+    }
+
+    void runEvent(const BenchStreamEvent& e) {
+        // first resume all script instances which are due before this event
+        resumeUntil(e.time);
+
+        VMEventHandler* handler = NULL;
+        switch (e.type) {
+            case BENCH_NOTE:
+                m_vm->setArrayElement("%KEY_DOWN", e.param1, 1);
+                handler = m_handlerNote;
+                break;
+            case BENCH_RELEASE:
+                m_vm->setArrayElement("%KEY_DOWN", e.param1, 0);
+                handler = m_handlerRelease;
+                break;
+            case BENCH_CONTROLLER:
+                m_vm->setArrayElement("%CC", e.param1, e.param2);
+                handler = m_handlerController;
+                break;
+        }
+        if (!handler) return;
+
+        BenchInstance* instance = acquire(handler);
+        instance->event.id = ++m_nextID;
+        instance->event.note = (e.type != BENCH_CONTROLLER) ? e.param1 : 0;
+        instance->event.velocity = (e.type == BENCH_NOTE) ? e.param2 : 0;
+        instance->event.ccNum = (e.type == BENCH_CONTROLLER) ? e.param1 : 0;
+        run(instance, e.time);
+    }
+
+    /// Resumes all suspended script instances due up to time @a end.
+    void resumeUntil(uint64_t end) {
+        while (!m_suspended.empty() && m_suspended.begin()->first <= end) {
+            const uint64_t time = m_suspended.begin()->first;
+            BenchInstance* instance = m_suspended.begin()->second;
+            m_suspended.erase(m_suspended.begin());
+            run(instance, time);
+        }
+    }
+
+    /// Resumes all suspended script instances.
+    void finish() {
+        while (!m_suspended.empty())
+            resumeUntil(m_suspended.begin()->first);
+    }
+
+    BenchHandlerStats& stats(VMEventHandler* handler) {
+        return m_stats[handler];
+    }
+
+protected:
+    BenchInstance* acquire(VMEventHandler* handler) {
+        BenchInstance* instance;
+        if (m_free.empty()) {
+            instance = new BenchInstance;
+            instance->execCtx = m_vm->createExecContext(m_parserContext);
+            instance->execCtx->setProfile(m_profile);
+            m_instances.push_back(instance);
+        } else {
+            instance = m_free.back();
+            m_free.pop_back();
+        }
+        instance->handler = handler;
+        instance->event = BenchEvent();
+        return instance;
+    }
+
+    void run(BenchInstance* instance, uint64_t time) {
+        m_vm->setEvent(&instance->event);
+        #if COUNT_ALLOCATIONS
+        allocations = 0;
+        countAllocations = true;
+        #endif
+        VMExecStatus_t result = m_vm->exec(m_parserContext, instance->execCtx, instance->handler);
+        #if COUNT_ALLOCATIONS
+        countAllocations = false;
+        #endif
+
+        BenchHandlerStats& s = m_stats[instance->handler];
+        #if COUNT_ALLOCATIONS
+        s.allocations += allocations;
+        #endif
+        if (result & VM_EXEC_ERROR) s.errors++;
+
+        if (result & VM_EXEC_SUSPENDED) {
+            m_suspended.insert(std::make_pair(
+                time + instance->execCtx->suspensionTimeMicroseconds(), instance
+            ));
+        } else {
+            m_free.push_back(instance);
+        }
+    }
+
+    BenchScriptVM* m_vm;
+    VMParserContext* m_parserContext;
+    VMScriptProfile* m_profile;
+    VMEventHandler* m_handlerNote;
+    VMEventHandler* m_handlerRelease;
+    VMEventHandler* m_handlerController;
+    int m_nextID;
+    std::vector<BenchInstance*> m_instances;
+    std::vector<BenchInstance*> m_free;
+    std::multimap<uint64_t,BenchInstance*> m_suspended; ///< Suspended script instances, sorted by the time they are to be resumed.
+    std::map<VMEventHandler*,BenchHandlerStats> m_stats;
+};
+
+///////////////////////////////////////////////////////////////////////////
+// main
+
+static void printUsage() {
+    cout << "ls_instr_script_bench - Benchmark real-time instrument script." << endl;
+    cout << endl;
+    cout << "Usage: ls_instr_script_bench ENGINE SCRIPT [EVENTS] [OPTIONS]" << endl;
+    cout << endl;
+    cout << "    ENGINE\n";
+    cout << "        Either \"core\", \"gig\", \"sf2\" or \"sfz\"." << endl;
+    cout << endl;
+    cout << "    SCRIPT\n";
+    cout << "        Instrument script file to be executed." << endl;
+    cout << endl;
+    cout << "    EVENTS\n";
+    cout << "        Event stream file, one event per line: the time in" << endl;
+    cout << "        microseconds followed by either \"note KEY VELOCITY\"," << endl;
+    cout << "        \"release KEY\" or \"cc CONTROLLER VALUE\". If omitted, a" << endl;
+    cout << "        synthetic event stream is generated." << endl;
+    cout << endl;
+    cout << "    OPTIONS" << endl;
+    cout << "        --synthetic NOTES | -n NOTES" << endl;
+    cout << "            Amount of notes of the synthetic event stream" << endl;
+    cout << "            (default: 1000)." << endl;
+    cout << endl;
+    cout << "        --repeat COUNT | -r COUNT" << endl;
+    cout << "            Process the event stream COUNT times (default: 1)." << endl;
+    cout << endl;
+    cout << "        --quiet | -q" << endl;
+    cout << "            Suppress the output of the script's message() calls." << endl;
+    cout << endl;
+    cout << "The built-in functions of the sampler engine given by ENGINE are" << endl;
+    cout << "replaced by stubs which do nothing, the built-in core functions are" << endl;
+    cout << "executed for real." << endl;
+    cout << endl;
+}
+
+static void printReport(VMParserContext* parserContext, VMScriptProfile& profile, BenchRunner& runner, uint64_t totalMicroseconds, int events) {
+    uint64_t instructions = 0;
+    printf("\n%-12s %10s %14s %12s %12s %10s %12s %8s\n",
+           "HANDLER", "CALLS", "INSTRUCTIONS", "SUSPENSIONS",
+           "TOTAL_US", "PEAK_US", "ALLOCATIONS", "ERRORS");
+    for (int i = 0; i < profile.handlers.size(); ++i) {
+        const VMProfileCounters& c = profile.handlers[i];
+        const BenchHandlerStats& s = runner.stats(parserContext->eventHandler(i));
+        instructions += c.instructions;
+        printf("%-12s %10llu %14llu %12llu %12llu %10llu ",
+               c.name.c_str(), (unsigned long long) c.calls,
+               (unsigned long long) c.instructions,
+               (unsigned long long) c.suspensions,
+               (unsigned long long) c.totalMicroseconds,
+               (unsigned long long) c.peakMicroseconds);
+        #if COUNT_ALLOCATIONS
+        printf("%12llu ", (unsigned long long) s.allocations);
+        #else
+        printf("%12s ", "n/a");
+        #endif
+        printf("%8llu\n", (unsigned long long) s.errors);
+    }
+    if (!profile.functions.empty()) {
+        printf("\n%-24s %10s %12s %10s\n", "FUNCTION", "CALLS", "TOTAL_US", "PEAK_US");
+        for (int i = 0; i < profile.functions.size(); ++i) {
+            const VMProfileCounters& c = profile.functions[i];
+            printf("%-24s %10llu %12llu %10llu\n",
+                   c.name.c_str(), (unsigned long long) c.calls,
+                   (unsigned long long) c.totalMicroseconds,
+                   (unsigned long long) c.peakMicroseconds);
+        }
+    }
+    printf("\n%d events processed in %llu us", events, (unsigned long long) totalMicroseconds);
+    if (totalMicroseconds)
+        printf(" (%.1f M instructions/s)", double(instructions) / double(totalMicroseconds));
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return -1;
+    }
+    const String engine = argv[1];
+    const String scriptFile = argv[2];
+    String eventsFile;
+    int notes = 1000;
+    int repeat = 1;
+    bool quiet = false;
+
+    // validate & parse arguments provided to this program
+    for (int iArg = 3; iArg < argc; ++iArg) {
+        const string opt = argv[iArg];
+        if (opt.substr(0, 1) != "-") {
+            eventsFile = opt;
+        } else if ((opt == "-n" || opt == "--synthetic") && iArg + 1 < argc) {
+            notes = atoi(argv[++iArg]);
+        } else if ((opt == "-r" || opt == "--repeat") && iArg + 1 < argc) {
+            repeat = atoi(argv[++iArg]);
+        } else if (opt == "-q" || opt == "--quiet") {
+            quiet = true;
+        } else {
+            cerr << "Unknown option '" << opt << "'" << endl;
+            cerr << endl;
+            printUsage();
+            return -1;
+        }
+    }
+
+    ScriptVM* engineVM = ScriptVMFactory::Create(engine);
+    if (!engineVM) {
+        std::cerr << "Unknown ENGINE '" << engine << "'\n\n";
+        printUsage();
+        return -1;
+    }
+
+    std::vector<BenchStreamEvent> events;
+    if (!eventsFile.empty()) {
+        if (!readEventStream(eventsFile, events)) return -1;
+    } else {
+        generateEventStream(notes, events);
+    }
+
+    std::ifstream f(scriptFile.c_str());
+    if (!f) {
+        cerr << "Could not open script file '" << scriptFile << "'" << endl;
+        return -1;
+    }
+    std::stringstream code;
+    code << f.rdbuf();
+
+    BenchScriptVM* vm = new BenchScriptVM(engineVM, quiet);
+    VMParserContext* parserContext = vm->loadScript(code.str());
+    std::vector<ParserIssue> issues = parserContext->issues();
+    for (int i = 0; i < issues.size(); ++i) {
+        CFmt fmt;
+        if (issues[i].isWrn()) fmt.yellow();
+        else if (issues[i].isErr()) fmt.red();
+        issues[i].dump();
+    }
+    if (!parserContext->errors().empty()) {
+        delete parserContext;
+        delete vm;
+        delete engineVM;
+        return -1;
+    }
+
+    VMScriptProfile profile;
+    vm->prepareProfile(parserContext, &profile);
+
+    const uint64_t tStart = RTMath::MicroSecondsNow();
+    {
+        BenchRunner runner(vm, parserContext, &profile);
+        runner.runInit();
+        const uint64_t streamDuration = (events.empty()) ? 0 : events.back().time + 1;
+        for (int r = 0; r < repeat; ++r) {
+            for (int i = 0; i < events.size(); ++i) {
+                BenchStreamEvent e = events[i];
+                e.time += r * streamDuration;
+                runner.runEvent(e);
+            }
+        }
+        runner.finish();
+        printReport(
+            parserContext, profile, runner, RTMath::MicroSecondsNow() - tStart,
+            int(events.size()) * repeat
+        );
+    }
+
+    delete parserContext;
+    delete vm;
+    delete engineVM;
+
+    return 0;
+}
@@ -397,6 +397,7 @@ get_instruction       :  AVAILABLE_ENGINES
                       |  CHANNEL SP BUFFER_FILL SP buffer_size_type SP sampler_channel              { $$ = LSCPSERVER->GetBufferFill($5, $7);                          }
                       |  CHANNEL SP STREAM_COUNT SP sampler_channel                                 { $$ = LSCPSERVER->GetStreamCount($5);                             }
                       |  CHANNEL SP VOICE_COUNT SP sampler_channel                                  { $$ = LSCPSERVER->GetVoiceCount($5);                              }
+                      |  CHANNEL SP SCRIPT_PROFILE SP sampler_channel                               { $$ = LSCPSERVER->GetChannelScriptProfile($5);                    }
                       |  ENGINE SP INFO SP engine_name                                              { $$ = LSCPSERVER->GetEngineInfo($5);                              }
                       |  SERVER SP INFO                                                             { $$ = LSCPSERVER->GetServerInfo();                                }
                       |  TOTAL_STREAM_COUNT                                                         { $$ = LSCPSERVER->GetTotalStreamCount();                           }
@@ -509,6 +510,7 @@ set_chan_instruction  :  AUDIO_OUTPUT_DEVICE SP sampler_channel SP device_index
                       |  VOLUME SP sampler_channel SP volume_value                                                           { $$ = LSCPSERVER->SetVolume($5, $3);                 }
                       |  MUTE SP sampler_channel SP boolean                                                                  { $$ = LSCPSERVER->SetChannelMute($5, $3);            }
                       |  SOLO SP sampler_channel SP boolean                                                                  { $$ = LSCPSERVER->SetChannelSolo($5, $3);            }
+                      |  SCRIPT_PROFILING SP sampler_channel SP boolean                                                      { $$ = LSCPSERVER->SetChannelScriptProfiling($5, $3); }
                       |  MIDI_INSTRUMENT_MAP SP sampler_channel SP midi_map                                                  { $$ = LSCPSERVER->SetChannelMap($3, $5);             }
                       |  MIDI_INSTRUMENT_MAP SP sampler_channel SP NONE                                                      { $$ = LSCPSERVER->SetChannelMap($3, -1);             }
                       |  MIDI_INSTRUMENT_MAP SP sampler_channel SP DEFAULT                                                   { $$ = LSCPSERVER->SetChannelMap($3, -2);             }
@@ -1042,6 +1044,12 @@ STREAM_COUNT         :  'S''T''R''E''A''M''_''C''O''U''N''T'
 VOICE_COUNT          :  'V''O''I''C''E''_''C''O''U''N''T'
                      ;
 
+SCRIPT_PROFILE       :  'S''C''R''I''P''T''_''P''R''O''F''I''L''E'
+                     ;
+
+SCRIPT_PROFILING     :  'S''C''R''I''P''T''_''P''R''O''F''I''L''I''N''G'
+                     ;
+
 TOTAL_STREAM_COUNT   :  'T''O''T''A''L''_''S''T''R''E''A''M''_''C''O''U''N''T'
                      ;
 
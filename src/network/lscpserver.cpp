@@ -44,11 +44,21 @@
 #include "../drivers/audio/AudioOutputDeviceFactory.h"
 #include "../drivers/midi/MidiInputDeviceFactory.h"
 #include "../effects/EffectFactory.h"
+#include "../scriptvm/common.h"
 
 namespace LinuxSampler {
 
 String lscpParserProcessShellInteraction(String& line, yyparse_param_t* param, bool possibilities);
 
+/**
+ * Returns a copy of the given string with all lower case letters converted
+ * to upper case (used for response field names).
+ */
+static String _toUpper(String txt) {
+    std::transform(txt.begin(), txt.end(), txt.begin(), ::toupper);
+    return txt;
+}
+
 /**
  * Returns a copy of the given string where all special characters are
  * replaced by LSCP escape sequences ("\xHH"). This function shall be used
@@ -1298,6 +1308,47 @@ String LSCPServer::GetVoiceCount(uint uiSamplerChannel) {
     return result.Produce();
 }
 
+/**
+ * Will be called by the parser to get the execution statistics of the
+ * instrument script on a particular sampler channel.
+ */
+String LSCPServer::GetChannelScriptProfile(uint uiSamplerChannel) {
+    dmsg(2,("LSCPServer: GetChannelScriptProfile(SamplerChannel=%d)\n", uiSamplerChannel));
+    LSCPResultSet result;
+    try {
+        EngineChannel* pEngineChannel = GetEngineChannel(uiSamplerChannel);
+        VMScriptProfile profile;
+        const bool bHasScript = pEngineChannel->GetScriptProfile(profile);
+        result.Add("PROFILING", pEngineChannel->GetScriptProfiling());
+        result.Add("SCRIPT", bHasScript);
+        result.Add("BUDGET_OVERRUNS", (int) pEngineChannel->GetScriptBudgetOverruns());
+        for (int i = 0; i < profile.handlers.size(); ++i) {
+            const VMProfileCounters& c = profile.handlers[i];
+            result.Add(
+                "HANDLER_" + _toUpper(c.name),
+                "CALLS=" + ToString(c.calls) +
+                ",INSTRUCTIONS=" + ToString(c.instructions) +
+                ",SUSPENSIONS=" + ToString(c.suspensions) +
+                ",TOTAL_US=" + ToString(c.totalMicroseconds) +
+                ",PEAK_US=" + ToString(c.peakMicroseconds)
+            );
+        }
+        for (int i = 0; i < profile.functions.size(); ++i) {
+            const VMProfileCounters& c = profile.functions[i];
+            result.Add(
+                "FUNCTION_" + _toUpper(c.name),
+                "CALLS=" + ToString(c.calls) +
+                ",TOTAL_US=" + ToString(c.totalMicroseconds) +
+                ",PEAK_US=" + ToString(c.peakMicroseconds)
+            );
+        }
+    }
+    catch (Exception e) {
+         result.Error(e);
+    }
+    return result.Produce();
+}
+
 /**
  * Will be called by the parser to get the amount of active disk streams on a
  * particular sampler channel.
@@ -2162,6 +2213,22 @@ String LSCPServer::SetChannelSolo(bool bSolo, uint uiSamplerChannel) {
     return result.Produce();
 }
 
+/**
+ * Will be called by the parser to start or stop collecting execution
+ * statistics of the instrument script on a particular sampler channel.
+ */
+String LSCPServer::SetChannelScriptProfiling(bool bEnable, uint uiSamplerChannel) {
+    dmsg(2,("LSCPServer: SetChannelScriptProfiling(bEnable=%d,uiSamplerChannel=%d)\n",bEnable,uiSamplerChannel));
+    LSCPResultSet result;
+    try {
+        EngineChannel* pEngineChannel = GetEngineChannel(uiSamplerChannel);
+        pEngineChannel->SetScriptProfiling(bEnable);
+    } catch (Exception e) {
+        result.Error(e);
+    }
+    return result.Produce();
+}
+
 /**
  * Determines whether there is at least one solo channel in the channel list.
  *
@@ -2772,6 +2839,7 @@ String LSCPServer::GetEffectInstanceInfo(int iEffectInstance) {
         result.Add("NAME", _escapeLscpResponse(pEffectInfo->Name()));
         result.Add("DESCRIPTION", _escapeLscpResponse(pEffectInfo->Description()));
         result.Add("INPUT_CONTROLS", ToString(pEffect->InputControlCount()));
+        result.Add("CPU_LOAD", pEffect->CpuLoad());
     }
     catch (Exception e) {
         result.Error(e);
@@ -95,6 +95,7 @@ class LSCPServer : public Thread {
         String GetEngineInfo(String EngineName);
         String GetChannelInfo(uint uiSamplerChannel);
         String GetVoiceCount(uint uiSamplerChannel);
+        String GetChannelScriptProfile(uint uiSamplerChannel);
         String GetStreamCount(uint uiSamplerChannel);
         String GetBufferFill(fill_response_t ResponseType, uint uiSamplerChannel);
         String GetAvailableAudioOutputDrivers();
@@ -145,6 +146,7 @@ class LSCPServer : public Thread {
         String SetVolume(double dVolume, uint uiSamplerChannel);
         String SetChannelMute(bool bMute, uint uiSamplerChannel);
         String SetChannelSolo(bool bSolo, uint uiSamplerChannel);
+        String SetChannelScriptProfiling(bool bEnable, uint uiSamplerChannel);
         String AddOrReplaceMIDIInstrumentMapping(uint MidiMapID, uint MidiBank, uint MidiProg, String EngineType, String InstrumentFile, uint InstrumentIndex, float Volume, MidiInstrumentMapper::mode_t LoadMode, String Name, bool bModal);
         String RemoveMIDIInstrumentMapping(uint MidiMapID, uint MidiBank, uint MidiProg);
         String GetMidiInstrumentMappings(uint MidiMapID);
@@ -72,7 +72,7 @@ VMFnResult* CoreVMFunction_message::exec(VMFnArgs* args) {
 
     VMStringExpr* strExpr = dynamic_cast<VMStringExpr*>(args->arg(0));
     if (strExpr) {
-        std::cout << "[ScriptVM] " << strExpr->evalStr() << "\n";
+        std::cout << "[ScriptVM] " << strExpr->evalCStr() << "\n";
         return successResult();
     }
 
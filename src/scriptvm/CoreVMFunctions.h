@@ -59,6 +59,7 @@ public:
     String value; ///< result value of the function call
 
     VMStringResult() : flags(STMT_SUCCESS) {}
+    const char* evalCStr() { return value.c_str(); }
     String evalStr() { return value; }
     VMExpr* resultValue() { return this; }
     StmtFlags_t resultFlags() { return flags; }
@@ -10,8 +10,12 @@
 #include "ScriptVM.h"
 
 #include <string.h>
+#include <stdlib.h>
 #include <assert.h>
+#include <algorithm>
+#include <new>
 #include "../common/global_private.h"
+#include "../common/RTMath.h"
 #include "tree.h"
 #include "CoreVMFunctions.h"
 #include "editor/NkspScanner.h"
@@ -20,78 +24,35 @@
 
 int InstrScript_parse(LinuxSampler::ParserContext*);
 
-namespace LinuxSampler {
+#if CONFIG_DEVMODE && defined(__GNUC__)
 
-    static void _printIndents(int n) {
-        for (int i = 0; i < n; ++i) printf("  ");
-        fflush(stdout);
-    }
+// In development mode any heap allocation by the thread which is currently
+// executing a script (that is the real-time audio thread) triggers an
+// assertion.
 
-    static int _requiredMaxStackSizeFor(Statement* statement, int depth = 0) {
-        if (!statement) return 1;
-
-        switch (statement->statementType()) {
-            case STMT_LEAF:
-                #if DEBUG_SCRIPTVM_CORE
-                _printIndents(depth);
-                printf("-> STMT_LEAF\n");
-                #endif
-                return 1;
-
-            case STMT_LIST: {
-                #if DEBUG_SCRIPTVM_CORE
-                _printIndents(depth);
-                printf("-> STMT_LIST\n");
-                #endif
-                Statements* stmts = (Statements*) statement;
-                int max = 0;
-                for (int i = 0; stmts->statement(i); ++i) {
-                    int size = _requiredMaxStackSizeFor( stmts->statement(i), depth+1 );
-                    if (max < size) max = size;
-                }
-                return max + 1;
-            }
-
-            case STMT_BRANCH: {
-                #if DEBUG_SCRIPTVM_CORE
-                _printIndents(depth);
-                printf("-> STMT_BRANCH\n");
-                #endif
-                BranchStatement* branchStmt = (BranchStatement*) statement;
-                int max = 0;
-                for (int i = 0; branchStmt->branch(i); ++i) {
-                    int size = _requiredMaxStackSizeFor( branchStmt->branch(i), depth+1 );
-                    if (max < size) max = size;
-                }
-                return max + 1;
-            }
-
-            case STMT_LOOP: {
-                #if DEBUG_SCRIPTVM_CORE
-                _printIndents(depth);
-                printf("-> STMT_LOOP\n");
-                #endif
-                While* whileStmt = (While*) statement;
-                if (whileStmt->statements())
-                    return _requiredMaxStackSizeFor( whileStmt->statements() ) + 1;
-                else
-                    return 1;
-            }
-        }
+static __thread bool _scriptExecActive = false;
 
-        return 1; // actually just to avoid compiler warning
-    }
+#if __cplusplus >= 201103L
+# define _OPERATOR_NEW_THROW_SPEC
+#else
+# define _OPERATOR_NEW_THROW_SPEC throw (std::bad_alloc)
+#endif
 
-    static int _requiredMaxStackSizeFor(EventHandlers* handlers) {
-        int max = 1;
-        for (int i = 0; i < handlers->size(); ++i) {
-            int size = _requiredMaxStackSizeFor(handlers->eventHandler(i));
-            if (max < size) max = size;
-        }
-        return max;
-    }
+void* operator new(size_t size) _OPERATOR_NEW_THROW_SPEC {
+    assert(!_scriptExecActive && "Heap allocation while executing instrument script!");
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
 
-    ScriptVM::ScriptVM() : m_eventHandler(NULL), m_parserContext(NULL) {
+#endif // CONFIG_DEVMODE
+
+namespace LinuxSampler {
+
+    ScriptVM::ScriptVM() : m_eventHandler(NULL), m_parserContext(NULL),
+        m_maxInstructions(CONFIG_SCRIPT_EXEC_MAX_INSTRUCTIONS),
+        m_maxMicroseconds(CONFIG_SCRIPT_EXEC_MAX_MICROSECONDS)
+    {
         m_fnMessage = new CoreVMFunction_message;
         m_fnExit = new CoreVMFunction_exit;
         m_fnWait = new CoreVMFunction_wait(this);
@@ -126,18 +87,27 @@ namespace LinuxSampler {
 
         InstrScript_parse(context);
         dmsg(2,("Allocating %ld bytes of global int VM memory.\n", long(context->globalIntVarCount * sizeof(int))));
-        dmsg(2,("Allocating %d of global VM string variables.\n", context->globalStrVarCount));
+        dmsg(2,("Allocating %d of global VM string variables (%d bytes each).\n", context->globalStrVarCount, CONFIG_MAX_SCRIPT_STRING_LENGTH));
         if (!context->globalIntMemory)
             context->globalIntMemory = new ArrayList<int>();
         if (!context->globalStrMemory)
-            context->globalStrMemory = new ArrayList<String>();
+            context->globalStrMemory = new ArrayList<char>();
         context->globalIntMemory->resize(context->globalIntVarCount);
         memset(&((*context->globalIntMemory)[0]), 0, context->globalIntVarCount * sizeof(int));
-        
-        context->globalStrMemory->resize(context->globalStrVarCount);
+
+        // each string variable has a fixed size slot, so assigning strings
+        // never allocates memory while the script is executed
+        const int strMemSize = context->globalStrVarCount * CONFIG_MAX_SCRIPT_STRING_LENGTH;
+        context->globalStrMemory->resize(strMemSize);
+        if (strMemSize) memset(&((*context->globalStrMemory)[0]), 0, strMemSize);
 
         context->destroyScanner();
 
+        // compile only after the global memory has been allocated, since the
+        // bytecode refers to global variables by their addresses
+        if (context->vErrors.empty() && context->handlers)
+            compileBytecode(context);
+
         return context;
     }
 
@@ -156,28 +126,41 @@ namespace LinuxSampler {
             return;
         }
         ctx->handlers->dump();
+        if (!ctx->bytecode.empty()) {
+            std::cout << "Bytecode:\n";
+            dumpBytecode(ctx->bytecode);
+        }
     }
 
     VMExecContext* ScriptVM::createExecContext(VMParserContext* parserContext) {
         ParserContext* parserCtx = dynamic_cast<ParserContext*>(parserContext);
-        ExecContext* execCtx = new ExecContext();
-        
-        if (parserCtx->requiredMaxStackSize < 0) {
-             parserCtx->requiredMaxStackSize =
-                _requiredMaxStackSizeFor(&*parserCtx->handlers);
-        }
-        execCtx->stack.resize(parserCtx->requiredMaxStackSize);
-        dmsg(2,("Created VM exec context with %ld bytes VM stack size.\n",
-                long(parserCtx->requiredMaxStackSize * sizeof(ExecContext::StackFrame))));
-        //printf("execCtx=0x%lx\n", (uint64_t)execCtx);
-        const int polySize = parserCtx->polyphonicIntVarCount;
-        execCtx->polyphonicIntMemory.resize(polySize);
-        memset(&execCtx->polyphonicIntMemory[0], 0, polySize * sizeof(int));
-
-        dmsg(2,("Allocated %ld bytes polyphonic memory.\n", long(polySize * sizeof(int))));
+        ExecContext* execCtx = new ExecContext(parserCtx);
+        dmsg(2,("Created VM exec context with %ld bytes VM stack size and %ld bytes polyphonic memory.\n",
+                long(ExecContext::stackSize(parserCtx) * sizeof(int)),
+                long(parserCtx->polyphonicIntVarCount * sizeof(int))));
         return execCtx;
     }
 
+    VMExecContextSlab* ScriptVM::createExecContextSlab(VMParserContext* parserContext, int count) {
+        ParserContext* parserCtx = dynamic_cast<ParserContext*>(parserContext);
+        ExecContextSlab* slab = new ExecContextSlab(parserCtx, count);
+        dmsg(2,("Created %d VM exec contexts with %ld bytes memory each.\n",
+                count, long(ExecContext::memorySize(parserCtx))));
+        return slab;
+    }
+
+    void ScriptVM::prepareProfile(VMParserContext* parserContext, VMScriptProfile* profile) {
+        ParserContext* parserCtx = dynamic_cast<ParserContext*>(parserContext);
+        const int handlerCount = parserCtx->handlers ? parserCtx->handlers->size() : 0;
+        profile->handlers.resize(handlerCount);
+        for (int i = 0; i < handlerCount; ++i)
+            profile->handlers[i].name = parserCtx->handlers->eventHandler(i)->eventHandlerName();
+        profile->functions.resize(parserCtx->calledFunctions.size());
+        for (int i = 0; i < parserCtx->calledFunctions.size(); ++i)
+            profile->functions[i].name = parserCtx->calledFunctions[i];
+        profile->reset();
+    }
+
     std::vector<VMSourceToken> ScriptVM::syntaxHighlighting(const String& s) {
         std::istringstream iss(s);
         return syntaxHighlighting(&iss);
@@ -231,6 +214,11 @@ namespace LinuxSampler {
         return m_parserContext->execContext;
     }
 
+    void ScriptVM::setExecBudget(int maxInstructions, int maxMicroseconds) {
+        m_maxInstructions = (maxInstructions > 0) ? maxInstructions : 0;
+        m_maxMicroseconds = (maxMicroseconds > 0) ? maxMicroseconds : 0;
+    }
+
     VMExecStatus_t ScriptVM::exec(VMParserContext* parserContext, VMExecContext* execContex, VMEventHandler* handler) {
         m_parserContext = dynamic_cast<ParserContext*>(parserContext);
         if (!m_parserContext) {
@@ -253,90 +241,56 @@ namespace LinuxSampler {
         m_parserContext->execContext = ctx;
 
         ctx->status = VM_EXEC_RUNNING;
-        StmtFlags_t flags = STMT_SUCCESS;
+        StmtFlags_t flags;
+
+        VMScriptProfile* profile = ctx->profile;
+        if (profile && h->profileIndex >= profile->handlers.size())
+            profile = NULL;
+        const uint64_t tStart = (profile || m_maxMicroseconds) ? RTMath::MicroSecondsNow() : 0;
+        if (profile && ctx->pc < 0)
+            profile->handlers[h->profileIndex].calls++;
+
+        if (ctx->pc < 0) // start condition ...
+            ctx->pc = h->codeEntry;
+
+        // the init handler is executed only once, so it cannot be preempted
+        ctx->preempted = false;
+        if (h->eventHandlerType() == VM_EVENT_HANDLER_INIT) {
+            ctx->maxInstructions = 0;
+            ctx->deadline = 0;
+        } else {
+            ctx->maxInstructions = m_maxInstructions;
+            ctx->deadline = (m_maxMicroseconds) ? tStart + m_maxMicroseconds : 0;
+        }
+        ctx->budgetCheckAt = (ctx->maxInstructions || ctx->deadline) ? 0 : INT_MAX;
 
-        int& frameIdx = ctx->stackFrame;
-        if (frameIdx < 0) { // start condition ...
-            frameIdx = -1;
-            ctx->pushStack(h);
+        if (ctx->pc < 0) { // should never happen, otherwise it's a bug ...
+            std::cerr << "CRITICAL: VM event handler was not compiled!\n";
+            flags = StmtFlags_t(STMT_ABORT_SIGNALLED | STMT_ERROR_OCCURRED);
+        } else {
+            #if DEBUG_SCRIPTVM_CORE
+            printf("-> exec pc=%d\n", ctx->pc);
+            #endif
+            #if CONFIG_DEVMODE && defined(__GNUC__)
+            _scriptExecActive = true;
+            #endif
+            flags = execBytecode(&m_parserContext->bytecode[0], ctx);
+            #if CONFIG_DEVMODE && defined(__GNUC__)
+            _scriptExecActive = false;
+            #endif
         }
 
-        while (flags == STMT_SUCCESS && frameIdx >= 0) {
-            if (frameIdx >= ctx->stack.size()) { // should never happen, otherwise it's a bug ...
-                std::cerr << "CRITICAL: VM stack overflow! (" << frameIdx << ")\n";
-                flags = StmtFlags_t(STMT_ABORT_SIGNALLED | STMT_ERROR_OCCURRED);
-                break;
-            }
-
-            ExecContext::StackFrame& frame = ctx->stack[frameIdx];
-            switch (frame.statement->statementType()) {
-                case STMT_LEAF: {
-                    #if DEBUG_SCRIPTVM_CORE
-                    _printIndents(frameIdx);
-                    printf("-> STMT_LEAF\n");
-                    #endif
-                    LeafStatement* leaf = (LeafStatement*) frame.statement;
-                    flags = leaf->exec();
-                    ctx->popStack();
-                    break;
-                }
-
-                case STMT_LIST: {
-                    #if DEBUG_SCRIPTVM_CORE
-                    _printIndents(frameIdx);
-                    printf("-> STMT_LIST subidx=%d\n", frame.subindex);
-                    #endif
-                    Statements* stmts = (Statements*) frame.statement;
-                    if (stmts->statement(frame.subindex)) {
-                        ctx->pushStack(
-                            stmts->statement(frame.subindex++)
-                        );
-                    } else {
-                        #if DEBUG_SCRIPTVM_CORE
-                        _printIndents(frameIdx);
-                        printf("[END OF LIST] subidx=%d\n", frame.subindex);
-                        #endif
-                        ctx->popStack();
-                    }
-                    break;
-                }
-
-                case STMT_BRANCH: {
-                    #if DEBUG_SCRIPTVM_CORE
-                    _printIndents(frameIdx);
-                    printf("-> STMT_BRANCH\n");
-                    #endif
-                    if (frame.subindex < 0) ctx->popStack();
-                    else {
-                        BranchStatement* branchStmt = (BranchStatement*) frame.statement;
-                        frame.subindex = branchStmt->evalBranch();
-                        if (frame.subindex >= 0) {
-                            ctx->pushStack(
-                                branchStmt->branch(frame.subindex)
-                            );
-                            frame.subindex = -1;
-                        } else ctx->popStack();
-                    }
-                    break;
-                }
-
-                case STMT_LOOP: {
-                    #if DEBUG_SCRIPTVM_CORE
-                    _printIndents(frameIdx);
-                    printf("-> STMT_LOOP\n");
-                    #endif
-                    While* whileStmt = (While*) frame.statement;
-                    if (whileStmt->evalLoopStartCondition() && whileStmt->statements()) {
-                        ctx->pushStack(
-                            whileStmt->statements()
-                        );
-                    } else ctx->popStack();
-                }
-            }
+        if (profile) {
+            VMProfileCounters& counters = profile->handlers[h->profileIndex];
+            counters.instructions += ctx->instructionsExecuted;
+            if (flags & STMT_SUSPEND_SIGNALLED) counters.suspensions++;
+            counters.addTime(RTMath::MicroSecondsNow() - tStart);
         }
 
         if (flags & STMT_SUSPEND_SIGNALLED) {
-            ctx->status = VM_EXEC_SUSPENDED;
+            ctx->status = (ctx->preempted) ?
+                VMExecStatus_t(VM_EXEC_SUSPENDED | VM_EXEC_PREEMPTED) :
+                VM_EXEC_SUSPENDED;
         } else {
             ctx->status = VM_EXEC_NOT_RUNNING;
             if (flags & STMT_ERROR_OCCURRED)
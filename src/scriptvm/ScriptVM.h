@@ -139,6 +139,32 @@ namespace LinuxSampler {
          */
         VMExecContext* createExecContext(VMParserContext* parserContext);
 
+        /**
+         * Creates @a count VM execution contexts for the already parsed
+         * script given by @a parserContext in one contiguous block of memory.
+         * Use this instead of createExecContext() if many execution contexts
+         * of the same script are required, i.e. for running many instances
+         * of the script's event handlers at the same time.
+         *
+         * @param parserContext - parsed representation of the script
+         * @param count - amount of execution contexts to create
+         * @see createExecContext()
+         */
+        VMExecContextSlab* createExecContextSlab(VMParserContext* parserContext, int count);
+
+        /**
+         * Prepares the given @a profile object for collecting the execution
+         * statistics of the script given by @a parserContext. This resizes
+         * the profile's lists of event handlers and built-in functions
+         * according to the script and resets all its counters. This method
+         * is not real-time safe.
+         *
+         * @param parserContext - parsed representation of the script
+         * @param profile - profile object to be prepared
+         * @see VMExecContext::setProfile()
+         */
+        void prepareProfile(VMParserContext* parserContext, VMScriptProfile* profile);
+
         /**
          * Execute a script by virtual machine. Since scripts are event-driven,
          * you actually execute only one specific event handler block (i.e. a
@@ -165,6 +191,24 @@ namespace LinuxSampler {
          */
         VMExecStatus_t exec(VMParserContext* parserContext, VMExecContext* execContext, VMEventHandler* handler);
 
+        /**
+         * Sets the execution budget of each single exec() call. Once an
+         * event handler exceeds either limit, the VM suspends it at the next
+         * back edge of a loop and exec() returns with VM_EXEC_SUSPENDED and
+         * VM_EXEC_PREEMPTED set. The clock is only read every 1024
+         * instructions, so the time limit may be exceeded slightly. The "init"
+         * event handler is never preempted, since it cannot be resumed.
+         *
+         * @param maxInstructions - max. amount of VM instructions per exec()
+         *                          call (0: unlimited)
+         * @param maxMicroseconds - max. execution time per exec() call in
+         *                          microseconds (0: unlimited); note that
+         *                          the point of preemption then depends on
+         *                          the machine's load, so script results
+         *                          are no longer deterministic
+         */
+        void setExecBudget(int maxInstructions, int maxMicroseconds);
+
         /**
          * Returns built-in script function for the given function @a name. To
          * get the implementation of the built-in message() script function for
@@ -223,6 +267,8 @@ namespace LinuxSampler {
     protected:
         VMEventHandler* m_eventHandler;
         ParserContext* m_parserContext;
+        int m_maxInstructions;
+        int m_maxMicroseconds;
         CoreVMFunction_message* m_fnMessage;
         CoreVMFunction_exit* m_fnExit;
         CoreVMFunction_wait* m_fnWait;
@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2026 agent
+ *
+ * http://www.linuxsampler.org
+ *
+ * This file is part of LinuxSampler and released under the same terms.
+ * See README file for details.
+ */
+
+// Compiles the event handlers of a parsed script to a flat bytecode and
+// executes that bytecode, instead of walking the parser tree at runtime.
+
+#include <cstdio>
+#include "tree.h"
+#include "../common/RTMath.h"
+#include "../common/global_private.h"
+
+// dispatch each instruction by jumping directly to the address of its
+// implementation stored in the instruction (direct threading), if the
+// compiler supports "labels as values"
+#if defined(__GNUC__)
+# define USE_COMPUTED_GOTO 1
+#else
+# define USE_COMPUTED_GOTO 0
+#endif
+
+namespace LinuxSampler {
+
+///////////////////////////////////////////////////////////////////////////
+// class 'VMCompiler'
+
+// change of the value stack's size by each opcode
+static const int _stackEffect[OP_COUNT] = {
+    +1, // OP_PUSH
+    +1, // OP_LOAD
+    +1, // OP_LOAD_POLY
+     0, // OP_LOAD_ELEM
+    -1, // OP_STORE
+    -1, // OP_STORE_POLY
+    -2, // OP_STORE_ELEM
+    +1, // OP_EVAL_INT
+     0, // OP_EXEC
+    +1, // OP_DUP
+    -1, // OP_POP
+    -1, // OP_ADD
+    -1, // OP_SUB
+    -1, // OP_MUL
+    -1, // OP_DIV
+    -1, // OP_MOD
+     0, // OP_NEG
+     0, // OP_NOT
+     0, // OP_BOOL
+    -1, // OP_LT
+    -1, // OP_GT
+    -1, // OP_LE
+    -1, // OP_GE
+    -1, // OP_EQ
+    -1, // OP_NE
+    -2, // OP_BETWEEN
+     0, // OP_JMP
+    -1, // OP_JZ
+    -1, // OP_JNZ
+     0, // OP_LOOP
+     0  // OP_RETURN
+};
+
+static const char* _opcodeNames[OP_COUNT] = {
+    "PUSH", "LOAD", "LOAD_POLY", "LOAD_ELEM", "STORE", "STORE_POLY",
+    "STORE_ELEM", "EVAL_INT", "EXEC", "DUP", "POP", "ADD", "SUB", "MUL",
+    "DIV", "MOD", "NEG", "NOT", "BOOL", "LT", "GT", "LE", "GE", "EQ", "NE",
+    "BETWEEN", "JMP", "JZ", "JNZ", "LOOP", "RETURN"
+};
+
+int VMCompiler::emit(VMOpcode_t op, int arg, void* ptr) {
+    VMInstr instr;
+    instr.handler = NULL;
+    instr.op  = op;
+    instr.arg = arg;
+    instr.ptr = ptr;
+    code.push_back(instr);
+    depth += _stackEffect[op];
+    if (depth > maxDepth) maxDepth = depth;
+    return code.size() - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// code generation of the parser tree nodes
+
+void IntExpr::emitInt(VMCompiler& c) {
+    c.emit(OP_EVAL_INT, 0, static_cast<IntExpr*>(this));
+}
+
+void IntLiteral::emitInt(VMCompiler& c) {
+    c.emit(OP_PUSH, value);
+}
+
+void IntVariable::emitInt(VMCompiler& c) {
+    if (!context) { // i.e. built-in variable
+        IntExpr::emitInt(c);
+        return;
+    }
+    if (polyphonic)
+        c.emit(OP_LOAD_POLY, memPos);
+    else
+        c.emit(OP_LOAD, 0, &(*context->globalIntMemory)[memPos]);
+}
+
+bool IntVariable::emitAssign(VMCompiler& c, Expression* expr) {
+    IntExpr* intExpr = dynamic_cast<IntExpr*>(expr);
+    if (!intExpr || !context || bConst) return false;
+    intExpr->emitInt(c);
+    if (polyphonic)
+        c.emit(OP_STORE_POLY, memPos);
+    else
+        c.emit(OP_STORE, 0, &(*context->globalIntMemory)[memPos]);
+    return true;
+}
+
+void ConstIntVariable::emitInt(VMCompiler& c) {
+    c.emit(OP_PUSH, value);
+}
+
+void IntArrayElement::emitInt(VMCompiler& c) {
+    if (!index) {
+        c.emit(OP_PUSH, 0);
+        return;
+    }
+    index->emitInt(c);
+    c.emit(OP_LOAD_ELEM, 0, &*array);
+}
+
+bool IntArrayElement::emitAssign(VMCompiler& c, Expression* expr) {
+    IntExpr* valueExpr = dynamic_cast<IntExpr*>(expr);
+    if (!valueExpr || !index) return false;
+    valueExpr->emitInt(c);
+    index->emitInt(c);
+    c.emit(OP_STORE_ELEM, 0, &*array);
+    return true;
+}
+
+static void _emitBinaryOp(VMCompiler& c, Expression* lhs, Expression* rhs, VMOpcode_t op) {
+    IntExpr* pLHS = dynamic_cast<IntExpr*>(lhs);
+    IntExpr* pRHS = dynamic_cast<IntExpr*>(rhs);
+    if (!pLHS || !pRHS) {
+        c.emit(OP_PUSH, 0);
+        return;
+    }
+    pLHS->emitInt(c);
+    pRHS->emitInt(c);
+    c.emit(op);
+}
+
+void Add::emitInt(VMCompiler& c) {
+    _emitBinaryOp(c, &*lhs, &*rhs, OP_ADD);
+}
+
+void Sub::emitInt(VMCompiler& c) {
+    _emitBinaryOp(c, &*lhs, &*rhs, OP_SUB);
+}
+
+void Mul::emitInt(VMCompiler& c) {
+    _emitBinaryOp(c, &*lhs, &*rhs, OP_MUL);
+}
+
+void Div::emitInt(VMCompiler& c) {
+    _emitBinaryOp(c, &*lhs, &*rhs, OP_DIV);
+}
+
+void Mod::emitInt(VMCompiler& c) {
+    _emitBinaryOp(c, &*lhs, &*rhs, OP_MOD);
+}
+
+void Neg::emitInt(VMCompiler& c) {
+    if (!expr) {
+        c.emit(OP_PUSH, 0);
+        return;
+    }
+    expr->emitInt(c);
+    c.emit(OP_NEG);
+}
+
+void Not::emitInt(VMCompiler& c) {
+    expr->emitInt(c);
+    c.emit(OP_NOT);
+}
+
+void Relation::emitInt(VMCompiler& c) {
+    if ((type == EQUAL || type == NOT_EQUAL) &&
+        (lhs->exprType() == STRING_EXPR || rhs->exprType() == STRING_EXPR))
+    {
+        // string comparison is left to the parser tree
+        IntExpr::emitInt(c);
+        return;
+    }
+    dynamic_cast<IntExpr*>(&*lhs)->emitInt(c);
+    dynamic_cast<IntExpr*>(&*rhs)->emitInt(c);
+    switch (type) {
+        case LESS_THAN:        c.emit(OP_LT); break;
+        case GREATER_THAN:     c.emit(OP_GT); break;
+        case LESS_OR_EQUAL:    c.emit(OP_LE); break;
+        case GREATER_OR_EQUAL: c.emit(OP_GE); break;
+        case EQUAL:            c.emit(OP_EQ); break;
+        case NOT_EQUAL:        c.emit(OP_NE); break;
+    }
+}
+
+// short circuit evaluation of "and" and "or"
+static void _emitLogicalOp(VMCompiler& c, Expression* lhs, Expression* rhs, bool isOr) {
+    dynamic_cast<IntExpr*>(lhs)->emitInt(c);
+    const int skip = c.emit(isOr ? OP_JNZ : OP_JZ);
+    dynamic_cast<IntExpr*>(rhs)->emitInt(c);
+    c.emit(OP_BOOL);
+    const int end = c.emit(OP_JMP);
+    c.adjustDepth(-1); // the result of the rhs is not on the stack on this path
+    c.patch(skip, c.pos());
+    c.emit(OP_PUSH, isOr ? 1 : 0);
+    c.patch(end, c.pos());
+}
+
+void Or::emitInt(VMCompiler& c) {
+    _emitLogicalOp(c, &*lhs, &*rhs, true);
+}
+
+void And::emitInt(VMCompiler& c) {
+    _emitLogicalOp(c, &*lhs, &*rhs, false);
+}
+
+void LeafStatement::emitStmt(VMCompiler& c) {
+    c.emit(OP_EXEC, 0, static_cast<LeafStatement*>(this));
+}
+
+void Assignment::emitStmt(VMCompiler& c) {
+    // anything else than integer assignments to user declared variables is
+    // left to the parser tree
+    if (!variable || !value || !variable->emitAssign(c, &*value))
+        LeafStatement::emitStmt(c);
+}
+
+void Statements::emitStmt(VMCompiler& c) {
+    for (int i = 0; statement(i); ++i)
+        statement(i)->emitStmt(c);
+}
+
+void If::emitStmt(VMCompiler& c) {
+    condition->emitInt(c);
+    const int jumpToElse = c.emit(OP_JZ);
+    if (ifStatements) ifStatements->emitStmt(c);
+    if (elseStatements) {
+        const int jumpToEnd = c.emit(OP_JMP);
+        c.patch(jumpToElse, c.pos());
+        elseStatements->emitStmt(c);
+        c.patch(jumpToEnd, c.pos());
+    } else {
+        c.patch(jumpToElse, c.pos());
+    }
+}
+
+void SelectCase::emitStmt(VMCompiler& c) {
+    // the selected value stays on the stack while the cases are compared
+    select->emitInt(c);
+    std::vector<int> jumpToBranch;
+    for (int i = 0; i < branches.size(); ++i) {
+        c.emit(OP_DUP);
+        branches[i].from->emitInt(c);
+        if (branches[i].to) {
+            branches[i].to->emitInt(c);
+            c.emit(OP_BETWEEN);
+        } else {
+            c.emit(OP_EQ);
+        }
+        jumpToBranch.push_back(c.emit(OP_JNZ));
+    }
+    c.emit(OP_POP);
+    std::vector<int> jumpToEnd;
+    jumpToEnd.push_back(c.emit(OP_JMP));
+    for (int i = 0; i < branches.size(); ++i) {
+        c.patch(jumpToBranch[i], c.pos());
+        c.adjustDepth(+1); // selected value is still on the stack here
+        c.emit(OP_POP);
+        if (branches[i].statements) branches[i].statements->emitStmt(c);
+        jumpToEnd.push_back(c.emit(OP_JMP));
+    }
+    for (int i = 0; i < jumpToEnd.size(); ++i)
+        c.patch(jumpToEnd[i], c.pos());
+}
+
+void While::emitStmt(VMCompiler& c) {
+    const int start = c.pos();
+    if (m_condition) m_condition->emitInt(c);
+    else c.emit(OP_PUSH, 0);
+    const int jumpToEnd = c.emit(OP_JZ);
+    if (m_statements) m_statements->emitStmt(c);
+    c.emit(OP_LOOP, start);
+    c.patch(jumpToEnd, c.pos());
+}
+
+///////////////////////////////////////////////////////////////////////////
+// bytecode interpreter
+
+#if USE_COMPUTED_GOTO
+# define VM_DISPATCH()   ++executed; goto *ip->handler
+# define VM_OP(name)     L_##name:
+# define VM_NEXT()       ++ip; VM_DISPATCH()
+# define VM_JUMP(target) ip = code + (target); VM_DISPATCH()
+#else
+# define VM_DISPATCH()   continue
+# define VM_OP(name)     case name:
+# define VM_NEXT()       ++ip; continue
+# define VM_JUMP(target) ip = code + (target); continue
+#endif
+
+// amount of instructions between two reads of the clock
+#define VM_BUDGET_CHECK_INTERVAL 1024
+
+/*
+ * Called by the interpreter on a loop's back edge once @a executed reached
+ * @c ctx->budgetCheckAt. Returns true if the current execBytecode() call
+ * exhausted its execution budget, otherwise it schedules the next check.
+ */
+static bool _execBudgetExceeded(ExecContext* ctx, int executed) {
+    if (ctx->maxInstructions && executed >= ctx->maxInstructions)
+        return true;
+    if (ctx->deadline && RTMath::MicroSecondsNow() >= ctx->deadline)
+        return true;
+    ctx->budgetCheckAt = executed + VM_BUDGET_CHECK_INTERVAL;
+    if (ctx->maxInstructions && ctx->budgetCheckAt > ctx->maxInstructions)
+        ctx->budgetCheckAt = ctx->maxInstructions;
+    return false;
+}
+
+/*
+ * Executes the bytecode @a code with the execution context @a ctx, starting
+ * at @c ctx->pc, until the event handler ends or a statement signals to
+ * suspend or abort execution. If @a labels is not NULL, nothing is executed
+ * and just the addresses of the opcode implementations are returned
+ * instead (only if dispatching by computed gotos, NULL otherwise).
+ */
+static StmtFlags_t _run(const VMInstr* code, ExecContext* ctx, const void* const** labels) {
+    #if USE_COMPUTED_GOTO
+    static const void* const opLabels[] = {
+        &&L_OP_PUSH, &&L_OP_LOAD, &&L_OP_LOAD_POLY, &&L_OP_LOAD_ELEM,
+        &&L_OP_STORE, &&L_OP_STORE_POLY, &&L_OP_STORE_ELEM, &&L_OP_EVAL_INT,
+        &&L_OP_EXEC, &&L_OP_DUP, &&L_OP_POP, &&L_OP_ADD, &&L_OP_SUB,
+        &&L_OP_MUL, &&L_OP_DIV, &&L_OP_MOD, &&L_OP_NEG, &&L_OP_NOT,
+        &&L_OP_BOOL, &&L_OP_LT, &&L_OP_GT, &&L_OP_LE, &&L_OP_GE, &&L_OP_EQ,
+        &&L_OP_NE, &&L_OP_BETWEEN, &&L_OP_JMP, &&L_OP_JZ, &&L_OP_JNZ,
+        &&L_OP_LOOP, &&L_OP_RETURN
+    };
+    // compile time check that there is a label for each opcode
+    typedef char opLabelsComplete[sizeof(opLabels) / sizeof(opLabels[0]) == OP_COUNT ? 1 : -1] __attribute__((unused));
+    if (labels) {
+        *labels = opLabels;
+        return STMT_SUCCESS;
+    }
+    #else
+    if (labels) {
+        *labels = NULL;
+        return STMT_SUCCESS;
+    }
+    #endif
+
+    const VMInstr* ip = code + ctx->pc;
+    int* sp = ctx->stack - 1; // top of stack, stack is empty between statements
+    int* const poly = ctx->polyphonicIntMemory;
+    StmtFlags_t flags;
+    int executed = USE_COMPUTED_GOTO ? 0 : 1; // amount of instructions executed
+
+    #if USE_COMPUTED_GOTO
+    VM_DISPATCH();
+    #else
+    for (;; ++executed) switch (ip->op) {
+    #endif
+
+    VM_OP(OP_PUSH)
+        *++sp = ip->arg;
+        VM_NEXT();
+    VM_OP(OP_LOAD)
+        *++sp = *(int*)ip->ptr;
+        VM_NEXT();
+    VM_OP(OP_LOAD_POLY)
+        *++sp = poly[ip->arg];
+        VM_NEXT();
+    VM_OP(OP_LOAD_ELEM) {
+        IntArrayVariable* array = (IntArrayVariable*) ip->ptr;
+        *sp = (*sp < 0 || *sp >= array->arraySize()) ? 0 : array->evalIntElement(*sp);
+        VM_NEXT();
+    }
+    VM_OP(OP_STORE)
+        *(int*)ip->ptr = *sp--;
+        VM_NEXT();
+    VM_OP(OP_STORE_POLY)
+        poly[ip->arg] = *sp--;
+        VM_NEXT();
+    VM_OP(OP_STORE_ELEM) {
+        IntArrayVariable* array = (IntArrayVariable*) ip->ptr;
+        if (sp[0] >= 0 && sp[0] < array->arraySize())
+            array->assignIntElement(sp[0], sp[-1]);
+        sp -= 2;
+        VM_NEXT();
+    }
+    VM_OP(OP_EVAL_INT)
+        ctx->resetStrArena(); // strings only live while a node is evaluated
+        *++sp = ((IntExpr*) ip->ptr)->evalInt();
+        VM_NEXT();
+    VM_OP(OP_EXEC)
+        ctx->resetStrArena();
+        flags = ((LeafStatement*) ip->ptr)->exec();
+        if (flags != STMT_SUCCESS) {
+            ctx->pc = ip - code + 1; // resume with next statement
+            ctx->instructionsExecuted = executed;
+            return flags;
+        }
+        VM_NEXT();
+    VM_OP(OP_DUP)
+        sp[1] = sp[0];
+        ++sp;
+        VM_NEXT();
+    VM_OP(OP_POP)
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_ADD)
+        sp[-1] += sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_SUB)
+        sp[-1] -= sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_MUL)
+        sp[-1] *= sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_DIV)
+        sp[-1] = (sp[0] == 0) ? 0 : sp[-1] / sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_MOD)
+        sp[-1] = (sp[0] == 0) ? 0 : sp[-1] % sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_NEG)
+        *sp = -*sp;
+        VM_NEXT();
+    VM_OP(OP_NOT)
+        *sp = !*sp;
+        VM_NEXT();
+    VM_OP(OP_BOOL)
+        *sp = (*sp) ? 1 : 0;
+        VM_NEXT();
+    VM_OP(OP_LT)
+        sp[-1] = sp[-1] < sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_GT)
+        sp[-1] = sp[-1] > sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_LE)
+        sp[-1] = sp[-1] <= sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_GE)
+        sp[-1] = sp[-1] >= sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_EQ)
+        sp[-1] = sp[-1] == sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_NE)
+        sp[-1] = sp[-1] != sp[0];
+        --sp;
+        VM_NEXT();
+    VM_OP(OP_BETWEEN)
+        sp[-2] = sp[-1] <= sp[-2] && sp[-2] <= sp[0];
+        sp -= 2;
+        VM_NEXT();
+    VM_OP(OP_JMP)
+        VM_JUMP(ip->arg);
+    VM_OP(OP_JZ)
+        if (!*sp--) {
+            VM_JUMP(ip->arg);
+        }
+        VM_NEXT();
+    VM_OP(OP_JNZ)
+        if (*sp--) {
+            VM_JUMP(ip->arg);
+        }
+        VM_NEXT();
+    VM_OP(OP_LOOP)
+        if (executed >= ctx->budgetCheckAt && _execBudgetExceeded(ctx, executed)) {
+            ctx->pc = ip->arg; // resume with the loop's condition
+            ctx->preempted = true;
+            ctx->suspendMicroseconds = 0;
+            ctx->instructionsExecuted = executed;
+            return STMT_SUSPEND_SIGNALLED;
+        }
+        VM_JUMP(ip->arg);
+    VM_OP(OP_RETURN)
+        ctx->pc = -1;
+        ctx->instructionsExecuted = executed;
+        return STMT_SUCCESS;
+
+    #if !USE_COMPUTED_GOTO
+        default:
+            std::cerr << "CRITICAL: Invalid VM opcode " << ip->op << "!\n";
+            ctx->instructionsExecuted = executed;
+            return StmtFlags_t(STMT_ABORT_SIGNALLED | STMT_ERROR_OCCURRED);
+    }
+    #endif
+}
+
+StmtFlags_t execBytecode(const VMInstr* code, ExecContext* ctx) {
+    return _run(code, ctx, NULL);
+}
+
+void compileBytecode(ParserContext* context) {
+    std::vector<VMInstr>& code = context->bytecode;
+    code.clear();
+    VMCompiler c(code);
+    for (int i = 0; context->handlers && i < context->handlers->size(); ++i) {
+        EventHandler* handler = context->handlers->eventHandler(i);
+        handler->codeEntry = c.pos();
+        handler->profileIndex = i;
+        handler->emitStmt(c);
+        c.emit(OP_RETURN);
+    }
+
+    // resolve the address of each opcode's implementation
+    const void* const* labels;
+    _run(NULL, NULL, &labels);
+    if (labels)
+        for (int i = 0; i < code.size(); ++i)
+            code[i].handler = labels[code[i].op];
+
+    // at least one entry, since execBytecode() takes the address of the
+    // stack's first element
+    context->requiredMaxStackSize = c.requiredStackSize() + 1;
+
+    dmsg(2,("Compiled script to %d VM instructions (%d bytes).\n",
+            int(code.size()), int(code.size() * sizeof(VMInstr))));
+}
+
+void dumpBytecode(const std::vector<VMInstr>& code) {
+    for (int i = 0; i < code.size(); ++i) {
+        const VMInstr& instr = code[i];
+        printf("%4d: %-10s", i, _opcodeNames[instr.op]);
+        switch (instr.op) {
+            case OP_PUSH:
+            case OP_LOAD_POLY:
+            case OP_STORE_POLY:
+            case OP_JMP:
+            case OP_JZ:
+            case OP_JNZ:
+            case OP_LOOP:
+                printf(" %d", instr.arg);
+                break;
+            case OP_LOAD:
+            case OP_LOAD_ELEM:
+            case OP_STORE:
+            case OP_STORE_ELEM:
+            case OP_EVAL_INT:
+            case OP_EXEC:
+                printf(" %p", instr.ptr);
+                break;
+            default:
+                break;
+        }
+        printf("\n");
+    }
+}
+
+} // namespace LinuxSampler
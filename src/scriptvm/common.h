@@ -74,6 +74,7 @@ namespace LinuxSampler {
         VM_EXEC_RUNNING = 1, ///< The VM is currently executing the script.
         VM_EXEC_SUSPENDED = (1<<1), ///< Script is currently suspended by the VM, either because the script called the built-in wait() script function or because the script consumed too much execution time and was forced by the VM to be suspended for some time.
         VM_EXEC_ERROR = (1<<2), ///< A runtime error occurred while executing the script (i.e. a call to some built-in script function failed).
+        VM_EXEC_PREEMPTED = (1<<3), ///< Always combined with VM_EXEC_SUSPENDED: the script was suspended by the VM because it exhausted its execution budget, and should be resumed as soon as possible (i.e. in the next audio fragment).
     };
 
     /** @brief Script event handler type.
@@ -198,6 +199,15 @@ namespace LinuxSampler {
          */
         virtual String evalStr() = 0;
 
+        /**
+         * Returns the result of this expression as C string, without
+         * allocating memory on the heap. So this is the method of choice for
+         * built-in functions, which are called by the real-time thread. The
+         * returned string is only valid until the built-in function returns.
+         * This abstract method must be implemented by deriving classes.
+         */
+        virtual const char* evalCStr() = 0;
+
         /**
          * Returns always STRING_EXPR for instances of this class.
          */
@@ -589,6 +599,62 @@ namespace LinuxSampler {
         virtual std::map<String,int> builtInConstIntVariables() = 0;
     };
 
+    /** @brief Execution statistics of a script event handler or function.
+     *
+     * Used by VMScriptProfile for collecting the execution statistics of
+     * one event handler (i.e. "on note ... end on") or one built-in function
+     * (i.e. "play_note()") of a script.
+     */
+    struct VMProfileCounters {
+        String   name; ///< Name of the event handler (i.e. "note") or built-in function (i.e. "play_note").
+        uint64_t calls; ///< How often the event handler was started, or how often the built-in function was called respectively.
+        uint64_t instructions; ///< Amount of VM instructions executed (event handlers only).
+        uint64_t suspensions; ///< How often the event handler was suspended (event handlers only).
+        uint64_t totalMicroseconds; ///< Total execution time (of event handlers including the time spent in built-in functions).
+        uint64_t peakMicroseconds; ///< Longest execution time of one call (of event handlers: of one execution slice between two suspensions).
+
+        VMProfileCounters() { reset(); }
+
+        void reset() {
+            calls = instructions = suspensions = 0;
+            totalMicroseconds = peakMicroseconds = 0;
+        }
+
+        void addTime(uint64_t microseconds) {
+            totalMicroseconds += microseconds;
+            if (microseconds > peakMicroseconds)
+                peakMicroseconds = microseconds;
+        }
+    };
+
+    /** @brief Execution statistics of a script.
+     *
+     * Collects execution statistics of all event handlers and all built-in
+     * functions of a script while it is assigned to the script's execution
+     * contexts with VMExecContext::setProfile(). Call
+     * ScriptVM::prepareProfile() to prepare an object of this class for a
+     * script before.
+     *
+     * Measuring costs some execution time by itself, so profile objects
+     * should only be assigned while the statistics are actually needed.
+     *
+     * Only the thread executing the script writes to the counters. Other
+     * threads may read them at any time, but should keep in mind that the
+     * counters are not updated atomically.
+     */
+    struct VMScriptProfile {
+        std::vector<VMProfileCounters> handlers; ///< Statistics of the script's event handlers, in the order of the handlers in the script.
+        std::vector<VMProfileCounters> functions; ///< Statistics of the built-in functions called by the script.
+
+        /**
+         * Resets all counters to zero.
+         */
+        void reset() {
+            for (int i = 0; i < handlers.size(); ++i) handlers[i].reset();
+            for (int i = 0; i < functions.size(); ++i) functions[i].reset();
+        }
+    };
+
     /** @brief Execution state of a virtual machine.
      *
      * An instance of this abstract base class represents exactly one execution
@@ -629,6 +695,46 @@ namespace LinuxSampler {
          * @see ScriptVM::exec()
          */
         virtual int suspensionTimeMicroseconds() const = 0;
+
+        /**
+         * Assigns the object which shall collect execution statistics
+         * whenever this execution context is executed by ScriptVM::exec().
+         * Pass NULL to stop collecting statistics (which is the default).
+         *
+         * @param profile - statistics of the script this execution context
+         *                  was created for (prepared with
+         *                  ScriptVM::prepareProfile())
+         */
+        virtual void setProfile(VMScriptProfile* profile) = 0;
+    };
+
+    /** @brief Contiguous block of VM execution contexts.
+     *
+     * Holds a fixed amount of VM execution contexts of one script, all
+     * allocated from one contiguous block of memory, with the polyphonic
+     * variable memory and the value stack of each context placed directly
+     * behind the context. This keeps the data of many simultaneously running
+     * script event handlers close together in memory.
+     *
+     * The individual execution contexts of a slab must not be deleted,
+     * deleting the slab frees all of its execution contexts.
+     *
+     * @see ScriptVM::createExecContextSlab()
+     */
+    class VMExecContextSlab {
+    public:
+        virtual ~VMExecContextSlab() {}
+
+        /**
+         * Returns the amount of execution contexts of this slab.
+         */
+        virtual int size() const = 0;
+
+        /**
+         * Returns the execution context with index @a index (0 .. size() - 1)
+         * of this slab.
+         */
+        virtual VMExecContext* execContext(int index) = 0;
     };
 
     /** @brief Script callback for a certain event.
@@ -22,6 +22,27 @@
     #define scanner context->scanner
     #define PARSE_ERR(loc,txt)  yyerror(&loc, context, txt)
     #define PARSE_WRN(loc,txt)  InstrScript_warning(&loc, context, txt)
+
+    // replaces an integer expression by its result if it can already be
+    // evaluated at parse time (i.e. arithmetic with literals and constants)
+    static ExpressionRef foldConstInt(IntExprRef expr) {
+        if (!expr->isConstExpr()) return expr;
+        return new IntLiteral(expr->evalInt());
+    }
+
+    // a string variable holds at most CONFIG_MAX_SCRIPT_STRING_LENGTH - 1
+    // characters, longer strings assigned to it are truncated at runtime
+    static bool exceedsMaxStrLength(StringExprRef expr) {
+        return expr->isConstExpr() &&
+               expr->evalStr().length() > CONFIG_MAX_SCRIPT_STRING_LENGTH - 1;
+    }
+
+    static String strTruncationWrn(const char* name) {
+        return String("String assigned to variable '") + name +
+               "' exceeds max. string length of " +
+               ToString(CONFIG_MAX_SCRIPT_STRING_LENGTH - 1) +
+               " characters and will be truncated.";
+    }
 %}
 
 // generate reentrant safe parser
@@ -145,7 +166,7 @@ statement:
             PARSE_ERR(@3, (String("Redeclaration of variable '") + name + "'.").c_str());
         if (name[0] != '$') {
             PARSE_ERR(@3, "Polyphonic variables may only be declared as integers.");
-            $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+            $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
         } else {
             context->vartable[name] = new PolyphonicIntVariable(context);
             $$ = new NoOperation;
@@ -160,6 +181,8 @@ statement:
             if (name[0] == '$')
                 PARSE_WRN(@2, (String("Variable '") + name + "' declared as integer, string expression assigned though.").c_str());
             StringExprRef expr = $4;
+            if (exceedsMaxStrLength(expr))
+                PARSE_WRN(@4, strTruncationWrn(name).c_str());
             if (expr->isConstExpr()) {
                 const String s = expr->evalStr();
                 StringVariableRef var = new StringVariable(context);
@@ -191,19 +214,19 @@ statement:
         const char* name = $2;
         if (!$4->isConstExpr()) {
             PARSE_ERR(@4, (String("Array variable '") + name + "' must be declared with constant array size.").c_str());
-            $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+            $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
         } else if ($4->exprType() != INT_EXPR) {
             PARSE_ERR(@4, (String("Size of array variable '") + name + "' declared with non integer expression.").c_str());
-            $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+            $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
         } else if (context->variableByName(name)) {
             PARSE_ERR(@2, (String("Redeclaration of variable '") + name + "'.").c_str());
-            $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+            $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
         } else {
             IntExprRef expr = $4;
             int size = expr->evalInt();
             if (size <= 0) {
                 PARSE_ERR(@4, (String("Array variable '") + name + "' declared with array size " + ToString(size) + ".").c_str());
-                $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+                $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
             } else {
                 context->vartable[name] = new IntArrayVariable(context, size);
                 $$ = new NoOperation;
@@ -214,26 +237,26 @@ statement:
         const char* name = $2;
         if (!$4->isConstExpr()) {
             PARSE_ERR(@4, (String("Array variable '") + name + "' must be declared with constant array size.").c_str());
-            $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+            $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
         } else if ($4->exprType() != INT_EXPR) {
             PARSE_ERR(@4, (String("Size of array variable '") + name + "' declared with non integer expression.").c_str());
-            $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+            $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
         } else if (context->variableByName(name)) {
             PARSE_ERR(@2, (String("Redeclaration of variable '") + name + "'.").c_str());
-            $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+            $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
         } else {
             IntExprRef sizeExpr = $4;
             ArgsRef args = $8;
             int size = sizeExpr->evalInt();
             if (size <= 0) {
                 PARSE_ERR(@4, (String("Array variable '") + name + "' must be declared with positive array size.").c_str());
-                $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+                $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
             } else if (args->argsCount() > size) {
                 PARSE_ERR(@8, (String("Variable '") + name +
                           "' was declared with size " + ToString(size) +
                           " but " + ToString(args->argsCount()) +
                           " values were assigned." ).c_str());
-                $$ = new FunctionCall("nothing", new Args, NULL); // whatever           
+                $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever           
             } else {
                 bool argsOK = true;
                 for (int i = 0; i < args->argsCount(); ++i) {
@@ -251,7 +274,7 @@ statement:
                 if (argsOK)
                     $$ = context->vartable[name] = new IntArrayVariable(context, size, args);
                 else
-                    $$ = new FunctionCall("nothing", new Args, NULL); // whatever
+                    $$ = new FunctionCall(context, "nothing", new Args, NULL); // whatever
             }
         }
     }
@@ -289,7 +312,10 @@ statement:
         $$ = $1;
     }
     | WHILE '(' expr ')' statements END WHILE  {
-        if ($3->exprType() == INT_EXPR) {
+        if ($3->exprType() == INT_EXPR && $3->isConstExpr() && !IntExprRef($3)->evalInt()) {
+            PARSE_WRN(@3, "Condition is always false, 'while' loop eliminated.");
+            $$ = new NoOperation;
+        } else if ($3->exprType() == INT_EXPR) {
             $$ = new While($3, $5);
         } else {
             PARSE_ERR(@3, "Condition for 'while' loops must be integer expression.");
@@ -297,13 +323,43 @@ statement:
         }
     }
     | IF '(' expr ')' statements ELSE statements END IF  {
-        $$ = new If($3, $5, $7);
+        if ($3->exprType() == INT_EXPR && $3->isConstExpr()) {
+            if (IntExprRef($3)->evalInt()) {
+                PARSE_WRN(@3, "Condition is always true, 'else' branch eliminated.");
+                $$ = $5;
+            } else {
+                PARSE_WRN(@3, "Condition is always false, 'if' branch eliminated.");
+                $$ = $7;
+            }
+        } else {
+            $$ = new If($3, $5, $7);
+        }
     }
     | IF '(' expr ')' statements END IF  {
-        $$ = new If($3, $5);
+        if ($3->exprType() == INT_EXPR && $3->isConstExpr()) {
+            if (IntExprRef($3)->evalInt()) {
+                PARSE_WRN(@3, "Condition is always true, 'if' statement replaced by its body.");
+                $$ = $5;
+            } else {
+                PARSE_WRN(@3, "Condition is always false, 'if' statement eliminated.");
+                $$ = new NoOperation;
+            }
+        } else {
+            $$ = new If($3, $5);
+        }
     }
     | SELECT expr caseclauses END SELECT  {
-        if ($2->exprType() == INT_EXPR) {
+        if ($2->exprType() == INT_EXPR && $2->isConstExpr()) {
+            SelectCaseRef select = new SelectCase($2, $3);
+            const int branch = select->evalBranch();
+            if (branch >= 0) {
+                PARSE_WRN(@2, "Select value is constant, 'select' statement replaced by the matching case.");
+                $$ = $3[branch].statements;
+            } else {
+                PARSE_WRN(@2, "Select value is constant and matches no case, 'select' statement eliminated.");
+                $$ = new NoOperation;
+            }
+        } else if ($2->exprType() == INT_EXPR) {
             $$ = new SelectCase($2, $3);
         } else {
             PARSE_ERR(@2, "Statement 'select' can only by applied to integer expressions.");
@@ -342,13 +398,13 @@ functioncall:
         VMFunction* fn = context->functionProvider->functionByName(name);
         if (!fn) {
             PARSE_ERR(@1, (String("No built-in function with name '") + name + "'.").c_str());
-            $$ = new FunctionCall(name, args, NULL);
+            $$ = new FunctionCall(context, name, args, NULL);
         } else if (args->argsCount() < fn->minRequiredArgs()) {
             PARSE_ERR(@3, (String("Built-in function '") + name + "' requires at least " + ToString(fn->minRequiredArgs()) + " arguments.").c_str());
-            $$ = new FunctionCall(name, args, NULL);
+            $$ = new FunctionCall(context, name, args, NULL);
         } else if (args->argsCount() > fn->maxAllowedArgs()) {
             PARSE_ERR(@3, (String("Built-in function '") + name + "' accepts max. " + ToString(fn->maxAllowedArgs()) + " arguments.").c_str());
-            $$ = new FunctionCall(name, args, NULL);
+            $$ = new FunctionCall(context, name, args, NULL);
         } else {
             bool argsOK = true;
             for (int i = 0; i < args->argsCount(); ++i) {
@@ -358,7 +414,7 @@ functioncall:
                     break;
                 }
             }
-            $$ = new FunctionCall(name, args, argsOK ? fn : NULL);
+            $$ = new FunctionCall(context, name, args, argsOK ? fn : NULL);
         }
     }
     | IDENTIFIER '(' ')' {
@@ -368,12 +424,12 @@ functioncall:
         VMFunction* fn = context->functionProvider->functionByName(name);
         if (!fn) {
             PARSE_ERR(@1, (String("No built-in function with name '") + name + "'.").c_str());
-            $$ = new FunctionCall(name, args, NULL);
+            $$ = new FunctionCall(context, name, args, NULL);
         } else if (fn->minRequiredArgs() > 0) {
             PARSE_ERR(@3, (String("Built-in function '") + name + "' requires at least " + ToString(fn->minRequiredArgs()) + " arguments.").c_str());
-            $$ = new FunctionCall(name, args, NULL);
+            $$ = new FunctionCall(context, name, args, NULL);
         } else {
-            $$ = new FunctionCall(name, args, fn);
+            $$ = new FunctionCall(context, name, args, fn);
         }
     }
     | IDENTIFIER  {
@@ -383,12 +439,12 @@ functioncall:
         VMFunction* fn = context->functionProvider->functionByName(name);
         if (!fn) {
             PARSE_ERR(@1, (String("No built-in function with name '") + name + "'.").c_str());
-            $$ = new FunctionCall(name, args, NULL);
+            $$ = new FunctionCall(context, name, args, NULL);
         } else if (fn->minRequiredArgs() > 0) {
             PARSE_ERR(@1, (String("Built-in function '") + name + "' requires at least " + ToString(fn->minRequiredArgs()) + " arguments.").c_str());
-            $$ = new FunctionCall(name, args, NULL);
+            $$ = new FunctionCall(context, name, args, NULL);
         } else {
-            $$ = new FunctionCall(name, args, fn);
+            $$ = new FunctionCall(context, name, args, fn);
         }
     }
 
@@ -416,6 +472,8 @@ assignment:
             PARSE_ERR(@2, (String("Variable assignment: Cannot modify const variable '") + name + "'.").c_str());
         else if (var->exprType() != $3->exprType())
             PARSE_ERR(@3, (String("Variable assignment: Variable '") + name + "' is of type " + typeStr(var->exprType()) + ", assignment is of type " + typeStr($3->exprType()) + " though.").c_str());
+        else if (var->exprType() == STRING_EXPR && exceedsMaxStrLength($3))
+            PARSE_WRN(@3, strTruncationWrn(name).c_str());
         $$ = new Assignment(var, $3);
     }
     | VARIABLE '[' expr ']' ASSIGNMENT expr  {
@@ -470,17 +528,26 @@ unary_expr:
         $$ = $2;
     }
     | functioncall  {
-        $$ = $1;
+        FunctionCallRef call = $1;
+        if (call->function() &&
+            call->function() == context->functionProvider->functionByName("num_elements"))
+        {
+            // the size of arrays never changes, so no need to call
+            // num_elements() at runtime
+            $$ = new IntLiteral(call->arguments()->arg(0)->asIntArray()->arraySize());
+        } else {
+            $$ = call;
+        }
     }
     | '-' unary_expr  {
-        $$ = new Neg($2);
+        $$ = foldConstInt(new Neg($2));
     }
     | NOT unary_expr  {
         if ($2->exprType() != INT_EXPR) {
             PARSE_ERR(@2, (String("Right operand of operator 'not' must be an integer expression, is ") + typeStr($2->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Not($2);
+            $$ = foldConstInt(new Not($2));
         }
     }
 
@@ -497,7 +564,7 @@ concat_expr:
                 lhs->evalCastToStr() + rhs->evalCastToStr()
             );
         } else {
-            $$ = new ConcatString(lhs, rhs);
+            $$ = new ConcatString(context, lhs, rhs);
         }
     }
 
@@ -512,8 +579,10 @@ or_expr:
         } else if (rhs->exprType() != INT_EXPR) {
             PARSE_ERR(@3, (String("Right operand of operator 'or' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
+        } else if (lhs->isConstExpr() && IntExprRef(lhs)->evalInt()) {
+            $$ = new IntLiteral(1); // short-circuit, rhs would never be evaluated
         } else {
-            $$ = new Or(lhs, rhs);
+            $$ = foldConstInt(new Or(lhs, rhs));
         }
     }
 
@@ -530,8 +599,10 @@ and_expr:
         } else if (rhs->exprType() != INT_EXPR) {
             PARSE_ERR(@3, (String("Right operand of operator 'and' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
+        } else if (lhs->isConstExpr() && !IntExprRef(lhs)->evalInt()) {
+            $$ = new IntLiteral(0); // short-circuit, rhs would never be evaluated
         } else {
-            $$ = new And(lhs, rhs);
+            $$ = foldConstInt(new And(lhs, rhs));
         }
     }
 
@@ -547,7 +618,7 @@ rel_expr:
             PARSE_ERR(@3, (String("Right operand of operator '<' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Relation(lhs, Relation::LESS_THAN, rhs);
+            $$ = foldConstInt(new Relation(lhs, Relation::LESS_THAN, rhs));
         }
     }
     | rel_expr '>' add_expr  {
@@ -560,7 +631,7 @@ rel_expr:
             PARSE_ERR(@3, (String("Right operand of operator '>' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Relation(lhs, Relation::GREATER_THAN, rhs);
+            $$ = foldConstInt(new Relation(lhs, Relation::GREATER_THAN, rhs));
         }
     }
     | rel_expr LE add_expr  {
@@ -573,7 +644,7 @@ rel_expr:
             PARSE_ERR(@3, (String("Right operand of operator '<=' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Relation(lhs, Relation::LESS_OR_EQUAL, rhs);
+            $$ = foldConstInt(new Relation(lhs, Relation::LESS_OR_EQUAL, rhs));
         }
     }
     | rel_expr GE add_expr  {
@@ -586,14 +657,20 @@ rel_expr:
             PARSE_ERR(@3, (String("Right operand of operator '>=' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Relation(lhs, Relation::GREATER_OR_EQUAL, rhs);
+            $$ = foldConstInt(new Relation(lhs, Relation::GREATER_OR_EQUAL, rhs));
         }
     }
     | rel_expr '=' add_expr  {
-        $$ = new Relation($1, Relation::EQUAL, $3);
+        if ($1->exprType() == INT_EXPR && $3->exprType() == INT_EXPR)
+            $$ = foldConstInt(new Relation($1, Relation::EQUAL, $3));
+        else
+            $$ = new Relation($1, Relation::EQUAL, $3);
     }
     | rel_expr '#' add_expr  {
-        $$ = new Relation($1, Relation::NOT_EQUAL, $3);
+        if ($1->exprType() == INT_EXPR && $3->exprType() == INT_EXPR)
+            $$ = foldConstInt(new Relation($1, Relation::NOT_EQUAL, $3));
+        else
+            $$ = new Relation($1, Relation::NOT_EQUAL, $3);
     }
 
 add_expr:
@@ -608,7 +685,7 @@ add_expr:
             PARSE_ERR(@3, (String("Right operand of operator '+' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Add(lhs,rhs);
+            $$ = foldConstInt(new Add(lhs,rhs));
         }
     }
     | add_expr '-' mul_expr  {
@@ -621,7 +698,7 @@ add_expr:
             PARSE_ERR(@3, (String("Right operand of operator '-' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Sub(lhs,rhs);
+            $$ = foldConstInt(new Sub(lhs,rhs));
         }
     }
 
@@ -637,7 +714,7 @@ mul_expr:
             PARSE_ERR(@3, (String("Right operand of operator '*' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Mul(lhs,rhs);
+            $$ = foldConstInt(new Mul(lhs,rhs));
         }
     }
     | mul_expr '/' unary_expr  {
@@ -650,7 +727,7 @@ mul_expr:
             PARSE_ERR(@3, (String("Right operand of operator '/' must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Div(lhs,rhs);
+            $$ = foldConstInt(new Div(lhs,rhs));
         }
     }
     | mul_expr MOD unary_expr  {
@@ -663,7 +740,7 @@ mul_expr:
             PARSE_ERR(@3, (String("Right operand of modulo operator must be an integer expression, is ") + typeStr(rhs->exprType()) + " though.").c_str());
             $$ = new IntLiteral(0);
         } else {
-            $$ = new Mod(lhs,rhs);
+            $$ = foldConstInt(new Mod(lhs,rhs));
         }
     }
 
@@ -11,7 +11,10 @@
 #include <string.h>
 #include "tree.h"
 #include "../common/global_private.h"
+#include "../common/RTMath.h"
 #include <assert.h>
+#include <algorithm>
+#include <new>
 
 namespace LinuxSampler {
     
@@ -120,7 +123,9 @@ void Div::dump(int level) {
 int Mod::evalInt() {
     IntExpr* pLHS = dynamic_cast<IntExpr*>(&*lhs);
     IntExpr* pRHS = dynamic_cast<IntExpr*>(&*rhs);;
-    return (pLHS && pRHS) ? pLHS->evalInt() % pRHS->evalInt() : 0;
+    if (!pLHS || !pRHS) return 0;
+    const int r = pRHS->evalInt();
+    return (r == 0) ? 0 : pLHS->evalInt() % r;
 }
 
 void Mod::dump(int level) {
@@ -208,7 +213,7 @@ StmtFlags_t Assignment::exec() {
     return STMT_SUCCESS;
 }
 
-EventHandler::EventHandler(StatementsRef statements) {
+EventHandler::EventHandler(StatementsRef statements) : codeEntry(-1), profileIndex(0) {
     this->statements = statements;
     usingPolyphonics = statements->isPolyphonic();
 }
@@ -256,11 +261,30 @@ ExprType_t FunctionCall::exprType() const {
     return fn->returnType();
 }
 
+FunctionCall::FunctionCall(ParserContext* ctx, const char* function, ArgsRef args, VMFunction* fn) :
+    functionName(function), args(args), fn(fn), context(ctx), profileIndex(-1)
+{
+    if (!fn) return;
+    std::vector<String>& names = ctx->calledFunctions;
+    profileIndex = std::find(names.begin(), names.end(), functionName) - names.begin();
+    if (profileIndex == names.size()) names.push_back(functionName);
+}
+
 VMFnResult* FunctionCall::execVMFn() {
     if (!fn) return NULL;
     // assuming here that all argument checks (amount and types) have been made
     // at parse time, to avoid time intensive checks on each function call
-    return fn->exec(dynamic_cast<VMFnArgs*>(&*args));
+    VMScriptProfile* profile =
+        (context->execContext) ? context->execContext->profile : NULL;
+    if (!profile || profileIndex >= profile->functions.size())
+        return fn->exec(dynamic_cast<VMFnArgs*>(&*args));
+
+    const uint64_t t = RTMath::MicroSecondsNow();
+    VMFnResult* result = fn->exec(dynamic_cast<VMFnArgs*>(&*args));
+    VMProfileCounters& counters = profile->functions[profileIndex];
+    counters.calls++;
+    counters.addTime(RTMath::MicroSecondsNow() - t);
+    return result;
 }
 
 StmtFlags_t FunctionCall::exec() {
@@ -278,6 +302,14 @@ int FunctionCall::evalInt() {
     return intExpr->evalInt();
 }
 
+const char* FunctionCall::evalCStr() {
+    VMFnResult* result = execVMFn();
+    if (!result) return "";
+    VMStringExpr* strExpr = dynamic_cast<VMStringExpr*>(result->resultValue());
+    if (!strExpr) return "";
+    return strExpr->evalCStr();
+}
+
 String FunctionCall::evalStr() {
     VMFnResult* result = execVMFn();
     if (!result) return "";
@@ -506,14 +538,33 @@ StringVariable::StringVariable(ParserContext* ctx, bool bConst)
 {
 }
 
+// Strings are truncated at runtime without interrupting the script, so just
+// let the user know about it once per script instead of flooding the output.
+static bool reportStrTruncation(ParserContext* ctx) {
+    if (ctx->strTruncationReported) return false;
+    ctx->strTruncationReported = true;
+    return true;
+}
+
 void StringVariable::assign(Expression* expr) {
     StringExpr* strExpr = dynamic_cast<StringExpr*>(expr);
-    (*context->globalStrMemory)[memPos] = strExpr->evalStr();
+    const char* s = strExpr->evalCStr();
+    char* slot = &(*context->globalStrMemory)[memPos * CONFIG_MAX_SCRIPT_STRING_LENGTH];
+    // string is truncated if it does not fit into the variable's slot
+    size_t len = strlen(s);
+    if (len > CONFIG_MAX_SCRIPT_STRING_LENGTH - 1) {
+        len = CONFIG_MAX_SCRIPT_STRING_LENGTH - 1;
+        if (reportStrTruncation(context))
+            std::cerr << "[ScriptVM] Runtime warning: String truncated to max. string length of "
+                      << (CONFIG_MAX_SCRIPT_STRING_LENGTH - 1) << " characters." << std::endl;
+    }
+    memmove(slot, s, len); // s might be the variable itself
+    slot[len] = 0;
 }
 
-String StringVariable::evalStr() {
+const char* StringVariable::evalCStr() {
     //printf("StringVariable::eval pos=%d\n", memPos);
-    return (*context->globalStrMemory)[memPos];
+    return &(*context->globalStrMemory)[memPos * CONFIG_MAX_SCRIPT_STRING_LENGTH];
 }
 
 void StringVariable::dump(int level) {
@@ -532,8 +583,8 @@ void ConstStringVariable::assign(Expression* expr) {
 //     if (strExpr) value = strExpr->evalStr();
 }
 
-String ConstStringVariable::evalStr() {
-    return value;
+const char* ConstStringVariable::evalCStr() {
+    return value.c_str();
 }
 
 void ConstStringVariable::dump(int level) {
@@ -674,6 +725,43 @@ void Neg::dump(int level) {
     printf("Negative Expr\n");
 }
 
+// Returns the result of the given expression as string, integer expressions
+// are converted to a string in the given buffer.
+static const char* _evalCastToCStr(Expression* expr, char (&intBuf)[12]) {
+    switch (expr->exprType()) {
+        case STRING_EXPR:
+            return dynamic_cast<StringExpr*>(expr)->evalCStr();
+        case INT_EXPR:
+            snprintf(intBuf, sizeof(intBuf), "%d", dynamic_cast<IntExpr*>(expr)->evalInt());
+            return intBuf;
+        default:
+            return "";
+    }
+}
+
+const char* ConcatString::evalCStr() {
+    ExecContext* ctx = context->execContext;
+    if (!ctx) return ""; // not executed by the VM, evalStr() has to be used instead
+    char lBuf[12], rBuf[12];
+    const char* l = _evalCastToCStr(&*lhs, lBuf);
+    const char* r = _evalCastToCStr(&*rhs, rBuf);
+    const int lLen = strlen(l);
+    const int rLen = strlen(r);
+    int size = lLen + rLen + 1;
+    char* s = ctx->allocStr(size);
+    // truncate result if string arena is exhausted
+    if (size < lLen + rLen + 1 && reportStrTruncation(context))
+        std::cerr << "[ScriptVM] Runtime warning: String concatenation truncated, temporary string memory of "
+                  << CONFIG_SCRIPT_STRING_ARENA_SIZE << " bytes exhausted." << std::endl;
+    if (!size) return "";
+    const int n1 = std::min(lLen, size - 1);
+    const int n2 = std::min(rLen, size - 1 - n1);
+    memcpy(s, l, n1);
+    memcpy(s + n1, r, n2);
+    s[n1 + n2] = 0;
+    return s;
+}
+
 String ConcatString::evalStr() {
     return lhs->evalCastToStr() + rhs->evalCastToStr();
 }
@@ -694,29 +782,37 @@ bool ConcatString::isConstExpr() const {
 }
 
 int Relation::evalInt() {
+    if (type == EQUAL || type == NOT_EQUAL) {
+        if (lhs->exprType() == STRING_EXPR || rhs->exprType() == STRING_EXPR) {
+            const int cmp = evalStrCompare();
+            return (type == EQUAL) ? cmp == 0 : cmp != 0;
+        }
+    }
+    IntExpr* pLHS = dynamic_cast<IntExpr*>(&*lhs);
+    IntExpr* pRHS = dynamic_cast<IntExpr*>(&*rhs);
+    if (!pLHS || !pRHS) return 0;
     switch (type) {
         case LESS_THAN:
-            return lhs->evalInt() < rhs->evalInt();
+            return pLHS->evalInt() < pRHS->evalInt();
         case GREATER_THAN:
-            return lhs->evalInt() > rhs->evalInt();
+            return pLHS->evalInt() > pRHS->evalInt();
         case LESS_OR_EQUAL:
-            return lhs->evalInt() <= rhs->evalInt();
+            return pLHS->evalInt() <= pRHS->evalInt();
         case GREATER_OR_EQUAL:
-            return lhs->evalInt() >= rhs->evalInt();
+            return pLHS->evalInt() >= pRHS->evalInt();
         case EQUAL:
-            if (lhs->exprType() == STRING_EXPR || rhs->exprType() == STRING_EXPR)
-                return lhs->evalCastToStr() == rhs->evalCastToStr();
-            else
-                return lhs->evalInt() == rhs->evalInt();
+            return pLHS->evalInt() == pRHS->evalInt();
         case NOT_EQUAL:
-            if (lhs->exprType() == STRING_EXPR || rhs->exprType() == STRING_EXPR)
-                return lhs->evalCastToStr() != rhs->evalCastToStr();
-            else
-                return lhs->evalInt() != rhs->evalInt();
+            return pLHS->evalInt() != pRHS->evalInt();
     }
     return 0;
 }
 
+int Relation::evalStrCompare() {
+    char lBuf[12], rBuf[12];
+    return strcmp(_evalCastToCStr(&*lhs, lBuf), _evalCastToCStr(&*rhs, rBuf));
+}
+
 void Relation::dump(int level) {
     printIndents(level);
     printf("Relation(\n");
@@ -826,6 +922,10 @@ ParserContext::~ParserContext() {
         delete globalIntMemory;
         globalIntMemory = NULL;
     }
+    if (globalStrMemory) {
+        delete globalStrMemory;
+        globalStrMemory = NULL;
+    }
 }
 
 void ParserContext::addErr(int firstLine, int lastLine, int firstColumn, int lastColumn, const char* txt) {
@@ -920,4 +1020,22 @@ void ParserContext::registerBuiltInIntArrayVariables(const std::map<String,VMInt
     }
 }
 
+ExecContextSlab::ExecContextSlab(const ParserContext* parserCtx, int count) : count(count) {
+    const size_t line = 64; // assumed cache line size
+    const size_t objSize = (sizeof(ExecContext) + 15) & ~size_t(15);
+    stride = (objSize + ExecContext::memorySize(parserCtx) + line - 1) & ~(line - 1);
+    block = new char[count * stride + line];
+    base = (char*) ((uintptr_t(block) + line - 1) & ~uintptr_t(line - 1));
+    for (int i = 0; i < count; ++i) {
+        char* p = base + i * stride;
+        new (p) ExecContext(parserCtx, p + objSize);
+    }
+}
+
+ExecContextSlab::~ExecContextSlab() {
+    for (int i = 0; i < count; ++i)
+        reinterpret_cast<ExecContext*>(base + i * stride)->~ExecContext();
+    delete [] block;
+}
+
 } // namespace LinuxSampler
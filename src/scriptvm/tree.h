@@ -20,7 +20,9 @@
 #include <iostream>
 #include <map>
 #include <set>
-#include "../common/global.h"
+#include <limits.h>
+#include <string.h>
+#include "../common/global_private.h"
 #include "../common/Ref.h"
 #include "../common/ArrayList.h"
 #include "common.h"
@@ -29,6 +31,7 @@ namespace LinuxSampler {
     
 class ParserContext;
 class ExecContext;
+class VMCompiler;
 
 enum StmtType_t {
     STMT_LEAF,
@@ -60,13 +63,15 @@ public:
     ExprType_t exprType() const { return INT_EXPR; }
     virtual int evalInt() = 0;
     String evalCastToStr();
+    virtual void emitInt(VMCompiler& c);
 };
 typedef Ref<IntExpr,Node> IntExprRef;
 
 class StringExpr : virtual public VMStringExpr, virtual public Expression {
 public:
     ExprType_t exprType() const { return STRING_EXPR; }
-    virtual String evalStr() = 0;
+    virtual const char* evalCStr() = 0;
+    virtual String evalStr() { return evalCStr(); }
     String evalCastToStr() { return evalStr(); }
 };
 typedef Ref<StringExpr,Node> StringExprRef;
@@ -76,6 +81,7 @@ class IntLiteral : virtual public IntExpr {
 public:
     IntLiteral(int value) : value(value) { }
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
     bool isConstExpr() const { return true; }
     bool isPolyphonic() const { return false; }
@@ -88,7 +94,7 @@ public:
     StringLiteral(const String& value) : value(value) { }
     bool isConstExpr() const { return true; }
     void dump(int level = 0);
-    String evalStr() { return value; }
+    const char* evalCStr() { return value.c_str(); }
     bool isPolyphonic() const { return false; }
 };
 typedef Ref<StringLiteral,Node> StringLiteralRef;
@@ -108,6 +114,7 @@ class Variable : virtual public Expression {
 public:
     virtual bool isConstExpr() const { return bConst; }
     virtual void assign(Expression* expr) = 0;
+    virtual bool emitAssign(VMCompiler& c, Expression* expr) { return false; }
 protected:
     Variable(ParserContext* ctx, int _memPos, bool _bConst)
         : context(ctx), memPos(_memPos), bConst(_bConst) {}
@@ -123,7 +130,9 @@ class IntVariable : public Variable, virtual public IntExpr {
 public:
     IntVariable(ParserContext* ctx);
     void assign(Expression* expr);
+    bool emitAssign(VMCompiler& c, Expression* expr);
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
     bool isPolyphonic() const { return polyphonic; }
 protected:
@@ -138,7 +147,9 @@ public:
     ConstIntVariable(int value);
     //ConstIntVariable(ParserContext* ctx, int value = 0);
     void assign(Expression* expr);
+    bool emitAssign(VMCompiler& c, Expression* expr) { return false; }
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<ConstIntVariable,Node> ConstIntVariableRef;
@@ -197,7 +208,9 @@ class IntArrayElement : public IntVariable {
 public:
     IntArrayElement(IntArrayVariableRef array, IntExprRef arrayIndex);
     void assign(Expression* expr);
+    bool emitAssign(VMCompiler& c, Expression* expr);
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<IntArrayElement,Node> IntArrayElementRef;
@@ -206,7 +219,7 @@ class StringVariable : public Variable, virtual public StringExpr {
 public:
     StringVariable(ParserContext* ctx);
     void assign(Expression* expr);
-    String evalStr();
+    const char* evalCStr();
     void dump(int level = 0);
     bool isPolyphonic() const { return false; }
 protected:
@@ -220,7 +233,7 @@ public:
 
     ConstStringVariable(ParserContext* ctx, String value = "");
     void assign(Expression* expr);
-    String evalStr();
+    const char* evalCStr();
     void dump(int level = 0);
 };
 typedef Ref<ConstStringVariable,Node> ConstStringVariableRef;
@@ -240,6 +253,7 @@ class Add : virtual public BinaryOp, virtual public IntExpr {
 public:
     Add(IntExprRef lhs, IntExprRef rhs) : BinaryOp(lhs, rhs) { }
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<Add,Node> AddRef;
@@ -248,6 +262,7 @@ class Sub : virtual public BinaryOp, virtual public IntExpr {
 public:
     Sub(IntExprRef lhs, IntExprRef rhs) : BinaryOp(lhs, rhs) { }
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<Sub,Node> SubRef;
@@ -256,6 +271,7 @@ class Mul : virtual public BinaryOp, virtual public IntExpr {
 public:
     Mul(IntExprRef lhs, IntExprRef rhs) : BinaryOp(lhs, rhs) { }
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<Mul,Node> MulRef;
@@ -264,6 +280,7 @@ class Div : virtual public BinaryOp, virtual public IntExpr {
 public:
     Div(IntExprRef lhs, IntExprRef rhs) : BinaryOp(lhs, rhs) { }
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<Div,Node> DivRef;
@@ -272,6 +289,7 @@ class Mod : virtual public BinaryOp, virtual public IntExpr {
 public:
     Mod(IntExprRef lhs, IntExprRef rhs) : BinaryOp(lhs, rhs) { }
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<Mod,Node> ModRef;
@@ -279,6 +297,7 @@ typedef Ref<Mod,Node> ModRef;
 class Statement : virtual public Node {
 public:
     virtual StmtType_t statementType() const = 0;
+    virtual void emitStmt(VMCompiler& c) = 0;
 };
 typedef Ref<Statement,Node> StatementRef;
 
@@ -288,6 +307,7 @@ class NoOperation : public Statement {
 public:
     NoOperation() : Statement() {}
     StmtType_t statementType() const { return STMT_LEAF; }
+    void emitStmt(VMCompiler& c) {}
     void dump(int level = 0) {}
     bool isPolyphonic() const { return false; }
 };
@@ -299,6 +319,7 @@ class LeafStatement : public Statement {
 public:
     virtual StmtFlags_t exec() = 0;
     virtual StmtType_t statementType() const { return STMT_LEAF; }
+    virtual void emitStmt(VMCompiler& c);
 };
 typedef Ref<LeafStatement,Node> LeafStatementRef;
 
@@ -309,6 +330,7 @@ public:
     void dump(int level = 0);
     StmtType_t statementType() const { return STMT_LIST; }
     virtual Statement* statement(uint i);
+    void emitStmt(VMCompiler& c);
     bool isPolyphonic() const;
 };
 typedef Ref<Statements,Node> StatementsRef;
@@ -324,12 +346,16 @@ class FunctionCall : virtual public LeafStatement, virtual public IntExpr, virtu
     String functionName;
     ArgsRef args;
     VMFunction* fn;
+    ParserContext* context;
+    int profileIndex; ///< Index of this function in VMScriptProfile::functions (-1 if unknown function).
 public:
-    FunctionCall(const char* function, ArgsRef args, VMFunction* fn) :
-        functionName(function), args(args), fn(fn) { }
+    FunctionCall(ParserContext* ctx, const char* function, ArgsRef args, VMFunction* fn);
+    VMFunction* function() const { return fn; }
+    Args* arguments() const { return const_cast<Args*>(&*args); }
     void dump(int level = 0);
     StmtFlags_t exec();
     int evalInt();
+    const char* evalCStr();
     String evalStr();
     bool isConstExpr() const { return false; }
     ExprType_t exprType() const;
@@ -344,6 +370,9 @@ class EventHandler : virtual public Statements, virtual public VMEventHandler {
     StatementsRef statements;
     bool usingPolyphonics;
 public:
+    int codeEntry; ///< Position of the handler's first instruction in ParserContext::bytecode (-1 if not compiled yet).
+    int profileIndex; ///< Index of this handler in VMScriptProfile::handlers.
+
     void dump(int level = 0);
     StmtFlags_t exec();
     EventHandler(StatementsRef statements);
@@ -407,6 +436,7 @@ public:
     Assignment(VariableRef variable, ExpressionRef value);
     void dump(int level = 0);
     StmtFlags_t exec();
+    void emitStmt(VMCompiler& c);
     bool isPolyphonic() const { return (variable && variable->isPolyphonic()) || (value && value->isPolyphonic()); }
 };
 typedef Ref<Assignment,Node> AssignmentRef;
@@ -423,6 +453,7 @@ public:
     void dump(int level = 0);
     int evalBranch();
     Statements* branch(uint i) const;
+    void emitStmt(VMCompiler& c);
     bool isPolyphonic() const;
 };
 typedef Ref<If,Node> IfRef;
@@ -443,6 +474,7 @@ public:
     void dump(int level = 0);
     int evalBranch();
     Statements* branch(uint i) const;
+    void emitStmt(VMCompiler& c);
     //void addBranch(IntExprRef condition, StatementsRef statements);
     //void addBranch(IntExprRef from, IntExprRef to, StatementsRef statements);
     //void addBranch(CaseBranchRef branch);
@@ -461,6 +493,7 @@ public:
     void dump(int level = 0);
     bool evalLoopStartCondition();
     Statements* statements() const;
+    void emitStmt(VMCompiler& c);
     bool isPolyphonic() const { return m_condition->isPolyphonic() || m_statements->isPolyphonic(); }
 };
 
@@ -469,6 +502,7 @@ class Neg : public IntExpr {
 public:
     Neg(IntExprRef expr) : expr(expr) { }
     int evalInt() { return (expr) ? -expr->evalInt() : 0; }
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
     bool isConstExpr() const { return expr->isConstExpr(); }
     bool isPolyphonic() const { return expr->isPolyphonic(); }
@@ -476,10 +510,12 @@ public:
 typedef Ref<Neg,Node> NegRef;
 
 class ConcatString : public StringExpr {
+    ParserContext* context;
     ExpressionRef lhs;
     ExpressionRef rhs;
 public:
-    ConcatString(ExpressionRef lhs, ExpressionRef rhs) : lhs(lhs), rhs(rhs) {}
+    ConcatString(ParserContext* ctx, ExpressionRef lhs, ExpressionRef rhs) : context(ctx), lhs(lhs), rhs(rhs) {}
+    const char* evalCStr();
     String evalStr();
     void dump(int level = 0);
     bool isConstExpr() const;
@@ -497,15 +533,18 @@ public:
         EQUAL,
         NOT_EQUAL
     };
-    Relation(IntExprRef lhs, Type type, IntExprRef rhs) :
+    Relation(ExpressionRef lhs, Type type, ExpressionRef rhs) :
         lhs(lhs), rhs(rhs), type(type) {}
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
     bool isConstExpr() const;
     bool isPolyphonic() const { return lhs->isPolyphonic() || rhs->isPolyphonic(); }
 private:
-    IntExprRef lhs;
-    IntExprRef rhs;
+    int evalStrCompare();
+
+    ExpressionRef lhs; ///< Either integer or string expression.
+    ExpressionRef rhs; ///< Either integer or string expression.
     Type type;
 };
 typedef Ref<Relation,Node> RelationRef;
@@ -514,6 +553,7 @@ class Or : virtual public BinaryOp, virtual public IntExpr {
 public:
     Or(IntExprRef lhs, IntExprRef rhs) : BinaryOp(lhs,rhs) {}
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<Or,Node> OrRef;
@@ -522,6 +562,7 @@ class And : virtual public BinaryOp, virtual public IntExpr {
 public:
     And(IntExprRef lhs, IntExprRef rhs) : BinaryOp(lhs,rhs) {}
     int evalInt();
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
 };
 typedef Ref<And,Node> AndRef;
@@ -531,12 +572,82 @@ class Not : virtual public IntExpr {
 public:
     Not(IntExprRef expr) : expr(expr) {}
     int evalInt() { return !expr->evalInt(); }
+    void emitInt(VMCompiler& c);
     void dump(int level = 0);
     bool isConstExpr() const { return expr->isConstExpr(); }
     bool isPolyphonic() const { return expr->isPolyphonic(); }
 };
 typedef Ref<Not,Node> NotRef;
 
+/**
+ * Instructions of the bytecode the event handlers are compiled to. All
+ * integer operands are passed on the VM's value stack, which is always empty
+ * between two statements.
+ */
+enum VMOpcode_t {
+    OP_PUSH,       ///< Push constant @c arg.
+    OP_LOAD,       ///< Push global integer variable at @c ptr.
+    OP_LOAD_POLY,  ///< Push polyphonic integer variable at position @c arg.
+    OP_LOAD_ELEM,  ///< Replace array index on top of stack by the element of IntArrayVariable @c ptr.
+    OP_STORE,      ///< Pop value and store it to global integer variable at @c ptr.
+    OP_STORE_POLY, ///< Pop value and store it to polyphonic integer variable at position @c arg.
+    OP_STORE_ELEM, ///< Pop array index and value and store the value to IntArrayVariable @c ptr.
+    OP_EVAL_INT,   ///< Push result of IntExpr @c ptr, evaluated by the parser tree.
+    OP_EXEC,       ///< Execute LeafStatement @c ptr by the parser tree.
+    OP_DUP,
+    OP_POP,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_NEG,
+    OP_NOT,
+    OP_BOOL,       ///< Replace top of stack by 1 if it is non-zero.
+    OP_LT,
+    OP_GT,
+    OP_LE,
+    OP_GE,
+    OP_EQ,
+    OP_NE,
+    OP_BETWEEN,    ///< Pop upper and lower limit and replace top of stack by 1 if it is inside the limits, 0 otherwise.
+    OP_JMP,        ///< Continue with instruction @c arg.
+    OP_JZ,         ///< Pop value and continue with instruction @c arg if it is zero.
+    OP_JNZ,        ///< Pop value and continue with instruction @c arg if it is non-zero.
+    OP_LOOP,       ///< Continue with instruction @c arg (back edge of a loop), or suspend there if the execution budget is exhausted.
+    OP_RETURN,     ///< End of event handler.
+    OP_COUNT
+};
+
+struct VMInstr {
+    const void* handler; ///< Address of the opcode's implementation in the interpreter loop (only if it dispatches by computed gotos).
+    VMOpcode_t op;
+    int arg;
+    void* ptr;
+};
+
+/** @brief Generates the bytecode of a script.
+ *
+ * Used by the emitInt() and emitStmt() methods of the parser tree nodes
+ * to append their instructions to the script's bytecode. Nodes which are
+ * not worth to be compiled (i.e. string expressions and built-in function
+ * calls) emit an OP_EVAL_INT or OP_EXEC instruction instead, which lets the
+ * parser tree evaluate the node at runtime.
+ */
+class VMCompiler {
+public:
+    VMCompiler(std::vector<VMInstr>& code) : code(code), depth(0), maxDepth(0) {}
+    int emit(VMOpcode_t op, int arg = 0, void* ptr = NULL);
+    int pos() const { return code.size(); }
+    void patch(int instr, int target) { code[instr].arg = target; }
+    void adjustDepth(int n) { depth += n; }
+    int requiredStackSize() const { return maxDepth; }
+private:
+    std::vector<VMInstr>& code;
+    int depth;
+    int maxDepth;
+};
+
 class ParserContext : public VMParserContext {
 public:
     struct Error {
@@ -567,8 +678,11 @@ public:
     OnControllerRef onController;
 
     ArrayList<int>* globalIntMemory;
-    ArrayList<String>* globalStrMemory;
+    ArrayList<char>* globalStrMemory; ///< Fixed size slots of CONFIG_MAX_SCRIPT_STRING_LENGTH characters for the global string variables.
+    std::vector<VMInstr> bytecode;
     int requiredMaxStackSize;
+    std::vector<String> calledFunctions; ///< Names of all built-in functions called by the script (order of VMScriptProfile::functions).
+    bool strTruncationReported; ///< Whether truncation of a string at runtime was already reported (only reported once per script).
 
     VMFunctionProvider* functionProvider;
 
@@ -578,7 +692,7 @@ public:
         scanner(NULL), is(NULL),
         globalIntVarCount(0), globalStrVarCount(0), polyphonicIntVarCount(0),
         globalIntMemory(NULL), globalStrMemory(NULL), requiredMaxStackSize(-1),
-        functionProvider(parent), execContext(NULL)
+        strTruncationReported(false), functionProvider(parent), execContext(NULL)
     {
     }
     virtual ~ParserContext();
@@ -605,53 +719,122 @@ public:
 
 class ExecContext : public VMExecContext {
 public:
-    struct StackFrame {
-        Statement* statement;
-        int subindex;
-
-        StackFrame() {
-            statement = NULL;
-            subindex  = -1;
-        }
-    };
-
-    ArrayList<int> polyphonicIntMemory;
+    int* polyphonicIntMemory; ///< Values of the script's polyphonic variables (at the fixed offsets assigned by the parser).
     VMExecStatus_t status;
-    ArrayList<StackFrame> stack;
-    int stackFrame;
+    int* stack; ///< Value stack of the bytecode interpreter.
+    int pc; ///< Bytecode position to resume execution at (-1 if not running).
     int suspendMicroseconds;
+    int instructionsExecuted; ///< Amount of VM instructions executed by the last execBytecode() call.
+    int budgetCheckAt; ///< Amount of executed instructions after which the execution budget has to be checked next.
+    int maxInstructions; ///< Max. amount of instructions the current execBytecode() call may execute (0: unlimited).
+    uint64_t deadline; ///< Time (RTMath::MicroSecondsNow()) at which the current execBytecode() call must have suspended (0: unlimited).
+    bool preempted; ///< Whether the last execBytecode() call was suspended because it exhausted its execution budget.
+    VMScriptProfile* profile;
+    char* strArena; ///< Memory for temporary strings (i.e. results of string concatenations) of the currently executed statement.
+    int strArenaSize;
+    int strArenaUsed;
+
+    /**
+     * Creates an execution context for the script given by @a parserCtx.
+     * The polyphonic variable memory, the value stack and the string arena
+     * are placed in one block of memory of memorySize() bytes: in
+     * @a memory if supplied (i.e. by ExecContextSlab), otherwise the
+     * context allocates that block by itself.
+     */
+    ExecContext(const ParserContext* parserCtx, char* memory = NULL) :
+        status(VM_EXEC_NOT_RUNNING), pc(-1), suspendMicroseconds(0),
+        instructionsExecuted(0), budgetCheckAt(INT_MAX), maxInstructions(0),
+        deadline(0), preempted(false), profile(NULL),
+        strArenaSize(CONFIG_SCRIPT_STRING_ARENA_SIZE), strArenaUsed(0),
+        ownMemory(NULL)
+    {
+        if (!memory) memory = ownMemory = new char[memorySize(parserCtx)];
+        const int polySize = parserCtx->polyphonicIntVarCount;
+        polyphonicIntMemory = (int*) memory;
+        memset(polyphonicIntMemory, 0, polySize * sizeof(int));
+        stack = polyphonicIntMemory + polySize;
+        strArena = (char*) (stack + stackSize(parserCtx));
+    }
 
-    ExecContext() :
-        status(VM_EXEC_NOT_RUNNING), stackFrame(-1), suspendMicroseconds(0) {}
+    virtual ~ExecContext() {
+        if (ownMemory) delete [] ownMemory;
+    }
 
-    virtual ~ExecContext() {}
+    /// Size of the value stack (in elements) required by the script.
+    static int stackSize(const ParserContext* parserCtx) {
+        return (parserCtx->requiredMaxStackSize > 1) ? parserCtx->requiredMaxStackSize : 1;
+    }
 
-    inline void pushStack(Statement* stmt) {
-        stackFrame++;
-        //printf("pushStack() -> %d\n", stackFrame);
-        if (stackFrame >= stack.size()) return;
-        stack[stackFrame].statement = stmt;
-        stack[stackFrame].subindex  = 0;
+    /// Size of the memory block (in bytes) for an execution context of the script.
+    static size_t memorySize(const ParserContext* parserCtx) {
+        return (parserCtx->polyphonicIntVarCount + stackSize(parserCtx)) * sizeof(int) +
+               CONFIG_SCRIPT_STRING_ARENA_SIZE;
     }
 
-    inline void popStack() {
-        stack[stackFrame].statement = NULL;
-        stack[stackFrame].subindex  = -1;
-        stackFrame--;
-        //printf("popStack() -> %d\n", stackFrame);
+    /**
+     * Returns memory for a temporary string of @a size bytes (including the
+     * terminating zero) from the string arena. If the arena does not have
+     * that much memory left, @a size is reduced accordingly.
+     */
+    inline char* allocStr(int& size) {
+        const int left = strArenaSize - strArenaUsed;
+        if (size > left) size = left;
+        char* s = &strArena[strArenaUsed];
+        strArenaUsed += size;
+        return s;
+    }
+
+    /// Releases all temporary strings.
+    inline void resetStrArena() {
+        strArenaUsed = 0;
     }
 
     inline void reset() {
-        stack[0].statement = NULL;
-        stack[0].subindex  = -1;
-        stackFrame = -1;
+        pc = -1;
     }
 
     int suspensionTimeMicroseconds() const OVERRIDE {
         return suspendMicroseconds;
     }
+
+    void setProfile(VMScriptProfile* profile) OVERRIDE {
+        this->profile = profile;
+    }
+
+private:
+    char* ownMemory; ///< Memory block allocated by this context itself (NULL if it is part of an ExecContextSlab).
+};
+
+/** @brief Contiguous block of execution contexts of one script.
+ *
+ * Places all its execution contexts in one contiguous block of memory, each
+ * context aligned to a cache line and directly followed by its polyphonic
+ * variable memory, value stack and string arena.
+ */
+class ExecContextSlab : public VMExecContextSlab {
+public:
+    ExecContextSlab(const ParserContext* parserCtx, int count);
+    virtual ~ExecContextSlab();
+
+    int size() const OVERRIDE {
+        return count;
+    }
+
+    VMExecContext* execContext(int index) OVERRIDE {
+        return reinterpret_cast<ExecContext*>(base + index * stride);
+    }
+
+private:
+    char* block;
+    char* base; ///< Start of the first context (cache line aligned).
+    size_t stride; ///< Distance (in bytes) between two contexts.
+    int count;
 };
 
+void compileBytecode(ParserContext* context);
+StmtFlags_t execBytecode(const VMInstr* code, ExecContext* ctx);
+void dumpBytecode(const std::vector<VMInstr>& code);
+
 } // namespace LinuxSampler
 
 #endif // LS_INSTRPARSERTREE_H
@@ -0,0 +1,161 @@
+#include "InstrumentScriptVMFunctionsTest.h"
+
+#include "../scriptvm/tree.h"
+
+#include <iostream>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InstrumentScriptVMFunctionsTest);
+
+using namespace std;
+using namespace LinuxSampler;
+
+// engine channel which just records the notes scheduled by the script, the
+// note with the key given by failingKey is rejected as if the engine's note
+// pool was empty
+class TestEngineChannel : public AbstractEngineChannel {
+    public:
+        vector<int> scheduledKeys;
+        int failingKey;
+
+        TestEngineChannel() : failingKey(-1), nextNoteID(1) {}
+
+        virtual note_id_t ScheduleNoteMicroSec(const Event* pEvent, int delay) OVERRIDE {
+            if (pEvent->Param.Note.Key == failingKey) return 0;
+            scheduledKeys.push_back(pEvent->Param.Note.Key);
+            return nextNoteID++;
+        }
+
+        virtual void IgnoreNote(note_id_t id) OVERRIDE {}
+        virtual void Connect(AudioOutputDevice* pAudioOut) OVERRIDE {}
+        virtual void DisconnectAudioOutputDevice() OVERRIDE {}
+        virtual void LoadInstrument() OVERRIDE {}
+        virtual void SendProgramChange(uint8_t Program) OVERRIDE {}
+        virtual AbstractEngine::Format GetEngineFormat() OVERRIDE { return AbstractEngine::SFZ; }
+        virtual MidiKeyboardManagerBase* GetMidiKeyboardManager() OVERRIDE { return NULL; }
+
+    private:
+        note_id_t nextNoteID;
+};
+
+// gives the tests access to the event currently executed by the VM
+class TestInstrumentScriptVM : public InstrumentScriptVM {
+    public:
+        void setEvent(ScriptEvent* event) { m_event = event; }
+};
+
+// Note:
+// we have to declare all those variables which we want to use for all
+// tests within this test suite static because there are side effects which
+// occur on transition to the next test which would change the values of our
+// variables
+static TestInstrumentScriptVM* pVM = NULL;
+static TestEngineChannel*      pEngineChannel = NULL;
+static VMParserContext*        pParserContext = NULL;
+static VMExecContext*          pExecContext = NULL;
+
+static const char* script =
+    "on init\n"
+    "  declare %keys[6] := (60, -1, 128, 61, 62, 63)\n"
+    "  declare %ids[6] := (-5, -5, -5, -5, -5, -5)\n"
+    "  declare %fewIDs[2] := (-5, -5)\n"
+    "  declare $triggered\n"
+    "end on\n"
+    "\n"
+    "on note\n"
+    "  $triggered := play_notes(%keys, %ids)\n"
+    "end on\n"
+    "\n"
+    "on release\n"
+    "  $triggered := play_notes(%keys, %fewIDs)\n"
+    "end on\n";
+
+// runs the given event handler of the script on pEngineChannel
+static VMExecStatus_t runHandler(const String& name) {
+    VMEventHandler* handler = pParserContext->eventHandlerByName(name);
+    CPPUNIT_ASSERT(handler != NULL);
+    ScriptEvent event;
+    event.cause.Init();
+    event.cause.Type = Event::type_note_on;
+    event.cause.pEngineChannel = pEngineChannel;
+    event.execCtx = pExecContext;
+    pVM->setEvent(&event);
+    return pVM->ScriptVM::exec(pParserContext, pExecContext, handler);
+}
+
+// returns the current value of the given global variable of the script
+static int intVariable(const String& name) {
+    ParserContext* ctx = dynamic_cast<ParserContext*>(pParserContext);
+    IntVariable* var = dynamic_cast<IntVariable*>(&*ctx->vartable[name]);
+    CPPUNIT_ASSERT(var != NULL);
+    return var->evalInt();
+}
+
+// returns the current value of the given global array variable of the script
+static int intArrayElement(const String& name, int i) {
+    ParserContext* ctx = dynamic_cast<ParserContext*>(pParserContext);
+    IntArrayVariable* var = dynamic_cast<IntArrayVariable*>(&*ctx->vartable[name]);
+    CPPUNIT_ASSERT(var != NULL);
+    return var->evalIntElement(i);
+}
+
+
+// InstrumentScriptVMFunctionsTest
+
+void InstrumentScriptVMFunctionsTest::printTestSuiteName() {
+    cout << "\b \nRunning InstrumentScriptVM Functions Tests: " << flush;
+}
+
+void InstrumentScriptVMFunctionsTest::testLoadScript() {
+    pVM = new TestInstrumentScriptVM;
+    pEngineChannel = new TestEngineChannel;
+    pParserContext = pVM->loadScript(script);
+    CPPUNIT_ASSERT(pParserContext != NULL);
+    CPPUNIT_ASSERT(pParserContext->errors().empty());
+    pExecContext = pVM->createExecContext(pParserContext);
+    CPPUNIT_ASSERT(pExecContext != NULL);
+    CPPUNIT_ASSERT(runHandler("init") == VM_EXEC_NOT_RUNNING);
+}
+
+void InstrumentScriptVMFunctionsTest::testPlayNotesIDs() {
+    pEngineChannel->failingKey = 62;
+    CPPUNIT_ASSERT(runHandler("note") == VM_EXEC_NOT_RUNNING);
+
+    // invalid keys are skipped, the engine failed to schedule key 62
+    CPPUNIT_ASSERT(pEngineChannel->scheduledKeys.size() == 3);
+    CPPUNIT_ASSERT(pEngineChannel->scheduledKeys[0] == 60);
+    CPPUNIT_ASSERT(pEngineChannel->scheduledKeys[1] == 61);
+    CPPUNIT_ASSERT(pEngineChannel->scheduledKeys[2] == 63);
+    CPPUNIT_ASSERT(intVariable("$triggered") == 3);
+
+    // triggered notes get their note ID, all other elements a plain 0
+    CPPUNIT_ASSERT(intArrayElement("%ids", 0) == (int) ScriptID::fromNoteID(1));
+    CPPUNIT_ASSERT(intArrayElement("%ids", 1) == 0);
+    CPPUNIT_ASSERT(intArrayElement("%ids", 2) == 0);
+    CPPUNIT_ASSERT(intArrayElement("%ids", 3) == (int) ScriptID::fromNoteID(2));
+    CPPUNIT_ASSERT(intArrayElement("%ids", 4) == 0);
+    CPPUNIT_ASSERT(intArrayElement("%ids", 5) == (int) ScriptID::fromNoteID(3));
+}
+
+void InstrumentScriptVMFunctionsTest::testPlayNotesShortIDArray() {
+    pEngineChannel->failingKey = -1;
+    pEngineChannel->scheduledKeys.clear();
+    CPPUNIT_ASSERT(runHandler("release") == VM_EXEC_NOT_RUNNING);
+
+    // all notes are triggered, but only the first IDs are returned
+    CPPUNIT_ASSERT(pEngineChannel->scheduledKeys.size() == 4);
+    CPPUNIT_ASSERT(intVariable("$triggered") == 4);
+    CPPUNIT_ASSERT(intArrayElement("%fewIDs", 0) == (int) ScriptID::fromNoteID(4));
+    CPPUNIT_ASSERT(intArrayElement("%fewIDs", 1) == 0);
+}
+
+void InstrumentScriptVMFunctionsTest::testUnloadScript() {
+    delete pExecContext;
+    pExecContext = NULL;
+    delete pParserContext;
+    pParserContext = NULL;
+    delete pEngineChannel;
+    pEngineChannel = NULL;
+    delete pVM;
+    pVM = NULL;
+}
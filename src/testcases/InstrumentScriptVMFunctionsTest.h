@@ -0,0 +1,28 @@
+#ifndef __LS_INSTRUMENTSCRIPTVMFUNCTIONSTEST_H__
+#define __LS_INSTRUMENTSCRIPTVMFUNCTIONSTEST_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../engines/AbstractEngineChannel.h"
+#include "../engines/common/InstrumentScriptVM.h"
+
+class InstrumentScriptVMFunctionsTest : public CppUnit::TestFixture {
+
+    CPPUNIT_TEST_SUITE(InstrumentScriptVMFunctionsTest);
+    CPPUNIT_TEST(printTestSuiteName);
+    CPPUNIT_TEST(testLoadScript);
+    CPPUNIT_TEST(testPlayNotesIDs);
+    CPPUNIT_TEST(testPlayNotesShortIDArray);
+    CPPUNIT_TEST(testUnloadScript);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void printTestSuiteName();
+        void testLoadScript();
+        void testPlayNotesIDs();
+        void testPlayNotesShortIDArray();
+        void testUnloadScript();
+};
+
+#endif // __LS_INSTRUMENTSCRIPTVMFUNCTIONSTEST_H__
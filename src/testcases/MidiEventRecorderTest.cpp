@@ -0,0 +1,227 @@
+#include "MidiEventRecorderTest.h"
+
+#include "../drivers/audio/AudioOutputDeviceFactory.h"
+
+#include <iostream>
+#include <stdio.h>
+#include <unistd.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MidiEventRecorderTest);
+
+using namespace std;
+using namespace LinuxSampler;
+
+#define CAPTURE_FILE  "linuxsamplertest.lsmc"
+
+static vector<uint8_t> readFile(const char* fileName) {
+    vector<uint8_t> data;
+    FILE* hFile = fopen(fileName, "rb");
+    CPPUNIT_ASSERT(hFile != NULL);
+    uint8_t buf[4096];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), hFile)) > 0; )
+        data.insert(data.end(), buf, buf + n);
+    fclose(hFile);
+    return data;
+}
+
+static vector<MidiEventRecorder::CapturedEvent> parseFile(const char* fileName) {
+    vector<MidiEventRecorder::CapturedEvent> records;
+    uint sampleRate = 1;
+    vector<uint8_t> data = readFile(fileName);
+    CPPUNIT_ASSERT(MidiEventRecorder::IsCaptureFile(data));
+    MidiEventRecorder::Parse(data, records, sampleRate);
+    CPPUNIT_ASSERT(sampleRate == 0); // recorded without clock
+    return records;
+}
+
+
+// RecordingThread
+
+MidiEventRecorderTest::RecordingThread::RecordingThread(MidiEventRecorder* pRecorder, int channel, int events)
+    : Thread(false, false, 0, -4)
+{
+    this->pRecorder = pRecorder;
+    this->channel   = channel;
+    this->events    = events;
+}
+
+int MidiEventRecorderTest::RecordingThread::Main() {
+    for (int i = 0; i < events; ++i) {
+        const uint8_t event[3] = { uint8_t(0x90 | channel), uint8_t(i & 0x7f), uint8_t((i >> 7) & 0x7f) };
+        pRecorder->Record(event, 3, i);
+    }
+    return 0;
+}
+
+
+// MidiEventRecorderTest
+
+void MidiEventRecorderTest::printTestSuiteName() {
+    cout << "\b \nRunning MidiEventRecorder Tests: " << flush;
+}
+
+void MidiEventRecorderTest::testRecordAndParse() {
+    const uint8_t noteOn[3]  = { 0x90, 60, 100 };
+    const uint8_t noteOff[3] = { 0x80, 60, 0 };
+    const uint8_t sysex[6]   = { 0xf0, 0x7e, 0x7f, 0x09, 0x01, 0xf7 };
+    MidiEventRecorder* pRecorder = new MidiEventRecorder(CAPTURE_FILE, NULL);
+    pRecorder->Record(noteOn, 3, 17);
+    pRecorder->Record(sysex, 6, -1);
+    pRecorder->Record(noteOff, 3, 0);
+    pRecorder->Record(noteOff, 0, 5); // empty events are ignored
+    CPPUNIT_ASSERT(pRecorder->DroppedEvents() == 0);
+    delete pRecorder; // writes all pending events
+
+    vector<MidiEventRecorder::CapturedEvent> records = parseFile(CAPTURE_FILE);
+    CPPUNIT_ASSERT(records.size() == 3);
+    CPPUNIT_ASSERT(records[0].fragmentPos == 17);
+    CPPUNIT_ASSERT(records[0].data == vector<uint8_t>(noteOn, noteOn + 3));
+    CPPUNIT_ASSERT(records[1].fragmentPos == -1);
+    CPPUNIT_ASSERT(records[1].data == vector<uint8_t>(sysex, sysex + 6));
+    CPPUNIT_ASSERT(records[2].fragmentPos == 0);
+    CPPUNIT_ASSERT(records[2].data == vector<uint8_t>(noteOff, noteOff + 3));
+    for (int i = 0; i < records.size(); ++i)
+        CPPUNIT_ASSERT(records[i].frame == 0);
+    unlink(CAPTURE_FILE);
+}
+
+void MidiEventRecorderTest::testRecordFromSeveralThreads() {
+    const int threads = 4;
+    const int events  = 2000; // each, more than fit into a ring buffer at once
+    MidiEventRecorder* pRecorder = new MidiEventRecorder(CAPTURE_FILE, NULL);
+    RecordingThread* recordingThreads[threads];
+    for (int i = 0; i < threads; ++i)
+        recordingThreads[i] = new RecordingThread(pRecorder, i, events);
+    for (int i = 0; i < threads; ++i)
+        recordingThreads[i]->StartThread();
+    // this thread records as well
+    const uint8_t allNotesOff[3] = { 0xb0 | threads, 123, 0 };
+    pRecorder->Record(allNotesOff, 3, -1);
+    for (int i = 0; i < threads; ++i) {
+        while (recordingThreads[i]->IsRunning()) usleep(1000);
+        delete recordingThreads[i];
+    }
+    const uint dropped = pRecorder->DroppedEvents();
+    delete pRecorder;
+
+    // events of each thread must be complete and in order, the writer
+    // thread might have fallen behind, but must not have lost anything
+    // without counting it
+    vector<MidiEventRecorder::CapturedEvent> records = parseFile(CAPTURE_FILE);
+    CPPUNIT_ASSERT(records.size() + dropped == threads * events + 1);
+    int next[threads + 1] = {};
+    uint32_t sequence[threads] = {};
+    for (int i = 0; i < records.size(); ++i) {
+        CPPUNIT_ASSERT(records[i].data.size() == 3);
+        const int channel = records[i].data[0] & 0x0f;
+        CPPUNIT_ASSERT(channel <= threads);
+        if (channel == threads) {
+            CPPUNIT_ASSERT(records[i].data == vector<uint8_t>(allNotesOff, allNotesOff + 3));
+            ++next[threads];
+            continue;
+        }
+        const int event = records[i].data[1] | (records[i].data[2] << 7);
+        CPPUNIT_ASSERT(records[i].fragmentPos == event);
+        CPPUNIT_ASSERT(event >= next[channel]);
+        CPPUNIT_ASSERT(!next[channel] || records[i].sequence > sequence[channel]);
+        next[channel] = event + 1;
+        sequence[channel] = records[i].sequence;
+    }
+    CPPUNIT_ASSERT(next[threads] == 1);
+    unlink(CAPTURE_FILE);
+}
+
+void MidiEventRecorderTest::testRecordFromManyThreads() {
+    // more threads than ring buffers, but never more than one at a time
+    const int threads = 20;
+    MidiEventRecorder* pRecorder = new MidiEventRecorder(CAPTURE_FILE, NULL);
+    for (int i = 0; i < threads; ++i) {
+        RecordingThread* pThread = new RecordingThread(pRecorder, i & 0x0f, 1);
+        pThread->StartThread();
+        while (pThread->IsRunning()) usleep(1000);
+        delete pThread;
+    }
+    CPPUNIT_ASSERT(pRecorder->DroppedEvents() == 0);
+    delete pRecorder;
+
+    vector<MidiEventRecorder::CapturedEvent> records = parseFile(CAPTURE_FILE);
+    CPPUNIT_ASSERT(records.size() == threads);
+    for (int i = 0; i < threads; ++i)
+        CPPUNIT_ASSERT(records[i].data[0] == (0x90 | (i & 0x0f)));
+    unlink(CAPTURE_FILE);
+}
+
+void MidiEventRecorderTest::testClock() {
+    map<String,String> audioParams;
+    audioParams["ACTIVE"]       = "false";
+    audioParams["SAMPLERATE"]   = "48000";
+    audioParams["FRAGMENTSIZE"] = "256";
+    audioParams["FORMAT"]       = "NONE";
+    audioParams["FRAMES"]       = "1024";
+    AudioOutputDevice* pAudioDevice = AudioOutputDeviceFactory::Create("FILE", audioParams);
+    CPPUNIT_ASSERT(pAudioDevice != NULL);
+
+    const uint8_t noteOn[3]  = { 0x90, 60, 100 };
+    const uint8_t noteOff[3] = { 0x80, 60, 0 };
+    MidiEventRecorder* pRecorder = new MidiEventRecorder(CAPTURE_FILE, pAudioDevice);
+    pAudioDevice->Play();
+    while (pAudioDevice->IsPlaying()) usleep(1000);
+    pRecorder->Record(noteOn, 3, -1);
+    // the recorder must survive its clock
+    AudioOutputDeviceFactory::Destroy(pAudioDevice);
+    pRecorder->Record(noteOff, 3, 10);
+    delete pRecorder;
+
+    vector<MidiEventRecorder::CapturedEvent> records;
+    uint sampleRate = 0;
+    MidiEventRecorder::Parse(readFile(CAPTURE_FILE), records, sampleRate);
+    CPPUNIT_ASSERT(sampleRate == 48000);
+    CPPUNIT_ASSERT(records.size() == 2);
+    // time stamp of the last audio fragment cycle
+    CPPUNIT_ASSERT(records[0].frame == 768);
+    CPPUNIT_ASSERT(records[0].fragmentPos == -1);
+    CPPUNIT_ASSERT(records[1].frame == 768);
+    CPPUNIT_ASSERT(records[1].fragmentPos == 10);
+    unlink(CAPTURE_FILE);
+}
+
+void MidiEventRecorderTest::testParseInvalidFiles() {
+    vector<MidiEventRecorder::CapturedEvent> records;
+    uint sampleRate;
+
+    const uint8_t smf[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96 };
+    vector<uint8_t> data(smf, smf + sizeof(smf));
+    CPPUNIT_ASSERT(!MidiEventRecorder::IsCaptureFile(data));
+    CPPUNIT_ASSERT_THROW(MidiEventRecorder::Parse(data, records, sampleRate), MidiInputException);
+
+    // valid header with 44100 Hz, followed by a truncated record
+    const uint8_t capture[] = {
+        'L', 'S', 'M', 'C', 1, 0, 0, 0, 0x44, 0xac, 0, 0,
+        1, 0, 0, 0, 0, 0, 0, 0,  3, 0, 0, 0,  0, 0, 0, 0,  3, 0,  0x90, 60, 100,
+        2, 0, 0, 0, 0, 0, 0, 0,  4, 0, 0, 0,  1, 0, 0, 0,  3, 0,  0x80, 60
+    };
+    data.assign(capture, capture + sizeof(capture));
+    CPPUNIT_ASSERT(MidiEventRecorder::IsCaptureFile(data));
+    CPPUNIT_ASSERT_THROW(MidiEventRecorder::Parse(data, records, sampleRate), MidiInputException);
+
+    // without the truncated record it is fine
+    data.resize(data.size() - 20);
+    MidiEventRecorder::Parse(data, records, sampleRate);
+    CPPUNIT_ASSERT(sampleRate == 44100);
+    CPPUNIT_ASSERT(records.size() == 1);
+    CPPUNIT_ASSERT(records[0].frame == 1);
+    CPPUNIT_ASSERT(records[0].fragmentPos == 3);
+
+    // records are returned in the order they were recorded
+    const uint8_t noteOff[] = { 2, 0, 0, 0, 0, 0, 0, 0,  4, 0, 0, 0,  0, 0, 0, 0,  3, 0,  0x80, 60, 0 };
+    data[24] = 1; // sequence number of the note on
+    data.insert(data.end(), noteOff, noteOff + sizeof(noteOff));
+    MidiEventRecorder::Parse(data, records, sampleRate);
+    CPPUNIT_ASSERT(records.size() == 2);
+    CPPUNIT_ASSERT(records[0].sequence == 0 && records[0].data[0] == 0x80);
+    CPPUNIT_ASSERT(records[1].sequence == 1 && records[1].data[0] == 0x90);
+
+    // unknown format version
+    data[4] = 2;
+    CPPUNIT_ASSERT_THROW(MidiEventRecorder::Parse(data, records, sampleRate), MidiInputException);
+}
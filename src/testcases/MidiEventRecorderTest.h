@@ -0,0 +1,41 @@
+#ifndef __LS_MIDIEVENTRECORDERTEST_H__
+#define __LS_MIDIEVENTRECORDERTEST_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../drivers/midi/MidiEventRecorder.h"
+
+class MidiEventRecorderTest : public CppUnit::TestFixture {
+
+    CPPUNIT_TEST_SUITE(MidiEventRecorderTest);
+    CPPUNIT_TEST(printTestSuiteName);
+    CPPUNIT_TEST(testRecordAndParse);
+    CPPUNIT_TEST(testRecordFromSeveralThreads);
+    CPPUNIT_TEST(testRecordFromManyThreads);
+    CPPUNIT_TEST(testClock);
+    CPPUNIT_TEST(testParseInvalidFiles);
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        // records a sequence of note on events on its own MIDI channel
+        class RecordingThread : public LinuxSampler::Thread {
+            public:
+                RecordingThread(LinuxSampler::MidiEventRecorder* pRecorder, int channel, int events);
+                int Main();
+            private:
+                LinuxSampler::MidiEventRecorder* pRecorder;
+                int channel;
+                int events;
+        };
+
+    public:
+        void printTestSuiteName();
+        void testRecordAndParse();
+        void testRecordFromSeveralThreads();
+        void testRecordFromManyThreads();
+        void testClock();
+        void testParseInvalidFiles();
+};
+
+#endif // __LS_MIDIEVENTRECORDERTEST_H__
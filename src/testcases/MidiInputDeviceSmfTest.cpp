@@ -0,0 +1,255 @@
+#include "MidiInputDeviceSmfTest.h"
+
+#include "../drivers/audio/AudioOutputDeviceFactory.h"
+#include "../drivers/midi/MidiInputDeviceFactory.h"
+#include "../engines/AbstractEngineChannel.h"
+
+#include <iostream>
+#include <stdio.h>
+#include <unistd.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MidiInputDeviceSmfTest);
+
+using namespace std;
+using namespace LinuxSampler;
+
+#define MIDI_FILE     "linuxsamplertest.mid"
+#define SAMPLE_RATE   48000
+#define FRAGMENT_SIZE 256
+
+// one MIDI event received by RecordingEngineChannel
+struct ReceivedEvent {
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+    int64_t frame; ///< position on the audio device's sample clock, -1 if dispatched without fragment position
+};
+
+// engine channel which just records all MIDI events it receives
+class RecordingEngineChannel : public AbstractEngineChannel {
+    public:
+        vector<ReceivedEvent> events;
+        AudioOutputDevice* pClock;
+
+        virtual void SendNoteOn(uint8_t Key, uint8_t Velocity, uint8_t MidiChannel) OVERRIDE {
+            add(0x90 | MidiChannel, Key, Velocity, -1);
+        }
+        virtual void SendNoteOn(uint8_t Key, uint8_t Velocity, uint8_t MidiChannel, int32_t FragmentPos) OVERRIDE {
+            add(0x90 | MidiChannel, Key, Velocity, FragmentPos);
+        }
+        virtual void SendNoteOff(uint8_t Key, uint8_t Velocity, uint8_t MidiChannel) OVERRIDE {
+            add(0x80 | MidiChannel, Key, Velocity, -1);
+        }
+        virtual void SendNoteOff(uint8_t Key, uint8_t Velocity, uint8_t MidiChannel, int32_t FragmentPos) OVERRIDE {
+            add(0x80 | MidiChannel, Key, Velocity, FragmentPos);
+        }
+        virtual void SendControlChange(uint8_t Controller, uint8_t Value, uint8_t MidiChannel, int32_t FragmentPos) OVERRIDE {
+            add(0xb0 | MidiChannel, Controller, Value, FragmentPos);
+        }
+
+        virtual note_id_t ScheduleNoteMicroSec(const Event* pEvent, int delay) OVERRIDE { return 0; }
+        virtual void IgnoreNote(note_id_t id) OVERRIDE {}
+        virtual void Connect(AudioOutputDevice* pAudioOut) OVERRIDE {}
+        virtual void DisconnectAudioOutputDevice() OVERRIDE {}
+        virtual void LoadInstrument() OVERRIDE {}
+        virtual void SendProgramChange(uint8_t Program) OVERRIDE {}
+        virtual AbstractEngine::Format GetEngineFormat() OVERRIDE { return AbstractEngine::SFZ; }
+        virtual MidiKeyboardManagerBase* GetMidiKeyboardManager() OVERRIDE { return NULL; }
+
+        using AbstractEngineChannel::Connect;
+
+    private:
+        void add(uint8_t status, uint8_t data1, uint8_t data2, int32_t FragmentPos) {
+            ReceivedEvent event = { status, data1, data2, -1 };
+            if (FragmentPos >= 0) event.frame = int64_t(pClock->FrameTime()) + FragmentPos;
+            events.push_back(event);
+        }
+};
+
+// writes the given bytes to MIDI_FILE
+static void writeFile(const uint8_t* data, size_t size) {
+    FILE* hFile = fopen(MIDI_FILE, "wb");
+    CPPUNIT_ASSERT(hFile != NULL);
+    CPPUNIT_ASSERT(fwrite(data, 1, size, hFile) == size);
+    fclose(hFile);
+}
+
+// format 1 file with 96 ticks per quarter note: a tempo track starting at
+// 120 bpm and switching to 240 bpm after two quarter notes (1 s), and one
+// note track using running status and note-on with velocity 0 as note-off
+static void writeTestFile() {
+    const uint8_t smf[] = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6,  0, 1,  0, 2,  0, 96,
+        'M', 'T', 'r', 'k', 0, 0, 0, 19,
+            0x00, 0xff, 0x51, 3, 0x07, 0xa1, 0x20,     // tempo 500000 us
+            0x81, 0x40, 0xff, 0x51, 3, 0x03, 0xd0, 0x90, // tempo 250000 us at tick 192
+            0x00, 0xff, 0x2f, 0,
+        'M', 'T', 'r', 'k', 0, 0, 0, 23,
+            0x00, 0x90, 60, 100,                       // tick 0:   0 s
+            0x60, 60, 0,                               // tick 96:  0.5 s
+            0x60, 0xb1, 7, 90,                         // tick 192: 1 s
+            0x60, 0x90, 62, 80,                        // tick 288: 1.25 s
+            0x60, 0x80, 62, 64,                        // tick 384: 1.5 s
+            0x00, 0xff, 0x2f, 0
+    };
+    writeFile(smf, sizeof(smf));
+}
+
+// plays MIDI_FILE for the given amount of sample frames and returns all
+// events dispatched by the SMF driver
+static vector<ReceivedEvent> play(uint64_t frames, map<String,String> params = map<String,String>()) {
+    map<String,String> audioParams;
+    audioParams["ACTIVE"]       = "false";
+    audioParams["SAMPLERATE"]   = ToString(SAMPLE_RATE);
+    audioParams["FRAGMENTSIZE"] = ToString(FRAGMENT_SIZE);
+    audioParams["FORMAT"]       = "NONE";
+    audioParams["FRAMES"]       = ToString(frames);
+    AudioOutputDevice* pAudioDevice = AudioOutputDeviceFactory::Create("FILE", audioParams);
+    CPPUNIT_ASSERT(pAudioDevice != NULL);
+
+    params["FILENAME"]     = MIDI_FILE;
+    params["AUDIO_DEVICE"] = ToString(pAudioDevice->deviceId());
+    MidiInputDevice* pMidiDevice = MidiInputDeviceFactory::Create("SMF", params, NULL);
+    CPPUNIT_ASSERT(pMidiDevice != NULL);
+
+    RecordingEngineChannel channel;
+    channel.pClock = pAudioDevice;
+    MidiInputPort* pPort = pMidiDevice->GetPort(0);
+    pPort->Connect(&channel, midi_chan_all);
+
+    pAudioDevice->Play();
+    while (pAudioDevice->IsPlaying()) usleep(1000);
+    CPPUNIT_ASSERT(pAudioDevice->FrameTime() == frames);
+
+    pMidiDevice->StopListen(); // releases notes still hanging
+    pPort->Disconnect(&channel);
+    MidiInputDeviceFactory::Destroy(pMidiDevice);
+    AudioOutputDeviceFactory::Destroy(pAudioDevice);
+    return channel.events;
+}
+
+static bool isEvent(const ReceivedEvent& event, uint8_t status, uint8_t data1, uint8_t data2, int64_t frame) {
+    if (event.status == status && event.data1 == data1 && event.data2 == data2 && event.frame == frame)
+        return true;
+    cout << "\nunexpected event " << hex << int(event.status) << " " << dec << int(event.data1)
+         << " " << int(event.data2) << " at frame " << event.frame << endl;
+    return false;
+}
+
+
+// MidiInputDeviceSmfTest
+
+void MidiInputDeviceSmfTest::printTestSuiteName() {
+    cout << "\b \nRunning MIDI Input Device SMF Tests: " << flush;
+}
+
+void MidiInputDeviceSmfTest::testPlayback() {
+    writeTestFile();
+    vector<ReceivedEvent> events = play(2 * SAMPLE_RATE);
+    CPPUNIT_ASSERT(events.size() == 5);
+    CPPUNIT_ASSERT(isEvent(events[0], 0x90, 60, 100, 0));
+    CPPUNIT_ASSERT(isEvent(events[1], 0x80, 60, 0, SAMPLE_RATE / 2));
+    CPPUNIT_ASSERT(isEvent(events[2], 0xb1, 7, 90, SAMPLE_RATE));
+    CPPUNIT_ASSERT(isEvent(events[3], 0x90, 62, 80, SAMPLE_RATE * 5 / 4));
+    CPPUNIT_ASSERT(isEvent(events[4], 0x80, 62, 64, SAMPLE_RATE * 3 / 2));
+    unlink(MIDI_FILE);
+}
+
+void MidiInputDeviceSmfTest::testTempoScale() {
+    writeTestFile();
+    map<String,String> params;
+    params["TEMPO_SCALE"] = "2.0";
+    vector<ReceivedEvent> events = play(SAMPLE_RATE, params);
+    CPPUNIT_ASSERT(events.size() == 5);
+    CPPUNIT_ASSERT(isEvent(events[1], 0x80, 60, 0, SAMPLE_RATE / 4));
+    CPPUNIT_ASSERT(isEvent(events[3], 0x90, 62, 80, SAMPLE_RATE * 5 / 8));
+    CPPUNIT_ASSERT(isEvent(events[4], 0x80, 62, 64, SAMPLE_RATE * 3 / 4));
+    unlink(MIDI_FILE);
+}
+
+void MidiInputDeviceSmfTest::testLoop() {
+    writeTestFile();
+    map<String,String> params;
+    params["LOOP"] = "true";
+    // stop shortly before the end of the second run, while note 62 is on
+    const int64_t length = SAMPLE_RATE * 3 / 2;
+    vector<ReceivedEvent> events = play(2 * length - 1000, params);
+    CPPUNIT_ASSERT(events.size() == 10);
+    for (int i = 0; i < 4; ++i) {
+        CPPUNIT_ASSERT(isEvent(events[5 + i], events[i].status, events[i].data1,
+                               events[i].data2, events[i].frame + length));
+    }
+    // hanging note is released when playback stops
+    CPPUNIT_ASSERT(isEvent(events[9], 0x80, 62, 0, -1));
+    unlink(MIDI_FILE);
+}
+
+void MidiInputDeviceSmfTest::testCaptureFile() {
+    // capture of a performance at 48 kHz, with one event that was dispatched
+    // without fragment position, recorded out of order by another thread
+    const uint8_t capture[] = {
+        'L', 'S', 'M', 'C', 1, 0, 0, 0, 0x80, 0xbb, 0, 0,
+        0x00, 0x10, 0, 0, 0, 0, 0, 0,  10, 0, 0, 0,  1, 0, 0, 0,  3, 0,  0x90, 64, 90,
+        0x00, 0x20, 0, 0, 0, 0, 0, 0,  0xff, 0xff, 0xff, 0xff,  3, 0, 0, 0,  3, 0,  0xb0, 64, 127,
+        0x00, 0x11, 0, 0, 0, 0, 0, 0,  5, 0, 0, 0,  2, 0, 0, 0,  3, 0,  0x80, 64, 0,
+        0x00, 0x0f, 0, 0, 0, 0, 0, 0,  3, 0, 0, 0,  0, 0, 0, 0,  3, 0,  0x90, 40, 70
+    };
+    writeFile(capture, sizeof(capture));
+    vector<ReceivedEvent> events = play(8192);
+    // positions are relative to the earliest event's fragment
+    CPPUNIT_ASSERT(events.size() == 5);
+    CPPUNIT_ASSERT(isEvent(events[0], 0x90, 40, 70, 3));
+    CPPUNIT_ASSERT(isEvent(events[1], 0x90, 64, 90, 0x100 + 10));
+    CPPUNIT_ASSERT(isEvent(events[2], 0x80, 64, 0, 0x200 + 5));
+    CPPUNIT_ASSERT(isEvent(events[3], 0xb0, 64, 127, 0x1100));
+    // note 40 was never released in the capture
+    CPPUNIT_ASSERT(isEvent(events[4], 0x80, 40, 0, -1));
+    unlink(MIDI_FILE);
+}
+
+void MidiInputDeviceSmfTest::testInvalidFiles() {
+    map<String,String> audioParams;
+    audioParams["ACTIVE"] = "false";
+    audioParams["FORMAT"] = "NONE";
+    AudioOutputDevice* pAudioDevice = AudioOutputDeviceFactory::Create("FILE", audioParams);
+    map<String,String> params;
+    params["ACTIVE"]       = "false";
+    params["AUDIO_DEVICE"] = ToString(pAudioDevice->deviceId());
+    params["FILENAME"]     = MIDI_FILE;
+
+    unlink(MIDI_FILE);
+    CPPUNIT_ASSERT_THROW(MidiInputDeviceFactory::Create("SMF", params, NULL), Exception);
+
+    const uint8_t wav[] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 0, 0 };
+    writeFile(wav, sizeof(wav));
+    CPPUNIT_ASSERT_THROW(MidiInputDeviceFactory::Create("SMF", params, NULL), Exception);
+
+    // format 2 is not supported
+    const uint8_t format2[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 2, 0, 1, 0, 96 };
+    writeFile(format2, sizeof(format2));
+    CPPUNIT_ASSERT_THROW(MidiInputDeviceFactory::Create("SMF", params, NULL), Exception);
+
+    // track chunk longer than the file
+    const uint8_t truncated[] = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+        'M', 'T', 'r', 'k', 0, 0, 0, 8, 0x00, 0x90, 60, 100
+    };
+    writeFile(truncated, sizeof(truncated));
+    CPPUNIT_ASSERT_THROW(MidiInputDeviceFactory::Create("SMF", params, NULL), Exception);
+
+    // data bytes without any status byte before
+    const uint8_t noStatus[] = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+        'M', 'T', 'r', 'k', 0, 0, 0, 4, 0x00, 60, 100, 0x00
+    };
+    writeFile(noStatus, sizeof(noStatus));
+    CPPUNIT_ASSERT_THROW(MidiInputDeviceFactory::Create("SMF", params, NULL), Exception);
+
+    // whereas a valid file is accepted with the same parameters
+    writeTestFile();
+    MidiInputDevice* pMidiDevice = MidiInputDeviceFactory::Create("SMF", params, NULL);
+    CPPUNIT_ASSERT(pMidiDevice != NULL);
+    MidiInputDeviceFactory::Destroy(pMidiDevice);
+    AudioOutputDeviceFactory::Destroy(pAudioDevice);
+    unlink(MIDI_FILE);
+}
@@ -0,0 +1,31 @@
+#ifndef __LS_MIDIINPUTDEVICESMFTEST_H__
+#define __LS_MIDIINPUTDEVICESMFTEST_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../drivers/midi/MidiInputDeviceSmf.h"
+
+// Plays MIDI files with the "SMF" driver, clocked by the offline "FILE" audio
+// driver, and checks the sample accurate positions of the dispatched events.
+class MidiInputDeviceSmfTest : public CppUnit::TestFixture {
+
+    CPPUNIT_TEST_SUITE(MidiInputDeviceSmfTest);
+    CPPUNIT_TEST(printTestSuiteName);
+    CPPUNIT_TEST(testPlayback);
+    CPPUNIT_TEST(testTempoScale);
+    CPPUNIT_TEST(testLoop);
+    CPPUNIT_TEST(testCaptureFile);
+    CPPUNIT_TEST(testInvalidFiles);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void printTestSuiteName();
+        void testPlayback();
+        void testTempoScale();
+        void testLoop();
+        void testCaptureFile();
+        void testInvalidFiles();
+};
+
+#endif // __LS_MIDIINPUTDEVICESMFTEST_H__
@@ -0,0 +1,202 @@
+#include "RTTimingWheelTest.h"
+
+#include <iostream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RTTimingWheelTest);
+
+using namespace std;
+
+#define NO_END  (~uint64_t(0))
+
+// element type we manage with the timing wheels in these tests
+struct TimedNode : public RTTimingWheelNode {
+    uint64_t scheduleTime;
+    int      id;
+};
+
+// the wheel is a bit too big to be put on the stack of each test
+static RTTimingWheel<TimedNode> wheel;
+
+
+// RTTimingWheelTest
+
+void RTTimingWheelTest::printTestSuiteName() {
+    cout << "\b \nRunning RTTimingWheel Tests: " << flush;
+}
+
+void RTTimingWheelTest::testEmptyWheel() {
+    wheel.clear();
+    CPPUNIT_ASSERT(wheel.isEmpty());
+    CPPUNIT_ASSERT(wheel.size() == 0);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == NULL);
+}
+
+void RTTimingWheelTest::testPopInTimeOrder() {
+    wheel.clear();
+    // times spread over all wheel levels, inserted in random order
+    const uint64_t times[] = {
+        70000, 3, 255, 256, 20000000, 65535, 1, 65536, 16777216, 4000000000u, 300
+    };
+    const int n = sizeof(times) / sizeof(times[0]);
+    TimedNode nodes[n];
+    for (int i = 0; i < n; ++i) {
+        nodes[i].scheduleTime = times[i];
+        nodes[i].id = i;
+        wheel.insert(nodes[i]);
+    }
+    CPPUNIT_ASSERT(wheel.size() == n);
+
+    uint64_t prevTime = 0;
+    for (int i = 0; i < n; ++i) {
+        TimedNode* node = wheel.popNext(NO_END);
+        CPPUNIT_ASSERT(node != NULL);
+        CPPUNIT_ASSERT(node->scheduleTime >= prevTime);
+        prevTime = node->scheduleTime;
+    }
+    CPPUNIT_ASSERT(prevTime == 4000000000u);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == NULL);
+}
+
+void RTTimingWheelTest::testPopEqualTimesInInsertOrder() {
+    wheel.clear();
+    TimedNode nodes[6];
+    for (int i = 0; i < 6; ++i) {
+        // two groups of equal times, the later group on a higher level
+        nodes[i].scheduleTime = (i < 3) ? 10 : 100000;
+        nodes[i].id = i;
+        wheel.insert(nodes[i]);
+    }
+    for (int i = 0; i < 6; ++i) {
+        TimedNode* node = wheel.popNext(NO_END);
+        CPPUNIT_ASSERT(node != NULL);
+        CPPUNIT_ASSERT(node->id == i);
+    }
+    CPPUNIT_ASSERT(wheel.isEmpty());
+}
+
+void RTTimingWheelTest::testPopNextRespectsEnd() {
+    wheel.clear();
+    TimedNode a, b;
+    a.scheduleTime = 100;
+    a.id = 0;
+    b.scheduleTime = 5000;
+    b.id = 1;
+    wheel.insert(b);
+    wheel.insert(a);
+
+    CPPUNIT_ASSERT(wheel.popNext(100) == NULL); // end is exclusive
+    CPPUNIT_ASSERT(wheel.size() == 2);
+    CPPUNIT_ASSERT(wheel.popNext(101) == &a);
+    CPPUNIT_ASSERT(wheel.popNext(4096) == NULL);
+    CPPUNIT_ASSERT(wheel.popNext(5000) == NULL);
+    CPPUNIT_ASSERT(wheel.size() == 1);
+    CPPUNIT_ASSERT(wheel.popNext(5001) == &b);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+}
+
+void RTTimingWheelTest::testErase() {
+    wheel.clear();
+    TimedNode nodes[4];
+    for (int i = 0; i < 4; ++i) {
+        nodes[i].scheduleTime = 1000 * (i + 1);
+        nodes[i].id = i;
+        wheel.insert(nodes[i]);
+    }
+    wheel.erase(nodes[1]);
+    wheel.erase(nodes[3]);
+    CPPUNIT_ASSERT(wheel.size() == 2);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &nodes[0]);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &nodes[2]);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == NULL);
+
+    // an erased element can be inserted again
+    wheel.insert(nodes[3]);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &nodes[3]);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+}
+
+void RTTimingWheelTest::testOverflow() {
+    wheel.clear();
+    // elements due more than 2^32 time units ahead
+    TimedNode nodes[3];
+    nodes[0].scheduleTime = (uint64_t(1) << 40) + 7;
+    nodes[1].scheduleTime = (uint64_t(1) << 33) + 1;
+    nodes[2].scheduleTime = 12;
+    for (int i = 0; i < 3; ++i) {
+        nodes[i].id = i;
+        wheel.insert(nodes[i]);
+    }
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &nodes[2]);
+    CPPUNIT_ASSERT(wheel.popNext(uint64_t(1) << 33) == NULL);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &nodes[1]);
+    CPPUNIT_ASSERT(wheel.popNext((uint64_t(1) << 40) + 7) == NULL);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &nodes[0]);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+}
+
+void RTTimingWheelTest::testInsertPastTime() {
+    wheel.clear();
+    TimedNode a, b;
+    a.scheduleTime = 50000;
+    a.id = 0;
+    wheel.insert(a);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &a);
+
+    // wheel's time is 50000 now, so earlier elements are due immediately
+    b.scheduleTime = 20;
+    b.id = 1;
+    a.scheduleTime = 50001;
+    wheel.insert(a);
+    wheel.insert(b);
+    CPPUNIT_ASSERT(wheel.popNext(50001) == &b);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &a);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+}
+
+void RTTimingWheelTest::testClear() {
+    wheel.clear();
+    TimedNode nodes[5];
+    for (int i = 0; i < 5; ++i) {
+        nodes[i].scheduleTime = uint64_t(1) << (i * 9);
+        nodes[i].id = i;
+        wheel.insert(nodes[i]);
+    }
+    wheel.clear();
+    CPPUNIT_ASSERT(wheel.isEmpty());
+    CPPUNIT_ASSERT(wheel.size() == 0);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == NULL);
+
+    // cleared elements can be inserted again
+    wheel.insert(nodes[2]);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &nodes[2]);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+}
+
+void RTTimingWheelTest::testClearThenReinsert() {
+    wheel.clear();
+    TimedNode a;
+    a.scheduleTime = 1000000;
+    a.id = 0;
+    wheel.insert(a);
+    CPPUNIT_ASSERT(wheel.popNext(NO_END) == &a);
+
+    // clear() must reset the wheel's time as well, i.e. for a new time
+    // source that starts counting from 0 again, otherwise this element
+    // would be considered to be due at time 1000000 already
+    wheel.clear();
+    a.scheduleTime = 100;
+    wheel.insert(a);
+    CPPUNIT_ASSERT(wheel.popNext(100) == NULL);
+    CPPUNIT_ASSERT(wheel.popNext(200) == &a);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+
+    // same after the time was advanced on an empty wheel
+    wheel.popNext(5000000);
+    wheel.clear();
+    a.scheduleTime = 4000;
+    wheel.insert(a);
+    CPPUNIT_ASSERT(wheel.popNext(4000) == NULL);
+    CPPUNIT_ASSERT(wheel.popNext(4001) == &a);
+    CPPUNIT_ASSERT(wheel.isEmpty());
+}
@@ -0,0 +1,37 @@
+#ifndef __LS_RTTIMINGWHEELTEST_H__
+#define __LS_RTTIMINGWHEELTEST_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../common/RTTimingWheel.h"
+
+class RTTimingWheelTest : public CppUnit::TestFixture {
+
+    CPPUNIT_TEST_SUITE(RTTimingWheelTest);
+    CPPUNIT_TEST(printTestSuiteName);
+    CPPUNIT_TEST(testEmptyWheel);
+    CPPUNIT_TEST(testPopInTimeOrder);
+    CPPUNIT_TEST(testPopEqualTimesInInsertOrder);
+    CPPUNIT_TEST(testPopNextRespectsEnd);
+    CPPUNIT_TEST(testErase);
+    CPPUNIT_TEST(testOverflow);
+    CPPUNIT_TEST(testInsertPastTime);
+    CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST(testClearThenReinsert);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void printTestSuiteName();
+        void testEmptyWheel();
+        void testPopInTimeOrder();
+        void testPopEqualTimesInInsertOrder();
+        void testPopNextRespectsEnd();
+        void testErase();
+        void testOverflow();
+        void testInsertPastTime();
+        void testClear();
+        void testClearThenReinsert();
+};
+
+#endif // __LS_RTTIMINGWHEELTEST_H__
@@ -0,0 +1,141 @@
+#include "ScriptExecContextPoolTest.h"
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ScriptExecContextPoolTest);
+
+using namespace std;
+using namespace LinuxSampler;
+
+#define INITIAL_SIZE  CONFIG_MAX_EVENTS_PER_FRAGMENT
+
+// Note:
+// we have to declare all those variables which we want to use for all
+// tests within this test suite static because there are side effects which
+// occur on transition to the next test which would change the values of our
+// variables
+static ScriptVM*              pVM = NULL;
+static VMParserContext*       pParserContext = NULL;
+static ScriptExecContextPool* pPool = NULL;
+
+// acquires contexts until the pool is exhausted, returns the amount acquired
+static int acquireAll(vector<VMExecContext*>& contexts) {
+    set<VMExecContext*> unique;
+    for (VMExecContext* pContext = pPool->acquire(); pContext; pContext = pPool->acquire()) {
+        contexts.push_back(pContext);
+        unique.insert(pContext);
+    }
+    CPPUNIT_ASSERT(unique.size() == contexts.size());
+    return contexts.size();
+}
+
+static void releaseAll(vector<VMExecContext*>& contexts) {
+    for (int i = 0; i < contexts.size(); ++i)
+        pPool->release(contexts[i]);
+    contexts.clear();
+}
+
+
+// ScriptExecContextPoolTest
+
+void ScriptExecContextPoolTest::printTestSuiteName() {
+    cout << "\b \nRunning ScriptExecContextPool Tests: " << flush;
+}
+
+void ScriptExecContextPoolTest::testCreatePool() {
+    pVM = new ScriptVM;
+    pParserContext = pVM->loadScript(
+        "on init\n"
+        "  declare polyphonic $x\n"
+        "end on\n"
+        "on note\n"
+        "  $x := $x + 1\n"
+        "end on\n"
+    );
+    CPPUNIT_ASSERT(pParserContext != NULL);
+    CPPUNIT_ASSERT(pParserContext->errors().empty());
+    pPool = new ScriptExecContextPool(pVM, pParserContext);
+    // must at least provide as many contexts as there may be events in one
+    // fragment, so that a single engine channel never runs out of contexts
+    CPPUNIT_ASSERT(pPool->size() == INITIAL_SIZE);
+}
+
+void ScriptExecContextPoolTest::testAcquireAllContexts() {
+    vector<VMExecContext*> contexts;
+    CPPUNIT_ASSERT(acquireAll(contexts) == INITIAL_SIZE);
+    CPPUNIT_ASSERT(pPool->acquire() == NULL);
+    releaseAll(contexts);
+}
+
+void ScriptExecContextPoolTest::testReleaseContexts() {
+    vector<VMExecContext*> contexts;
+    for (int i = 0; i < 10; ++i) {
+        VMExecContext* pContext = pPool->acquire();
+        CPPUNIT_ASSERT(pContext != NULL);
+        contexts.push_back(pContext);
+    }
+    releaseAll(contexts);
+    // released contexts must be available again
+    CPPUNIT_ASSERT(acquireAll(contexts) == INITIAL_SIZE);
+    releaseAll(contexts);
+}
+
+void ScriptExecContextPoolTest::testRequestGrowth() {
+    vector<VMExecContext*> contexts;
+    int requests = 0;
+    for (int i = 0; i < INITIAL_SIZE; ++i) {
+        contexts.push_back(pPool->acquire());
+        CPPUNIT_ASSERT(contexts.back() != NULL);
+        if (pPool->requestGrowth()) {
+            // only when running low on contexts (25% or less left)
+            CPPUNIT_ASSERT((INITIAL_SIZE - i - 1) * 4 <= INITIAL_SIZE);
+            ++requests;
+        }
+    }
+    // growth must only be requested once until the pool was grown
+    CPPUNIT_ASSERT(requests == 1);
+    releaseAll(contexts);
+}
+
+void ScriptExecContextPoolTest::testGrowByPeakUsage() {
+    // all contexts were used simultaneously so far, so the pool should grow
+    // to twice that amount
+    pPool->grow();
+    CPPUNIT_ASSERT(pPool->size() == 2 * INITIAL_SIZE);
+    CPPUNIT_ASSERT(!pPool->requestGrowth());
+
+    // growing again without higher usage must not change anything
+    pPool->grow();
+    CPPUNIT_ASSERT(pPool->size() == 2 * INITIAL_SIZE);
+
+    vector<VMExecContext*> contexts;
+    CPPUNIT_ASSERT(acquireAll(contexts) == 2 * INITIAL_SIZE);
+    releaseAll(contexts);
+}
+
+void ScriptExecContextPoolTest::testHandBack() {
+    vector<VMExecContext*> contexts;
+    for (int i = 0; i < 10; ++i) {
+        VMExecContext* pContext = pPool->acquire();
+        CPPUNIT_ASSERT(pContext != NULL);
+        contexts.push_back(pContext);
+    }
+    // contexts handed back by a non real-time thread must be available to
+    // the audio thread again
+    for (int i = 0; i < contexts.size(); ++i)
+        pPool->handBack(contexts[i]);
+    contexts.clear();
+    CPPUNIT_ASSERT(acquireAll(contexts) == 2 * INITIAL_SIZE);
+    releaseAll(contexts);
+}
+
+void ScriptExecContextPoolTest::testDestroyPool() {
+    delete pPool;
+    pPool = NULL;
+    delete pParserContext;
+    pParserContext = NULL;
+    delete pVM;
+    pVM = NULL;
+}
@@ -0,0 +1,33 @@
+#ifndef __LS_SCRIPTEXECCONTEXTPOOLTEST_H__
+#define __LS_SCRIPTEXECCONTEXTPOOLTEST_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../engines/common/ScriptExecContextPool.h"
+
+class ScriptExecContextPoolTest : public CppUnit::TestFixture {
+
+    CPPUNIT_TEST_SUITE(ScriptExecContextPoolTest);
+    CPPUNIT_TEST(printTestSuiteName);
+    CPPUNIT_TEST(testCreatePool);
+    CPPUNIT_TEST(testAcquireAllContexts);
+    CPPUNIT_TEST(testReleaseContexts);
+    CPPUNIT_TEST(testRequestGrowth);
+    CPPUNIT_TEST(testGrowByPeakUsage);
+    CPPUNIT_TEST(testHandBack);
+    CPPUNIT_TEST(testDestroyPool);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void printTestSuiteName();
+        void testCreatePool();
+        void testAcquireAllContexts();
+        void testReleaseContexts();
+        void testRequestGrowth();
+        void testGrowByPeakUsage();
+        void testHandBack();
+        void testDestroyPool();
+};
+
+#endif // __LS_SCRIPTEXECCONTEXTPOOLTEST_H__
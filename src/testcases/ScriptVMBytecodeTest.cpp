@@ -0,0 +1,342 @@
+#include "ScriptVMBytecodeTest.h"
+
+#include "../scriptvm/tree.h"
+
+#include <iostream>
+#include <sstream>
+#include <map>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ScriptVMBytecodeTest);
+
+using namespace std;
+using namespace LinuxSampler;
+
+// values of all variables of a script after it was executed, by name
+typedef map<String,String> VariableValues;
+
+// reference implementation: executes the statements by walking the parser
+// tree (without support for suspending the script)
+static StmtFlags_t execTree(Statement* statement, ExecContext* ctx) {
+    StmtFlags_t flags = STMT_SUCCESS;
+    switch (statement->statementType()) {
+        case STMT_LEAF:
+            ctx->resetStrArena(); // like the VM does before each statement
+            return dynamic_cast<LeafStatement*>(statement)->exec();
+        case STMT_LIST: {
+            Statements* statements = dynamic_cast<Statements*>(statement);
+            for (uint i = 0; statements->statement(i) && flags == STMT_SUCCESS; ++i)
+                flags = execTree(statements->statement(i), ctx);
+            return flags;
+        }
+        case STMT_BRANCH: {
+            BranchStatement* branchStatement = dynamic_cast<BranchStatement*>(statement);
+            const int branch = branchStatement->evalBranch();
+            return (branch < 0) ? STMT_SUCCESS : execTree(branchStatement->branch(branch), ctx);
+        }
+        case STMT_LOOP: {
+            While* loop = dynamic_cast<While*>(statement);
+            while (flags == STMT_SUCCESS && loop->evalLoopStartCondition())
+                flags = execTree(loop->statements(), ctx);
+            return flags;
+        }
+    }
+    return StmtFlags_t(STMT_ABORT_SIGNALLED | STMT_ERROR_OCCURRED);
+}
+
+static VariableValues variableValues(ParserContext* context) {
+    VariableValues values;
+    for (map<String,VariableRef>::iterator it = context->vartable.begin();
+         it != context->vartable.end(); ++it)
+    {
+        Variable* var = &*it->second;
+        ostringstream s;
+        if (IntArrayVariable* array = dynamic_cast<IntArrayVariable*>(var)) {
+            for (int i = 0; i < array->arraySize(); ++i)
+                s << array->evalIntElement(i) << " ";
+        } else if (IntVariable* integer = dynamic_cast<IntVariable*>(var)) {
+            s << integer->evalInt();
+        } else if (StringVariable* str = dynamic_cast<StringVariable*>(var)) {
+            s << str->evalStr();
+        } else continue;
+        values[it->first] = s.str();
+    }
+    return values;
+}
+
+// runs the init and note handler of the script either with the bytecode
+// interpreter or with execTree() and returns the resulting variable values
+static VariableValues runScript(const String& code, bool bytecode) {
+    ScriptVM vm;
+    VMParserContext* parserContext = vm.loadScript(code);
+    CPPUNIT_ASSERT(parserContext != NULL);
+    CPPUNIT_ASSERT(parserContext->errors().empty());
+    VMExecContext* execContext = vm.createExecContext(parserContext);
+    ParserContext* context = dynamic_cast<ParserContext*>(parserContext);
+
+    const char* handlerNames[] = { "init", "note" };
+    for (int i = 0; i < 2; ++i) {
+        VMEventHandler* handler = parserContext->eventHandlerByName(handlerNames[i]);
+        if (!handler) continue;
+        if (bytecode) {
+            CPPUNIT_ASSERT(vm.exec(parserContext, execContext, handler) == VM_EXEC_NOT_RUNNING);
+        } else {
+            context->execContext = dynamic_cast<ExecContext*>(execContext);
+            CPPUNIT_ASSERT(execTree(dynamic_cast<EventHandler*>(handler), context->execContext) == STMT_SUCCESS);
+        }
+    }
+
+    // polyphonic variables are read from the execution context
+    context->execContext = dynamic_cast<ExecContext*>(execContext);
+    VariableValues values = variableValues(context);
+    delete execContext;
+    delete parserContext;
+    return values;
+}
+
+// runs the script both ways, the results must be equal, returns the values
+static VariableValues checkParity(const String& code) {
+    VariableValues tree = runScript(code, false);
+    VariableValues bytecode = runScript(code, true);
+    CPPUNIT_ASSERT(!tree.empty());
+    CPPUNIT_ASSERT(tree.size() == bytecode.size());
+    for (VariableValues::iterator it = tree.begin(); it != tree.end(); ++it) {
+        if (bytecode[it->first] != it->second)
+            cout << "\n" << it->first << ": tree " << it->second << ", bytecode " << bytecode[it->first] << endl;
+        CPPUNIT_ASSERT(bytecode[it->first] == it->second);
+    }
+    return bytecode;
+}
+
+
+// ScriptVMBytecodeTest
+
+void ScriptVMBytecodeTest::printTestSuiteName() {
+    cout << "\b \nRunning ScriptVM Bytecode Tests: " << flush;
+}
+
+void ScriptVMBytecodeTest::testArithmetic() {
+    VariableValues values = checkParity(
+        "on init\n"
+        "  declare $a := 17\n"
+        "  declare $b := -5\n"
+        "  declare $c\n"
+        "  declare $d\n"
+        "  declare $e\n"
+        "  declare $f\n"
+        "  $c := $a + $b * 3 - $a / $b\n"
+        "  $d := $a mod 5 + (-$a) mod 5 + $b mod 3\n"
+        "  $e := -(-$a - $b) * ($a - 20)\n"
+        "  $f := $a / 3 * 3 + $a mod 3 - $a\n"
+        "end on\n"
+    );
+    CPPUNIT_ASSERT(values["$c"] == "5");
+    CPPUNIT_ASSERT(values["$f"] == "0");
+}
+
+void ScriptVMBytecodeTest::testComparisonsAndLogic() {
+    checkParity(
+        "on init\n"
+        "  declare $a := 3\n"
+        "  declare $b := 7\n"
+        "  declare %r[12]\n"
+        "  %r[0] := $a < $b\n"
+        "  %r[1] := $a > $b\n"
+        "  %r[2] := $a <= 3\n"
+        "  %r[3] := $b >= 8\n"
+        "  %r[4] := $a = 3\n"
+        "  %r[5] := $a # 3\n"
+        "  %r[6] := $a < $b and $b < 10\n"
+        "  %r[7] := $a > $b or $b = 7\n"
+        "  %r[8] := not ($a = $b)\n"
+        "  %r[9] := not $a and $b\n"
+        "  %r[10] := ($a < $b) + ($b < $a) * 2 + ($a = 3) * 4\n"
+        "  %r[11] := $a > 1 and ($b > 10 or $a # $b)\n"
+        "end on\n"
+    );
+}
+
+void ScriptVMBytecodeTest::testConstantExpressions() {
+    checkParity(
+        "on init\n"
+        "  declare const $N := 4 * 8 - 2\n"
+        "  declare $a := $N / 7 + 2 * 3\n"
+        "  declare $b\n"
+        "  declare %arr[$N / 10] := (1, 2, 3)\n"
+        "  $b := ($N + 1) * 2 - %arr[1] * (3 mod 2)\n"
+        "  if (1)\n"
+        "    $a := $a + 1\n"
+        "  else\n"
+        "    $a := $a - 1\n"
+        "  end if\n"
+        "end on\n"
+    );
+}
+
+void ScriptVMBytecodeTest::testIfElse() {
+    checkParity(
+        "on init\n"
+        "  declare $i := 0\n"
+        "  declare %r[6]\n"
+        "  while ($i < 6)\n"
+        "    if ($i < 2)\n"
+        "      %r[$i] := 10\n"
+        "    else\n"
+        "      if ($i = 3)\n"
+        "        %r[$i] := 30\n"
+        "      else\n"
+        "        %r[$i] := -$i\n"
+        "      end if\n"
+        "    end if\n"
+        "    if ($i = 5)\n"
+        "      %r[0] := %r[0] + 1\n"
+        "    end if\n"
+        "    $i := $i + 1\n"
+        "  end while\n"
+        "end on\n"
+    );
+}
+
+void ScriptVMBytecodeTest::testSelectCase() {
+    checkParity(
+        "on init\n"
+        "  declare $i := -2\n"
+        "  declare %r[10]\n"
+        "  while ($i < 8)\n"
+        "    select ($i)\n"
+        "      case 0\n"
+        "        %r[$i + 2] := 100\n"
+        "      case 1 to 3\n"
+        "        %r[$i + 2] := 200 + $i\n"
+        "      case 5\n"
+        "        %r[$i + 2] := 500\n"
+        "    end select\n"
+        "    $i := $i + 1\n"
+        "  end while\n"
+        "end on\n"
+    );
+}
+
+void ScriptVMBytecodeTest::testWhileLoops() {
+    VariableValues values = checkParity(
+        "on init\n"
+        "  declare $i := 0\n"
+        "  declare $j\n"
+        "  declare $sum := 0\n"
+        "  declare $never := 0\n"
+        "  while ($i < 10)\n"
+        "    $j := 0\n"
+        "    while ($j < $i)\n"
+        "      $sum := $sum + $i * $j\n"
+        "      $j := $j + 1\n"
+        "    end while\n"
+        "    $i := $i + 1\n"
+        "  end while\n"
+        "  while ($i < 0)\n"
+        "    $never := 1\n"
+        "  end while\n"
+        "end on\n"
+    );
+    CPPUNIT_ASSERT(values["$sum"] == "870");
+}
+
+void ScriptVMBytecodeTest::testArrays() {
+    checkParity(
+        "on init\n"
+        "  declare %a[8] := (5, 3, 9, 1, 7, 2, 8, 4)\n"
+        "  declare %b[8]\n"
+        "  declare $i := 0\n"
+        "  declare $j\n"
+        "  declare $tmp\n"
+        "  { bubble sort }\n"
+        "  while ($i < 8)\n"
+        "    $j := 0\n"
+        "    while ($j < 7 - $i)\n"
+        "      if (%a[$j] > %a[$j + 1])\n"
+        "        $tmp := %a[$j]\n"
+        "        %a[$j] := %a[$j + 1]\n"
+        "        %a[$j + 1] := $tmp\n"
+        "      end if\n"
+        "      $j := $j + 1\n"
+        "    end while\n"
+        "    %b[7 - $i] := %a[$i] * 2\n"
+        "    $i := $i + 1\n"
+        "  end while\n"
+        "end on\n"
+    );
+}
+
+void ScriptVMBytecodeTest::testStrings() {
+    checkParity(
+        "on init\n"
+        "  declare @s := \"a\"\n"
+        "  declare @t\n"
+        "  declare $i := 0\n"
+        "  while ($i < 3)\n"
+        "    @s := @s & $i & \"-\"\n"
+        "    $i := $i + 1\n"
+        "  end while\n"
+        "  @t := \"n=\" & ($i * 2) & @s\n"
+        "end on\n"
+    );
+}
+
+void ScriptVMBytecodeTest::testStringTruncation() {
+    const int maxLength = CONFIG_MAX_SCRIPT_STRING_LENGTH - 1;
+    const String code =
+        "on init\n"
+        "  declare @s := \"" + String(maxLength + 1, 'x') + "\"\n"
+        "  declare @t := \"" + String(maxLength, 'x') + "\"\n"
+        "  declare @u\n"
+        "  declare $i := 0\n"
+        "  while ($i <= " + ToString(maxLength) + ")\n"
+        "    @u := @u & \"y\"\n"
+        "    $i := $i + 1\n"
+        "  end while\n"
+        "end on\n";
+
+    // only the constant string exceeding the limit is reported by the parser
+    {
+        ScriptVM vm;
+        VMParserContext* parserContext = vm.loadScript(code);
+        CPPUNIT_ASSERT(parserContext->errors().empty());
+        CPPUNIT_ASSERT(parserContext->warnings().size() == 1);
+        delete parserContext;
+    }
+
+    VariableValues values = checkParity(code);
+    CPPUNIT_ASSERT(values["@s"] == String(maxLength, 'x'));
+    CPPUNIT_ASSERT(values["@t"] == String(maxLength, 'x'));
+    CPPUNIT_ASSERT(values["@u"] == String(maxLength, 'y'));
+}
+
+void ScriptVMBytecodeTest::testBuiltInFunctions() {
+    checkParity(
+        "on init\n"
+        "  declare %a[5] := (-3, 4, -5, 0, 2)\n"
+        "  declare $sum := 0\n"
+        "  declare $i := 0\n"
+        "  declare $n\n"
+        "  $n := num_elements(%a)\n"
+        "  while ($i < num_elements(%a))\n"
+        "    $sum := $sum + abs(%a[$i]) * ($i + 1)\n"
+        "    $i := $i + 1\n"
+        "  end while\n"
+        "end on\n"
+    );
+}
+
+void ScriptVMBytecodeTest::testPolyphonicVariables() {
+    checkParity(
+        "on init\n"
+        "  declare polyphonic $p\n"
+        "  declare $g := 5\n"
+        "  declare $r\n"
+        "end on\n"
+        "\n"
+        "on note\n"
+        "  $p := $g * 3\n"
+        "  $p := $p + 1\n"
+        "  $r := $p * 2\n"
+        "end on\n"
+    );
+}
@@ -0,0 +1,44 @@
+#ifndef __LS_SCRIPTVMBYTECODETEST_H__
+#define __LS_SCRIPTVMBYTECODETEST_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../scriptvm/ScriptVM.h"
+
+// Runs scripts both with the VM's bytecode interpreter and by directly
+// walking the parser tree, and expects both to end up with identical values
+// of all script variables.
+class ScriptVMBytecodeTest : public CppUnit::TestFixture {
+
+    CPPUNIT_TEST_SUITE(ScriptVMBytecodeTest);
+    CPPUNIT_TEST(printTestSuiteName);
+    CPPUNIT_TEST(testArithmetic);
+    CPPUNIT_TEST(testComparisonsAndLogic);
+    CPPUNIT_TEST(testConstantExpressions);
+    CPPUNIT_TEST(testIfElse);
+    CPPUNIT_TEST(testSelectCase);
+    CPPUNIT_TEST(testWhileLoops);
+    CPPUNIT_TEST(testArrays);
+    CPPUNIT_TEST(testStrings);
+    CPPUNIT_TEST(testStringTruncation);
+    CPPUNIT_TEST(testBuiltInFunctions);
+    CPPUNIT_TEST(testPolyphonicVariables);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void printTestSuiteName();
+        void testArithmetic();
+        void testComparisonsAndLogic();
+        void testConstantExpressions();
+        void testIfElse();
+        void testSelectCase();
+        void testWhileLoops();
+        void testArrays();
+        void testStrings();
+        void testStringTruncation();
+        void testBuiltInFunctions();
+        void testPolyphonicVariables();
+};
+
+#endif // __LS_SCRIPTVMBYTECODETEST_H__
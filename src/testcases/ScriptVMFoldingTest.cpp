@@ -0,0 +1,212 @@
+#include "ScriptVMFoldingTest.h"
+
+#include "../scriptvm/tree.h"
+
+#include <iostream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ScriptVMFoldingTest);
+
+using namespace std;
+using namespace LinuxSampler;
+
+// what we are interested in of a script after running its init handler
+struct ScriptResult {
+    int bytecodeSize;
+    int warnings;
+    int a; // value of the script's variable $a
+};
+
+static ScriptResult runScript(const String& code) {
+    ScriptVM vm;
+    VMParserContext* parserContext = vm.loadScript(code);
+    CPPUNIT_ASSERT(parserContext != NULL);
+    CPPUNIT_ASSERT(parserContext->errors().empty());
+    ParserContext* context = dynamic_cast<ParserContext*>(parserContext);
+    VMExecContext* execContext = vm.createExecContext(parserContext);
+    VMEventHandler* handler = parserContext->eventHandlerByName("init");
+    CPPUNIT_ASSERT(handler != NULL);
+    CPPUNIT_ASSERT(vm.exec(parserContext, execContext, handler) == VM_EXEC_NOT_RUNNING);
+
+    ScriptResult result;
+    result.bytecodeSize = context->bytecode.size();
+    result.warnings = parserContext->warnings().size();
+    IntVariable* a = dynamic_cast<IntVariable*>(&*context->vartable["$a"]);
+    CPPUNIT_ASSERT(a != NULL);
+    result.a = a->evalInt();
+
+    delete execContext;
+    delete parserContext;
+    return result;
+}
+
+// the init handler with the given declarations and statements
+static String initHandler(const String& declarations, const String& statements) {
+    return "on init\n" + declarations + statements + "end on\n";
+}
+
+// the statements must compile to exactly the same bytecode size as their
+// manually simplified equivalent and yield the same value for $a
+static ScriptResult checkFolded(const String& declarations, const String& statements,
+                                const String& simplifiedStatements)
+{
+    ScriptResult folded = runScript(initHandler(declarations, statements));
+    ScriptResult simplified = runScript(initHandler(declarations, simplifiedStatements));
+    if (folded.bytecodeSize != simplified.bytecodeSize)
+        cout << "\nbytecode size: " << folded.bytecodeSize << ", expected " << simplified.bytecodeSize << endl;
+    CPPUNIT_ASSERT(folded.bytecodeSize == simplified.bytecodeSize);
+    CPPUNIT_ASSERT(folded.a == simplified.a);
+    return folded;
+}
+
+
+// ScriptVMFoldingTest
+
+void ScriptVMFoldingTest::printTestSuiteName() {
+    cout << "\b \nRunning ScriptVM Folding Tests: " << flush;
+}
+
+void ScriptVMFoldingTest::testArithmetic() {
+    ScriptResult result = checkFolded(
+        "  declare $a\n",
+        "  $a := (2 + 3) * 4 - 10 / 3 + -(7 mod 4)\n",
+        "  $a := 14\n"
+    );
+    CPPUNIT_ASSERT(result.a == 14);
+    CPPUNIT_ASSERT(result.warnings == 0);
+}
+
+void ScriptVMFoldingTest::testConstVariables() {
+    ScriptResult result = checkFolded(
+        "  declare const $N := 3 * 4\n"
+        "  declare $a\n",
+        "  $a := $N * 2 + $N / 4\n",
+        "  $a := 27\n"
+    );
+    CPPUNIT_ASSERT(result.a == 27);
+}
+
+void ScriptVMFoldingTest::testRelationsAndLogic() {
+    ScriptResult result = checkFolded(
+        "  declare const $N := 5\n"
+        "  declare $a\n",
+        "  $a := ($N > 3) + ($N <= 4) * 2 + ($N = 5) * 4 + ($N # 5) * 8 + not ($N < 1 or $N >= 6) * 16\n",
+        "  $a := 21\n"
+    );
+    CPPUNIT_ASSERT(result.a == 21);
+}
+
+void ScriptVMFoldingTest::testShortCircuit() {
+    // the right hand side would never be evaluated, so even a non constant
+    // one does not prevent folding
+    ScriptResult result = checkFolded(
+        "  declare $b := 3\n"
+        "  declare $a\n",
+        "  $a := (1 or $b) + (0 and $b) * 2\n",
+        "  $a := 1\n"
+    );
+    CPPUNIT_ASSERT(result.a == 1);
+}
+
+void ScriptVMFoldingTest::testNumElements() {
+    ScriptResult result = checkFolded(
+        "  declare %arr[7]\n"
+        "  declare $a\n",
+        "  $a := num_elements(%arr) * 2\n",
+        "  $a := 14\n"
+    );
+    CPPUNIT_ASSERT(result.a == 14);
+}
+
+void ScriptVMFoldingTest::testModuloByZero() {
+    ScriptResult result = checkFolded(
+        "  declare $a\n",
+        "  $a := 5 mod 0 + 7 / 0\n",
+        "  $a := 0\n"
+    );
+    CPPUNIT_ASSERT(result.a == 0);
+
+    // must not crash at runtime either
+    result = runScript(initHandler(
+        "  declare $z := 0\n"
+        "  declare $a := 1\n",
+        "  $a := 5 mod $z\n"
+    ));
+    CPPUNIT_ASSERT(result.a == 0);
+}
+
+void ScriptVMFoldingTest::testIfElimination() {
+    ScriptResult result = checkFolded(
+        "  declare $a := 1\n",
+        "  if (2 > 3)\n"
+        "    $a := $a + 10\n"
+        "  else\n"
+        "    $a := $a + 20\n"
+        "  end if\n"
+        "  if (1)\n"
+        "    $a := $a * 2\n"
+        "  end if\n"
+        "  if (0)\n"
+        "    $a := 0\n"
+        "  end if\n",
+        "  $a := $a + 20\n"
+        "  $a := $a * 2\n"
+    );
+    CPPUNIT_ASSERT(result.a == 42);
+    // each eliminated branch is reported
+    CPPUNIT_ASSERT(result.warnings == 3);
+}
+
+void ScriptVMFoldingTest::testSelectElimination() {
+    ScriptResult result = checkFolded(
+        "  declare const $N := 3\n"
+        "  declare $a := 1\n",
+        "  select ($N)\n"
+        "    case 1\n"
+        "      $a := 10\n"
+        "    case 2 to 4\n"
+        "      $a := $a + 6\n"
+        "    case 5\n"
+        "      $a := 50\n"
+        "  end select\n"
+        "  select ($N * 10)\n"
+        "    case 1 to 4\n"
+        "      $a := 0\n"
+        "  end select\n",
+        "  $a := $a + 6\n"
+    );
+    CPPUNIT_ASSERT(result.a == 7);
+    CPPUNIT_ASSERT(result.warnings == 2);
+}
+
+void ScriptVMFoldingTest::testWhileElimination() {
+    ScriptResult result = checkFolded(
+        "  declare $a := 4\n",
+        "  while (1 > 2)\n"
+        "    $a := $a + 1\n"
+        "  end while\n"
+        "  $a := $a * 3\n",
+        "  $a := $a * 3\n"
+    );
+    CPPUNIT_ASSERT(result.a == 12);
+    CPPUNIT_ASSERT(result.warnings == 1);
+}
+
+void ScriptVMFoldingTest::testVariablesNotFolded() {
+    // expressions and conditions depending on variables must be kept
+    ScriptResult folded = runScript(initHandler(
+        "  declare $b := 2\n"
+        "  declare $a\n",
+        "  $a := $b * 3\n"
+        "  if ($b > 1)\n"
+        "    $a := $a + 1\n"
+        "  end if\n"
+    ));
+    ScriptResult constant = runScript(initHandler(
+        "  declare $b := 2\n"
+        "  declare $a\n",
+        "  $a := 7\n"
+    ));
+    CPPUNIT_ASSERT(folded.bytecodeSize > constant.bytecodeSize);
+    CPPUNIT_ASSERT(folded.a == 7);
+    CPPUNIT_ASSERT(folded.warnings == 0);
+}
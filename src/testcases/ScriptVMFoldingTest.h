@@ -0,0 +1,42 @@
+#ifndef __LS_SCRIPTVMFOLDINGTEST_H__
+#define __LS_SCRIPTVMFOLDINGTEST_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../scriptvm/ScriptVM.h"
+
+// Checks that constant expressions and branches with constant conditions are
+// already resolved by the parser, by comparing the bytecode of such scripts
+// with the bytecode of their manually simplified equivalents.
+class ScriptVMFoldingTest : public CppUnit::TestFixture {
+
+    CPPUNIT_TEST_SUITE(ScriptVMFoldingTest);
+    CPPUNIT_TEST(printTestSuiteName);
+    CPPUNIT_TEST(testArithmetic);
+    CPPUNIT_TEST(testConstVariables);
+    CPPUNIT_TEST(testRelationsAndLogic);
+    CPPUNIT_TEST(testShortCircuit);
+    CPPUNIT_TEST(testNumElements);
+    CPPUNIT_TEST(testModuloByZero);
+    CPPUNIT_TEST(testIfElimination);
+    CPPUNIT_TEST(testSelectElimination);
+    CPPUNIT_TEST(testWhileElimination);
+    CPPUNIT_TEST(testVariablesNotFolded);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void printTestSuiteName();
+        void testArithmetic();
+        void testConstVariables();
+        void testRelationsAndLogic();
+        void testShortCircuit();
+        void testNumElements();
+        void testModuloByZero();
+        void testIfElimination();
+        void testSelectElimination();
+        void testWhileElimination();
+        void testVariablesNotFolded();
+};
+
+#endif // __LS_SCRIPTVMFOLDINGTEST_H__